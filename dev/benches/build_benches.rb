@@ -5,4 +5,8 @@ MxxRu::Cpp::composite_target {
 	required_prj "benches/single_handler/prj.rb"
 	required_prj "benches/single_handler_so5_timer/prj.rb"
 	required_prj "benches/single_handler_no_timer/prj.rb"
+	required_prj "benches/load_suite/prj.rb"
+	required_prj "benches/query_string/prj.rb"
+	required_prj "benches/response_header/prj.rb"
+	required_prj "benches/ws_permessage_deflate/prj.rb"
 }
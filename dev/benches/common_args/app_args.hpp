@@ -15,6 +15,8 @@ struct app_args_t
 	std::string m_address{ "localhost" };
 	std::uint16_t m_port{ 8080 };
 	std::size_t m_pool_size{ 1 };
+	std::size_t m_request_arena_size{ 0 };
+	bool m_count_allocations{ false };
 
 	static app_args_t
 	parse( int argc, const char * argv[] )
@@ -35,6 +37,16 @@ struct app_args_t
 					( fmt::format(
 						"The size of a thread pool to run server (default: {})",
 						result.m_pool_size ) )
+			| Opt( result.m_request_arena_size, "bytes" )
+					[ "--request-arena-size" ]
+					( fmt::format(
+						"The size of per-connection arena for requests, "
+						"0 disables arenas (default: {})",
+						result.m_request_arena_size ) )
+			| Opt( result.m_count_allocations )
+					[ "--count-allocations" ]
+					( "Count memory allocations and show allocations per request "
+						"on exit" )
 			| Help(result.m_help);
 
 		auto parse_result = cli.parse( Args(argc, argv) );
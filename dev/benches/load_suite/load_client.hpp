@@ -0,0 +1,594 @@
+/*
+	restinio bench load suite: in-process load client.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <http_parser.h>
+
+#include <restinio/asio_include.hpp>
+
+namespace load_suite
+{
+
+using clock_type_t = std::chrono::steady_clock;
+
+//
+// load_params_t
+//
+
+//! Parameters of a single run of a scenario.
+struct load_params_t
+{
+	std::string m_address;
+	std::uint16_t m_port;
+
+	//! Count of connections (each connection has its own thread).
+	std::size_t m_connections;
+
+	//! Count of requests that are sent without waiting for responses.
+	std::size_t m_pipeline;
+
+	//! Time of warm-up, responses received during it aren't counted.
+	clock_type_t::duration m_warmup;
+
+	//! Time of measurement.
+	clock_type_t::duration m_duration;
+};
+
+//
+// connection_stats_t
+//
+
+//! Results of a single connection.
+struct connection_stats_t
+{
+	std::uint64_t m_responses{ 0 };
+	std::uint64_t m_errors{ 0 };
+	std::uint64_t m_body_bytes{ 0 };
+
+	//! Latencies of measured responses in nanoseconds.
+	std::vector< std::uint64_t > m_latencies;
+};
+
+//
+// run_result_t
+//
+
+//! Aggregated results of a run of a scenario.
+struct run_result_t
+{
+	std::uint64_t m_responses{ 0 };
+	std::uint64_t m_errors{ 0 };
+	std::uint64_t m_body_bytes{ 0 };
+	double m_seconds{ 0.0 };
+
+	//! Sorted latencies of all responses in nanoseconds.
+	std::vector< std::uint64_t > m_latencies;
+
+	double
+	throughput() const noexcept
+	{
+		return 0.0 < m_seconds ? double( m_responses ) / m_seconds : 0.0;
+	}
+
+	//! Get a percentile of latency in microseconds.
+	double
+	latency_us( double percentile ) const noexcept
+	{
+		if( m_latencies.empty() )
+			return 0.0;
+
+		const auto index = std::min(
+				m_latencies.size() - 1u,
+				static_cast< std::size_t >(
+					percentile / 100.0 * double( m_latencies.size() ) ) );
+
+		return double( m_latencies[ index ] ) / 1000.0;
+	}
+};
+
+namespace details
+{
+
+//! Time window of measurement and accounting of responses.
+class measurement_t
+{
+	public:
+		measurement_t(
+			const load_params_t & params,
+			connection_stats_t & stats )
+			:	m_stats{ stats }
+			,	m_start{ clock_type_t::now() + params.m_warmup }
+			,	m_finish{ m_start + params.m_duration }
+		{}
+
+		//! Should a new request be sent?
+		bool
+		is_running( clock_type_t::time_point now ) const noexcept
+		{
+			return now < m_finish;
+		}
+
+		//! Account a received response.
+		void
+		response_received(
+			clock_type_t::time_point sent_at,
+			std::size_t body_bytes )
+		{
+			const auto now = clock_type_t::now();
+			// Only responses to requests sent inside the window are counted.
+			if( m_start <= sent_at && sent_at < m_finish )
+			{
+				++m_stats.m_responses;
+				m_stats.m_body_bytes += body_bytes;
+				m_stats.m_latencies.push_back(
+					static_cast< std::uint64_t >(
+						std::chrono::duration_cast< std::chrono::nanoseconds >(
+							now - sent_at ).count() ) );
+			}
+		}
+
+		void
+		error( std::size_t count = 1u ) noexcept
+		{
+			m_stats.m_errors += count;
+		}
+
+	private:
+		connection_stats_t & m_stats;
+		const clock_type_t::time_point m_start;
+		const clock_type_t::time_point m_finish;
+};
+
+//! Open a blocking connection to the server.
+inline void
+connect(
+	restinio::asio_ns::ip::tcp::socket & socket,
+	const load_params_t & params )
+{
+	socket.connect(
+		restinio::asio_ns::ip::tcp::endpoint{
+			restinio::asio_ns::ip::make_address( params.m_address ),
+			params.m_port } );
+	socket.set_option( restinio::asio_ns::ip::tcp::no_delay{ true } );
+}
+
+//! Size of a buffer for reading responses.
+constexpr std::size_t read_buffer_size = 64u * 1024u;
+
+//
+// http_connection_t
+//
+
+//! A connection that sends the same HTTP request again and again.
+class http_connection_t
+{
+	public:
+		http_connection_t(
+			const load_params_t & params,
+			const std::string & request,
+			connection_stats_t & stats )
+			:	m_params{ params }
+			,	m_request{ request }
+			,	m_measurement{ params, stats }
+			,	m_socket{ m_io_context }
+		{
+			http_parser_init( &m_parser, HTTP_RESPONSE );
+			m_parser.data = this;
+
+			http_parser_settings_init( &m_parser_settings );
+			m_parser_settings.on_headers_complete = &on_headers_complete;
+			m_parser_settings.on_body = &on_body;
+			m_parser_settings.on_message_complete = &on_message_complete;
+		}
+
+		void
+		run()
+		{
+			connect( m_socket, m_params );
+
+			send_requests( m_params.m_pipeline );
+
+			std::array< char, read_buffer_size > buffer;
+			while( !m_in_flight.empty() )
+			{
+				restinio::asio_ns::error_code ec;
+				const auto length = m_socket.read_some(
+						restinio::asio_ns::buffer( buffer ), ec );
+				if( ec )
+				{
+					m_measurement.error( m_in_flight.size() );
+					return;
+				}
+
+				m_completed = 0u;
+				const auto parsed = http_parser_execute(
+						&m_parser, &m_parser_settings, buffer.data(), length );
+				if( parsed != length || HPE_OK != m_parser.http_errno )
+				{
+					m_measurement.error( m_in_flight.size() );
+					return;
+				}
+
+				if( m_measurement.is_running( clock_type_t::now() ) )
+					send_requests( m_completed );
+			}
+		}
+
+	private:
+		void
+		send_requests( std::size_t count )
+		{
+			if( 0u == count )
+				return;
+
+			// All requests are sent by one write operation.
+			m_batch.clear();
+			const auto now = clock_type_t::now();
+			for( std::size_t i = 0u; i != count; ++i )
+			{
+				m_batch += m_request;
+				m_in_flight.push_back( now );
+			}
+
+			restinio::asio_ns::write(
+				m_socket, restinio::asio_ns::buffer( m_batch ) );
+		}
+
+		static http_connection_t &
+		self( http_parser * parser ) noexcept
+		{
+			return *static_cast< http_connection_t * >( parser->data );
+		}
+
+		static int
+		on_headers_complete( http_parser * parser )
+		{
+			auto & s = self( parser );
+			s.m_body_bytes = 0u;
+			if( 200u != parser->status_code )
+				s.m_measurement.error();
+
+			return 0;
+		}
+
+		static int
+		on_body( http_parser * parser, const char *, std::size_t length )
+		{
+			self( parser ).m_body_bytes += length;
+			return 0;
+		}
+
+		static int
+		on_message_complete( http_parser * parser )
+		{
+			auto & s = self( parser );
+			s.m_measurement.response_received(
+					s.m_in_flight.front(), s.m_body_bytes );
+			s.m_in_flight.pop_front();
+			++s.m_completed;
+
+			return 0;
+		}
+
+		const load_params_t & m_params;
+		const std::string & m_request;
+		measurement_t m_measurement;
+
+		restinio::asio_ns::io_context m_io_context;
+		restinio::asio_ns::ip::tcp::socket m_socket;
+
+		http_parser m_parser;
+		http_parser_settings m_parser_settings;
+
+		//! Send times of requests waiting for responses.
+		std::deque< clock_type_t::time_point > m_in_flight;
+
+		//! Count of responses parsed from the last read.
+		std::size_t m_completed{ 0u };
+
+		//! Size of the body of the current response.
+		std::size_t m_body_bytes{ 0u };
+
+		std::string m_batch;
+};
+
+//
+// ws_connection_t
+//
+
+//! A websocket connection that sends the same message to an echo server.
+class ws_connection_t
+{
+	public:
+		ws_connection_t(
+			const load_params_t & params,
+			const std::string & target,
+			const std::string & payload,
+			connection_stats_t & stats )
+			:	m_params{ params }
+			,	m_target{ target }
+			,	m_frame{ make_client_frame( 0x1u, payload ) }
+			,	m_measurement{ params, stats }
+			,	m_socket{ m_io_context }
+		{}
+
+		void
+		run()
+		{
+			connect( m_socket, m_params );
+
+			if( !handshake() )
+			{
+				m_measurement.error();
+				return;
+			}
+
+			send_messages( m_params.m_pipeline );
+
+			std::array< char, read_buffer_size > buffer;
+			while( !m_in_flight.empty() )
+			{
+				restinio::asio_ns::error_code ec;
+				const auto length = m_socket.read_some(
+						restinio::asio_ns::buffer( buffer ), ec );
+				if( ec )
+				{
+					m_measurement.error( m_in_flight.size() );
+					return;
+				}
+
+				m_input.append( buffer.data(), length );
+
+				const auto completed = handle_frames();
+
+				if( m_measurement.is_running( clock_type_t::now() ) )
+					send_messages( completed );
+			}
+
+			// Close frame without a status code.
+			restinio::asio_ns::error_code ec;
+			restinio::asio_ns::write(
+				m_socket,
+				restinio::asio_ns::buffer( make_client_frame( 0x8u, std::string{} ) ),
+				ec );
+		}
+
+	private:
+		bool
+		handshake()
+		{
+			const std::string request =
+				"GET " + m_target + " HTTP/1.1\r\n"
+				"Host: " + m_params.m_address + "\r\n"
+				"Upgrade: websocket\r\n"
+				"Connection: Upgrade\r\n"
+				"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+				"Sec-WebSocket-Version: 13\r\n"
+				"\r\n";
+
+			restinio::asio_ns::write(
+				m_socket, restinio::asio_ns::buffer( request ) );
+
+			restinio::asio_ns::streambuf response;
+			const auto header_size = restinio::asio_ns::read_until(
+					m_socket, response, "\r\n\r\n" );
+
+			std::string data{
+				restinio::asio_ns::buffers_begin( response.data() ),
+				restinio::asio_ns::buffers_end( response.data() ) };
+
+			// Frames can follow the response in the same read.
+			m_input = data.substr( header_size );
+
+			return 0u == data.rfind( "HTTP/1.1 101", 0u );
+		}
+
+		void
+		send_messages( std::size_t count )
+		{
+			if( 0u == count )
+				return;
+
+			m_batch.clear();
+			const auto now = clock_type_t::now();
+			for( std::size_t i = 0u; i != count; ++i )
+			{
+				m_batch += m_frame;
+				m_in_flight.push_back( now );
+			}
+
+			restinio::asio_ns::write(
+				m_socket, restinio::asio_ns::buffer( m_batch ) );
+		}
+
+		//! Handle all complete frames from the input.
+		/*!
+			\return count of received echo messages.
+		*/
+		std::size_t
+		handle_frames()
+		{
+			std::size_t completed = 0u;
+			std::size_t offset = 0u;
+
+			for(;;)
+			{
+				const auto available = m_input.size() - offset;
+				if( available < 2u )
+					break;
+
+				const auto * header =
+					reinterpret_cast< const unsigned char * >( m_input.data() + offset );
+
+				// Server frames are not masked.
+				std::size_t header_size = 2u;
+				std::uint64_t payload_size = header[ 1 ] & 0x7Fu;
+				if( 126u == payload_size )
+				{
+					header_size += 2u;
+					if( available < header_size )
+						break;
+					payload_size = ( std::uint64_t{ header[ 2 ] } << 8 ) | header[ 3 ];
+				}
+				else if( 127u == payload_size )
+				{
+					header_size += 8u;
+					if( available < header_size )
+						break;
+					payload_size = 0u;
+					for( std::size_t i = 2u; i != 10u; ++i )
+						payload_size = ( payload_size << 8 ) | header[ i ];
+				}
+
+				if( available < header_size + payload_size )
+					break;
+
+				offset += header_size + static_cast< std::size_t >( payload_size );
+
+				m_measurement.response_received(
+						m_in_flight.front(),
+						static_cast< std::size_t >( payload_size ) );
+				m_in_flight.pop_front();
+				++completed;
+			}
+
+			m_input.erase( 0u, offset );
+
+			return completed;
+		}
+
+		//! Make a final masked frame.
+		static std::string
+		make_client_frame( unsigned opcode, const std::string & payload )
+		{
+			std::string result;
+			result += static_cast< char >( 0x80u | opcode );
+
+			if( payload.size() < 126u )
+				result += static_cast< char >( 0x80u | payload.size() );
+			else if( payload.size() <= 0xFFFFu )
+			{
+				result += static_cast< char >( 0x80u | 126u );
+				result += static_cast< char >( ( payload.size() >> 8 ) & 0xFFu );
+				result += static_cast< char >( payload.size() & 0xFFu );
+			}
+			else
+			{
+				result += static_cast< char >( 0x80u | 127u );
+				for( int shift = 56; shift >= 0; shift -= 8 )
+					result += static_cast< char >(
+						( std::uint64_t{ payload.size() } >> shift ) & 0xFFu );
+			}
+
+			const std::array< char, 4 > mask{ { 0x12, 0x34, 0x56, 0x78 } };
+			result.append( mask.data(), mask.size() );
+
+			for( std::size_t i = 0u; i != payload.size(); ++i )
+				result += static_cast< char >( payload[ i ] ^ mask[ i % 4u ] );
+
+			return result;
+		}
+
+		const load_params_t & m_params;
+		const std::string & m_target;
+		const std::string m_frame;
+		measurement_t m_measurement;
+
+		restinio::asio_ns::io_context m_io_context;
+		restinio::asio_ns::ip::tcp::socket m_socket;
+
+		//! Send times of messages waiting for echo.
+		std::deque< clock_type_t::time_point > m_in_flight;
+
+		//! Received but not handled data.
+		std::string m_input;
+
+		std::string m_batch;
+};
+
+//! Run connections on separate threads and aggregate results.
+template< typename Connection_Runner >
+run_result_t
+run_connections(
+	const load_params_t & params,
+	Connection_Runner && runner )
+{
+	std::vector< connection_stats_t > stats( params.m_connections );
+	std::vector< std::thread > threads;
+	threads.reserve( params.m_connections );
+
+	for( auto & s : stats )
+		threads.emplace_back( [&runner, &s] {
+			try
+			{
+				runner( s );
+			}
+			catch( const std::exception & )
+			{
+				++s.m_errors;
+			}
+		} );
+
+	for( auto & t : threads )
+		t.join();
+
+	run_result_t result;
+	result.m_seconds = std::chrono::duration< double >( params.m_duration ).count();
+
+	for( auto & s : stats )
+	{
+		result.m_responses += s.m_responses;
+		result.m_errors += s.m_errors;
+		result.m_body_bytes += s.m_body_bytes;
+		result.m_latencies.insert(
+				result.m_latencies.end(),
+				s.m_latencies.begin(),
+				s.m_latencies.end() );
+	}
+
+	std::sort( result.m_latencies.begin(), result.m_latencies.end() );
+
+	return result;
+}
+
+} /* namespace details */
+
+//! Send the same HTTP request over several connections.
+inline run_result_t
+run_http_load(
+	const load_params_t & params,
+	const std::string & request )
+{
+	return details::run_connections( params,
+		[&]( connection_stats_t & stats ) {
+			details::http_connection_t connection{ params, request, stats };
+			connection.run();
+		} );
+}
+
+//! Send the same websocket message over several connections.
+inline run_result_t
+run_ws_load(
+	const load_params_t & params,
+	const std::string & target,
+	const std::string & payload )
+{
+	return details::run_connections( params,
+		[&]( connection_stats_t & stats ) {
+			details::ws_connection_t connection{ params, target, payload, stats };
+			connection.run();
+		} );
+}
+
+} /* namespace load_suite */
@@ -0,0 +1,433 @@
+/*
+	restinio bench load suite.
+
+	Runs a server and an in-process load client on loopback
+	and reports throughput and latency of several scenarios
+	as JSON lines.
+*/
+#include <stdexcept>
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <cstdio>
+
+#include <restinio/all.hpp>
+#include <restinio/websocket/websocket.hpp>
+#include <restinio/transforms/zlib.hpp>
+
+#include <clara.hpp>
+#include <fmt/format.h>
+
+#include <benches/load_suite/load_client.hpp>
+
+//
+// app_args_t
+//
+
+struct app_args_t
+{
+	bool m_help{ false };
+	std::string m_address{ "127.0.0.1" };
+	std::uint16_t m_port{ 8080 };
+	std::size_t m_pool_size{ 2 };
+	std::size_t m_connections{ 8 };
+	std::size_t m_pipeline{ 1 };
+	std::size_t m_warmup{ 1 };
+	std::size_t m_duration{ 5 };
+	std::string m_scenarios{ "all" };
+	std::size_t m_large_body_size{ 1024 * 1024 };
+	std::size_t m_ws_message_size{ 128 };
+
+	static app_args_t
+	parse( int argc, const char * argv[] )
+	{
+		using namespace clara;
+
+		app_args_t result;
+
+		auto cli =
+			Opt( result.m_address, "address" )
+					["-a"]["--address"]
+					( fmt::format( "address to listen (default: {})", result.m_address ) )
+			| Opt( result.m_port, "port" )
+					["-p"]["--port"]
+					( fmt::format( "port to listen (default: {})", result.m_port ) )
+			| Opt( result.m_pool_size, "thread-pool size" )
+					[ "-n" ][ "--thread-pool-size" ]
+					( fmt::format(
+						"The size of a thread pool to run server (default: {})",
+						result.m_pool_size ) )
+			| Opt( result.m_connections, "connections" )
+					[ "-c" ][ "--connections" ]
+					( fmt::format(
+						"Count of client connections, each has its own thread "
+						"(default: {})",
+						result.m_connections ) )
+			| Opt( result.m_pipeline, "depth" )
+					[ "--pipeline" ]
+					( fmt::format(
+						"Count of requests sent on a connection without waiting "
+						"for responses (default: {})",
+						result.m_pipeline ) )
+			| Opt( result.m_warmup, "seconds" )
+					[ "--warmup" ]
+					( fmt::format(
+						"Warm-up time of every scenario (default: {})",
+						result.m_warmup ) )
+			| Opt( result.m_duration, "seconds" )
+					[ "-d" ][ "--duration" ]
+					( fmt::format(
+						"Measurement time of every scenario (default: {})",
+						result.m_duration ) )
+			| Opt( result.m_scenarios, "names" )
+					[ "-s" ][ "--scenarios" ]
+					( "Comma separated list of scenarios: plain, routing, "
+						"large_body, chunked, sendfile, compression, ws_echo "
+						"(default: all)" )
+			| Opt( result.m_large_body_size, "bytes" )
+					[ "--large-body-size" ]
+					( fmt::format(
+						"Size of bodies for large_body and sendfile scenarios "
+						"(default: {})",
+						result.m_large_body_size ) )
+			| Opt( result.m_ws_message_size, "bytes" )
+					[ "--ws-message-size" ]
+					( fmt::format(
+						"Size of messages for ws_echo scenario (default: {})",
+						result.m_ws_message_size ) )
+			| Help(result.m_help);
+
+		auto parse_result = cli.parse( Args(argc, argv) );
+		if( !parse_result )
+		{
+			throw std::runtime_error{
+				fmt::format(
+					"Invalid command-line arguments: {}",
+					parse_result.errorMessage() ) };
+		}
+
+		if( result.m_help )
+		{
+			std::cout << cli << std::endl;
+		}
+
+		if( 0u == result.m_connections || 0u == result.m_pipeline )
+			throw std::runtime_error{
+				"connections and pipeline depth must be greater than 0" };
+
+		return result;
+	}
+};
+
+namespace rr = restinio::router;
+namespace rws = restinio::websocket::basic;
+namespace rtz = restinio::transforms::zlib;
+
+using router_t = rr::express_router_t<>;
+
+using traits_t =
+	restinio::traits_t<
+		restinio::asio_timer_manager_t,
+		restinio::null_logger_t,
+		router_t >;
+
+using http_server_t = restinio::http_server_t< traits_t >;
+
+//! Count of routes that are checked before the route of routing scenario.
+constexpr int routes_count = 50;
+
+//
+// server_data_t
+//
+
+//! Data used by request handlers.
+struct server_data_t
+{
+	std::string m_large_body;
+	std::string m_text_body;
+	std::string m_sendfile_path;
+
+	std::mutex m_ws_lock;
+	std::map< std::uint64_t, rws::ws_handle_t > m_ws_registry;
+};
+
+std::string
+make_text( std::size_t size )
+{
+	std::string result;
+	result.reserve( size );
+
+	for( std::size_t i = 0u; result.size() < size; ++i )
+		result += fmt::format( "line {}: The quick brown fox jumps over the lazy dog\n", i );
+
+	result.resize( size );
+	return result;
+}
+
+auto
+make_router( server_data_t & data )
+{
+	auto router = std::make_unique< router_t >();
+
+	router->http_get( "/plain", []( auto req, auto ){
+		return req->create_response()
+			.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+			.append_header( restinio::http_field::content_type, "text/plain; charset=utf-8" )
+			.set_body( "Hello world!" )
+			.done();
+	} );
+
+	router->http_get( "/large", [&data]( auto req, auto ){
+		return req->create_response()
+			.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+			.append_header( restinio::http_field::content_type, "text/plain; charset=utf-8" )
+			.set_body( restinio::const_buffer(
+					data.m_large_body.data(), data.m_large_body.size() ) )
+			.done();
+	} );
+
+	router->http_get( "/chunked", [&data]( auto req, auto ){
+		auto resp = req->template create_response< restinio::chunked_output_t >();
+		resp
+			.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+			.append_header( restinio::http_field::content_type, "text/plain; charset=utf-8" );
+
+		// 16 chunks of 1KiB.
+		for( std::size_t i = 0u; i != 16u; ++i )
+			resp.append_chunk( restinio::const_buffer(
+					data.m_text_body.data() + i * 1024u, 1024u ) );
+
+		return resp.done();
+	} );
+
+	router->http_get( "/sendfile", [&data]( auto req, auto ){
+		return req->create_response()
+			.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+			.append_header( restinio::http_field::content_type, "application/octet-stream" )
+			.set_body( restinio::sendfile( data.m_sendfile_path ) )
+			.done();
+	} );
+
+	router->http_get( "/compressed", [&data]( auto req, auto ){
+		auto resp = req->create_response();
+		resp
+			.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+			.append_header( restinio::http_field::content_type, "text/plain; charset=utf-8" );
+
+		auto ba = rtz::gzip_body_appender( resp );
+		ba.append( data.m_text_body );
+		ba.complete();
+
+		return resp.done();
+	} );
+
+	router->http_get( "/ws", [&data]( auto req, auto ){
+		if( restinio::http_connection_header_t::upgrade != req->header().connection() )
+			return restinio::request_rejected();
+
+		auto wsh = rws::upgrade< traits_t >(
+			*req,
+			rws::activation_t::immediate,
+			[&data]( auto wsh, auto m ){
+				if( rws::opcode_t::text_frame == m->opcode() ||
+					rws::opcode_t::binary_frame == m->opcode() )
+				{
+					wsh->send_message( *m );
+				}
+				else if( rws::opcode_t::connection_close_frame == m->opcode() )
+				{
+					std::lock_guard< std::mutex > lock{ data.m_ws_lock };
+					data.m_ws_registry.erase( wsh->connection_id() );
+				}
+			} );
+
+		std::lock_guard< std::mutex > lock{ data.m_ws_lock };
+		data.m_ws_registry.emplace( wsh->connection_id(), wsh );
+
+		return restinio::request_accepted();
+	} );
+
+	// Routes for routing scenario. The route used by the client
+	// is the last one, so the router has to check all of them.
+	for( int i = 0; i != routes_count; ++i )
+	{
+		router->http_get(
+			fmt::format( R"(/api/v1/resource{}/:id(\d+))", i ),
+			[]( auto req, auto params ){
+				return req->create_response()
+					.append_header( restinio::http_field::server, "RESTinio Benchmark" )
+					.append_header( restinio::http_field::content_type, "text/plain; charset=utf-8" )
+					.set_body( restinio::cast_to< std::string >( params[ "id" ] ) )
+					.done();
+			} );
+	}
+
+	return router;
+}
+
+std::string
+make_get_request( const app_args_t & args, const std::string & target )
+{
+	return fmt::format(
+		"GET {} HTTP/1.1\r\n"
+		"Host: {}:{}\r\n"
+		"User-Agent: restinio-load-suite\r\n"
+		"Accept: */*\r\n"
+		"Accept-Encoding: gzip\r\n"
+		"\r\n",
+		target, args.m_address, args.m_port );
+}
+
+void
+print_result(
+	const std::string & scenario,
+	const app_args_t & args,
+	const load_suite::run_result_t & result )
+{
+	std::cout << fmt::format(
+		"{{\"scenario\":\"{}\",\"connections\":{},\"pipeline\":{},"
+		"\"server_threads\":{},\"seconds\":{:.3f},\"responses\":{},"
+		"\"errors\":{},\"rps\":{:.1f},\"body_mib_per_sec\":{:.2f},"
+		"\"p50_us\":{:.1f},\"p99_us\":{:.1f},\"p999_us\":{:.1f}}}",
+		scenario,
+		args.m_connections,
+		args.m_pipeline,
+		args.m_pool_size,
+		result.m_seconds,
+		result.m_responses,
+		result.m_errors,
+		result.throughput(),
+		double( result.m_body_bytes ) / result.m_seconds / ( 1024.0 * 1024.0 ),
+		result.latency_us( 50.0 ),
+		result.latency_us( 99.0 ),
+		result.latency_us( 99.9 ) ) << std::endl;
+}
+
+bool
+is_selected( const std::string & scenarios, const std::string & name )
+{
+	if( "all" == scenarios )
+		return true;
+
+	return std::string::npos != ( "," + scenarios + "," ).find( "," + name + "," );
+}
+
+void
+run_suite( const app_args_t & args, server_data_t & data )
+{
+	restinio::asio_ns::io_context ioctx;
+
+	http_server_t server{
+		restinio::external_io_context( ioctx ),
+		[&]( auto & settings ){
+			using namespace std::chrono;
+			settings
+				.address( args.m_address )
+				.port( args.m_port )
+				.read_next_http_message_timelimit( 60s )
+				.write_http_response_timelimit( 60s )
+				.handle_request_timeout( 60s )
+				.max_pipelined_requests( args.m_pipeline )
+				// Responses written by several operations (e.g. chunked output)
+				// shouldn't be delayed by Nagle's algorithm.
+				.socket_options_setter( []( auto & options ){
+					options.set_option( restinio::asio_ns::ip::tcp::no_delay{ true } );
+				} )
+				.request_handler( make_router( data ) );
+		} };
+
+	server.open_sync();
+
+	std::vector< std::thread > pool;
+	for( std::size_t i = 0u; i != args.m_pool_size; ++i )
+		pool.emplace_back( [&ioctx]{ ioctx.run(); } );
+
+	const load_suite::load_params_t params{
+		args.m_address,
+		args.m_port,
+		args.m_connections,
+		args.m_pipeline,
+		std::chrono::seconds( args.m_warmup ),
+		std::chrono::seconds( args.m_duration ) };
+
+	const std::vector< std::pair< std::string, std::string > > http_scenarios{
+		{ "plain", "/plain" },
+		{ "routing", fmt::format( "/api/v1/resource{}/42", routes_count - 1 ) },
+		{ "large_body", "/large" },
+		{ "chunked", "/chunked" },
+		{ "sendfile", "/sendfile" },
+		{ "compression", "/compressed" } };
+
+	for( const auto & s : http_scenarios )
+	{
+		if( is_selected( args.m_scenarios, s.first ) )
+		{
+			print_result( s.first, args,
+				load_suite::run_http_load(
+					params, make_get_request( args, s.second ) ) );
+		}
+	}
+
+	if( is_selected( args.m_scenarios, "ws_echo" ) )
+	{
+		print_result( "ws_echo", args,
+			load_suite::run_ws_load(
+				params, "/ws", make_text( args.m_ws_message_size ) ) );
+	}
+
+	restinio::asio_ns::post( ioctx, [&]{
+			{
+				std::lock_guard< std::mutex > lock{ data.m_ws_lock };
+				data.m_ws_registry.clear();
+			}
+			server.close_sync();
+			ioctx.stop();
+		} );
+
+	for( auto & t : pool )
+		t.join();
+}
+
+int main(int argc, const char *argv[])
+{
+	try
+	{
+		const auto args = app_args_t::parse( argc, argv );
+
+		if( !args.m_help )
+		{
+			server_data_t data;
+			data.m_large_body = make_text( args.m_large_body_size );
+			data.m_text_body = make_text( 16u * 1024u );
+
+			// File for sendfile scenario is created in the current directory.
+			data.m_sendfile_path = "_restinio_load_suite.sendfile.bin";
+			{
+				std::ofstream file{ data.m_sendfile_path, std::ios::binary };
+				file << data.m_large_body;
+				if( !file )
+					throw std::runtime_error{ "unable to create file for sendfile" };
+			}
+
+			try
+			{
+				run_suite( args, data );
+			}
+			catch( ... )
+			{
+				std::remove( data.m_sendfile_path.c_str() );
+				throw;
+			}
+
+			std::remove( data.m_sendfile_path.c_str() );
+		}
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
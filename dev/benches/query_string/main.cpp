@@ -0,0 +1,88 @@
+/*
+	restinio bench for query string parsing.
+
+	Compares parse_query() with query_string_view_t for the case
+	when only a few of many parameters are used.
+*/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <restinio/all.hpp>
+
+#include <fmt/format.h>
+
+//! Make a query string with a number of parameters.
+std::string
+make_query( std::size_t params_count )
+{
+	std::string result;
+	for( std::size_t i = 0; i < params_count; ++i )
+	{
+		if( !result.empty() )
+			result += '&';
+
+		if( 0 == i % 5 )
+			result += fmt::format( "text{}=some+escaped%20value+{}", i, i );
+		else
+			result += fmt::format( "param{}={}", i, i * 1000 );
+	}
+
+	return result;
+}
+
+template< typename Lambda >
+void
+run_case( const char * name, std::size_t iterations, Lambda && lambda )
+{
+	std::uint64_t checksum = 0u;
+
+	const auto started_at = std::chrono::steady_clock::now();
+	for( std::size_t i = 0; i < iterations; ++i )
+		checksum += lambda();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+			finished_at - started_at ).count();
+
+	std::cout << fmt::format(
+			"{:<16} {:>10.1f} ns/op  (checksum: {})",
+			name,
+			static_cast< double >( ns ) / static_cast< double >( iterations ),
+			checksum )
+		<< std::endl;
+}
+
+int
+main( int argc, const char * argv[] )
+{
+	const std::size_t iterations =
+		1 < argc ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 1000000u;
+	const std::size_t params_count =
+		2 < argc ? std::strtoul( argv[ 2 ], nullptr, 10 ) : 40u;
+
+	const auto query = make_query( params_count );
+	const auto last = fmt::format( "param{}", params_count - 1u );
+
+	std::cout << fmt::format(
+			"query: {} bytes, {} parameters, {} iterations",
+			query.size(), params_count, iterations ) << std::endl;
+
+	run_case( "parse_query", iterations, [&]{
+			const auto params = restinio::parse_query( query );
+			return
+				restinio::cast_to< std::uint64_t >( params[ "param1" ] ) +
+				restinio::cast_to< std::uint64_t >( params[ last ] ) +
+				restinio::cast_to< std::string >( params[ "text10" ] ).size();
+		} );
+
+	run_case( "query_view", iterations, [&]{
+			const restinio::query_string_view_t<> params{ query };
+			return
+				params.get< std::uint64_t >( "param1" ) +
+				params.get< std::uint64_t >( last ) +
+				params.get< std::string >( "text10" ).size();
+		} );
+
+	return 0;
+}
@@ -0,0 +1,172 @@
+/*
+	restinio bench for serialization of response headers.
+
+	Compares create_header_string() and make_date_field_value()
+	with the previous implementation based on snprintf() and strftime().
+*/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <restinio/all.hpp>
+
+#include <fmt/format.h>
+
+namespace legacy
+{
+
+//! The previous version of restinio::impl::create_header_string().
+std::string
+create_header_string( const restinio::http_response_header_t & h )
+{
+	std::string result;
+	result.reserve( restinio::impl::calculate_approx_buffer_size_for_header( h ) );
+
+	result.append( "HTTP/" );
+	result += static_cast<char>( '0' + h.http_major() );
+	result += '.';
+	result += static_cast<char>( '0' + h.http_minor() );
+	result += ' ';
+
+	const auto sc = h.status_code().raw_code();
+	result += static_cast<char>( '0' + ( sc / 100 ) % 10 );
+	result += static_cast<char>( '0' + ( sc / 10 ) % 10 );
+	result += static_cast<char>( '0' + ( sc ) % 10 );
+
+	result += ' ';
+	result += h.reason_phrase();
+	result.append( "\r\n" );
+
+	if( h.should_keep_alive() )
+		result.append( "Connection: keep-alive\r\n" );
+	else
+		result.append( "Connection: close\r\n" );
+
+	std::array< char, 64 > buf{};
+	const auto n =
+		std::snprintf(
+			buf.data(),
+			buf.size(),
+			"Content-Length: %llu\r\n",
+			static_cast< unsigned long long >( h.content_length() ) );
+	result.append( buf.data(), static_cast<std::string::size_type>(n) );
+
+	h.for_each_field( [&result](const auto & f) {
+		result += f.name();
+		result.append( ": " );
+		result += f.value();
+		result.append( "\r\n" );
+	} );
+
+	result.append( "\r\n" );
+
+	return result;
+}
+
+//! The previous version of restinio::make_date_field_value().
+std::string
+make_date_field_value( std::chrono::system_clock::time_point tp )
+{
+	const auto tpoint =
+		restinio::make_gmtime( std::chrono::system_clock::to_time_t( tp ) );
+
+	std::array< char, 64 > buf;
+	strftime(
+		buf.data(),
+		buf.size(),
+		"%a, %d %b %Y %H:%M:%S GMT",
+		&tpoint );
+
+	return std::string{ buf.data() };
+}
+
+} /* namespace legacy */
+
+//! Make a header of a typical response.
+restinio::http_response_header_t
+make_header( std::string date )
+{
+	restinio::http_response_header_t h{ restinio::status_ok() };
+	h.should_keep_alive( true );
+	h.content_length( 1024u * 1024u );
+	h.set_field( "Server", "RESTinio benchmark server" );
+	h.set_field( restinio::http_field::date, std::move( date ) );
+	h.set_field( restinio::http_field::content_type, "text/plain; charset=utf-8" );
+	h.set_field( restinio::http_field::cache_control, "no-cache" );
+
+	return h;
+}
+
+template< typename Lambda >
+void
+run_case( const char * name, std::size_t iterations, Lambda && lambda )
+{
+	std::uint64_t checksum = 0u;
+
+	const auto started_at = std::chrono::steady_clock::now();
+	for( std::size_t i = 0; i < iterations; ++i )
+		checksum += lambda();
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const auto ns = std::chrono::duration_cast< std::chrono::nanoseconds >(
+			finished_at - started_at ).count();
+
+	std::cout << fmt::format(
+			"{:<16} {:>10.1f} ns/op  (checksum: {})",
+			name,
+			static_cast< double >( ns ) / static_cast< double >( iterations ),
+			checksum )
+		<< std::endl;
+}
+
+int
+main( int argc, const char * argv[] )
+{
+	const std::size_t iterations =
+		1 < argc ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 1000000u;
+
+	const auto header = make_header(
+			restinio::make_date_field_value( std::chrono::system_clock::now() ) );
+
+	if( legacy::create_header_string( header ) !=
+		restinio::impl::create_header_string( header ) )
+	{
+		std::cerr << "serialized headers differ" << std::endl;
+		return 1;
+	}
+
+	std::cout << fmt::format( "{} iterations", iterations ) << std::endl;
+
+	run_case( "legacy header", iterations, [&]{
+			return legacy::create_header_string( header ).size();
+		} );
+
+	run_case( "header", iterations, [&]{
+			return restinio::impl::create_header_string( header ).size();
+		} );
+
+	run_case( "legacy date", iterations, [&]{
+			return legacy::make_date_field_value(
+					std::chrono::system_clock::now() ).size();
+		} );
+
+	run_case( "date", iterations, [&]{
+			return restinio::make_date_field_value(
+					std::chrono::system_clock::now() ).size();
+		} );
+
+	// A response as it is built by a request handler.
+	run_case( "legacy response", iterations, [&]{
+			return legacy::create_header_string( make_header(
+					legacy::make_date_field_value(
+						std::chrono::system_clock::now() ) ) ).size();
+		} );
+
+	run_case( "response", iterations, [&]{
+			return restinio::impl::create_header_string( make_header(
+					restinio::make_date_field_value(
+						std::chrono::system_clock::now() ) ) ).size();
+		} );
+
+	return 0;
+}
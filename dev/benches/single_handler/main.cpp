@@ -4,6 +4,9 @@
 #include <stdexcept>
 #include <iostream>
 #include <fstream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 
 #include <restinio/all.hpp>
 
@@ -11,10 +14,73 @@
 
 const std::string resp_body{ "Hello world!" };
 
+//
+// Allocations counting.
+//
+
+// Is set only once before the server is started.
+bool g_count_allocations{ false };
+
+std::atomic< std::size_t > g_allocations{ 0 };
+std::atomic< std::size_t > g_allocations_before_first_request{ 0 };
+std::atomic< std::size_t > g_requests{ 0 };
+
+void *
+operator new( std::size_t size )
+{
+	if( g_count_allocations )
+		g_allocations.fetch_add( 1, std::memory_order_relaxed );
+
+	if( void * p = std::malloc( size ? size : 1 ) )
+		return p;
+
+	throw std::bad_alloc{};
+}
+
+void
+operator delete( void * p ) noexcept
+{
+	std::free( p );
+}
+
+void
+operator delete( void * p, std::size_t ) noexcept
+{
+	std::free( p );
+}
+
+void
+count_request()
+{
+	if( g_count_allocations &&
+		0 == g_requests.fetch_add( 1, std::memory_order_relaxed ) )
+	{
+		// Allocations made on server start and on the first request
+		// (e.g. a new connection) are not taken into account.
+		g_allocations_before_first_request =
+			g_allocations.load( std::memory_order_relaxed );
+	}
+}
+
+void
+show_allocations_per_request()
+{
+	const auto requests = g_requests.load();
+	if( 1 < requests )
+	{
+		std::cout << "allocations per request: "
+			<< double( g_allocations.load() - g_allocations_before_first_request ) /
+				double( requests - 1 )
+			<< std::endl;
+	}
+}
+
 struct req_handler_t
 {
 	auto operator () ( restinio::request_handle_t req ) const
 	{
+		count_request();
+
 		if( restinio::http_method_get() == req->header().method() &&
 			req->header().request_target() == "/" )
 		{
@@ -43,7 +109,8 @@ void run_app( const app_args_t args )
 			.read_next_http_message_timelimit( 5s )
 			.write_http_response_timelimit( 5s )
 			.handle_request_timeout( 5s )
-			.max_pipelined_requests( 4 ) );
+			.max_pipelined_requests( 4 )
+			.request_arena_size( args.m_request_arena_size ) );
 }
 
 int main(int argc, const char *argv[])
@@ -55,6 +122,9 @@ int main(int argc, const char *argv[])
 		if( !args.m_help )
 		{
 			std::cout << "pool size: " << args.m_pool_size << std::endl;
+			std::cout << "request arena size: " << args.m_request_arena_size << std::endl;
+
+			g_count_allocations = args.m_count_allocations;
 
 			if( 1 < args.m_pool_size )
 			{
@@ -80,6 +150,8 @@ int main(int argc, const char *argv[])
 			{
 				throw std::runtime_error{ "invalid asio pool size" };
 			}
+
+			show_allocations_per_request();
 		}
 	}
 	catch( const std::exception & ex )
@@ -0,0 +1,133 @@
+/*
+	restinio bench for permessage-deflate websocket extension.
+
+	Measures bytes on the wire and CPU time per message
+	for compression and decompression of small JSON-like messages
+	with and without context takeover.
+*/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+#include <restinio/all.hpp>
+#include <restinio/websocket/permessage_deflate.hpp>
+
+#include <fmt/format.h>
+
+namespace rws = restinio::websocket::basic;
+
+//! Make a sequence of similar messages like market data updates.
+std::vector< std::string >
+make_messages( std::size_t count )
+{
+	std::vector< std::string > result;
+	result.reserve( count );
+
+	for( std::size_t i = 0; i < count; ++i )
+		result.push_back( fmt::format(
+				R"({{"type":"quote","symbol":"SYM{}","bid":{}.{:02},)"
+				R"("ask":{}.{:02},"volume":{},"seq":{}}})",
+				i % 16,
+				100 + i % 7, i % 100,
+				101 + i % 5, ( i * 7 ) % 100,
+				1000 + ( i * 31 ) % 9000,
+				i ) );
+
+	return result;
+}
+
+void
+run_case(
+	const char * name,
+	const std::vector< std::string > & messages,
+	const rws::permessage_deflate_params_t & params )
+{
+	const auto config = rws::negotiate_permessage_deflate(
+			"permessage-deflate", params );
+	if( !config )
+		throw std::runtime_error{ "permessage-deflate isn't negotiated" };
+
+	// Messages from the server are decompressed by the same implementation.
+	// It's possible because the default settings for the client
+	// allow any settings of the server.
+	auto sender = rws::impl::make_permessage_deflate_compression( *config, params );
+	auto receiver = rws::impl::make_permessage_deflate_compression( *config, params );
+
+	std::vector< std::string > compressed;
+	compressed.reserve( messages.size() );
+
+	std::size_t original_bytes = 0u;
+	std::size_t wire_bytes = 0u;
+
+	const auto compress_started_at = std::chrono::steady_clock::now();
+	for( const auto & m : messages )
+	{
+		auto frame = sender.m_compressor->compress_frame(
+				rws::opcode_t::text_frame, true, m );
+		compressed.push_back( frame ? std::move( frame->m_payload ) : m );
+
+		original_bytes += m.size();
+		wire_bytes += compressed.back().size();
+	}
+	const auto compress_finished_at = std::chrono::steady_clock::now();
+
+	for( auto & c : compressed )
+		receiver.m_decompressor->decompress_frame( true, c );
+	const auto decompress_finished_at = std::chrono::steady_clock::now();
+
+	for( std::size_t i = 0; i < messages.size(); ++i )
+		if( messages[ i ] != compressed[ i ] )
+			throw std::runtime_error{ "decompressed message differs" };
+
+	const auto per_message = [&]( auto from, auto to ) {
+		return static_cast< double >(
+				std::chrono::duration_cast< std::chrono::nanoseconds >(
+					to - from ).count() ) /
+			static_cast< double >( messages.size() );
+	};
+
+	std::cout << fmt::format(
+			"{:<24} {:>6.1f} bytes/msg (ratio {:.3f})  "
+			"compress: {:>8.1f} ns/msg  decompress: {:>8.1f} ns/msg",
+			name,
+			static_cast< double >( wire_bytes ) /
+				static_cast< double >( messages.size() ),
+			static_cast< double >( wire_bytes ) /
+				static_cast< double >( original_bytes ),
+			per_message( compress_started_at, compress_finished_at ),
+			per_message( compress_finished_at, decompress_finished_at ) )
+		<< std::endl;
+}
+
+int
+main( int argc, const char * argv[] )
+{
+	try
+	{
+		const std::size_t count =
+			1 < argc ? std::strtoul( argv[ 1 ], nullptr, 10 ) : 100000u;
+
+		const auto messages = make_messages( count );
+
+		std::cout << fmt::format( "{} messages", count ) << std::endl;
+
+		const auto params = rws::permessage_deflate_params_t{}
+			.compression_threshold( 0u );
+
+		run_case( "context takeover", messages, params );
+
+		run_case( "window bits 10", messages,
+			rws::permessage_deflate_params_t{ params }.server_max_window_bits( 10 ) );
+
+		run_case( "no context takeover", messages,
+			rws::permessage_deflate_params_t{ params }
+				.server_no_context_takeover( true ) );
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -13,15 +13,19 @@
 #include <restinio/asio_include.hpp>
 #include <restinio/settings.hpp>
 #include <restinio/http_headers.hpp>
+#include <restinio/http_header_view.hpp>
 #include <restinio/message_builders.hpp>
 #include <restinio/http_server.hpp>
 #include <restinio/http_server_run.hpp>
 #include <restinio/asio_timer_manager.hpp>
 #include <restinio/null_timer_manager.hpp>
+#include <restinio/timing_wheel_timer_manager.hpp>
 #include <restinio/null_logger.hpp>
 #include <restinio/ostream_logger.hpp>
+#include <restinio/async_logger.hpp>
 #include <restinio/uri_helpers.hpp>
 #include <restinio/cast_to.hpp>
 #include <restinio/value_or.hpp>
 
 #include <restinio/router/express.hpp>
+#include <restinio/router/radix.hpp>
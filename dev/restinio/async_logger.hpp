@@ -0,0 +1,514 @@
+/*
+	restinio
+*/
+
+/*!
+	Logger that writes messages on a background thread.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <string>
+#include <iostream>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <iterator>
+
+#include <restinio/impl/include_fmtlib.hpp>
+
+#include <restinio/os.hpp>
+#include <restinio/exception.hpp>
+
+namespace restinio
+{
+
+//
+// log_level_t
+//
+
+//! Level of a log message.
+/*!
+	@since v.0.6.2
+*/
+enum class log_level_t : int
+{
+	trace = 0,
+	info = 1,
+	warn = 2,
+	error = 3,
+	//! Turns logging off if used as a threshold.
+	off = 4
+};
+
+//
+// log_overflow_policy_t
+//
+
+//! What to do if the queue of a logger is full.
+/*!
+	@since v.0.6.2
+*/
+enum class log_overflow_policy_t
+{
+	//! Message is dropped and the count of dropped messages is increased.
+	drop,
+	//! Thread that logs a message waits for free space in the queue.
+	block
+};
+
+namespace impl
+{
+
+//
+// log_record_t
+//
+
+//! A message waiting to be written.
+struct log_record_t
+{
+	log_level_t m_level{ log_level_t::trace };
+	std::chrono::system_clock::time_point m_when;
+	std::string m_msg;
+};
+
+//
+// log_records_queue_t
+//
+
+//! Bounded lock-free queue for many producers and one consumer.
+/*!
+	Based on the bounded MPMC queue by Dmitry Vyukov. Each cell has
+	a sequence number that tells whether the cell is free for
+	the producer with a given position or ready for the consumer.
+
+	Capacity is rounded up to a power of two.
+
+	@since v.0.6.2
+*/
+class log_records_queue_t
+{
+	public:
+		explicit log_records_queue_t( std::size_t capacity )
+			:	m_mask{ round_up_capacity( capacity ) - 1u }
+			,	m_cells{ new cell_t[ m_mask + 1u ] }
+		{
+			for( std::size_t i = 0u; i <= m_mask; ++i )
+				m_cells[ i ].m_sequence.store( i, std::memory_order_relaxed );
+		}
+
+		log_records_queue_t( const log_records_queue_t & ) = delete;
+		log_records_queue_t & operator = ( const log_records_queue_t & ) = delete;
+
+		//! Try to push a record.
+		/*!
+			Returns false if the queue is full, the record is left intact
+			in that case.
+		*/
+		bool
+		try_push( log_record_t & record ) noexcept
+		{
+			auto pos = m_enqueue_pos.load( std::memory_order_relaxed );
+			cell_t * cell;
+
+			while( true )
+			{
+				cell = &m_cells[ pos & m_mask ];
+				const auto seq = cell->m_sequence.load( std::memory_order_acquire );
+				const auto diff =
+					static_cast< std::ptrdiff_t >( seq ) -
+					static_cast< std::ptrdiff_t >( pos );
+
+				if( 0 == diff )
+				{
+					if( m_enqueue_pos.compare_exchange_weak(
+							pos, pos + 1u, std::memory_order_relaxed ) )
+						break;
+				}
+				else if( diff < 0 )
+					return false;
+				else
+					pos = m_enqueue_pos.load( std::memory_order_relaxed );
+			}
+
+			cell->m_record = std::move( record );
+			cell->m_sequence.store( pos + 1u, std::memory_order_release );
+
+			return true;
+		}
+
+		//! Try to pop a record.
+		/*!
+			Must be called only by one thread.
+		*/
+		bool
+		try_pop( log_record_t & record ) noexcept
+		{
+			cell_t & cell = m_cells[ m_dequeue_pos & m_mask ];
+			const auto seq = cell.m_sequence.load( std::memory_order_acquire );
+
+			if( seq != m_dequeue_pos + 1u )
+				return false;
+
+			record = std::move( cell.m_record );
+			cell.m_sequence.store(
+				m_dequeue_pos + m_mask + 1u, std::memory_order_release );
+			++m_dequeue_pos;
+
+			return true;
+		}
+
+		//! Is there a record for the consumer?
+		/*!
+			Must be called only by the consumer thread.
+		*/
+		bool
+		has_records() const noexcept
+		{
+			const cell_t & cell = m_cells[ m_dequeue_pos & m_mask ];
+			return cell.m_sequence.load( std::memory_order_acquire ) ==
+				m_dequeue_pos + 1u;
+		}
+
+	private:
+		struct cell_t
+		{
+			std::atomic< std::size_t > m_sequence;
+			log_record_t m_record;
+		};
+
+		static std::size_t
+		round_up_capacity( std::size_t capacity )
+		{
+			std::size_t result = 2u;
+			while( result < capacity )
+				result <<= 1u;
+
+			return result;
+		}
+
+		const std::size_t m_mask;
+		std::unique_ptr< cell_t[] > m_cells;
+
+		//! Producers and the consumer work on different cache lines.
+		char m_padding1[ 64 ];
+		std::atomic< std::size_t > m_enqueue_pos{ 0u };
+		char m_padding2[ 64 ];
+		std::size_t m_dequeue_pos{ 0u };
+};
+
+} /* namespace impl */
+
+//
+// async_logger_t
+//
+
+//! Logger that writes messages to std::ostream on a background thread.
+/*!
+	A message builder is called only if the level of the message
+	passes both the compile-time threshold \a Min_Level and
+	the runtime threshold that can be changed by set_level().
+	Messages below \a Min_Level are stripped by the compiler
+	like with null_logger_t.
+
+	Built messages are moved to a lock-free queue, so threads
+	that log messages don't wait for a mutex or for I/O.
+	Timestamps and tags are formatted by the writer thread.
+	If the queue is full the message is either dropped or
+	the logging thread waits for free space, depending on
+	log_overflow_policy_t. The count of dropped messages is
+	written to the log when there is free space again.
+
+	All queued messages are written before the destructor returns.
+
+	Usage example:
+	\code
+	struct my_traits_t : public restinio::default_traits_t
+	{
+		using logger_t = restinio::async_logger_t< restinio::log_level_t::info >;
+	};
+
+	restinio::run(
+		restinio::on_thread_pool< my_traits_t >( 4 )
+			.logger( std::cerr, restinio::log_level_t::warn )
+			...
+	\endcode
+
+	@since v.0.6.2
+*/
+template < log_level_t Min_Level = log_level_t::trace >
+class async_logger_t
+{
+	public:
+		//! Default capacity of the queue.
+		static constexpr std::size_t default_queue_capacity = 8 * 1024;
+
+		async_logger_t( const async_logger_t & ) = delete;
+		async_logger_t & operator = ( const async_logger_t & ) = delete;
+
+		async_logger_t(
+			std::ostream & out = std::cout,
+			log_level_t level = Min_Level,
+			std::size_t queue_capacity = default_queue_capacity,
+			log_overflow_policy_t overflow_policy = log_overflow_policy_t::drop )
+			:	m_out{ &out }
+			,	m_level{ level }
+			,	m_overflow_policy{ overflow_policy }
+			,	m_queue{ queue_capacity }
+		{
+			m_writer = std::thread{ [this]{ writer_body(); } };
+		}
+
+		~async_logger_t()
+		{
+			{
+				std::lock_guard< std::mutex > lock{ m_wakeup_lock };
+				m_shutdown = true;
+			}
+			m_wakeup_cv.notify_one();
+			m_writer.join();
+		}
+
+		//! Set the runtime threshold.
+		void
+		set_level( log_level_t level ) noexcept
+		{
+			m_level.store( level, std::memory_order_relaxed );
+		}
+
+		//! Get the runtime threshold.
+		log_level_t
+		level() const noexcept
+		{
+			return m_level.load( std::memory_order_relaxed );
+		}
+
+		//! Get the count of messages dropped because the queue was full.
+		std::uint64_t
+		dropped_count() const noexcept
+		{
+			return m_total_dropped.load( std::memory_order_relaxed );
+		}
+
+		template< typename Message_Builder >
+		void
+		trace( Message_Builder && msg_builder )
+		{
+			log_if_enabled< log_level_t::trace >( msg_builder );
+		}
+
+		template< typename Message_Builder >
+		void
+		info( Message_Builder && msg_builder )
+		{
+			log_if_enabled< log_level_t::info >( msg_builder );
+		}
+
+		template< typename Message_Builder >
+		void
+		warn( Message_Builder && msg_builder )
+		{
+			log_if_enabled< log_level_t::warn >( msg_builder );
+		}
+
+		template< typename Message_Builder >
+		void
+		error( Message_Builder && msg_builder )
+		{
+			log_if_enabled< log_level_t::error >( msg_builder );
+		}
+
+	private:
+		template< log_level_t Level, typename Message_Builder >
+		void
+		log_if_enabled( Message_Builder & msg_builder )
+		{
+			if( static_cast< int >( Level ) >= static_cast< int >( Min_Level ) &&
+				static_cast< int >( Level ) >= static_cast< int >( level() ) )
+			{
+				push( Level, msg_builder() );
+			}
+		}
+
+		void
+		push( log_level_t level, std::string msg )
+		{
+			impl::log_record_t record{
+				level, std::chrono::system_clock::now(), std::move( msg ) };
+
+			while( !m_queue.try_push( record ) )
+			{
+				if( log_overflow_policy_t::drop == m_overflow_policy )
+				{
+					m_dropped.fetch_add( 1u, std::memory_order_relaxed );
+					m_total_dropped.fetch_add( 1u, std::memory_order_relaxed );
+					return;
+				}
+
+				wakeup_writer();
+				std::this_thread::yield();
+			}
+
+			wakeup_writer();
+		}
+
+		void
+		wakeup_writer()
+		{
+			// The record must be visible to the writer before the flag
+			// is checked, the pair for that fence is in writer_body().
+			std::atomic_thread_fence( std::memory_order_seq_cst );
+
+			// The mutex is touched only if the writer is going to sleep.
+			if( m_writer_sleeps.load( std::memory_order_relaxed ) )
+			{
+				std::lock_guard< std::mutex > lock{ m_wakeup_lock };
+				m_wakeup_cv.notify_one();
+			}
+		}
+
+		static const char *
+		tag( log_level_t level ) noexcept
+		{
+			switch( level )
+			{
+				case log_level_t::trace: return "TRACE";
+				case log_level_t::info: return " INFO";
+				case log_level_t::warn: return " WARN";
+				case log_level_t::error: return "ERROR";
+				case log_level_t::off: break;
+			}
+
+			return "?????";
+		}
+
+		void
+		format_record( const impl::log_record_t & record )
+		{
+			namespace stdchrono = std::chrono;
+
+			const auto ms = stdchrono::duration_cast< stdchrono::milliseconds >(
+					record.m_when.time_since_epoch() );
+			const std::time_t unix_time =
+					stdchrono::duration_cast< stdchrono::seconds >( ms ).count();
+
+			fmt::format_to(
+				std::back_inserter( m_buffer ),
+				"[{:%Y-%m-%d %H:%M:%S}.{:03d}] {}: {}\n",
+				make_localtime( unix_time ),
+				static_cast< int >( ms.count() % 1000u ),
+				tag( record.m_level ),
+				record.m_msg );
+		}
+
+		void
+		format_dropped()
+		{
+			const auto dropped = m_dropped.exchange( 0u, std::memory_order_relaxed );
+			if( 0u != dropped )
+			{
+				format_record( impl::log_record_t{
+					log_level_t::warn,
+					std::chrono::system_clock::now(),
+					fmt::format( "{} log messages dropped", dropped ) } );
+			}
+		}
+
+		//! Write formatted records and clear the buffer.
+		void
+		write_buffer()
+		{
+			if( !m_buffer.empty() )
+			{
+				m_out->write( m_buffer.data(),
+					static_cast< std::streamsize >( m_buffer.size() ) );
+				m_out->flush();
+				m_buffer.clear();
+			}
+		}
+
+		//! Write all the records that are in the queue.
+		/*!
+			Returns false if the queue was empty.
+		*/
+		bool
+		drain_queue()
+		{
+			bool has_records = false;
+			impl::log_record_t record;
+
+			while( m_queue.try_pop( record ) )
+			{
+				has_records = true;
+				format_record( record );
+
+				// Don't let the buffer grow too much.
+				if( m_buffer.size() >= 64 * 1024 )
+					write_buffer();
+			}
+
+			format_dropped();
+			write_buffer();
+
+			return has_records;
+		}
+
+		void
+		writer_body()
+		{
+			while( true )
+			{
+				if( drain_queue() )
+					continue;
+
+				std::unique_lock< std::mutex > lock{ m_wakeup_lock };
+				if( m_shutdown )
+					break;
+
+				m_writer_sleeps.store( true, std::memory_order_relaxed );
+
+				// Either a producer sees the flag and notifies under
+				// the lock or its record is seen here.
+				std::atomic_thread_fence( std::memory_order_seq_cst );
+
+				if( !m_queue.has_records() )
+				{
+					// Timeout is just a safety net.
+					m_wakeup_cv.wait_for( lock, std::chrono::milliseconds( 100 ) );
+				}
+
+				m_writer_sleeps.store( false, std::memory_order_relaxed );
+			}
+
+			// Producers must not log during the destruction but
+			// records that are already in the queue are written.
+			drain_queue();
+		}
+
+		std::ostream * m_out;
+		std::atomic< log_level_t > m_level;
+		const log_overflow_policy_t m_overflow_policy;
+
+		impl::log_records_queue_t m_queue;
+
+		//! Dropped messages that are not reported yet.
+		std::atomic< std::uint64_t > m_dropped{ 0u };
+		std::atomic< std::uint64_t > m_total_dropped{ 0u };
+
+		//! Buffer of the writer thread for formatting records.
+		std::string m_buffer;
+
+		std::atomic< bool > m_writer_sleeps{ false };
+		std::mutex m_wakeup_lock;
+		std::condition_variable m_wakeup_cv;
+		bool m_shutdown{ false };
+
+		std::thread m_writer;
+};
+
+} /* namespace restinio */
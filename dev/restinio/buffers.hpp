@@ -848,8 +848,9 @@ class write_group_t
 
 		//! Merges with another group.
 		/*!
-			Two groups can be merged if the first one has no after-write callback
-			and the second one has no status line size.
+			Two groups can be merged if the first one has no after-write callback.
+			The status line size of the second group is dropped, so
+			it has to be saved before the merge if it is needed.
 		*/
 		void
 		merge( write_group_t second )
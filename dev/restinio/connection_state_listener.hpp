@@ -13,6 +13,7 @@
 
 #include <restinio/compiler_features.hpp>
 #include <restinio/common_types.hpp>
+#include <restinio/incoming_http_msg_limits.hpp>
 #include <utility>
 #include <restinio/variant.hpp>
 #include <restinio/tls_fwd.hpp>
@@ -197,6 +198,31 @@ class upgraded_to_websocket_t final
 {
 };
 
+/*!
+ * @brief Type of object that tells that an incoming http message
+ * exceeds one of limits.
+ *
+ * The connection will be closed after sending the response
+ * with an appropriate status code.
+ *
+ * @since v.0.6.2
+ */
+class limit_exceeded_t final
+{
+	incoming_http_msg_limit_t m_limit;
+
+public:
+	explicit limit_exceeded_t(
+		incoming_http_msg_limit_t limit ) noexcept
+		:	m_limit{ limit }
+	{}
+
+	//! Get the kind of the exceeded limit.
+	RESTINIO_NODISCARD
+	incoming_http_msg_limit_t
+	limit() const noexcept { return m_limit; }
+};
+
 /*!
  * @brief A type for the representation of the current state of a connection.
  *
@@ -208,9 +234,16 @@ class upgraded_to_websocket_t final
  * be used (e.g. `restinio::holds_alternative`, `restinio::get`,
  * `restinio::get_if`, `restinio::visit`).
  *
+ * @note
+ * limit_exceeded_t is added in v.0.6.2.
+ *
  * @since v.0.6.0
  */
-using cause_t = variant_t< accepted_t, closed_t, upgraded_to_websocket_t >;
+using cause_t = variant_t<
+		accepted_t,
+		closed_t,
+		upgraded_to_websocket_t,
+		limit_exceeded_t >;
 
 /*!
  * @brief An object with info about connection to be passed to state listener.
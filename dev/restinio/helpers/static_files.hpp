@@ -0,0 +1,887 @@
+/*
+ * RESTinio
+ */
+
+/*!
+ * @file
+ * @brief Serving of static files with precompressed variants.
+ *
+ * @since v.0.6.2
+ */
+
+#pragma once
+
+#include <restinio/helpers/http_field_parsers/accept-encoding.hpp>
+#include <restinio/helpers/string_algo.hpp>
+
+#include <restinio/transforms/zlib.hpp>
+
+#include <restinio/request_handler.hpp>
+#include <restinio/sendfile.hpp>
+#include <restinio/hot_file_cache.hpp>
+#include <restinio/optional.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace restinio
+{
+
+namespace static_files
+{
+
+//
+// compression_executor_t
+//
+/*!
+ * @brief Type of executor for compression of variants.
+ *
+ * It receives a job that should be executed on some other thread.
+ *
+ * @since v.0.6.2
+ */
+using compression_executor_t = std::function< void( std::function< void() > ) >;
+
+//
+// settings_t
+//
+/*!
+ * @brief Settings for static files cache.
+ *
+ * @since v.0.6.2
+ */
+class settings_t
+{
+	public:
+		//! Directory with files to be served.
+		//! \{
+		settings_t &
+		root_dir( std::string v ) &
+		{
+			m_root_dir = std::move( v );
+			return *this;
+		}
+
+		settings_t &&
+		root_dir( std::string v ) &&
+		{
+			return std::move( this->root_dir( std::move( v ) ) );
+		}
+
+		const std::string &
+		root_dir() const noexcept { return m_root_dir; }
+		//! \}
+
+		//! Directory for variants compressed on the first request.
+		/*!
+		 * If it is empty (the default) then files are not compressed
+		 * by RESTinio and only `.gz` siblings are used.
+		 *
+		 * A variant is compressed in the background, the original file
+		 * is sent until the variant is ready.
+		 */
+		//! \{
+		settings_t &
+		variants_dir( std::string v ) &
+		{
+			m_variants_dir = std::move( v );
+			return *this;
+		}
+
+		settings_t &&
+		variants_dir( std::string v ) &&
+		{
+			return std::move( this->variants_dir( std::move( v ) ) );
+		}
+
+		const std::string &
+		variants_dir() const noexcept { return m_variants_dir; }
+		//! \}
+
+		//! Use `file.gz` as a compressed variant of `file` if it exists.
+		//! \{
+		settings_t &
+		use_gz_siblings( bool v ) & noexcept
+		{
+			m_use_gz_siblings = v;
+			return *this;
+		}
+
+		settings_t &&
+		use_gz_siblings( bool v ) && noexcept
+		{
+			return std::move( this->use_gz_siblings( v ) );
+		}
+
+		bool
+		use_gz_siblings() const noexcept { return m_use_gz_siblings; }
+		//! \}
+
+		//! Files smaller than that are not compressed.
+		//! \{
+		settings_t &
+		min_size_to_compress( file_size_t v ) & noexcept
+		{
+			m_min_size_to_compress = v;
+			return *this;
+		}
+
+		settings_t &&
+		min_size_to_compress( file_size_t v ) && noexcept
+		{
+			return std::move( this->min_size_to_compress( v ) );
+		}
+
+		file_size_t
+		min_size_to_compress() const noexcept { return m_min_size_to_compress; }
+		//! \}
+
+		//! Compression level for variants compressed on the first request.
+		//! \{
+		settings_t &
+		compression_level( int v ) & noexcept
+		{
+			m_compression_level = v;
+			return *this;
+		}
+
+		settings_t &&
+		compression_level( int v ) && noexcept
+		{
+			return std::move( this->compression_level( v ) );
+		}
+
+		int
+		compression_level() const noexcept { return m_compression_level; }
+		//! \}
+
+		//! Executor for compression of variants.
+		/*!
+		 * If it isn't set then files are compressed one by one
+		 * on a worker thread owned by cache_t. The worker is stopped
+		 * and joined when cache_t is destroyed.
+		 */
+		//! \{
+		settings_t &
+		compression_executor( compression_executor_t v ) &
+		{
+			m_compression_executor = std::move( v );
+			return *this;
+		}
+
+		settings_t &&
+		compression_executor( compression_executor_t v ) &&
+		{
+			return std::move( this->compression_executor( std::move( v ) ) );
+		}
+
+		const compression_executor_t &
+		compression_executor() const noexcept { return m_compression_executor; }
+		//! \}
+
+		//! Cache for keeping small files in memory.
+		/*!
+		 * If it is set then files (and their compressed variants)
+		 * that are in the cache are sent from memory instead of sendfile_t.
+		 */
+		//! \{
+		settings_t &
+		hot_file_cache( std::shared_ptr< hot_file_cache_t > v ) &
+		{
+			m_hot_file_cache = std::move( v );
+			return *this;
+		}
+
+		settings_t &&
+		hot_file_cache( std::shared_ptr< hot_file_cache_t > v ) &&
+		{
+			return std::move( this->hot_file_cache( std::move( v ) ) );
+		}
+
+		const std::shared_ptr< hot_file_cache_t > &
+		hot_file_cache() const noexcept { return m_hot_file_cache; }
+		//! \}
+
+	private:
+		std::string m_root_dir{ "." };
+		std::string m_variants_dir;
+		bool m_use_gz_siblings{ true };
+		file_size_t m_min_size_to_compress{ 1024 };
+		int m_compression_level{ 9 };
+		compression_executor_t m_compression_executor;
+		std::shared_ptr< hot_file_cache_t > m_hot_file_cache;
+};
+
+//
+// content_type_by_extension()
+//
+/*!
+ * @brief Get Content-Type for a file by its extension.
+ *
+ * Only a small set of types usual for static assets is known,
+ * `application/octet-stream` is returned for all other files.
+ *
+ * @since v.0.6.2
+ */
+inline string_view_t
+content_type_by_extension( string_view_t path ) noexcept
+{
+	using restinio::string_algo::ends_with;
+
+	struct known_type_t
+	{
+		string_view_t m_ext;
+		string_view_t m_type;
+	};
+
+	static const known_type_t known_types[] = {
+		{ ".html", "text/html; charset=utf-8" },
+		{ ".htm", "text/html; charset=utf-8" },
+		{ ".css", "text/css; charset=utf-8" },
+		{ ".js", "application/javascript; charset=utf-8" },
+		{ ".mjs", "application/javascript; charset=utf-8" },
+		{ ".json", "application/json" },
+		{ ".map", "application/json" },
+		{ ".txt", "text/plain; charset=utf-8" },
+		{ ".xml", "application/xml" },
+		{ ".svg", "image/svg+xml" },
+		{ ".wasm", "application/wasm" },
+		{ ".ico", "image/x-icon" },
+		{ ".png", "image/png" },
+		{ ".jpg", "image/jpeg" },
+		{ ".jpeg", "image/jpeg" },
+		{ ".gif", "image/gif" },
+		{ ".webp", "image/webp" },
+		{ ".woff", "font/woff" },
+		{ ".woff2", "font/woff2" }
+	};
+
+	for( const auto & t : known_types )
+		if( ends_with( path, t.m_ext ) )
+			return t.m_type;
+
+	return "application/octet-stream";
+}
+
+namespace impl
+{
+
+//! Is it worth to compress a file of that type?
+inline bool
+is_compressible( string_view_t content_type ) noexcept
+{
+	using restinio::string_algo::starts_with;
+
+	return starts_with( content_type, "text/" ) ||
+		starts_with( content_type, "application/javascript" ) ||
+		starts_with( content_type, "application/json" ) ||
+		starts_with( content_type, "application/xml" ) ||
+		starts_with( content_type, "application/wasm" ) ||
+		starts_with( content_type, "image/svg+xml" ) ||
+		starts_with( content_type, "image/x-icon" );
+}
+
+//! Check that a relative path doesn't go outside of the root dir.
+inline bool
+is_safe_path( string_view_t path ) noexcept
+{
+	if( path.empty() )
+		return false;
+
+	std::size_t segment_start = 0u;
+	for( std::size_t i = 0u; i <= path.size(); ++i )
+	{
+		if( i == path.size() || '/' == path[ i ] || '\\' == path[ i ] )
+		{
+			if( path.substr( segment_start, i - segment_start ) == ".." )
+				return false;
+			segment_start = i + 1u;
+		}
+		else if( '\0' == path[ i ] )
+			return false;
+	}
+
+	return true;
+}
+
+//! Does the client accept gzip content-coding?
+inline bool
+accepts_gzip( const http_request_header_t & header )
+{
+	using http_field_parsers::accept_encoding_value_t;
+
+	const auto field = header.try_get_field( http_field::accept_encoding );
+	if( !field )
+		return false;
+
+	const auto parse_result = accept_encoding_value_t::try_parse( *field );
+	if( !parse_result )
+		return false;
+
+	optional_t< bool > any_accepted;
+	for( const auto & item : parse_result->codings )
+	{
+		const bool accepted = http_field_parsers::qvalue_t::zero != item.weight;
+
+		if( "gzip" == item.content_coding || "x-gzip" == item.content_coding )
+			return accepted;
+		else if( "*" == item.content_coding )
+			any_accepted = accepted;
+	}
+
+	return any_accepted && *any_accepted;
+}
+
+//! Check an entity-tag against If-None-Match value.
+/*!
+ * The weak comparison is used as required by RFC7232.
+ */
+inline bool
+if_none_match( string_view_t field, string_view_t etag ) noexcept
+{
+	std::size_t pos = 0u;
+	while( pos < field.size() )
+	{
+		auto end = field.find( ',', pos );
+		if( string_view_t::npos == end )
+			end = field.size();
+
+		auto item = field.substr( pos, end - pos );
+		while( !item.empty() && ( ' ' == item.front() || '\t' == item.front() ) )
+			item.remove_prefix( 1u );
+		while( !item.empty() && ( ' ' == item.back() || '\t' == item.back() ) )
+			item.remove_suffix( 1u );
+		if( restinio::string_algo::starts_with( item, "W/" ) )
+			item.remove_prefix( 2u );
+
+		if( "*" == item || etag == item )
+			return true;
+
+		pos = end + 1u;
+	}
+
+	return false;
+}
+
+//! Compressed variant of a file.
+struct entry_t
+{
+	//! Meta of the original file the variant was made for.
+	file_meta_t m_meta;
+	//! Path to gzip variant. Empty if there is no such variant.
+	std::string m_gzip_path;
+	//! Was the variant compressed by cache_t.
+	bool m_generated{ false };
+	//! Is the variant being compressed now.
+	bool m_pending{ false };
+};
+
+//
+// compression_worker_t
+//
+//! A worker thread for compression if an executor isn't set.
+/*!
+ * The thread is started on the first job. Jobs that haven't been
+ * started yet are discarded on destruction and the thread is joined.
+ */
+class compression_worker_t
+{
+	public:
+		compression_worker_t() = default;
+
+		compression_worker_t( const compression_worker_t & ) = delete;
+		compression_worker_t & operator = ( const compression_worker_t & ) = delete;
+
+		~compression_worker_t()
+		{
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+				m_shutdown = true;
+			}
+			m_wakeup.notify_one();
+
+			if( m_thread.joinable() )
+				m_thread.join();
+		}
+
+		void
+		push( std::function< void() > job )
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			if( !m_thread.joinable() )
+				m_thread = std::thread{ [this]{ body(); } };
+
+			m_jobs.push_back( std::move( job ) );
+			m_wakeup.notify_one();
+		}
+
+	private:
+		void
+		body()
+		{
+			std::unique_lock< std::mutex > lock{ m_lock };
+			while( true )
+			{
+				m_wakeup.wait( lock, [this]{ return m_shutdown || !m_jobs.empty(); } );
+				if( m_shutdown )
+					return;
+
+				auto job = std::move( m_jobs.front() );
+				m_jobs.pop_front();
+
+				lock.unlock();
+				try
+				{
+					job();
+				}
+				catch( ... )
+				{}
+				lock.lock();
+			}
+		}
+
+		std::mutex m_lock;
+		std::condition_variable m_wakeup;
+		std::deque< std::function< void() > > m_jobs;
+		bool m_shutdown{ false };
+		std::thread m_thread;
+};
+
+} /* namespace impl */
+
+//
+// cache_t
+//
+/*!
+ * @brief Serving of static files with a cache of compressed variants.
+ *
+ * A gzip variant of a file is either a `.gz` sibling of it or
+ * a file compressed after the first request and stored in
+ * settings_t::variants_dir(). Compression is done on
+ * settings_t::compression_executor() (or on a worker thread of cache_t
+ * if there is no executor) and the original file is sent
+ * until the variant is ready. Variants are kept by a path to a file
+ * and are recreated if modification time or size of the file changes.
+ *
+ * The variant is chosen by the value of Accept-Encoding field.
+ * ETag and Last-Modified fields are set for every response and
+ * conditional requests with If-None-Match or If-Modified-Since
+ * are answered with 304. If-Modified-Since is compared
+ * with the exact value of Last-Modified field.
+ *
+ * The chosen variant is sent with sendfile_t or from
+ * hot_file_cache_t if it is set in settings.
+ *
+ * Usage example:
+ * \code
+ * auto files = std::make_shared< restinio::static_files::cache_t >(
+ *   restinio::static_files::settings_t{}
+ *     .root_dir( "/var/www/assets" )
+ *     .variants_dir( "/var/cache/myapp" ) );
+ *
+ * router->http_get( R"(/assets/:path(.*))",
+ *   [files]( auto req, auto params ) {
+ *     return files->serve( req, params[ "path" ] );
+ *   } );
+ * \endcode
+ *
+ * This class is thread safe.
+ *
+ * @since v.0.6.2
+ */
+class cache_t
+{
+	public:
+		explicit cache_t( settings_t settings )
+			:	m_state{ std::make_shared< state_t >( std::move( settings ) ) }
+		{}
+
+		cache_t( const cache_t & ) = delete;
+		cache_t & operator = ( const cache_t & ) = delete;
+
+		//! Send a file by its path relative to the root dir.
+		/*!
+		 * Responds with 404 if there is no such file or
+		 * the path refers to a directory.
+		 */
+		request_handling_status_t
+		serve( const request_handle_t & req, string_view_t path )
+		{
+			while( !path.empty() && '/' == path.front() )
+				path.remove_prefix( 1u );
+
+			if( !impl::is_safe_path( path ) )
+				return not_found( req );
+
+			const std::string file_path =
+				m_state->m_settings.root_dir() + "/" + std::string{ path.data(), path.size() };
+
+			if( !is_regular_file( file_path.c_str() ) )
+				return not_found( req );
+
+			body_t body;
+			try
+			{
+				body = open_body( file_path );
+			}
+			catch( const std::exception & )
+			{
+				return not_found( req );
+			}
+
+			const auto meta = body.meta();
+			const auto content_type = content_type_by_extension( path );
+
+			bool is_gzip = false;
+			if( impl::accepts_gzip( req->header() ) )
+			{
+				const auto gzip_path = gzip_variant( file_path, meta, content_type );
+				if( !gzip_path.empty() )
+				{
+					try
+					{
+						body = open_body( gzip_path );
+						is_gzip = true;
+					}
+					catch( const std::exception & )
+					{
+						// The variant was removed, the original file is sent.
+					}
+				}
+			}
+
+			const auto etag = make_etag( meta, is_gzip );
+			const auto last_modified = make_date_field_value( meta.last_modified_at() );
+
+			if( is_not_modified( req->header(), etag, last_modified ) )
+			{
+				return req->create_response( status_not_modified() )
+					.append_header( http_field::etag, etag )
+					.append_header( http_field::last_modified, last_modified )
+					.append_header( http_field::vary, "Accept-Encoding" )
+					.done();
+			}
+
+			auto resp = req->create_response();
+			resp
+				.append_header( http_field::content_type,
+					std::string{ content_type.data(), content_type.size() } )
+				.append_header( http_field::etag, etag )
+				.append_header( http_field::last_modified, last_modified )
+				.append_header( http_field::vary, "Accept-Encoding" );
+
+			if( is_gzip )
+				resp.append_header( http_field::content_encoding, "gzip" );
+
+			return resp.set_body( body.take_writable_item() ).done();
+		}
+
+	private:
+		//! Data shared with compression jobs.
+		struct state_t
+		{
+			explicit state_t( settings_t settings )
+				:	m_settings{ std::move( settings ) }
+			{}
+
+			const settings_t m_settings;
+
+			std::mutex m_lock;
+			std::map< std::string, impl::entry_t > m_entries;
+
+			std::atomic< unsigned > m_tmp_counter{ 0u };
+		};
+
+		//! Content of a file either in hot_file_cache_t or on disk.
+		struct body_t
+		{
+			optional_t< sendfile_t > m_sf;
+			hot_file_cache_t::file_handle_t m_cached;
+
+			file_meta_t
+			meta() const
+			{
+				return m_cached ? m_cached->meta() : m_sf->meta();
+			}
+
+			writable_item_t
+			take_writable_item()
+			{
+				if( m_cached )
+					return writable_item_t{ std::move( m_cached ) };
+
+				return writable_item_t{ std::move( *m_sf ) };
+			}
+		};
+
+		//! Get content of a file, throws if the file can't be opened.
+		body_t
+		open_body( const std::string & file_path )
+		{
+			body_t result;
+
+			if( m_state->m_settings.hot_file_cache() )
+				result.m_cached = m_state->m_settings.hot_file_cache()->get( file_path );
+
+			if( !result.m_cached )
+				result.m_sf = sendfile( file_path );
+
+			return result;
+		}
+
+		static request_handling_status_t
+		not_found( const request_handle_t & req )
+		{
+			return req->create_response( status_not_found() ).done();
+		}
+
+		static std::string
+		make_etag( const file_meta_t & meta, bool is_gzip )
+		{
+			const auto mtime = std::chrono::duration_cast< std::chrono::microseconds >(
+					meta.last_modified_at().time_since_epoch() ).count();
+
+			return fmt::format( "\"{:x}-{:x}{}\"",
+				mtime, meta.file_total_size(), is_gzip ? "-gz" : "" );
+		}
+
+		static bool
+		is_not_modified(
+			const http_request_header_t & header,
+			string_view_t etag,
+			string_view_t last_modified )
+		{
+			// If-Modified-Since is ignored if If-None-Match is present.
+			if( const auto inm = header.try_get_field( http_field::if_none_match ) )
+				return impl::if_none_match( *inm, etag );
+
+			if( const auto ims = header.try_get_field( http_field::if_modified_since ) )
+				return last_modified == *ims;
+
+			return false;
+		}
+
+		static bool
+		same_meta( const file_meta_t & a, const file_meta_t & b ) noexcept
+		{
+			return a.file_total_size() == b.file_total_size() &&
+				a.last_modified_at() == b.last_modified_at();
+		}
+
+		//! Get path to gzip variant of a file or empty string.
+		/*!
+		 * An empty string is also returned while the variant
+		 * is being compressed.
+		 */
+		std::string
+		gzip_variant(
+			const std::string & file_path,
+			const file_meta_t & meta,
+			string_view_t content_type )
+		{
+			{
+				std::lock_guard< std::mutex > lock{ m_state->m_lock };
+				const auto it = m_state->m_entries.find( file_path );
+				if( it != m_state->m_entries.end() && same_meta( it->second.m_meta, meta ) )
+					return it->second.m_gzip_path;
+			}
+
+			// Siblings are looked for without the lock.
+			auto entry = make_entry( file_path, meta, content_type );
+			const bool need_compression = entry.m_pending;
+			auto result = entry.m_gzip_path;
+
+			{
+				std::lock_guard< std::mutex > lock{ m_state->m_lock };
+				const auto it = m_state->m_entries.find( file_path );
+				if( it == m_state->m_entries.end() )
+					m_state->m_entries.emplace( file_path, std::move( entry ) );
+				else if( same_meta( it->second.m_meta, meta ) )
+					// Another thread has made the entry meanwhile.
+					return it->second.m_gzip_path;
+				else
+				{
+					if( it->second.m_generated )
+						std::remove( it->second.m_gzip_path.c_str() );
+					it->second = std::move( entry );
+				}
+			}
+
+			if( need_compression )
+				start_compression( file_path, meta );
+
+			return result;
+		}
+
+		impl::entry_t
+		make_entry(
+			const std::string & file_path,
+			const file_meta_t & meta,
+			string_view_t content_type )
+		{
+			impl::entry_t entry;
+			entry.m_meta = meta;
+
+			if( m_state->m_settings.use_gz_siblings() )
+			{
+				const auto gz_path = file_path + ".gz";
+				try
+				{
+					if( is_regular_file( gz_path.c_str() ) )
+					{
+						file_descriptor_holder_t fd{ open_file( gz_path.c_str() ) };
+						const auto gz_meta = get_file_meta< file_meta_t >( fd.fd() );
+
+						// Outdated sibling is ignored.
+						if( gz_meta.last_modified_at() >= meta.last_modified_at() )
+						{
+							entry.m_gzip_path = gz_path;
+							return entry;
+						}
+					}
+				}
+				catch( const std::exception & )
+				{}
+			}
+
+			entry.m_pending =
+				!m_state->m_settings.variants_dir().empty() &&
+				m_state->m_settings.min_size_to_compress() <= meta.file_total_size() &&
+				impl::is_compressible( content_type );
+
+			return entry;
+		}
+
+		//! Pass compression of a file to the executor.
+		void
+		start_compression( const std::string & file_path, const file_meta_t & meta )
+		{
+			std::function< void() > job =
+				[state = m_state, file_path, meta] {
+					std::string gzip_path;
+					try
+					{
+						gzip_path = compress_file( *state, file_path, meta );
+					}
+					catch( const std::exception & )
+					{
+						// The original file is sent.
+					}
+
+					complete_compression( *state, file_path, meta, std::move( gzip_path ) );
+				};
+
+			try
+			{
+				const auto & executor = m_state->m_settings.compression_executor();
+				if( executor )
+					executor( std::move( job ) );
+				else
+					m_worker.push( std::move( job ) );
+			}
+			catch( const std::exception & )
+			{
+				// The entry is removed for compression to be tried again
+				// on the next request.
+				std::lock_guard< std::mutex > lock{ m_state->m_lock };
+				const auto it = m_state->m_entries.find( file_path );
+				if( it != m_state->m_entries.end() && it->second.m_pending )
+					m_state->m_entries.erase( it );
+			}
+		}
+
+		//! Store the result of compression if it is still actual.
+		static void
+		complete_compression(
+			state_t & state,
+			const std::string & file_path,
+			const file_meta_t & meta,
+			std::string gzip_path )
+		{
+			std::lock_guard< std::mutex > lock{ state.m_lock };
+			const auto it = state.m_entries.find( file_path );
+			if( it != state.m_entries.end() && it->second.m_pending &&
+				same_meta( it->second.m_meta, meta ) )
+			{
+				it->second.m_gzip_path = std::move( gzip_path );
+				it->second.m_generated = !it->second.m_gzip_path.empty();
+				it->second.m_pending = false;
+			}
+			else if( !gzip_path.empty() )
+				// The file was modified while it was being compressed.
+				std::remove( gzip_path.c_str() );
+		}
+
+		//! Compress a file to the variants dir.
+		/*!
+		 * Returns an empty string if compression gives no gain.
+		 */
+		static std::string
+		compress_file(
+			state_t & state,
+			const std::string & file_path,
+			const file_meta_t & meta )
+		{
+			std::string content;
+			{
+				std::ifstream in{ file_path, std::ios::binary };
+				std::ostringstream buf;
+				buf << in.rdbuf();
+				if( !in )
+					throw exception_t{ fmt::format( "unable to read '{}'", file_path ) };
+				content = buf.str();
+			}
+
+			const auto compressed = transforms::zlib::gzip_compress(
+				content, state.m_settings.compression_level() );
+			if( compressed.size() >= content.size() )
+				return std::string{};
+
+			const auto mtime = std::chrono::duration_cast< std::chrono::microseconds >(
+					meta.last_modified_at().time_since_epoch() ).count();
+			const auto variant_path = fmt::format( "{}/{:x}-{:x}-{:x}.gz",
+				state.m_settings.variants_dir(),
+				std::hash< std::string >{}( file_path ),
+				mtime,
+				meta.file_total_size() );
+			const auto tmp_path = fmt::format( "{}.{}.tmp",
+				variant_path, ++state.m_tmp_counter );
+
+			{
+				std::ofstream out{ tmp_path, std::ios::binary | std::ios::trunc };
+				out.write( compressed.data(),
+					static_cast< std::streamsize >( compressed.size() ) );
+				if( !out )
+				{
+					std::remove( tmp_path.c_str() );
+					throw exception_t{ fmt::format( "unable to write '{}'", tmp_path ) };
+				}
+			}
+
+			std::remove( variant_path.c_str() );
+			if( 0 != std::rename( tmp_path.c_str(), variant_path.c_str() ) )
+			{
+				std::remove( tmp_path.c_str() );
+				throw exception_t{ fmt::format( "unable to create '{}'", variant_path ) };
+			}
+
+			return variant_path;
+		}
+
+		std::shared_ptr< state_t > m_state;
+
+		//! Worker for compression if there is no executor in settings.
+		impl::compression_worker_t m_worker;
+};
+
+} /* namespace static_files */
+
+} /* namespace restinio */
@@ -0,0 +1,477 @@
+/*
+	restinio
+*/
+
+/*!
+	In-memory cache of hot files.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/sendfile.hpp>
+#include <restinio/optional.hpp>
+
+#include <chrono>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace restinio
+{
+
+//
+// cached_file_t
+//
+
+//! Immutable content of a file kept in hot_file_cache_t.
+/*!
+	Can be used as a response body via std::shared_ptr, so the data
+	is sent without copying and without file operations:
+	\code
+	resp.set_body( cache.get( path ) );
+	\endcode
+
+	@since v.0.6.2
+*/
+class cached_file_t
+{
+	public:
+		cached_file_t( std::string content, file_meta_t meta )
+			:	m_content{ std::move( content ) }
+			,	m_meta{ meta }
+		{}
+
+		const char * data() const noexcept { return m_content.data(); }
+
+		std::size_t size() const noexcept { return m_content.size(); }
+
+		//! Meta of the file at the moment it was loaded.
+		const file_meta_t & meta() const noexcept { return m_meta; }
+
+	private:
+		const std::string m_content;
+		const file_meta_t m_meta;
+};
+
+//
+// hot_file_cache_params_t
+//
+
+//! Parameters of hot_file_cache_t.
+/*!
+	@since v.0.6.2
+*/
+class hot_file_cache_params_t
+{
+	public:
+		//! Files bigger than that are not cached.
+		//! \{
+		hot_file_cache_params_t &
+		max_file_size( std::size_t v ) & noexcept
+		{
+			m_max_file_size = v;
+			return *this;
+		}
+
+		hot_file_cache_params_t &&
+		max_file_size( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_file_size( v ) );
+		}
+
+		std::size_t
+		max_file_size() const noexcept { return m_max_file_size; }
+		//! \}
+
+		//! Max total size of cached files.
+		//! \{
+		hot_file_cache_params_t &
+		max_total_size( std::size_t v ) & noexcept
+		{
+			m_max_total_size = v;
+			return *this;
+		}
+
+		hot_file_cache_params_t &&
+		max_total_size( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_total_size( v ) );
+		}
+
+		std::size_t
+		max_total_size() const noexcept { return m_max_total_size; }
+		//! \}
+
+		//! How often a cached file is checked for modification.
+		/*!
+			Zero means that a file is checked on every access.
+		*/
+		//! \{
+		hot_file_cache_params_t &
+		revalidate_interval( std::chrono::steady_clock::duration v ) & noexcept
+		{
+			m_revalidate_interval = v;
+			return *this;
+		}
+
+		hot_file_cache_params_t &&
+		revalidate_interval( std::chrono::steady_clock::duration v ) && noexcept
+		{
+			return std::move( this->revalidate_interval( v ) );
+		}
+
+		std::chrono::steady_clock::duration
+		revalidate_interval() const noexcept { return m_revalidate_interval; }
+		//! \}
+
+	private:
+		std::size_t m_max_file_size{ 1024 * 1024 };
+		std::size_t m_max_total_size{ 64 * 1024 * 1024 };
+		std::chrono::steady_clock::duration m_revalidate_interval{
+			std::chrono::seconds( 1 ) };
+};
+
+//
+// hot_file_cache_stats_t
+//
+
+//! Counters of hot_file_cache_t.
+/*!
+	@since v.0.6.2
+*/
+struct hot_file_cache_stats_t
+{
+	std::uint64_t m_hits{ 0 };
+	std::uint64_t m_misses{ 0 };
+	//! Files removed to free space for other files.
+	std::uint64_t m_evictions{ 0 };
+	//! Files reloaded because they were modified.
+	std::uint64_t m_invalidations{ 0 };
+	std::size_t m_files_count{ 0 };
+	std::size_t m_total_size{ 0 };
+};
+
+//
+// hot_file_cache_t
+//
+
+//! Shared cache of small and medium files kept in memory.
+/*!
+	Content of a file is loaded on the first access and is shared
+	by all responses that send it. Files that exceed
+	hot_file_cache_params_t::max_file_size() are not cached,
+	only their meta is kept so they are not opened again until
+	the next revalidation.
+	If the total size of cached files exceeds
+	hot_file_cache_params_t::max_total_size() the least recently
+	used files are removed from the cache.
+
+	Modification time and size of a cached file are checked not
+	more often than hot_file_cache_params_t::revalidate_interval().
+	If the file is changed it is loaded again. Responses that are
+	already sending the old content keep it until they are done.
+
+	It is most useful for TLS connections where the content of
+	sendfile_t is read to a buffer for every chunk.
+
+	Usage example:
+	\code
+	auto cache = std::make_shared< restinio::hot_file_cache_t >(
+		restinio::hot_file_cache_params_t{}.max_total_size( 256 * 1024 * 1024 ) );
+	...
+	[cache]( auto req ) {
+		auto resp = req->create_response();
+		if( auto file = cache->get( path ) )
+			resp.set_body( std::move( file ) );
+		else
+			resp.set_body( restinio::sendfile( path ) );
+		return resp.done();
+	}
+	\endcode
+
+	This class is thread safe.
+
+	@since v.0.6.2
+*/
+class hot_file_cache_t
+{
+	public:
+		using file_handle_t = std::shared_ptr< const cached_file_t >;
+
+		explicit hot_file_cache_t(
+			hot_file_cache_params_t params = hot_file_cache_params_t{} )
+			:	m_params{ params }
+		{}
+
+		hot_file_cache_t( const hot_file_cache_t & ) = delete;
+		hot_file_cache_t & operator = ( const hot_file_cache_t & ) = delete;
+
+		//! Get the content of a file.
+		/*!
+			Returns nullptr if the file can't be opened or is too big
+			to be cached.
+		*/
+		file_handle_t
+		get( const std::string & path )
+		{
+			const auto now = std::chrono::steady_clock::now();
+
+			optional_t< file_meta_t > cached_meta;
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+
+				const auto it = m_entries.find( path );
+				if( it != m_entries.end() )
+				{
+					auto & entry = it->second;
+					if( now < entry.m_check_after )
+					{
+						touch( entry );
+						return entry.m_file;
+					}
+
+					cached_meta = entry.m_meta;
+				}
+			}
+
+			return cached_meta ?
+				revalidate( path, *cached_meta, now ) : load( path, now );
+		}
+
+		//! Remove all files from the cache.
+		void
+		clear()
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			m_entries.clear();
+			m_lru.clear();
+			m_stats.m_total_size = 0u;
+			m_stats.m_files_count = 0u;
+		}
+
+		hot_file_cache_stats_t
+		stats() const
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			return m_stats;
+		}
+
+	private:
+		struct entry_t
+		{
+			//! Meta of the file at the moment it was checked.
+			file_meta_t m_meta;
+			//! Content of the file, nullptr if it is too big to be cached.
+			file_handle_t m_file;
+			std::chrono::steady_clock::time_point m_check_after;
+			//! Position in m_lru, files without content are not there.
+			std::list< std::string >::iterator m_lru_pos;
+		};
+
+		using entries_map_t = std::unordered_map< std::string, entry_t >;
+
+		static bool
+		same_meta( const file_meta_t & a, const file_meta_t & b ) noexcept
+		{
+			return a.file_total_size() == b.file_total_size() &&
+				a.last_modified_at() == b.last_modified_at();
+		}
+
+		//! Count an access to a file that is in the cache.
+		/*!
+			Must be called under the lock.
+		*/
+		void
+		touch( entry_t & entry ) noexcept
+		{
+			if( entry.m_file )
+			{
+				++m_stats.m_hits;
+				m_lru.splice( m_lru.end(), m_lru, entry.m_lru_pos );
+			}
+			else
+				++m_stats.m_misses;
+		}
+
+		//! Check if a cached file was modified.
+		file_handle_t
+		revalidate(
+			const std::string & path,
+			const file_meta_t & cached_meta,
+			std::chrono::steady_clock::time_point now )
+		{
+			file_descriptor_holder_t fd{ null_file_descriptor() };
+			file_meta_t meta;
+			try
+			{
+				fd = file_descriptor_holder_t{ open_file( path.c_str() ) };
+				meta = get_file_meta< file_meta_t >( fd.fd() );
+			}
+			catch( const std::exception & )
+			{
+				remove( path );
+				return file_handle_t{};
+			}
+
+			if( same_meta( meta, cached_meta ) )
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+
+				const auto it = m_entries.find( path );
+				if( it != m_entries.end() && same_meta( it->second.m_meta, meta ) )
+				{
+					touch( it->second );
+					it->second.m_check_after = now + m_params.revalidate_interval();
+
+					return it->second.m_file;
+				}
+			}
+			else
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+				++m_stats.m_invalidations;
+			}
+
+			return load( path, fd.fd(), meta, now );
+		}
+
+		//! Open a file and put it to the cache.
+		file_handle_t
+		load( const std::string & path, std::chrono::steady_clock::time_point now )
+		{
+			file_descriptor_holder_t fd{ null_file_descriptor() };
+			file_meta_t meta;
+			try
+			{
+				fd = file_descriptor_holder_t{ open_file( path.c_str() ) };
+				meta = get_file_meta< file_meta_t >( fd.fd() );
+			}
+			catch( const std::exception & )
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+				++m_stats.m_misses;
+				return file_handle_t{};
+			}
+
+			return load( path, fd.fd(), meta, now );
+		}
+
+		//! Read an opened file and put it to the cache.
+		/*!
+			Files that are too big are put to the cache without content.
+		*/
+		file_handle_t
+		load(
+			const std::string & path,
+			file_descriptor_t fd,
+			const file_meta_t & meta,
+			std::chrono::steady_clock::time_point now )
+		{
+			file_handle_t file;
+			try
+			{
+				file = read_file( fd, meta );
+			}
+			catch( const std::exception & )
+			{
+				remove( path );
+
+				std::lock_guard< std::mutex > lock{ m_lock };
+				++m_stats.m_misses;
+				return file;
+			}
+
+			std::lock_guard< std::mutex > lock{ m_lock };
+			++m_stats.m_misses;
+
+			// Another thread could load the file at the same time.
+			const auto it = m_entries.find( path );
+			if( it != m_entries.end() )
+				erase( it );
+
+			const std::size_t size = file ? file->size() : 0u;
+			while( !m_lru.empty() &&
+				m_params.max_total_size() - size < m_stats.m_total_size )
+			{
+				erase( m_entries.find( m_lru.front() ) );
+				++m_stats.m_evictions;
+			}
+
+			auto lru_pos = m_lru.end();
+			if( file )
+			{
+				lru_pos = m_lru.insert( m_lru.end(), path );
+				m_stats.m_total_size += size;
+				++m_stats.m_files_count;
+			}
+
+			m_entries.emplace( path,
+				entry_t{ meta, file, now + m_params.revalidate_interval(), lru_pos } );
+
+			return file;
+		}
+
+		//! Read content of an opened file if it isn't too big.
+		/*!
+			Throws if the file was changed while it was read.
+		*/
+		file_handle_t
+		read_file( file_descriptor_t fd, const file_meta_t & meta ) const
+		{
+			if( m_params.max_file_size() < meta.file_total_size() ||
+				m_params.max_total_size() < meta.file_total_size() )
+				return file_handle_t{};
+
+			const auto size = static_cast< std::size_t >( meta.file_total_size() );
+
+			// One more byte is requested to detect that the file has grown.
+			std::string content( size + 1u, '\0' );
+			if( size != read_file_data( fd, &content[ 0 ], content.size() ) )
+				throw exception_t{ "file was changed while it was read" };
+			content.resize( size );
+
+			return std::make_shared< const cached_file_t >( std::move( content ), meta );
+		}
+
+		//! Remove an entry from the cache.
+		/*!
+			Must be called under the lock.
+		*/
+		void
+		erase( entries_map_t::iterator it )
+		{
+			if( it->second.m_file )
+			{
+				m_stats.m_total_size -= it->second.m_file->size();
+				--m_stats.m_files_count;
+				m_lru.erase( it->second.m_lru_pos );
+			}
+
+			m_entries.erase( it );
+		}
+
+		void
+		remove( const std::string & path )
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+
+			const auto it = m_entries.find( path );
+			if( it != m_entries.end() )
+				erase( it );
+		}
+
+		const hot_file_cache_params_t m_params;
+
+		mutable std::mutex m_lock;
+		entries_map_t m_entries;
+		//! Paths of cached files, the least recently used is the first.
+		std::list< std::string > m_lru;
+		hot_file_cache_stats_t m_stats;
+};
+
+} /* namespace restinio */
@@ -0,0 +1,518 @@
+/*
+	restinio
+*/
+
+/*!
+	Zero-copy view of request header fields.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/http_headers.hpp>
+#include <restinio/impl/request_arena.hpp>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+
+namespace restinio
+{
+
+namespace impl
+{
+
+class header_view_builder_t;
+
+} /* namespace impl */
+
+//
+// http_header_field_view_t
+//
+
+//! A single header field that refers to the raw header block.
+/*!
+	@since v.0.6.2
+*/
+class http_header_field_view_t
+{
+	public:
+		http_header_field_view_t(
+			string_view_t name,
+			string_view_t value,
+			http_field_t field_id ) noexcept
+			:	m_name{ name }
+			,	m_value{ value }
+			,	m_field_id{ field_id }
+		{}
+
+		string_view_t name() const noexcept { return m_name; }
+		string_view_t value() const noexcept { return m_value; }
+		http_field_t field_id() const noexcept { return m_field_id; }
+
+	private:
+		string_view_t m_name;
+		string_view_t m_value;
+		http_field_t m_field_id;
+};
+
+//
+// http_request_header_view_t
+//
+
+//! Header fields and request target of an incoming request
+//! as views into the raw header block.
+/*!
+	Is filled only if zero-copy header parsing is turned on by
+	server_settings_t::zero_copy_header_parsing(). In that mode header
+	fields are not copied to separate strings of http_request_header_t
+	(except fields required by RESTinio itself, see
+	server_settings_t::zero_copy_header_parsing()) and are available
+	via request_t::header_view().
+
+	The object owns a single block of memory. The block contains
+	the raw header data (collected by the parser) followed by views
+	of fields that refer to that data.
+
+	If there are several fields with the same name then lookup methods
+	return the last one (as http_header_fields_t keeps only the last value
+	of a field set several times).
+
+	The object can be moved but not copied because views refer to
+	the block owned by the object.
+
+	@since v.0.6.2
+*/
+class http_request_header_view_t
+{
+		friend class impl::header_view_builder_t;
+
+	public:
+		using block_t = std::vector< char, impl::arena_allocator_t< char > >;
+
+		//! Type of const_iterator for enumeration of fields.
+		using const_iterator = const http_header_field_view_t *;
+
+		http_request_header_view_t() = default;
+
+		http_request_header_view_t( const http_request_header_view_t & ) = delete;
+		http_request_header_view_t &
+		operator=( const http_request_header_view_t & ) = delete;
+
+		// The buffer of moved block stays the same so views remain valid.
+		http_request_header_view_t( http_request_header_view_t && o ) noexcept
+			:	m_block{ std::move( o.m_block ) }
+			,	m_request_target{ o.m_request_target }
+			,	m_fields{ o.m_fields }
+			,	m_fields_count{ o.m_fields_count }
+		{
+			o.reset();
+		}
+
+		http_request_header_view_t &
+		operator=( http_request_header_view_t && o ) noexcept
+		{
+			if( this != &o )
+			{
+				m_block = std::move( o.m_block );
+				m_request_target = o.m_request_target;
+				m_fields = o.m_fields;
+				m_fields_count = o.m_fields_count;
+
+				o.reset();
+			}
+
+			return *this;
+		}
+
+		//! Is the view filled?
+		/*!
+			Returns false if zero-copy header parsing isn't used.
+		*/
+		bool
+		empty() const noexcept { return m_block.empty(); }
+
+		//! Get the request target as it was received.
+		string_view_t
+		request_target() const noexcept { return m_request_target; }
+
+		//! Check field by name.
+		bool
+		has_field( string_view_t field_name ) const noexcept
+		{
+			return end() != cfind( field_name );
+		}
+
+		//! Check field by field-id.
+		bool
+		has_field( http_field_t field_id ) const noexcept
+		{
+			return end() != cfind( field_id );
+		}
+
+		//! Get the value of a field or throw if the field not found.
+		string_view_t
+		value_of( string_view_t field_name ) const
+		{
+			const auto it = cfind( field_name );
+			if( end() == it )
+				throw exception_t{
+					fmt::format( "field '{}' doesn't exist", field_name ) };
+
+			return it->value();
+		}
+
+		//! Get the value of a field or throw if the field not found.
+		string_view_t
+		value_of( http_field_t field_id ) const
+		{
+			if( http_field_t::field_unspecified == field_id )
+				throw exception_t{
+					fmt::format( "unspecified fields cannot be searched by id" ) };
+
+			const auto it = cfind( field_id );
+			if( end() == it )
+				throw exception_t{
+					fmt::format(
+						"field '{}' doesn't exist",
+						field_to_string( field_id ) ) };
+
+			return it->value();
+		}
+
+		//! Get optional value of a field.
+		optional_t< string_view_t >
+		opt_value_of( string_view_t field_name ) const noexcept
+		{
+			optional_t< string_view_t > result;
+
+			const auto it = cfind( field_name );
+			if( end() != it )
+				result = it->value();
+
+			return result;
+		}
+
+		//! Get optional value of a field.
+		optional_t< string_view_t >
+		opt_value_of( http_field_t field_id ) const noexcept
+		{
+			optional_t< string_view_t > result;
+
+			if( http_field_t::field_unspecified != field_id )
+			{
+				const auto it = cfind( field_id );
+				if( end() != it )
+					result = it->value();
+			}
+
+			return result;
+		}
+
+		//! Enumeration of fields.
+		template< typename Lambda >
+		void
+		for_each_field( Lambda && lambda ) const
+				noexcept(noexcept(lambda(
+						std::declval<const http_header_field_view_t &>())))
+		{
+			for( const auto & f : *this )
+				lambda( f );
+		}
+
+		const_iterator
+		begin() const noexcept
+		{
+			return m_fields;
+		}
+
+		const_iterator
+		end() const noexcept
+		{
+			return m_fields + m_fields_count;
+		}
+
+		std::size_t
+		fields_count() const noexcept
+		{
+			return m_fields_count;
+		}
+
+	private:
+		http_request_header_view_t(
+			block_t block,
+			string_view_t request_target,
+			const http_header_field_view_t * fields,
+			std::size_t fields_count ) noexcept
+			:	m_block{ std::move( block ) }
+			,	m_request_target{ request_target }
+			,	m_fields{ fields }
+			,	m_fields_count{ fields_count }
+		{}
+
+		void
+		reset() noexcept
+		{
+			m_block.clear();
+			m_request_target = string_view_t{};
+			m_fields = nullptr;
+			m_fields_count = 0u;
+		}
+
+		template< typename Predicate >
+		const_iterator
+		find_last( Predicate && predicate ) const noexcept
+		{
+			using reverse_iterator_t = std::reverse_iterator< const_iterator >;
+
+			const auto it = std::find_if(
+					reverse_iterator_t{ end() }, reverse_iterator_t{ begin() },
+					predicate );
+
+			return reverse_iterator_t{ begin() } == it ? end() : std::prev( it.base() );
+		}
+
+		const_iterator
+		cfind( string_view_t field_name ) const noexcept
+		{
+			return find_last( [&]( const auto & f ){
+					return impl::is_equal_caseless(
+							f.name().data(), f.name().size(),
+							field_name.data(), field_name.size() );
+				} );
+		}
+
+		const_iterator
+		cfind( http_field_t field_id ) const noexcept
+		{
+			return find_last( [&]( const auto & f ){
+					return f.field_id() == field_id;
+				} );
+		}
+
+		//! The raw header data followed by views of fields.
+		block_t m_block;
+
+		string_view_t m_request_target;
+
+		//! Views of fields at the end of the block.
+		const http_header_field_view_t * m_fields{ nullptr };
+
+		std::size_t m_fields_count{ 0u };
+};
+
+namespace impl
+{
+
+//
+// header_view_builder_t
+//
+
+//! Collector of the raw header block during parsing.
+/*!
+	Header parts that come from http-parser are appended directly to
+	the block that is then passed to http_request_header_view_t
+	(the block is allocated from the request arena if it is used).
+	When the message is parsed views of fields are placed at the end
+	of the same block, so header data is copied only once: from the
+	input buffer of the connection to the block.
+
+	The size of the block isn't known until the whole header is
+	parsed. The block is reserved with the size of the previous
+	request of the connection, so in steady state it isn't
+	reallocated while it grows.
+
+	Http-parser can report a name or a value by several parts
+	(if it is split between reads), but parts of the same name or
+	value come in a row, so they occupy a contiguous area of the buffer.
+
+	@since v.0.6.2
+*/
+class header_view_builder_t
+{
+	public:
+		//! Prepare builder for a new request.
+		void
+		reset(
+			//! Allocator for the block of the next request.
+			const arena_allocator_t< char > & allocator ) noexcept
+		{
+			// The previous block (if any) has been passed to the view.
+			m_buffer = block_t{ allocator };
+			m_target_size = 0u;
+			m_fields.clear();
+			m_last_was_value = true;
+		}
+
+		void
+		append_request_target( const char * at, std::size_t length )
+		{
+			// Request target comes before fields, so it starts
+			// at the beginning of the buffer.
+			append( at, length );
+			m_target_size += length;
+		}
+
+		void
+		append_field_name( const char * at, std::size_t length )
+		{
+			if( m_last_was_value )
+			{
+				m_fields.push_back( raw_field_t{
+						m_buffer.size(), 0u, 0u, http_field_t::field_unspecified } );
+				m_last_was_value = false;
+			}
+
+			append( at, length );
+			m_fields.back().m_name_size += length;
+		}
+
+		void
+		append_field_value( const char * at, std::size_t length )
+		{
+			append( at, length );
+			m_fields.back().m_value_size += length;
+			m_last_was_value = true;
+		}
+
+		//! Handle the end of the header.
+		/*!
+			Fields required by RESTinio itself are copied to
+			an ordinary header, so helpers that work with
+			http_header_fields_t (and body consumer factory) see them.
+			All fields are copied for upgrade requests.
+		*/
+		void
+		on_headers_complete(
+			http_header_fields_t & header,
+			bool is_upgrade_request )
+		{
+			for( auto & f : m_fields )
+			{
+				f.m_field_id = string_to_field( name_of( f ) );
+
+				if( is_upgrade_request || is_field_required_in_header( f.m_field_id ) )
+					header.set_field( http_header_field_t{
+							name_of( f ),
+							string_view_t{
+								m_buffer.data() + value_offset( f ), f.m_value_size } } );
+			}
+		}
+
+		//! Place views of fields into the block and pass it to the view.
+		/*!
+			The builder has to be reset before the next request.
+		*/
+		http_request_header_view_t
+		make_view()
+		{
+			static_assert(
+					std::is_trivially_destructible< http_header_field_view_t >::value,
+					"views are not destroyed when the block is freed" );
+
+			// Views are placed after the data. The block is aligned
+			// enough for them because it comes from operator new or
+			// from the arena, so only the offset has to be aligned.
+			constexpr std::size_t alignment = alignof( http_header_field_view_t );
+			const std::size_t views_offset =
+					( m_buffer.size() + alignment - 1u ) / alignment * alignment;
+
+			m_buffer.resize(
+					views_offset +
+					m_fields.size() * sizeof( http_header_field_view_t ) );
+			m_size_hint = m_buffer.size();
+
+			const char * data = m_buffer.data();
+			auto * views = reinterpret_cast< http_header_field_view_t * >(
+					m_buffer.data() + views_offset );
+
+			for( std::size_t i = 0u; i != m_fields.size(); ++i )
+			{
+				const auto & f = m_fields[ i ];
+				new( views + i ) http_header_field_view_t{
+						string_view_t{ data + f.m_name_offset, f.m_name_size },
+						string_view_t{ data + value_offset( f ), f.m_value_size },
+						f.m_field_id };
+			}
+
+			const string_view_t target{ data, m_target_size };
+
+			return http_request_header_view_t{
+					std::move( m_buffer ), target, views, m_fields.size() };
+		}
+
+	private:
+		struct raw_field_t
+		{
+			std::size_t m_name_offset;
+			std::size_t m_name_size;
+			std::size_t m_value_size;
+			http_field_t m_field_id;
+		};
+
+		//! Is a field used by RESTinio itself or by its helpers?
+		static bool
+		is_field_required_in_header( http_field_t field_id ) noexcept
+		{
+			switch( field_id )
+			{
+				// Body related fields (body consumers, multipart and
+				// file_upload helpers, zlib body handler).
+				case http_field_t::content_type:
+				case http_field_t::content_encoding:
+				case http_field_t::transfer_encoding:
+				// Static files helpers.
+				case http_field_t::accept_encoding:
+				case http_field_t::if_none_match:
+				case http_field_t::if_modified_since:
+					return true;
+
+				default:
+					return false;
+			}
+		}
+
+		using block_t = http_request_header_view_t::block_t;
+
+		void
+		append( const char * at, std::size_t length )
+		{
+			if( 0u == m_buffer.capacity() )
+				m_buffer.reserve( (std::max)( m_size_hint, length ) );
+
+			m_buffer.insert( m_buffer.end(), at, at + length );
+		}
+
+		static std::size_t
+		value_offset( const raw_field_t & f ) noexcept
+		{
+			// Value follows the name.
+			return f.m_name_offset + f.m_name_size;
+		}
+
+		string_view_t
+		name_of( const raw_field_t & f ) const noexcept
+		{
+			return { m_buffer.data() + f.m_name_offset, f.m_name_size };
+		}
+
+		//! Accumulated request target, names and values.
+		block_t m_buffer;
+
+		//! Size of the block of the previous request.
+		std::size_t m_size_hint{ 0u };
+
+		std::size_t m_target_size{ 0u };
+
+		std::vector< raw_field_t > m_fields;
+
+		bool m_last_was_value{ true };
+};
+
+} /* namespace impl */
+
+} /* namespace restinio */
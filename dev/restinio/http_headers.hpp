@@ -11,6 +11,7 @@
 #include <restinio/impl/include_fmtlib.hpp>
 
 #include <restinio/impl/string_caseless_compare.hpp>
+#include <restinio/impl/request_arena.hpp>
 
 #include <restinio/exception.hpp>
 #include <restinio/string_view.hpp>
@@ -22,7 +23,10 @@
 #include <iosfwd>
 #include <string>
 #include <vector>
+#include <array>
 #include <algorithm>
+#include <memory>
+#include <new>
 
 namespace restinio
 {
@@ -668,6 +672,174 @@ append_last_field_accessor( http_header_fields_t &, string_view_t );
 	#define RESTINIO_HEADER_FIELDS_DEFAULT_RESERVE_COUNT 4
 #endif
 
+//! Max count of fields that are searched without index.
+/*!
+	The index of http_header_fields_t is created only when the count
+	of fields exceeds this value.
+
+	@since v.0.6.2
+*/
+#if !defined( RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD )
+	#define RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD 8
+#endif
+
+namespace impl
+{
+
+//
+// header_fields_index_t
+//
+
+//! Index for constant time lookup of fields in http_header_fields_t.
+/*!
+	Positions of fields with standard names are stored in a table
+	indexed by http_field_t. Positions of all fields are also stored
+	in a small open addressing hash table keyed by case insensitive
+	hash of field name, so lookup by name doesn't need to detect
+	the field id. Both tables are kept inside the object, so the index
+	is allocated by a single allocation (and only for headers with
+	many fields, see RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD).
+
+	A position is stored as `position + 1`, zero means an empty slot.
+
+	If there are too many fields for the hash table the index is
+	turned off and the owner should use linear search.
+
+	@since v.0.6.2
+*/
+class header_fields_index_t
+{
+		static constexpr std::size_t known_fields_count =
+				static_cast< std::size_t >( http_field_t::field_unspecified );
+
+		//! Size of hash table for names of fields.
+		static constexpr std::size_t name_slots_bits = 6u;
+		static constexpr std::size_t name_slots = 1u << name_slots_bits;
+		//! Max count of indexed fields (load factor 0.75).
+		static constexpr std::size_t max_indexed_fields = 48u;
+
+	public:
+		//! Value for absent fields.
+		static constexpr std::size_t npos = static_cast< std::size_t >( -1 );
+
+		//! Can the index be used for lookup?
+		bool
+		usable() const noexcept { return !m_overflow; }
+
+		void
+		clear() noexcept
+		{
+			m_known.fill( 0u );
+			m_names.fill( 0u );
+			m_overflow = false;
+		}
+
+		//! Build index for all fields.
+		template< typename Fields >
+		void
+		rebuild( const Fields & fields ) noexcept
+		{
+			clear();
+			for( std::size_t i = 0; i != fields.size(); ++i )
+				add( fields[ i ], i );
+		}
+
+		//! Add a new field that is placed at position \a pos.
+		void
+		add( const http_header_field_t & field, std::size_t pos ) noexcept
+		{
+			if( m_overflow )
+				return;
+
+			if( max_indexed_fields <= pos )
+			{
+				m_overflow = true;
+				return;
+			}
+
+			const auto stored_pos = static_cast< std::uint8_t >( pos + 1u );
+
+			if( http_field_t::field_unspecified != field.field_id() )
+				m_known[ static_cast< std::size_t >( field.field_id() ) ] = stored_pos;
+
+			auto slot = hash( field.name() );
+			while( 0u != m_names[ slot ] )
+				slot = next_slot( slot );
+
+			m_names[ slot ] = stored_pos;
+		}
+
+		//! Find the position of a field with standard name.
+		std::size_t
+		find( http_field_t field_id ) const noexcept
+		{
+			return static_cast< std::size_t >(
+					m_known[ static_cast< std::size_t >( field_id ) ] ) - 1u;
+		}
+
+		//! Find the position of a field by name.
+		template< typename Fields >
+		std::size_t
+		find( string_view_t field_name, const Fields & fields ) const noexcept
+		{
+			for( auto slot = hash( field_name );
+				0u != m_names[ slot ];
+				slot = next_slot( slot ) )
+			{
+				const std::size_t pos = m_names[ slot ] - 1u;
+				const auto & name = fields[ pos ].name();
+				if( is_equal_caseless(
+						name.data(), name.size(),
+						field_name.data(), field_name.size() ) )
+					return pos;
+			}
+
+			return npos;
+		}
+
+	private:
+		//! Case insensitive hash of a name.
+		/*!
+			Uses only the length and a few characters of the name
+			to be cheap for long names. Collisions are resolved
+			by comparison of names.
+		*/
+		static std::size_t
+		hash( string_view_t name ) noexcept
+		{
+			const auto size = name.size();
+			if( 0u == size )
+				return 0u;
+
+			// Setting 0x20 bit makes ASCII letters lowercase,
+			// other symbols are just hashed with some collisions.
+			const auto at = [&]( std::size_t i ) noexcept {
+				return static_cast< std::size_t >(
+						static_cast< unsigned char >( name[ i ] ) | 0x20u );
+			};
+
+			std::uint32_t h = static_cast< std::uint32_t >(
+					size ^ ( at( 0u ) << 8 ) ^ ( at( size / 2u ) << 16 ) ^
+					( at( size - 1u ) << 24 ) );
+
+			// Fibonacci hashing: the highest bits are the best mixed.
+			h *= 2654435769u;
+			return h >> ( 32u - name_slots_bits );
+		}
+
+		static std::size_t
+		next_slot( std::size_t slot ) noexcept
+		{
+			return ( slot + 1u ) & ( name_slots - 1u );
+		}
+
+		std::array< std::uint8_t, known_fields_count > m_known{};
+		std::array< std::uint8_t, name_slots > m_names{};
+		bool m_overflow{ false };
+};
+
+} /* namespace impl */
+
 //
 // http_header_fields_t
 //
@@ -705,7 +877,16 @@ class http_header_fields_t
 		impl::append_last_field_accessor( http_header_fields_t &, string_view_t );
 
 	public:
-		using fields_container_t = std::vector< http_header_field_t >;
+		//! Allocator for the container of fields.
+		/*!
+			Uses the heap by default but can use a per-connection arena
+			for headers of incoming requests.
+
+			@since v.0.6.2
+		*/
+		using allocator_t = impl::arena_allocator_t< http_header_field_t >;
+
+		using fields_container_t = std::vector< http_header_field_t, allocator_t >;
 
 		//! Type of const_iterator for enumeration of fields.
 		using const_iterator = fields_container_t::const_iterator;
@@ -714,17 +895,66 @@ class http_header_fields_t
 		{
 			m_fields.reserve( RESTINIO_HEADER_FIELDS_DEFAULT_RESERVE_COUNT );
 		}
-		http_header_fields_t(const http_header_fields_t &) = default;
-		http_header_fields_t(http_header_fields_t &&) = default;
+
+		//! Initializing constructor with allocator for fields container.
+		/*!
+			Unlike the default constructor doesn't reserve memory
+			for fields, so no memory is allocated until the first
+			field is added.
+
+			@since v.0.6.2
+		*/
+		explicit http_header_fields_t( const allocator_t & allocator ) noexcept
+			:	m_fields( allocator )
+		{}
+		http_header_fields_t(const http_header_fields_t & other)
+			:	m_fields{ other.m_fields }
+		{
+			rebuild_index();
+		}
+
+		http_header_fields_t(http_header_fields_t && other) noexcept
+			:	m_fields{ std::move( other.m_fields ) }
+			,	m_index{ std::move( other.m_index ) }
+		{
+			// The source is left empty, so it doesn't need an index.
+			other.m_fields.clear();
+		}
+
 		virtual ~http_header_fields_t() {}
 
-		http_header_fields_t & operator=(const http_header_fields_t &) = default;
-		http_header_fields_t & operator=(http_header_fields_t &&) = default;
+		http_header_fields_t &
+		operator=(const http_header_fields_t & other)
+		{
+			if( this != &other )
+			{
+				m_fields = other.m_fields;
+				rebuild_index();
+			}
+
+			return *this;
+		}
+
+		http_header_fields_t &
+		operator=(http_header_fields_t && other) noexcept
+		{
+			if( this != &other )
+			{
+				m_fields = std::move( other.m_fields );
+				m_index = std::move( other.m_index );
+
+				// The source is left empty, so it doesn't need an index.
+				other.m_fields.clear();
+			}
+
+			return *this;
+		}
 
 		void
 		swap_fields( http_header_fields_t & http_header_fields )
 		{
 			std::swap( m_fields, http_header_fields.m_fields );
+			std::swap( m_index, http_header_fields.m_index );
 		}
 
 		//! Check field by name.
@@ -770,7 +1000,7 @@ class http_header_fields_t
 			}
 			else
 			{
-				m_fields.emplace_back( std::move( http_header_field ) );
+				emplace_field( std::move( http_header_field ) );
 			}
 		}
 
@@ -789,7 +1019,7 @@ class http_header_fields_t
 			}
 			else
 			{
-				m_fields.emplace_back(
+				emplace_field(
 					std::move( field_name ),
 					std::move( field_value ) );
 			}
@@ -815,7 +1045,7 @@ class http_header_fields_t
 				}
 				else
 				{
-					m_fields.emplace_back(
+					emplace_field(
 						field_id,
 						std::move( field_value ) );
 				}
@@ -836,7 +1066,7 @@ class http_header_fields_t
 			}
 			else
 			{
-				m_fields.emplace_back( field_name, field_value );
+				emplace_field( field_name, field_value );
 			}
 		}
 
@@ -860,7 +1090,7 @@ class http_header_fields_t
 				}
 				else
 				{
-					m_fields.emplace_back( field_id, field_value );
+					emplace_field( field_id, field_value );
 				}
 			}
 		}
@@ -1088,6 +1318,7 @@ class http_header_fields_t
 			if( m_fields.end() != it )
 			{
 				m_fields.erase( it );
+				rebuild_index();
 			}
 		}
 
@@ -1102,6 +1333,7 @@ class http_header_fields_t
 				if( m_fields.end() != it )
 				{
 					m_fields.erase( it );
+					rebuild_index();
 				}
 			}
 		}
@@ -1243,9 +1475,69 @@ class http_header_fields_t
 			m_fields.back().append_value( field_value );
 		}
 
+		//! Add a new field to the end of the container.
+		/*!
+			@since v.0.6.2
+		*/
+		template< typename... Args >
+		void
+		emplace_field( Args &&... args )
+		{
+			m_fields.emplace_back( std::forward< Args >( args )... );
+
+			if( m_index )
+				m_index->add( m_fields.back(), m_fields.size() - 1u );
+			else if( RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD < m_fields.size() )
+				rebuild_index();
+		}
+
+		//! Is the index created and usable for lookup?
+		/*!
+			@since v.0.6.2
+		*/
+		bool
+		is_index_usable() const noexcept
+		{
+			return m_index && m_index->usable();
+		}
+
+		//! Bring the index in accordance with fields.
+		/*!
+			The index is created only if there are many fields.
+
+			@since v.0.6.2
+		*/
+		void
+		rebuild_index()
+		{
+			if( RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD < m_fields.size() )
+			{
+				if( !m_index )
+					m_index = make_index( m_fields.get_allocator() );
+
+				m_index->rebuild( m_fields );
+			}
+			else
+				m_index.reset();
+		}
+
+		//! Convert a position from the index to iterator.
+		template< typename Iterator >
+		static Iterator
+		iterator_at( Iterator begin, Iterator end, std::size_t pos ) noexcept
+		{
+			return impl::header_fields_index_t::npos == pos ? end : begin + pos;
+		}
+
 		fields_container_t::iterator
 		find( string_view_t field_name ) noexcept
 		{
+			if( is_index_usable() )
+				return iterator_at(
+						m_fields.begin(),
+						m_fields.end(),
+						m_index->find( field_name, m_fields ) );
+
 			return std::find_if(
 				m_fields.begin(),
 				m_fields.end(),
@@ -1257,6 +1549,12 @@ class http_header_fields_t
 		fields_container_t::const_iterator
 		cfind( string_view_t field_name ) const noexcept
 		{
+			if( is_index_usable() )
+				return iterator_at(
+						m_fields.cbegin(),
+						m_fields.cend(),
+						m_index->find( field_name, m_fields ) );
+
 			return std::find_if(
 				m_fields.cbegin(),
 				m_fields.cend(),
@@ -1268,6 +1566,14 @@ class http_header_fields_t
 		fields_container_t::iterator
 		find( http_field_t field_id ) noexcept
 		{
+			// The index doesn't know the position of the first field
+			// with non-standard name.
+			if( is_index_usable() && http_field_t::field_unspecified != field_id )
+				return iterator_at(
+						m_fields.begin(),
+						m_fields.end(),
+						m_index->find( field_id ) );
+
 			return std::find_if(
 				m_fields.begin(),
 				m_fields.end(),
@@ -1279,6 +1585,12 @@ class http_header_fields_t
 		fields_container_t::const_iterator
 		cfind( http_field_t field_id ) const noexcept
 		{
+			if( is_index_usable() && http_field_t::field_unspecified != field_id )
+				return iterator_at(
+						m_fields.cbegin(),
+						m_fields.cend(),
+						m_index->find( field_id ) );
+
 			return std::find_if(
 				m_fields.cbegin(),
 				m_fields.cend(),
@@ -1287,7 +1599,60 @@ class http_header_fields_t
 				} );
 		}
 
+		//! Deleter for the index that is allocated by allocator of fields.
+		/*!
+			@since v.0.6.2
+		*/
+		class index_deleter_t
+		{
+			public:
+				using index_allocator_t =
+						impl::arena_allocator_t< impl::header_fields_index_t >;
+
+				index_deleter_t() noexcept = default;
+
+				explicit index_deleter_t( index_allocator_t allocator ) noexcept
+					:	m_allocator{ std::move( allocator ) }
+				{}
+
+				void
+				operator()( impl::header_fields_index_t * index ) noexcept
+				{
+					index->~header_fields_index_t();
+					m_allocator.deallocate( index, 1u );
+				}
+
+			private:
+				index_allocator_t m_allocator;
+		};
+
+		using index_handle_t =
+				std::unique_ptr< impl::header_fields_index_t, index_deleter_t >;
+
+		static index_handle_t
+		make_index( const allocator_t & fields_allocator )
+		{
+			index_deleter_t::index_allocator_t allocator{ fields_allocator };
+
+			auto * index = allocator.allocate( 1u );
+			// The constructor of the index doesn't throw.
+			new( index ) impl::header_fields_index_t{};
+
+			return index_handle_t{ index, index_deleter_t{ std::move( allocator ) } };
+		}
+
 		fields_container_t m_fields;
+
+		//! Index for fast lookup of fields.
+		/*!
+			Order of fields in m_fields isn't changed by the index.
+
+			Is created only if there are many fields, a small
+			header is searched linearly.
+
+			@since v.0.6.2
+		*/
+		index_handle_t m_index;
 };
 
 //
@@ -1311,6 +1676,16 @@ struct http_header_common_t
 	:	public http_header_fields_t
 {
 	public:
+		http_header_common_t() = default;
+
+		//! Initializing constructor with allocator for fields container.
+		/*!
+			@since v.0.6.2
+		*/
+		explicit http_header_common_t( const allocator_t & allocator ) noexcept
+			:	http_header_fields_t{ allocator }
+		{}
+
 		//! Http version.
 		//! \{
 		std::uint16_t
@@ -1601,6 +1976,14 @@ struct http_request_header_t final
 	public:
 		http_request_header_t() = default;
 
+		//! Initializing constructor with allocator for fields container.
+		/*!
+			@since v.0.6.2
+		*/
+		explicit http_request_header_t( const allocator_t & allocator ) noexcept
+			:	http_header_common_t{ allocator }
+		{}
+
 		http_request_header_t(
 			http_method_id_t method,
 			std::string request_target_ )
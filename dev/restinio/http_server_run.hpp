@@ -10,9 +10,13 @@
 #pragma once
 
 #include <restinio/impl/ioctx_on_thread_pool.hpp>
+#include <restinio/impl/ioctx_per_thread_pool.hpp>
 
 #include <restinio/http_server.hpp>
 
+#include <atomic>
+#include <mutex>
+
 namespace restinio
 {
 
@@ -642,6 +646,371 @@ run( run_existing_server_on_thread_pool_t<Traits> && params )
 		impl::run_without_break_signal_handling( pool, params.server() );
 }
 
+//
+// run_on_io_context_per_thread_settings_t
+//
+/*!
+ * @brief Parameters for the case when a separate http_server must be
+ * run on every thread with its own io_context.
+ *
+ * @note
+ * Shouldn't be used directly. Only as result of
+ * on_io_context_per_thread() function as parameter for run().
+ *
+ * @since v.0.6.2
+ */
+template<typename Traits, typename Configurator>
+class run_on_io_context_per_thread_settings_t final
+{
+	//! Count of threads.
+	std::size_t m_threads_count;
+
+	//! Should threads be bound to CPU cores.
+	bool m_pin_threads{ true };
+
+	//! Configurator for settings of every server instance.
+	Configurator m_configurator;
+
+public:
+	//! Initializing constructor.
+	run_on_io_context_per_thread_settings_t(
+		//! Count of threads.
+		std::size_t threads_count,
+		//! Configurator for settings of every server instance.
+		Configurator configurator )
+		:	m_threads_count{ threads_count }
+		,	m_configurator{ std::move(configurator) }
+	{}
+
+	//! Get the count of threads.
+	std::size_t
+	threads_count() const noexcept { return m_threads_count; }
+
+	//! Should threads be bound to CPU cores.
+	//! \{
+	run_on_io_context_per_thread_settings_t &
+	pin_threads( bool v ) & noexcept
+	{
+		m_pin_threads = v;
+		return *this;
+	}
+
+	run_on_io_context_per_thread_settings_t &&
+	pin_threads( bool v ) && noexcept
+	{
+		return std::move( this->pin_threads( v ) );
+	}
+
+	bool
+	pin_threads() const noexcept { return m_pin_threads; }
+	//! \}
+
+	//! Get the configurator.
+	Configurator &
+	configurator() noexcept { return m_configurator; }
+};
+
+//
+// on_io_context_per_thread
+//
+/*!
+ * @brief A special marker for the case when a separate instance of
+ * http_server must be run on every thread with its own io_context.
+ *
+ * Every thread gets its own io_context, its own timer manager and
+ * its own acceptor. All acceptors listen on the same address with
+ * SO_REUSEPORT option set, so the OS kernel balances new connections
+ * between threads. A connection is served only on the thread that
+ * accepted it, so there is no need in strands and locks and
+ * single-thread traits can be used.
+ *
+ * Because server settings can't be copied the settings are set by
+ * \a configurator that is called for every server instance.
+ * So if a request handler is created inside the configurator then
+ * every thread gets its own request handler.
+ *
+ * Usage example:
+ * @code
+ * restinio::run(
+ * 	restinio::on_io_context_per_thread< restinio::default_single_thread_traits_t >(
+ * 		std::thread::hardware_concurrency(),
+ * 		[]( auto & settings ) {
+ * 			settings
+ * 				.port( 8080 )
+ * 				.address( "localhost" )
+ * 				.request_handler( ... );
+ * 		} ) );
+ * @endcode
+ *
+ * @note
+ * SO_REUSEPORT isn't supported on some platforms, an exception is
+ * thrown from run() in that case.
+ *
+ * @since v.0.6.2
+ */
+template<typename Traits = default_single_thread_traits_t, typename Configurator>
+run_on_io_context_per_thread_settings_t<Traits, std::decay_t<Configurator>>
+on_io_context_per_thread(
+	//! Count of threads.
+	std::size_t threads_count,
+	//! Configurator for settings of every server instance.
+	Configurator && configurator )
+{
+	return { threads_count, std::forward<Configurator>(configurator) };
+}
+
+namespace impl {
+
+#if defined(SO_REUSEPORT)
+//! Socket option for SO_REUSEPORT.
+/*!
+ * @since v.0.6.2
+ */
+using reuse_port_option_t =
+		asio_ns::detail::socket_option::boolean< SOL_SOCKET, SO_REUSEPORT >;
+#endif
+
+/*!
+ * @brief Add SO_REUSEPORT option to acceptor options setter
+ * specified by user.
+ *
+ * @since v.0.6.2
+ */
+template<typename Settings>
+void
+add_reuse_port_option( Settings & settings )
+{
+#if defined(SO_REUSEPORT)
+	std::shared_ptr< acceptor_options_setter_t > users_setter{
+			settings.acceptor_options_setter() };
+
+	settings.acceptor_options_setter(
+		[users_setter]( acceptor_options_t & options ) {
+			(*users_setter)( options );
+			options.set_option( reuse_port_option_t{ true } );
+		} );
+#else
+	(void)settings;
+	throw exception_t{ "SO_REUSEPORT is not supported on this platform" };
+#endif
+}
+
+} /* namespace impl */
+
+//
+// on_io_context_per_thread_runner_t
+//
+/*!
+ * @brief Helper class for running a separate http_server on every
+ * thread with its own io_context without blocking the current thread.
+ *
+ * Usage example:
+ * @code
+ * restinio::on_io_context_per_thread_runner_t< my_single_thread_traits > runner{
+ * 	restinio::on_io_context_per_thread< my_single_thread_traits >(
+ * 		4,
+ * 		[]( auto & settings ) {
+ * 			settings
+ * 				.port( 8080 )
+ * 				.address( "localhost" )
+ * 				.request_handler( []( auto req ) {...} );
+ * 		} ) };
+ *
+ * runner.start();
+ *
+ * ... // Some application specific code here.
+ *
+ * // Now the servers can be stopped.
+ * runner.stop();
+ * runner.wait();
+ * @endcode
+ *
+ * The servers are stopped automatically in the destructor.
+ *
+ * @since v.0.6.2
+ */
+template<typename Traits>
+class on_io_context_per_thread_runner_t
+{
+public :
+	using server_t = http_server_t<Traits>;
+
+private :
+	//! Threads with their own io_contexts.
+	impl::ioctx_per_thread_pool_t m_pool;
+
+	//! A server for every io_context.
+	std::vector< std::unique_ptr< server_t > > m_servers;
+
+	//! Has stop() been called already?
+	std::atomic< bool > m_stop_initiated{ false };
+
+	//! Count of servers that are not closed yet.
+	/*!
+	 * All servers should be closed before stopping the pool.
+	 */
+	std::atomic< std::size_t > m_servers_to_close;
+
+	std::mutex m_exception_lock;
+
+	//! The first exception from open/close operations of servers.
+	std::exception_ptr m_exception_caught;
+
+	void
+	store_exception( std::exception_ptr ex )
+	{
+		std::lock_guard< std::mutex > lock{ m_exception_lock };
+		if( !m_exception_caught )
+			m_exception_caught = ex;
+	}
+
+	void
+	on_server_closed()
+	{
+		if( 1u == m_servers_to_close.fetch_sub( 1u ) )
+			m_pool.stop();
+	}
+
+public :
+	on_io_context_per_thread_runner_t(
+		const on_io_context_per_thread_runner_t & ) = delete;
+	on_io_context_per_thread_runner_t(
+		on_io_context_per_thread_runner_t && ) = delete;
+
+	//! Initializing constructor.
+	/*!
+	 * All servers are created here but they are opened by start().
+	 */
+	template<typename Configurator>
+	explicit on_io_context_per_thread_runner_t(
+		run_on_io_context_per_thread_settings_t<Traits, Configurator> && settings )
+		:	m_pool{ settings.threads_count(), settings.pin_threads() }
+		,	m_servers_to_close{ settings.threads_count() }
+	{
+		m_servers.reserve( m_pool.size() );
+		for( std::size_t i = 0; i != m_pool.size(); ++i )
+		{
+			m_servers.emplace_back( std::make_unique< server_t >(
+					restinio::external_io_context( m_pool.io_context( i ) ),
+					[&settings]( auto & server_settings ) {
+						settings.configurator()( server_settings );
+						impl::add_reuse_port_option( server_settings );
+					} ) );
+		}
+	}
+
+	~on_io_context_per_thread_runner_t()
+	{
+		if( started() )
+		{
+			stop();
+			m_pool.wait();
+		}
+	}
+
+	//! Start the servers.
+	void
+	start()
+	{
+		for( auto & server : m_servers )
+			server->open_async(
+				[]{ /* Ok. */},
+				[this]( std::exception_ptr ex ){
+					// Stop running io_contexts.
+					// We can't throw an exception here!
+					// Store it to rethrow later in wait().
+					store_exception( ex );
+					m_pool.stop();
+				} );
+
+		m_pool.start();
+	}
+
+	//! Are servers started.
+	bool
+	started() const noexcept { return m_pool.started(); }
+
+	//! Stop the servers.
+	/*!
+	 * Can be called from any thread, including threads of the pool.
+	 */
+	void
+	stop()
+	{
+		if( m_stop_initiated.exchange( true ) )
+			return;
+
+		for( auto & server : m_servers )
+			server->close_async(
+				[this]{ on_server_closed(); },
+				[this]( std::exception_ptr ex ){
+					// We can't throw an exception here!
+					// Store it to rethrow later in wait().
+					store_exception( ex );
+					on_server_closed();
+				} );
+	}
+
+	//! Wait for full stop of the servers.
+	/*!
+	 * If an error was detected during open or close of a server
+	 * the exception is rethrown.
+	 */
+	void
+	wait()
+	{
+		m_pool.wait();
+
+		std::lock_guard< std::mutex > lock{ m_exception_lock };
+		if( m_exception_caught )
+			std::rethrow_exception( m_exception_caught );
+	}
+
+	//! Get the count of threads (and servers).
+	std::size_t
+	size() const noexcept { return m_pool.size(); }
+
+	//! Get io_context for the thread with index \a i.
+	asio_ns::io_context &
+	io_context( std::size_t i ) noexcept { return m_pool.io_context( i ); }
+};
+
+/*!
+ * @brief Helper function for running a separate http_server on every
+ * thread with its own io_context until ctrl+c is hit.
+ *
+ * Usage example:
+ * @code
+ * restinio::run(
+ * 	restinio::on_io_context_per_thread< my_single_thread_traits >(
+ * 		4,
+ * 		[]( auto & settings ) {
+ * 			settings
+ * 				.port( 8080 )
+ * 				.address( "localhost" )
+ * 				.request_handler( []( auto req ) {...} );
+ * 		} ) );
+ * @endcode
+ *
+ * @since v.0.6.2
+ */
+template<typename Traits, typename Configurator>
+inline void
+run( run_on_io_context_per_thread_settings_t<Traits, Configurator> && settings )
+{
+	on_io_context_per_thread_runner_t<Traits> runner{ std::move(settings) };
+
+	asio_ns::signal_set break_signals{ runner.io_context( 0u ), SIGINT };
+	break_signals.async_wait(
+		[&]( const asio_ns::error_code & ec, int ){
+			if( !ec )
+				runner.stop();
+		} );
+
+	runner.start();
+	runner.wait();
+}
+
 //
 // initiate_shutdown
 //
@@ -16,11 +16,13 @@
 
 #include <restinio/exception.hpp>
 #include <restinio/http_headers.hpp>
+#include <restinio/http_header_view.hpp>
 #include <restinio/request_handler.hpp>
 #include <restinio/impl/connection_base.hpp>
 #include <restinio/impl/header_helpers.hpp>
 #include <restinio/impl/response_coordinator.hpp>
 #include <restinio/impl/connection_settings.hpp>
+#include <restinio/impl/request_arena.hpp>
 #include <restinio/impl/fixed_buffer.hpp>
 #include <restinio/impl/write_group_output_ctx.hpp>
 #include <restinio/impl/executor_wrapper.hpp>
@@ -60,15 +62,89 @@ struct http_parser_ctx_t
 	//! Flag: is http message parsed completely.
 	bool m_message_complete{ false };
 
+	//! Arena for data of incoming requests.
+	/*!
+		Is empty if arenas are not used.
+
+		\since
+		v.0.6.2
+	*/
+	request_arena_handle_t m_arena;
+
+	//! Zero-copy header parsing.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	//! \{
+	//! Is zero-copy header parsing used?
+	bool m_use_header_view{ false };
+
+	//! Collector of the raw header block.
+	header_view_builder_t m_header_view_builder;
+	//! \}
+
+	//! Incremental body handling.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	//! \{
+	//! Factory of body consumers (nullptr if not used).
+	const incoming_body_consumer_factory_t * m_body_consumer_factory{ nullptr };
+
+	//! Connection to be attached to created body consumers.
+	std::weak_ptr< connection_base_t > m_connection;
+
+	//! Consumer for the body of current request (if any).
+	incoming_body_consumer_handle_t m_body_consumer;
+
+	//! Flag: is reading of body suspended by body consumer.
+	bool m_body_reading_suspended{ false };
+	//! \}
+
+	//! Limits for incoming messages.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	//! \{
+	incoming_http_msg_limits_t m_limits;
+
+	//! Sizes of the current message to be checked against limits.
+	std::size_t m_url_size{ 0u };
+	std::size_t m_header_size{ 0u };
+	std::size_t m_field_count{ 0u };
+
+	//! A limit exceeded by the current message (if any).
+	optional_t< incoming_http_msg_limit_t > m_exceeded_limit;
+	//! \}
+
 	//! Prepare context to handle new request.
 	void
 	reset()
 	{
-		m_header = http_request_header_t{};
+		// Memory for fields is taken from the arena only when
+		// fields are parsed, so the arena can be reused if the
+		// previous request has already gone.
+		// There is no need to reserve memory for fields at all
+		// if zero-copy header parsing is used.
+		if( m_arena || m_use_header_view )
+			m_header = http_request_header_t{
+					http_request_header_t::allocator_t{ m_arena } };
+		else
+			m_header = http_request_header_t{};
 		m_body.clear();
+		m_header_view_builder.reset( arena_allocator_t< char >{ m_arena } );
 		m_current_field_name.clear();
 		m_last_was_value = true;
 		m_message_complete = false;
+		m_body_consumer.reset();
+		m_body_reading_suspended = false;
+		m_url_size = 0u;
+		m_header_size = 0u;
+		m_field_count = 0u;
+		m_exceeded_limit = nullopt;
 	}
 };
 
@@ -107,7 +183,7 @@ create_parser_settings() noexcept
 
 	parser_settings.on_headers_complete =
 		[]( http_parser * parser ) -> int {
-			return restinio_headers_complete_cb( parser );
+			return restinio_headers_complete_cb< Http_Methods >( parser );
 		};
 
 	parser_settings.on_body =
@@ -252,11 +328,27 @@ class connection_t final
 			,	m_settings{ std::move( settings ) }
 			,	m_remote_endpoint{ std::move( remote_endpoint ) }
 			,	m_input{ m_settings->m_buffer_size }
-			,	m_response_coordinator{ m_settings->m_max_pipelined_requests }
+			,	m_response_coordinator{
+					m_settings->m_max_pipelined_requests,
+					m_settings->m_batch_pipelined_requests }
 			,	m_timer_guard{ m_settings->create_timer_guard() }
 			,	m_request_handler{ *( m_settings->m_request_handler ) }
 			,	m_logger{ *( m_settings->m_logger ) }
 		{
+			if( m_settings->m_incoming_body_consumer_factory )
+				m_input.m_parser_ctx.m_body_consumer_factory =
+					&( m_settings->m_incoming_body_consumer_factory );
+
+			m_input.m_parser_ctx.m_use_header_view =
+					m_settings->m_zero_copy_header_parsing;
+
+			m_input.m_parser_ctx.m_limits =
+					m_settings->m_incoming_http_msg_limits;
+
+			if( 0u != m_settings->m_request_arena_size )
+				m_input.m_parser_ctx.m_arena = request_arena_handle_t{
+						m_settings->m_request_arena_size };
+
 			// Notify of a new connection instance.
 			m_logger.trace( [&]{
 					return fmt::format(
@@ -301,6 +393,10 @@ class connection_t final
 								};
 						} );
 
+					// Body consumers should be able to resume reading.
+					m_input.m_parser_ctx.m_connection =
+						shared_from_concrete< connection_base_t >();
+
 					// Start timeout checking.
 					m_prepared_weak_ctx = shared_from_this();
 					init_next_timeout_checking();
@@ -486,6 +582,42 @@ class connection_t final
 		//! Parse some data.
 		void
 		consume_data( const char * data, std::size_t length )
+		{
+			if( !m_settings->m_batch_pipelined_requests || m_dispatching_batch )
+			{
+				parse_data( data, length );
+				return;
+			}
+
+			// Parsing of a request that is followed by another one
+			// in the buffer continues parsing of the buffer,
+			// so all complete requests are dispatched inside this call.
+			// Responses created meanwhile are written after that
+			// by a single write operation.
+			m_dispatching_batch = true;
+			try
+			{
+				parse_data( data, length );
+			}
+			catch( ... )
+			{
+				m_dispatching_batch = false;
+				throw;
+			}
+			m_dispatching_batch = false;
+
+			if( m_write_deferred )
+			{
+				m_write_deferred = false;
+
+				if( m_socket.is_open() && !m_response_coordinator.closed() )
+					init_write_if_necessary();
+			}
+		}
+
+		//! Parse some data and handle complete request (if any).
+		void
+		parse_data( const char * data, std::size_t length )
 		{
 			auto & parser = m_input.m_parser;
 
@@ -506,6 +638,13 @@ class connection_t final
 			if( HPE_OK != parser.http_errno &&
 				HPE_PAUSED != parser.http_errno )
 			{
+				if( m_input.m_parser_ctx.m_exceeded_limit )
+				{
+					// Parsing was stopped by a limit.
+					on_limit_exceeded( *( m_input.m_parser_ctx.m_exceeded_limit ) );
+					return;
+				}
+
 				// PARSE ERROR:
 				auto err = HTTP_PARSER_ERRNO( &parser );
 
@@ -526,6 +665,122 @@ class connection_t final
 			{
 				on_request_message_complete();
 			}
+			else if( m_input.m_parser_ctx.m_body_reading_suspended )
+			{
+				// Body consumer asked to wait. Reading will be
+				// continued by resume_incoming_body().
+				m_logger.trace( [&]{
+					return fmt::format(
+							"[connection:{}] reading of request body suspended",
+							connection_id() );
+				} );
+
+				// There is no pending read operation now, so connection
+				// should keep itself alive until resume or close.
+				m_suspended_self = shared_from_concrete< connection_base_t >();
+
+				// The time spent by body consumer should not be
+				// counted as the time of reading the request.
+				guard_read_operation();
+			}
+			else
+				consume_message();
+		}
+
+		//! Handle an incoming message that exceeds a limit.
+		/*!
+			Response with an appropriate status is sent and then
+			the connection is closed.
+
+			\since
+			v.0.6.2
+		*/
+		void
+		on_limit_exceeded( incoming_http_msg_limit_t limit )
+		{
+			m_logger.warn( [&]{
+				return fmt::format(
+						"[connection:{}] incoming message exceeds limit: {}",
+						connection_id(),
+						limit_name( limit ) );
+			} );
+
+			// Inform state listener if it used.
+			m_settings->call_state_listener( [&]() noexcept {
+					return connection_state::notice_t{
+							connection_id(),
+							m_remote_endpoint,
+							connection_state::limit_exceeded_t{ limit }
+						};
+				} );
+
+			// There is no request for that message, but the response
+			// must be written after responses for already received requests.
+			const auto request_id = m_response_coordinator.register_new_request();
+
+			write_response_parts_impl(
+				request_id,
+				response_output_flags_t{
+					response_parts_attr_t::final_parts,
+					response_connection_attr_t::connection_close },
+				write_group_t{ create_limit_exceeded_resp( limit ) } );
+		}
+
+		//! Resume reading of request body suspended by body consumer.
+		/*!
+			\since
+			v.0.6.2
+		*/
+		void
+		resume_incoming_body() override
+		{
+			// Post is used instead of dispatch because resume can be
+			// initiated right from body consumer, e.g. inside
+			// of http_parser_execute().
+			asio_ns::post(
+				this->get_executor(),
+				[ this, ctx = shared_from_this() ]
+				// NOTE: this lambda is noexcept.
+				() noexcept {
+					try
+					{
+						resume_incoming_body_impl();
+					}
+					catch( const std::exception & x )
+					{
+						trigger_error_and_close( [&] {
+								return fmt::format(
+										"[connection:{}] unable to resume reading "
+										"of request body: {}",
+										connection_id(),
+										x.what() );
+							} );
+					}
+				} );
+		}
+
+		void
+		resume_incoming_body_impl()
+		{
+			auto & parser_ctx = m_input.m_parser_ctx;
+			if( !m_socket.is_open() || !parser_ctx.m_body_reading_suspended )
+				return;
+
+			m_logger.trace( [&]{
+				return fmt::format(
+						"[connection:{}] resume reading of request body",
+						connection_id() );
+			} );
+
+			parser_ctx.m_body_reading_suspended = false;
+			m_suspended_self.reset();
+			http_parser_pause( &m_input.m_parser, 0 );
+
+			// Reading of the request is guarded again.
+			guard_read_operation();
+
+			if( 0 != m_input.m_buf.length() )
+				consume_data( m_input.m_buf.bytes(), m_input.m_buf.length() );
 			else
 				consume_message();
 		}
@@ -573,13 +828,7 @@ class connection_t final
 					guard_request_handling_operation();
 
 					if( request_rejected() ==
-						m_request_handler(
-							std::make_shared< request_t >(
-								request_id,
-								std::move( parser_ctx.m_header ),
-								std::move( parser_ctx.m_body ),
-								shared_from_concrete< connection_base_t >(),
-								m_remote_endpoint ) ) )
+						m_request_handler( make_request( request_id ) ) )
 					{
 						// If handler refused request, say not implemented.
 						write_response_parts_impl(
@@ -648,6 +897,91 @@ class connection_t final
 			}
 		}
 
+		//! A reference to itself while reading of request body is suspended.
+		/*!
+			\since
+			v.0.6.2
+		*/
+		connection_handle_t m_suspended_self;
+
+		//! Are requests from the input buffer being dispatched as a batch?
+		/*!
+			\since
+			v.0.6.2
+		*/
+		bool m_dispatching_batch{ false };
+
+		//! Were responses appended while a batch was being dispatched?
+		/*!
+			\since
+			v.0.6.2
+		*/
+		bool m_write_deferred{ false };
+
+		//! Create request object from the data of parser context.
+		request_handle_t
+		make_request( request_id_t request_id )
+		{
+			auto & parser_ctx = m_input.m_parser_ctx;
+
+			if( parser_ctx.m_body_consumer )
+				return create_request(
+						request_id,
+						std::move( parser_ctx.m_body_consumer ) );
+
+			return create_request(
+					request_id,
+					std::move( parser_ctx.m_body ) );
+		}
+
+		//! Create request object in the arena of the connection (if any).
+		/*!
+			\since
+			v.0.6.2
+		*/
+		template< typename Body >
+		request_handle_t
+		create_request( request_id_t request_id, Body && body )
+		{
+			auto & parser_ctx = m_input.m_parser_ctx;
+
+			auto header_view = make_header_view();
+
+			if( parser_ctx.m_arena )
+				return std::allocate_shared< request_t >(
+						arena_allocator_t< request_t >{ parser_ctx.m_arena },
+						request_id,
+						std::move( parser_ctx.m_header ),
+						std::forward< Body >( body ),
+						shared_from_concrete< connection_base_t >(),
+						m_remote_endpoint,
+						std::move( header_view ) );
+
+			return std::make_shared< request_t >(
+					request_id,
+					std::move( parser_ctx.m_header ),
+					std::forward< Body >( body ),
+					shared_from_concrete< connection_base_t >(),
+					m_remote_endpoint,
+					std::move( header_view ) );
+		}
+
+		//! Create views of header fields if zero-copy parsing is used.
+		/*!
+			\since
+			v.0.6.2
+		*/
+		http_request_header_view_t
+		make_header_view()
+		{
+			auto & parser_ctx = m_input.m_parser_ctx;
+
+			if( !parser_ctx.m_use_header_view )
+				return {};
+
+			return parser_ctx.m_header_view_builder.make_view();
+		}
+
 		//! Calls handler for upgrade request.
 		/*!
 			Request data must be in input context (m_input).
@@ -683,13 +1017,7 @@ class connection_t final
 				connection_upgrade_stage_t::wait_for_upgrade_handling_result_or_nothing;
 
 			if( request_rejected() ==
-				m_request_handler(
-					std::make_shared< request_t >(
-						request_id,
-						std::move( parser_ctx.m_header ),
-						std::move( parser_ctx.m_body ),
-						shared_from_concrete< connection_base_t >(),
-						m_remote_endpoint) ) )
+				m_request_handler( make_request( request_id ) ) )
 			{
 				if( m_socket.is_open() )
 				{
@@ -835,7 +1163,11 @@ class connection_t final
 						response_output_flags,
 						std::move( wg ) );
 
-					init_write_if_necessary();
+					if( m_dispatching_batch )
+						// Write will be started when the batch is dispatched.
+						m_write_deferred = true;
+					else
+						init_write_if_necessary();
 				}
 				else
 				{
@@ -886,7 +1218,8 @@ class connection_t final
 			const bool response_coordinator_full_before =
 				m_response_coordinator.is_full();
 
-			auto next_write_group = m_response_coordinator.pop_ready_buffers();
+			auto next_write_group = m_response_coordinator.pop_ready_buffers(
+					&m_coalesced_responses );
 
 			if( next_write_group )
 			{
@@ -932,6 +1265,26 @@ class connection_t final
 					} );
 				}
 
+				for( const auto & r : m_coalesced_responses )
+				{
+					m_logger.trace( [&]{
+						const auto & item =
+							next_write_group->first.items()[ r.m_item_index ];
+
+						const string_view_t
+							status_line{
+								asio_ns::buffer_cast< const char * >( item.buf() ),
+								r.m_status_line_size };
+
+						return
+							fmt::format(
+								"[connection:{}] start response (#{}): {}",
+								this->connection_id(),
+								r.m_request_id,
+								status_line );
+					} );
+				}
+
 				// Initialize write context with a new write group.
 				m_write_output_ctx.start_next_write_group(
 					std::move( next_write_group->first ) );
@@ -1324,6 +1677,9 @@ class connection_t final
 
 			RESTINIO_ENSURE_NOEXCEPT_CALL( m_response_coordinator.reset() );
 
+			// Connection can be suspended by body consumer.
+			m_suspended_self.reset();
+
 			restinio::utils::log_trace_noexcept( m_logger,
 				[&]{
 					return fmt::format(
@@ -1381,6 +1737,10 @@ class connection_t final
 		//! Response coordinator.
 		response_coordinator_t m_response_coordinator;
 
+		//! Status lines of responses coalesced into the current write group.
+		//! \since v.0.6.2
+		coalesced_responses_t m_coalesced_responses;
+
 		//! Timer to controll operations.
 		//! \{
 
@@ -1483,6 +1843,22 @@ class connection_t final
 				timout_cb );
 		}
 
+		//! Stop guarding of the current operation.
+		/*!
+			Unlike cancel_timeout_checking() timeout checking continues,
+			so the next operation can be guarded by
+			schedule_operation_timeout_callback().
+
+			\since
+			v.0.6.2
+		*/
+		void
+		suspend_operation_timeout_callback() noexcept
+		{
+			m_current_timeout_after = std::chrono::steady_clock::time_point::max();
+			m_current_timeout_cb = nullptr;
+		}
+
 		void
 		handle_xxx_timeout( const char * operation_name )
 		{
@@ -1503,14 +1879,20 @@ class connection_t final
 		}
 
 		//! Statr guard read operation if necessary.
+		/*!
+			Reading isn't guarded while it is suspended by body consumer.
+		*/
 		void
 		guard_read_operation()
 		{
 			if( m_response_coordinator.empty() )
 			{
-				schedule_operation_timeout_callback(
-					m_settings->m_read_next_http_message_timelimit,
-					&connection_t::handle_read_timeout );
+				if( m_input.m_parser_ctx.m_body_reading_suspended )
+					suspend_operation_timeout_callback();
+				else
+					schedule_operation_timeout_callback(
+						m_settings->m_read_next_http_message_timelimit,
+						&connection_t::handle_read_timeout );
 			}
 		}
 
@@ -41,6 +41,19 @@ class connection_base_t
 			response_output_flags_t response_output_flags,
 			//! Part of the response data.
 			write_group_t wg ) = 0;
+
+		//! Resume reading of request body suspended by body consumer.
+		/*!
+			Can be called from any thread.
+
+			\since
+			v.0.6.2
+		*/
+		virtual void
+		resume_incoming_body()
+		{
+			// Nothing to do by default.
+		}
 };
 
 //! Alias for http connection handle.
@@ -14,6 +14,7 @@
 #include <http_parser.h>
 
 #include <restinio/connection_state_listener.hpp>
+#include <restinio/incoming_body.hpp>
 
 #include <restinio/utils/suppress_exceptions.hpp>
 
@@ -141,6 +142,12 @@ struct connection_settings_t final
 		,	m_handle_request_timeout{
 				settings.handle_request_timeout() }
 		,	m_max_pipelined_requests{ settings.max_pipelined_requests() }
+		,	m_batch_pipelined_requests{ settings.batch_pipelined_requests() }
+		,	m_request_arena_size{ settings.request_arena_size() }
+		,	m_zero_copy_header_parsing{ settings.zero_copy_header_parsing() }
+		,	m_incoming_http_msg_limits{ settings.incoming_http_msg_limits() }
+		,	m_incoming_body_consumer_factory{
+				settings.incoming_body_consumer_factory() }
 		,	m_logger{ settings.logger() }
 		,	m_timer_manager{ std::move( timer_manager ) }
 	{
@@ -172,6 +179,41 @@ struct connection_settings_t final
 
 	std::size_t m_max_pipelined_requests;
 
+	//! Are pipelined requests dispatched in batches?
+	/*!
+		\since
+		v.0.6.2
+	*/
+	bool m_batch_pipelined_requests;
+
+	//! Size of per-connection arena for requests data.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	std::size_t m_request_arena_size;
+
+	//! Is zero-copy parsing of header fields used?
+	/*!
+		\since
+		v.0.6.2
+	*/
+	bool m_zero_copy_header_parsing;
+
+	//! Limits for incoming http messages.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	const incoming_http_msg_limits_t m_incoming_http_msg_limits;
+
+	//! Optional factory of consumers for request bodies.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	const incoming_body_consumer_factory_t m_incoming_body_consumer_factory;
+
 	const std::unique_ptr< logger_t > m_logger;
 	//! \}
 
@@ -9,9 +9,11 @@
 #pragma once
 
 #include <array>
+#include <cstring>
 #include <numeric>
 
 #include <restinio/buffers.hpp>
+#include <restinio/incoming_http_msg_limits.hpp>
 
 namespace restinio
 {
@@ -59,11 +61,192 @@ calculate_approx_buffer_size_for_header(
 	return result;
 }
 
+//
+// RESTINIO_HTTP_STATUS_LINES_MAP
+//
+
+//! Standard status codes and reason phrases that have
+//! pre-rendered status lines.
+/*!
+	@since v.0.6.2
+*/
+#define RESTINIO_HTTP_STATUS_LINES_MAP( RESTINIO_GEN ) \
+	RESTINIO_GEN( 100, "Continue" ) \
+	RESTINIO_GEN( 101, "Switching Protocols" ) \
+	RESTINIO_GEN( 102, "Processing" ) \
+	RESTINIO_GEN( 200, "OK" ) \
+	RESTINIO_GEN( 201, "Created" ) \
+	RESTINIO_GEN( 202, "Accepted" ) \
+	RESTINIO_GEN( 203, "Non-Authoritative Information" ) \
+	RESTINIO_GEN( 204, "No Content" ) \
+	RESTINIO_GEN( 205, "Reset Content" ) \
+	RESTINIO_GEN( 206, "Partial Content" ) \
+	RESTINIO_GEN( 207, "Multi-Status" ) \
+	RESTINIO_GEN( 300, "Multiple Choices" ) \
+	RESTINIO_GEN( 301, "Moved Permanently" ) \
+	RESTINIO_GEN( 302, "Found" ) \
+	RESTINIO_GEN( 303, "See Other" ) \
+	RESTINIO_GEN( 304, "Not Modified" ) \
+	RESTINIO_GEN( 305, "Use Proxy" ) \
+	RESTINIO_GEN( 307, "Temporary Redirect" ) \
+	RESTINIO_GEN( 308, "Permanent Redirect" ) \
+	RESTINIO_GEN( 400, "Bad Request" ) \
+	RESTINIO_GEN( 401, "Unauthorized" ) \
+	RESTINIO_GEN( 402, "Payment Required" ) \
+	RESTINIO_GEN( 403, "Forbidden" ) \
+	RESTINIO_GEN( 404, "Not Found" ) \
+	RESTINIO_GEN( 405, "Method Not Allowed" ) \
+	RESTINIO_GEN( 406, "Not Acceptable" ) \
+	RESTINIO_GEN( 407, "Proxy Authentication Required" ) \
+	RESTINIO_GEN( 408, "Request Timeout" ) \
+	RESTINIO_GEN( 409, "Conflict" ) \
+	RESTINIO_GEN( 410, "Gone" ) \
+	RESTINIO_GEN( 411, "Length Required" ) \
+	RESTINIO_GEN( 412, "Precondition Failed" ) \
+	RESTINIO_GEN( 413, "Payload Too Large" ) \
+	RESTINIO_GEN( 414, "URI Too Long" ) \
+	RESTINIO_GEN( 415, "Unsupported Media Type" ) \
+	RESTINIO_GEN( 416, "Requested Range Not Satisfiable" ) \
+	RESTINIO_GEN( 417, "Expectation Failed" ) \
+	RESTINIO_GEN( 422, "Unprocessable Entity" ) \
+	RESTINIO_GEN( 423, "Locked" ) \
+	RESTINIO_GEN( 424, "Failed Dependency" ) \
+	RESTINIO_GEN( 428, "Precondition Required" ) \
+	RESTINIO_GEN( 429, "Too Many Requests" ) \
+	RESTINIO_GEN( 431, "Request Header Fields Too Large" ) \
+	RESTINIO_GEN( 500, "Internal Server Error" ) \
+	RESTINIO_GEN( 501, "Not Implemented" ) \
+	RESTINIO_GEN( 502, "Bad Gateway" ) \
+	RESTINIO_GEN( 503, "Service Unavailable" ) \
+	RESTINIO_GEN( 504, "Gateway Timeout" ) \
+	RESTINIO_GEN( 505, "HTTP Version not supported" ) \
+	RESTINIO_GEN( 507, "Insufficient Storage" ) \
+	RESTINIO_GEN( 511, "Network Authentication Required" )
+
+//
+// prerendered_status_line()
+//
+
+//! Get a pre-rendered status line (including "\r\n") for a header.
+/*!
+	Returns an empty string if the header has a non-standard
+	status code or reason phrase or HTTP version isn't 1.1.
+
+	@since v.0.6.2
+*/
+inline string_view_t
+prerendered_status_line( const http_response_header_t & h ) noexcept
+{
+	if( 1 != h.http_major() || 1 != h.http_minor() )
+		return string_view_t{};
+
+	string_view_t line;
+	switch( h.status_code().raw_code() )
+	{
+#define RESTINIO_GEN( code, reason ) \
+		case code: \
+			line = string_view_t{ \
+				"HTTP/1.1 " #code " " reason "\r\n", \
+				ct_string_len( "HTTP/1.1 " #code " " reason "\r\n" ) }; \
+		break;
+
+	RESTINIO_HTTP_STATUS_LINES_MAP( RESTINIO_GEN )
+#undef RESTINIO_GEN
+
+		default:
+			return string_view_t{};
+	}
+
+	// "HTTP/1.1 xxx " is 13 chars.
+	const auto & reason = h.reason_phrase();
+	if( line.size() != 13u + reason.size() + 2u ||
+		0 != std::memcmp( line.data() + 13u, reason.data(), reason.size() ) )
+		return string_view_t{};
+
+	return line;
+}
+
+//
+// decimal_digits_count()
+//
+
+//! Get the count of decimal digits of a number.
+/*!
+	@since v.0.6.2
+*/
+inline std::size_t
+decimal_digits_count( std::uint64_t v ) noexcept
+{
+	std::size_t result = 1u;
+	for( ; 10u <= v; v /= 10u )
+		++result;
+
+	return result;
+}
+
+//
+// write_decimal()
+//
+
+//! Write a number of \a digits decimal digits to \a out.
+/*!
+	Two digits are taken at once from a table,
+	locales are not used.
+
+	@return A pointer to the char that follows the number.
+
+	@since v.0.6.2
+*/
+inline char *
+write_decimal( char * out, std::uint64_t v, std::size_t digits ) noexcept
+{
+	constexpr const char pairs[] =
+		"00010203040506070809"
+		"10111213141516171819"
+		"20212223242526272829"
+		"30313233343536373839"
+		"40414243444546474849"
+		"50515253545556575859"
+		"60616263646566676869"
+		"70717273747576777879"
+		"80818283848586878889"
+		"90919293949596979899";
+
+	char * const end = out + digits;
+	char * p = end;
+	while( 100u <= v )
+	{
+		const auto i = static_cast< std::size_t >( v % 100u ) * 2u;
+		v /= 100u;
+		*--p = pairs[ i + 1u ];
+		*--p = pairs[ i ];
+	}
+
+	if( 10u <= v )
+	{
+		const auto i = static_cast< std::size_t >( v ) * 2u;
+		*--p = pairs[ i + 1u ];
+		*--p = pairs[ i ];
+	}
+	else
+		*--p = static_cast< char >( '0' + v );
+
+	return end;
+}
+
 //
 // create_header_string()
 //
 
 //! Creates a string for http response header.
+/*!
+	The exact size of the header is calculated first, so the string
+	is allocated once and then filled in a single pass.
+	Status lines for standard status codes are pre-rendered.
+
+	\a buffer_size (if not 0) is the capacity that should be reserved
+	for the resulting string.
+*/
 inline std::string
 create_header_string(
 	const http_response_header_t & h,
@@ -71,83 +254,112 @@ create_header_string(
 		content_length_field_presence_t::add_content_length,
 	std::size_t buffer_size = 0 )
 {
-	std::string result;
+	constexpr const char header_rn[] = "\r\n";
+	constexpr const char header_field_sep[] = ": ";
+	constexpr const char header_content_length[] = "Content-Length: ";
 
-	if( 0 != buffer_size )
-		result.reserve( buffer_size );
-	else
-		result.reserve( calculate_approx_buffer_size_for_header( h ) );
+	constexpr const char header_keep_alive[] = "Connection: keep-alive\r\n";
+	constexpr const char header_close[] = "Connection: close\r\n";
+	constexpr const char header_upgrade[] = "Connection: Upgrade\r\n";
 
-	constexpr const char header_part1[] = "HTTP/";
-	result.append( header_part1, ct_string_len( header_part1 ) );
+	const auto status_line = prerendered_status_line( h );
 
-	result += static_cast<char>( '0' + h.http_major() );
-	result += '.';
-	result += static_cast<char>( '0' + h.http_minor() );
-	result += ' ';
+	string_view_t connection;
+	switch( h.connection() )
+	{
+		case http_connection_header_t::keep_alive:
+			connection = string_view_t{
+					header_keep_alive, ct_string_len( header_keep_alive ) };
+		break;
 
-	const auto sc = h.status_code().raw_code();
+		case http_connection_header_t::close:
+			connection = string_view_t{
+					header_close, ct_string_len( header_close ) };
+		break;
 
-//FIXME: there should be a check for status_code in range 100..999.
-//May be a special type like bounded_value_t<100,999> must be used in
-//http_response_header_t.
-	result += '0' + ( sc / 100 ) % 10;
-	result += '0' + ( sc / 10 ) % 10;
-	result += '0' + ( sc ) % 10;
+		case http_connection_header_t::upgrade:
+			connection = string_view_t{
+					header_upgrade, ct_string_len( header_upgrade ) };
+		break;
+	}
 
-	result += ' ';
-	result += h.reason_phrase();
+	const bool add_content_length =
+		content_length_field_presence_t::add_content_length ==
+			content_length_field_presence;
+	const std::uint64_t content_length = h.content_length();
+	const auto content_length_digits = decimal_digits_count( content_length );
 
-	constexpr const char header_rn[] = "\r\n";
-	result.append( header_rn, ct_string_len( header_rn ) );
+	// Calculate the size of the header.
+	std::size_t size = status_line.empty() ?
+			// "HTTP/x.y xxx " + reason + "\r\n"
+			13u + h.reason_phrase().size() + 2u :
+			status_line.size();
 
-	switch( h.connection() )
+	size += connection.size();
+
+	if( add_content_length )
+		size += ct_string_len( header_content_length ) + content_length_digits + 2u;
+
+	h.for_each_field( [&size](const auto & f) noexcept {
+			size += f.name().size() + 2u + f.value().size() + 2u;
+		} );
+
+	size += 2u;
+
+	std::string result;
+	if( buffer_size > size )
+		result.reserve( buffer_size );
+	result.resize( size );
+
+	char * p = &result[ 0 ];
+	const auto append = [&p]( const char * data, std::size_t n ) noexcept {
+		std::memcpy( p, data, n );
+		p += n;
+	};
+
+	if( !status_line.empty() )
+		append( status_line.data(), status_line.size() );
+	else
 	{
-		case http_connection_header_t::keep_alive:
-		{
-			constexpr const char header_part2_1[] = "Connection: keep-alive\r\n";
-			result.append( header_part2_1, ct_string_len( header_part2_1 ) );
-			break;
-		}
+		constexpr const char header_part1[] = "HTTP/";
+		append( header_part1, ct_string_len( header_part1 ) );
 
-		case http_connection_header_t::close:
-		{
-			constexpr const char header_part2_2[] = "Connection: close\r\n";
-			result.append( header_part2_2, ct_string_len( header_part2_2 ) );
-			break;
-		}
+		*p++ = static_cast<char>( '0' + h.http_major() );
+		*p++ = '.';
+		*p++ = static_cast<char>( '0' + h.http_minor() );
+		*p++ = ' ';
 
-		case http_connection_header_t::upgrade:
-		{
-			constexpr const char header_part2_3[] = "Connection: Upgrade\r\n";
-			result.append( header_part2_3, ct_string_len( header_part2_3 ) );
-			break;
-		}
+		const auto sc = h.status_code().raw_code();
+
+//FIXME: there should be a check for status_code in range 100..999.
+//May be a special type like bounded_value_t<100,999> must be used in
+//http_response_header_t.
+		*p++ = static_cast<char>( '0' + ( sc / 100 ) % 10 );
+		*p++ = static_cast<char>( '0' + ( sc / 10 ) % 10 );
+		*p++ = static_cast<char>( '0' + ( sc ) % 10 );
+
+		*p++ = ' ';
+		append( h.reason_phrase().data(), h.reason_phrase().size() );
+		append( header_rn, ct_string_len( header_rn ) );
 	}
 
-	if( content_length_field_presence_t::add_content_length ==
-		content_length_field_presence )
+	append( connection.data(), connection.size() );
+
+	if( add_content_length )
 	{
-		std::array< char, 64 > buf{};
-		const auto n =
-			std::snprintf(
-				buf.data(),
-				buf.size(),
-				"Content-Length: %llu\r\n",
-				static_cast< unsigned long long >( h.content_length() ) );
-
-		result.append( buf.data(), static_cast<std::string::size_type>(n) );
+		append( header_content_length, ct_string_len( header_content_length ) );
+		p = write_decimal( p, content_length, content_length_digits );
+		append( header_rn, ct_string_len( header_rn ) );
 	}
 
-	constexpr const char header_field_sep[] = ": ";
-	h.for_each_field( [&result, header_field_sep, header_rn](const auto & f) {
-		result += f.name();
-		result.append( header_field_sep, ct_string_len( header_field_sep ) );
-		result += f.value();
-		result.append( header_rn, ct_string_len( header_rn ) );
+	h.for_each_field( [&append, header_field_sep, header_rn](const auto & f) {
+		append( f.name().data(), f.name().size() );
+		append( header_field_sep, ct_string_len( header_field_sep ) );
+		append( f.value().data(), f.value().size() );
+		append( header_rn, ct_string_len( header_rn ) );
 	} );
 
-	result.append( header_rn, ct_string_len( header_rn ) );
+	append( header_rn, ct_string_len( header_rn ) );
 
 	return result;
 }
@@ -180,6 +392,52 @@ create_timeout_resp()
 	return result;
 }
 
+//! Create a response for a message that exceeds a limit.
+/*!
+	@since v.0.6.2
+*/
+inline auto
+create_limit_exceeded_resp( incoming_http_msg_limit_t limit )
+{
+	constexpr const char raw_413_response[] =
+		"HTTP/1.1 413 Payload Too Large\r\n"
+		"Connection: close\r\n"
+		"Content-Length: 0\r\n"
+		"\r\n";
+
+	constexpr const char raw_414_response[] =
+		"HTTP/1.1 414 URI Too Long\r\n"
+		"Connection: close\r\n"
+		"Content-Length: 0\r\n"
+		"\r\n";
+
+	constexpr const char raw_431_response[] =
+		"HTTP/1.1 431 Request Header Fields Too Large\r\n"
+		"Connection: close\r\n"
+		"Content-Length: 0\r\n"
+		"\r\n";
+
+	writable_items_container_t result;
+
+	switch( limit )
+	{
+		case incoming_http_msg_limit_t::url_size:
+			result.emplace_back( raw_414_response );
+		break;
+
+		case incoming_http_msg_limit_t::header_size:
+		case incoming_http_msg_limit_t::field_count:
+			result.emplace_back( raw_431_response );
+		break;
+
+		case incoming_http_msg_limit_t::body_size:
+			result.emplace_back( raw_413_response );
+		break;
+	}
+
+	return result;
+}
+
 } /* namespace impl */
 
 } /* namespace restinio */
@@ -0,0 +1,204 @@
+/*
+	restinio
+*/
+
+/*!
+	A pool of threads where every thread runs its own io_context.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <thread>
+#include <memory>
+#include <vector>
+
+#if defined(__linux__)
+	#include <pthread.h>
+	#include <sched.h>
+#endif
+
+#include <restinio/asio_include.hpp>
+
+#include <restinio/exception.hpp>
+
+namespace restinio
+{
+
+namespace impl
+{
+
+//
+// pin_thread_to_core
+//
+
+//! Try to bind a thread to the specified CPU core.
+/*!
+	Binding is just an optimization, so failures are ignored.
+	Does nothing on platforms where it is not supported.
+
+	@since v.0.6.2
+*/
+inline void
+pin_thread_to_core(
+	std::thread & thread,
+	std::size_t core ) noexcept
+{
+#if defined(__linux__)
+	cpu_set_t cpuset;
+	CPU_ZERO( &cpuset );
+	CPU_SET( static_cast< int >( core % CPU_SETSIZE ), &cpuset );
+
+	(void)pthread_setaffinity_np(
+			thread.native_handle(), sizeof( cpuset ), &cpuset );
+#else
+	(void)thread;
+	(void)core;
+#endif
+}
+
+/*!
+ * Helper class for running a separate io_context on every thread
+ * of a thread pool.
+ *
+ * Unlike ioctx_on_thread_pool_t where all threads share the same
+ * io_context every thread of this pool has its own io_context
+ * and all handlers posted to that io_context are run only on that
+ * thread.
+ *
+ * \note class is not thread-safe (except `io_context()` method).
+ * Expected usage scenario is to start and stop it on the same thread.
+ *
+ * \since
+ * v.0.6.2
+ */
+class ioctx_per_thread_pool_t
+{
+	public:
+		ioctx_per_thread_pool_t( const ioctx_per_thread_pool_t & ) = delete;
+		ioctx_per_thread_pool_t( ioctx_per_thread_pool_t && ) = delete;
+
+		ioctx_per_thread_pool_t(
+			//! Pool size.
+			std::size_t pool_size,
+			//! Should threads be bound to CPU cores.
+			bool pin_threads )
+			:	m_pool( pool_size )
+			,	m_pin_threads{ pin_threads }
+			,	m_status( status_t::stopped )
+		{
+			if( 0u == pool_size )
+				throw exception_t{ "pool size cannot be zero" };
+
+			m_contexts.reserve( pool_size );
+			for( std::size_t i = 0; i != pool_size; ++i )
+				m_contexts.emplace_back( std::make_unique< asio_ns::io_context >( 1 ) );
+		}
+
+		// Makes sure the pool is stopped.
+		~ioctx_per_thread_pool_t()
+		{
+			if( started() )
+			{
+				stop();
+				wait();
+			}
+		}
+
+		void
+		start()
+		{
+			if( started() )
+			{
+				throw exception_t{
+					"io_context_per_thread_pool is already started" };
+			}
+
+			try
+			{
+				for( std::size_t i = 0; i != m_pool.size(); ++i )
+				{
+					m_pool[ i ] = std::thread{ [ioctx = m_contexts[ i ].get()] {
+							auto work{ asio_ns::make_work_guard( *ioctx ) };
+
+							ioctx->run();
+						} };
+
+					if( m_pin_threads )
+						pin_thread_to_core( m_pool[ i ], i );
+				}
+
+				// When all thread started successfully
+				// status can be changed.
+				m_status = status_t::started;
+			}
+			catch( const std::exception & )
+			{
+				stop_all_contexts();
+				for( auto & t : m_pool )
+					if( t.joinable() )
+						t.join();
+
+				throw;
+			}
+		}
+
+		void
+		stop()
+		{
+			if( started() )
+			{
+				stop_all_contexts();
+			}
+		}
+
+		void
+		wait()
+		{
+			if( started() )
+			{
+				for( auto & t : m_pool )
+					t.join();
+
+				// When all threads are stopped status can be changed.
+				m_status = status_t::stopped;
+			}
+		}
+
+		bool started() const noexcept { return status_t::started == m_status; }
+
+		//! Get the count of threads (and io_contexts).
+		std::size_t size() const noexcept { return m_contexts.size(); }
+
+		//! Get io_context for the thread with index \a i.
+		asio_ns::io_context &
+		io_context( std::size_t i ) noexcept
+		{
+			return *(m_contexts[ i ]);
+		}
+
+	private:
+		enum class status_t : std::uint8_t { stopped, started };
+
+		void
+		stop_all_contexts() noexcept
+		{
+			for( auto & ctx : m_contexts )
+				ctx->stop();
+		}
+
+		//! io_context for every thread.
+		/*!
+			Instances are allocated dynamically because io_context
+			is neither copyable nor movable.
+		*/
+		std::vector< std::unique_ptr< asio_ns::io_context > > m_contexts;
+		std::vector< std::thread > m_pool;
+		const bool m_pin_threads;
+		status_t m_status;
+};
+
+} /* namespace impl */
+
+} /* namespace restinio */
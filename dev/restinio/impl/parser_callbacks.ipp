@@ -6,6 +6,45 @@
 	Callbacks used with http parser.
 */
 
+//! Check a size of the current message against a limit.
+/*!
+	Remembers the exceeded limit in the context.
+
+	\since
+	v.0.6.2
+*/
+inline bool
+is_limit_exceeded(
+	http_parser_ctx_t & ctx,
+	incoming_http_msg_limit_t limit,
+	std::uint64_t value,
+	std::uint64_t max_value ) noexcept
+{
+	if( value > max_value )
+	{
+		ctx.m_exceeded_limit = limit;
+		return true;
+	}
+
+	return false;
+}
+
+//! Check the total size of the header of the current message.
+/*!
+	\since
+	v.0.6.2
+*/
+inline bool
+is_header_size_exceeded( http_parser_ctx_t & ctx, std::size_t length ) noexcept
+{
+	ctx.m_header_size += length;
+
+	return is_limit_exceeded( ctx,
+			incoming_http_msg_limit_t::header_size,
+			ctx.m_header_size,
+			ctx.m_limits.max_header_size() );
+}
+
 inline int
 restinio_url_cb( http_parser * parser, const char * at, size_t length )
 {
@@ -15,6 +54,18 @@ restinio_url_cb( http_parser * parser, const char * at, size_t length )
 			reinterpret_cast< restinio::impl::http_parser_ctx_t * >(
 				parser->data );
 
+		ctx->m_url_size += length;
+		if( is_limit_exceeded( *ctx,
+				incoming_http_msg_limit_t::url_size,
+				ctx->m_url_size,
+				ctx->m_limits.max_url_size() ) ||
+			is_header_size_exceeded( *ctx, length ) )
+			return 1;
+
+		if( ctx->m_use_header_view )
+			ctx->m_header_view_builder.append_request_target( at, length );
+
+		// Request target is also necessary for routers.
 		ctx->m_header.append_request_target( at, length );
 	}
 	catch( const std::exception & )
@@ -34,15 +85,31 @@ restinio_header_field_cb( http_parser * parser, const char *at, size_t length )
 			reinterpret_cast< restinio::impl::http_parser_ctx_t * >(
 				parser->data );
 
-		if( ctx->m_last_was_value )
+		// A name of a new field is started.
+		if( ctx->m_last_was_value &&
+			is_limit_exceeded( *ctx,
+				incoming_http_msg_limit_t::field_count,
+				++( ctx->m_field_count ),
+				ctx->m_limits.max_field_count() ) )
+			return 1;
+
+		if( is_header_size_exceeded( *ctx, length ) )
+			return 1;
+
+		if( ctx->m_use_header_view )
+		{
+			ctx->m_header_view_builder.append_field_name( at, length );
+		}
+		else if( ctx->m_last_was_value )
 		{
 			ctx->m_current_field_name.assign( at, length );
-			ctx->m_last_was_value = false;
 		}
 		else
 		{
 			ctx->m_current_field_name.append( at, length );
 		}
+
+		ctx->m_last_was_value = false;
 	}
 	catch( const std::exception & )
 	{
@@ -66,18 +133,25 @@ restinio_header_value_cb( http_parser * parser, const char *at, size_t length )
 		auto * ctx =
 			reinterpret_cast< restinio::impl::http_parser_ctx_t * >( parser->data );
 
-		if( !ctx->m_last_was_value )
+		if( is_header_size_exceeded( *ctx, length ) )
+			return 1;
+
+		if( ctx->m_use_header_view )
+		{
+			ctx->m_header_view_builder.append_field_value( at, length );
+		}
+		else if( !ctx->m_last_was_value )
 		{
 			ctx->m_header.set_field(
 				std::move( ctx->m_current_field_name ),
 				std::string{ at, length } );
-
-			ctx->m_last_was_value = true;
 		}
 		else
 		{
 			append_last_field_accessor( ctx->m_header, std::string{ at, length } );
 		}
+
+		ctx->m_last_was_value = true;
 	}
 	catch( const std::exception & )
 	{
@@ -87,26 +161,60 @@ restinio_header_value_cb( http_parser * parser, const char *at, size_t length )
 	return 0;
 }
 
-inline int
+template< typename Http_Methods >
+int
 restinio_headers_complete_cb( http_parser * parser )
 {
-	if( ULLONG_MAX != parser->content_length &&
-		0 < parser->content_length )
+	try
 	{
-		try
+		auto * ctx =
+			reinterpret_cast< restinio::impl::http_parser_ctx_t * >(
+				parser->data );
+
+		if( ctx->m_use_header_view )
+			ctx->m_header_view_builder.on_headers_complete(
+					ctx->m_header, 0 != parser->upgrade );
+
+		if( ctx->m_body_consumer_factory && 0 == parser->upgrade )
 		{
-			auto * ctx =
-				reinterpret_cast< restinio::impl::http_parser_ctx_t * >(
-					parser->data );
+			// Body consumer factory should see the method of the request.
+			ctx->m_header.method( Http_Methods::from_nodejs( parser->method ) );
+
+			ctx->m_body_consumer = ( *ctx->m_body_consumer_factory )(
+					ctx->m_header );
+
+			if( ctx->m_body_consumer )
+			{
+				attach_connection_to_body_consumer(
+						*( ctx->m_body_consumer ),
+						ctx->m_connection );
+
+				// Body won't be collected, no need to reserve memory for it.
+				return 0;
+			}
+		}
+
+		if( ULLONG_MAX != parser->content_length &&
+			0 < parser->content_length )
+		{
+			// Memory for the body shouldn't be reserved
+			// if the body is too big.
+			if( is_limit_exceeded( *ctx,
+					incoming_http_msg_limit_t::body_size,
+					parser->content_length,
+					ctx->m_limits.max_body_size() ) )
+				return -1;
 
 			ctx->m_body.reserve(
 					::restinio::utils::impl::uint64_to_size_t(
 							parser->content_length) );
 		}
-		catch( const std::exception & )
-		{
-			return 1;
-		}
+	}
+	catch( const std::exception & )
+	{
+		// NOTE: 1 and 2 have special meaning for on_headers_complete,
+		// any other non-zero value is treated as an error.
+		return -1;
 	}
 
 	return 0;
@@ -122,7 +230,28 @@ restinio_body_cb( http_parser * parser, const char *at, size_t length )
 			reinterpret_cast< restinio::impl::http_parser_ctx_t * >(
 				parser->data );
 
-		ctx->m_body.append( at, length );
+		if( ctx->m_body_consumer )
+		{
+			if( incoming_body_flow_t::suspend ==
+				ctx->m_body_consumer->consume_chunk(
+						string_view_t{ at, length } ) )
+			{
+				// Parser should be stopped until consumer resumes reading.
+				ctx->m_body_reading_suspended = true;
+				http_parser_pause( parser, 1 );
+			}
+		}
+		else
+		{
+			// Size of chunked body isn't known in advance.
+			if( is_limit_exceeded( *ctx,
+					incoming_http_msg_limit_t::body_size,
+					ctx->m_body.size() + length,
+					ctx->m_limits.max_body_size() ) )
+				return 1;
+
+			ctx->m_body.append( at, length );
+		}
 	}
 	catch( const std::exception & )
 	{
@@ -0,0 +1,296 @@
+/*
+	restinio
+*/
+
+/*!
+	Per-connection arena for request data.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace restinio
+{
+
+namespace impl
+{
+
+//
+// request_arena_t
+//
+
+//! Monotonic memory arena for data of incoming requests.
+/*!
+	Memory is carved from a single buffer by moving the offset and
+	individual blocks are never reused. The whole buffer is reused when
+	all blocks are returned to the arena, so for sequential requests
+	on a connection the same memory is used again and again.
+	If the buffer is exhausted (for example a handler holds several
+	pipelined requests) blocks are allocated from the heap.
+
+	New blocks must be allocated on the context of the connection
+	only, but blocks can be returned from any thread.
+
+	Lifetime of the arena is controlled by reference counter:
+	every arena_allocator_t holds a reference, so the arena
+	outlives the connection if requests are still alive.
+
+	@since v.0.6.2
+*/
+class request_arena_t
+{
+		static constexpr std::size_t block_alignment = alignof( std::max_align_t );
+
+	public:
+		request_arena_t( const request_arena_t & ) = delete;
+		request_arena_t & operator=( const request_arena_t & ) = delete;
+
+		//! Create a new arena with one reference.
+		static request_arena_t *
+		make( std::size_t capacity )
+		{
+			return new request_arena_t{ capacity };
+		}
+
+		void
+		add_ref() noexcept
+		{
+			m_references.fetch_add( 1u, std::memory_order_relaxed );
+		}
+
+		void
+		release() noexcept
+		{
+			if( 1u == m_references.fetch_sub( 1u, std::memory_order_acq_rel ) )
+				delete this;
+		}
+
+		//! Allocate a block of memory.
+		void *
+		allocate( std::size_t size )
+		{
+			// There are no alive blocks, so the whole buffer can be reused.
+			if( 0u == m_alive_blocks.load( std::memory_order_acquire ) )
+				m_offset = 0u;
+
+			const std::size_t aligned_size =
+					( size + block_alignment - 1u ) / block_alignment * block_alignment;
+
+			if( aligned_size <= m_capacity - m_offset )
+			{
+				void * result = m_buffer.get() + m_offset;
+				m_offset += aligned_size;
+				m_alive_blocks.fetch_add( 1u, std::memory_order_relaxed );
+
+				return result;
+			}
+
+			return ::operator new( size );
+		}
+
+		//! Return a block of memory.
+		void
+		deallocate( void * p ) noexcept
+		{
+			if( is_owned( p ) )
+				m_alive_blocks.fetch_sub( 1u, std::memory_order_release );
+			else
+				::operator delete( p );
+		}
+
+		//! Size of the buffer of the arena.
+		std::size_t
+		capacity() const noexcept { return m_capacity; }
+
+		//! Count of blocks allocated from the buffer and not returned yet.
+		std::size_t
+		alive_blocks() const noexcept
+		{
+			return m_alive_blocks.load( std::memory_order_acquire );
+		}
+
+	private:
+		explicit request_arena_t( std::size_t capacity )
+			:	m_capacity{ capacity }
+			,	m_buffer{ static_cast< unsigned char * >(
+					::operator new( capacity ) ) }
+		{}
+
+		struct buffer_deleter_t
+		{
+			void operator()( unsigned char * p ) const noexcept
+			{
+				::operator delete( p );
+			}
+		};
+
+		bool
+		is_owned( const void * p ) const noexcept
+		{
+			const auto * b = static_cast< const unsigned char * >( p );
+			return std::less_equal< const unsigned char * >{}( m_buffer.get(), b ) &&
+				std::less< const unsigned char * >{}( b, m_buffer.get() + m_capacity );
+		}
+
+		const std::size_t m_capacity;
+
+		//! Buffer for blocks.
+		/*!
+			Is allocated by operator new, so it is aligned
+			for any fundamental type.
+		*/
+		const std::unique_ptr< unsigned char, buffer_deleter_t > m_buffer;
+
+		//! Offset of the free part of the buffer.
+		/*!
+			Is modified only on the context of the connection.
+		*/
+		std::size_t m_offset{ 0u };
+
+		std::atomic< std::size_t > m_references{ 1u };
+		std::atomic< std::size_t > m_alive_blocks{ 0u };
+};
+
+//
+// request_arena_handle_t
+//
+
+//! Smart pointer to request_arena_t.
+/*!
+	@since v.0.6.2
+*/
+class request_arena_handle_t
+{
+	public:
+		request_arena_handle_t() noexcept = default;
+
+		//! Create a new arena with specified capacity.
+		explicit request_arena_handle_t( std::size_t capacity )
+			:	m_arena{ request_arena_t::make( capacity ) }
+		{}
+
+		request_arena_handle_t( const request_arena_handle_t & o ) noexcept
+			:	m_arena{ o.m_arena }
+		{
+			if( m_arena )
+				m_arena->add_ref();
+		}
+
+		request_arena_handle_t( request_arena_handle_t && o ) noexcept
+			:	m_arena{ o.m_arena }
+		{
+			o.m_arena = nullptr;
+		}
+
+		~request_arena_handle_t()
+		{
+			if( m_arena )
+				m_arena->release();
+		}
+
+		request_arena_handle_t &
+		operator=( request_arena_handle_t o ) noexcept
+		{
+			std::swap( m_arena, o.m_arena );
+			return *this;
+		}
+
+		request_arena_t * get() const noexcept { return m_arena; }
+		request_arena_t * operator->() const noexcept { return m_arena; }
+
+		explicit operator bool() const noexcept { return nullptr != m_arena; }
+
+	private:
+		request_arena_t * m_arena{ nullptr };
+};
+
+//
+// arena_allocator_t
+//
+
+//! Allocator that uses request_arena_t if it is set and heap otherwise.
+/*!
+	Containers copied from a container that uses the arena
+	get a default (heap) allocator, so long living copies of
+	request data don't pin the memory of the arena.
+	But moved containers take the arena with them.
+
+	@since v.0.6.2
+*/
+template< typename T >
+class arena_allocator_t
+{
+		template< typename U > friend class arena_allocator_t;
+
+	public:
+		using value_type = T;
+
+		using propagate_on_container_copy_assignment = std::false_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		arena_allocator_t() noexcept = default;
+
+		explicit arena_allocator_t( request_arena_handle_t arena ) noexcept
+			:	m_arena{ std::move( arena ) }
+		{}
+
+		template< typename U >
+		arena_allocator_t( const arena_allocator_t< U > & o ) noexcept
+			:	m_arena{ o.m_arena }
+		{}
+
+		T *
+		allocate( std::size_t n )
+		{
+			const std::size_t size = n * sizeof( T );
+			return static_cast< T * >(
+					m_arena ? m_arena->allocate( size ) : ::operator new( size ) );
+		}
+
+		void
+		deallocate( T * p, std::size_t ) noexcept
+		{
+			if( m_arena )
+				m_arena->deallocate( p );
+			else
+				::operator delete( p );
+		}
+
+		arena_allocator_t
+		select_on_container_copy_construction() const noexcept
+		{
+			return {};
+		}
+
+		const request_arena_handle_t &
+		arena() const noexcept { return m_arena; }
+
+		template< typename U >
+		bool
+		operator==( const arena_allocator_t< U > & o ) const noexcept
+		{
+			return m_arena.get() == o.m_arena.get();
+		}
+
+		template< typename U >
+		bool
+		operator!=( const arena_allocator_t< U > & o ) const noexcept
+		{
+			return !( *this == o );
+		}
+
+	private:
+		request_arena_handle_t m_arena;
+};
+
+} /* namespace impl */
+
+} /* namespace restinio */
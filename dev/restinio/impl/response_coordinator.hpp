@@ -11,6 +11,7 @@
 
 #include <string>
 #include <deque>
+#include <vector>
 
 #include <restinio/impl/include_fmtlib.hpp>
 
@@ -268,6 +269,32 @@ class response_context_table_t
 		std::size_t m_elements_exists{0};
 };
 
+//
+// coalesced_response_t
+//
+
+//! A response that starts in the middle of a coalesced write group.
+/*!
+	The status line of such response isn't described by
+	write_group_t::status_line_size() of the group.
+
+	\since
+	v.0.6.2
+*/
+struct coalesced_response_t
+{
+	//! Id of the request of the response.
+	request_id_t m_request_id;
+	//! Index of the item with the status line in the write group.
+	std::size_t m_item_index;
+	//! Size of the status line at the beginning of that item.
+	std::size_t m_status_line_size;
+};
+
+//! A container for information about coalesced responses.
+//! \since v.0.6.2
+using coalesced_responses_t = std::vector< coalesced_response_t >;
+
 //
 // response_coordinator_t
 //
@@ -284,8 +311,11 @@ class response_coordinator_t
 	public:
 		response_coordinator_t(
 			//! Maximum count of requests to keep track of.
-			std::size_t max_req_count )
+			std::size_t max_req_count,
+			//! Should ready responses be coalesced into a single write group?
+			bool coalesce_responses = false )
 			:	m_context_table{ max_req_count }
+			,	m_coalesce_responses{ coalesce_responses }
 		{}
 
 		/** @name Response coordinator state.
@@ -360,10 +390,25 @@ class response_coordinator_t
 			It can have a stats line mark (that is necessary for logging)
 			and a notificator that must be invoked after the write operation
 			of a given group completes.
+
+			If coalescing of responses is turned on then data of the
+			following responses that is already available is appended
+			to the group (until a group with a notificator or
+			a response that closes the connection is met).
+			The returned request id is the id of the first response.
+			Status lines of the appended responses are described in
+			\a coalesced (if it isn't null) as write_group_t
+			keeps only the status line of its first item.
 		*/
 		optional_t< std::pair< write_group_t, request_id_t > >
-		pop_ready_buffers()
+		pop_ready_buffers(
+			//! Receiver of status lines of coalesced responses.
+			//! \since v.0.6.2
+			coalesced_responses_t * coalesced = nullptr )
 		{
+			if( coalesced )
+				coalesced->clear();
+
 			if( closed() )
 				throw exception_t{
 					"unable to prepare output buffers, "
@@ -378,21 +423,11 @@ class response_coordinator_t
 
 				if( !current_ctx.empty() )
 				{
-					result =
-						std::make_pair(
-							current_ctx.dequeue_group(),
-							current_ctx.request_id() );
-
-					if( current_ctx.is_complete() )
-					{
-						m_connection_closed_response_occured =
-							( response_parts_attr_t::final_parts ==
-								current_ctx.response_output_flags().m_response_parts )
-							&&( response_connection_attr_t::connection_close ==
-								current_ctx.response_output_flags().m_response_connection );
-
-						m_context_table.pop_response_context();
-					}
+					const auto request_id = current_ctx.request_id();
+					result = std::make_pair( dequeue_front_group(), request_id );
+
+					if( m_coalesce_responses )
+						coalesce_ready_groups( result->first, coalesced );
 				}
 			}
 
@@ -438,6 +473,58 @@ class response_coordinator_t
 		}
 
 	private:
+		//! Take the first group of the first response.
+		/*!
+			The response is removed if it is complete.
+		*/
+		write_group_t
+		dequeue_front_group()
+		{
+			auto & current_ctx = m_context_table.front();
+
+			write_group_t result = current_ctx.dequeue_group();
+
+			if( current_ctx.is_complete() )
+			{
+				m_connection_closed_response_occured =
+					( response_parts_attr_t::final_parts ==
+						current_ctx.response_output_flags().m_response_parts )
+					&&( response_connection_attr_t::connection_close ==
+						current_ctx.response_output_flags().m_response_connection );
+
+				m_context_table.pop_response_context();
+			}
+
+			return result;
+		}
+
+		//! Append ready groups of the following responses to \a wg.
+		void
+		coalesce_ready_groups(
+			write_group_t & wg,
+			coalesced_responses_t * coalesced )
+		{
+			// Groups are taken only from the front response,
+			// so responses that are not complete stop the loop.
+			while( !wg.has_after_write_notificator() &&
+				!closed() &&
+				!m_context_table.empty() &&
+				!m_context_table.front().empty() )
+			{
+				const auto request_id = m_context_table.front().request_id();
+				auto next = dequeue_front_group();
+
+				// merge() drops the status line size of the second group.
+				if( coalesced && 0u != next.status_line_size() )
+					coalesced->push_back( coalesced_response_t{
+							request_id,
+							wg.items_count(),
+							next.status_line_size() } );
+
+				wg.merge( std::move( next ) );
+			}
+		}
+
 		//! Counter for asigining id to new requests.
 		request_id_t m_request_id_counter{ 0 };
 
@@ -446,6 +533,13 @@ class response_coordinator_t
 
 		//! A storage for resp-context items.
 		response_context_table_t m_context_table;
+
+		//! Should ready responses be coalesced into a single write group?
+		/*!
+			\since
+			v.0.6.2
+		*/
+		const bool m_coalesce_responses;
 };
 
 } /* namespace impl */
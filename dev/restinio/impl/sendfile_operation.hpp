@@ -39,6 +39,45 @@ using sendfile_operation_shared_ptr_t = std::shared_ptr< sendfile_operation_base
 using after_sendfile_cb_t =
 	std::function< void ( const asio_ns::error_code & , file_size_t ) >;
 
+//
+// sendfile_buffer_t
+//
+
+//! A buffer for file data of sendfile operations that can't use sendfile(2).
+/*!
+	When a file is sent through a socket other than a plain tcp-socket
+	(e.g. TLS socket) its data is read to the buffer and then written
+	to the socket. The buffer is owned by the write context of
+	a connection and is reused by all sendfile operations of it,
+	so an operation doesn't allocate a chunk-sized buffer.
+
+	The buffer grows up to the biggest chunk actually read and
+	is released with the connection.
+
+	@since v.0.6.2
+*/
+class sendfile_buffer_t
+{
+	public:
+		//! Get the buffer of at least \a size bytes.
+		char *
+		acquire( std::size_t size )
+		{
+			if( m_capacity < size )
+			{
+				m_data.reset();
+				m_data.reset( new char[ size ] );
+				m_capacity = size;
+			}
+
+			return m_data.get();
+		}
+
+	private:
+		std::unique_ptr< char[] > m_data;
+		std::size_t m_capacity{ 0u };
+};
+
 //
 // sendfile_operation_runner_base_t
 //
@@ -55,6 +94,7 @@ class sendfile_operation_runner_base_t
 			const sendfile_t & sf,
 			asio_ns::executor executor,
 			Socket & socket,
+			sendfile_buffer_t & buffer,
 			after_sendfile_cb_t after_sendfile_cb )
 			:	m_file_descriptor{ sf.file_descriptor() }
 			,	m_next_write_offset{ sf.offset() }
@@ -63,6 +103,7 @@ class sendfile_operation_runner_base_t
 			,	m_expires_after{ std::chrono::steady_clock::now() + sf.timelimit() }
 			,	m_executor{ std::move( executor )}
 			,	m_socket{ socket }
+			,	m_buffer{ buffer }
 			,	m_after_sendfile_cb{ std::move( after_sendfile_cb ) }
 		{}
 
@@ -80,6 +121,11 @@ class sendfile_operation_runner_base_t
 
 		asio_ns::executor m_executor;
 		Socket & m_socket;
+
+		//! A buffer for file data if it is read before writing.
+		//! \since v.0.6.2
+		sendfile_buffer_t & m_buffer;
+
 		after_sendfile_cb_t m_after_sendfile_cb;
 };
 
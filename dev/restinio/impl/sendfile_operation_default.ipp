@@ -38,6 +38,10 @@ class sendfile_operation_runner_t final
 		void
 		start() override
 		{
+			m_data = this->m_buffer.acquire(
+					static_cast< std::size_t >( std::min< file_size_t >(
+							this->m_remained_size, this->m_chunk_size ) ) );
+
 			const auto n =
 				std::fseek(
 					this->m_file_descriptor,
@@ -69,7 +73,7 @@ class sendfile_operation_runner_t final
 
 			const auto n =
 				std::fread(
-					this->m_buffer.get(),
+					m_data,
 					1,
 					desired_size,
 					this->m_file_descriptor );
@@ -88,7 +92,7 @@ class sendfile_operation_runner_t final
 					asio_ns::async_write(
 						this->m_socket,
 						asio_ns::const_buffer{
-							this->m_buffer.get(),
+							m_data,
 							static_cast< std::size_t >( desired_size ) },
 						asio_ns::bind_executor(
 							this->m_executor,
@@ -105,7 +109,8 @@ class sendfile_operation_runner_t final
 		}
 
 	private:
-		std::unique_ptr< char[] > m_buffer{ new char [ this->m_chunk_size ] };
+		//! Memory for file data taken from the connection's buffer.
+		char * m_data{ nullptr };
 
 		//! Helper method for making a lambda for async_write completion handler.
 		auto
@@ -41,6 +41,10 @@ class sendfile_operation_runner_t final
 		virtual void
 		start() override
 		{
+			m_data = this->m_buffer.acquire(
+					static_cast< std::size_t >( std::min< file_size_t >(
+							this->m_remained_size, this->m_chunk_size ) ) );
+
 #if defined( RESTINIO_FREEBSD_TARGET ) || defined( RESTINIO_MACOS_TARGET )
 			auto const n = ::lseek( this->m_file_descriptor, this->m_next_write_offset, SEEK_SET );
 #else
@@ -76,7 +80,7 @@ class sendfile_operation_runner_t final
 			{
 				auto const n = ::read(
 						this->m_file_descriptor,
-						this->m_buffer.get(),
+						m_data,
 						std::min< file_size_t >(
 								this->m_remained_size, this->m_chunk_size ) );
 
@@ -107,7 +111,7 @@ class sendfile_operation_runner_t final
 						asio_ns::async_write(
 							this->m_socket,
 							asio_ns::const_buffer{
-									this->m_buffer.get(),
+									m_data,
 									static_cast< std::size_t >( n ) },
 							asio_ns::bind_executor(
 								this->m_executor,
@@ -127,7 +131,8 @@ class sendfile_operation_runner_t final
 		}
 
 	private:
-		std::unique_ptr< char[] > m_buffer{ new char [ this->m_chunk_size ] };
+		//! Memory for file data taken from the connection's buffer.
+		char * m_data{ nullptr };
 
 		//! Helper method for making a lambda for async_write completion handler.
 		auto
@@ -62,8 +62,14 @@ class sendfile_operation_runner_t final
 			sendfile_t & sf,
 			asio_ns::executor executor,
 			Socket & socket,
+			sendfile_buffer_t & buffer,
 			after_sendfile_cb_t after_sendfile_cb )
-			:	base_type_t{ sf, std::move( executor), socket, std::move( after_sendfile_cb ) }
+			:	base_type_t{
+					sf,
+					std::move( executor),
+					socket,
+					buffer,
+					std::move( after_sendfile_cb ) }
 		{
 			// We have passed sf.file_descriptor() to m_file_handle object.
 			// It means that file description will be closed automatically
@@ -76,6 +82,10 @@ class sendfile_operation_runner_t final
 		void
 		start() override
 		{
+			m_data = this->m_buffer.acquire(
+					static_cast< std::size_t >( std::min< file_size_t >(
+							this->m_remained_size, this->m_chunk_size ) ) );
+
 			init_next_read_some_from_file();
 		}
 
@@ -94,7 +104,7 @@ class sendfile_operation_runner_t final
 				this->m_file_handle.async_read_some_at(
 					this->m_next_write_offset,
 					asio_ns::buffer(
-						this->m_buffer.get(),
+						m_data,
 						static_cast< std::size_t >( desired_size ) ),
 					asio_ns::bind_executor(
 						this->m_executor,
@@ -121,7 +131,7 @@ class sendfile_operation_runner_t final
 				asio_ns::async_write(
 					this->m_socket,
 					asio_ns::const_buffer{
-						this->m_buffer.get(),
+						m_data,
 						static_cast< std::size_t >( len ) },
 					asio_ns::bind_executor(
 						this->m_executor,
@@ -137,7 +147,8 @@ class sendfile_operation_runner_t final
 		}
 
 	private:
-		std::unique_ptr< char[] > m_buffer{ new char [ this->m_chunk_size ] };
+		//! Memory for file data taken from the connection's buffer.
+		char * m_data{ nullptr };
 		asio_ns::windows::random_access_handle
 			m_file_handle{ this->m_socket.get_executor().context(), this->m_file_descriptor };
 
@@ -246,8 +257,14 @@ class sendfile_operation_runner_t < asio_ns::ip::tcp::socket > final
 			sendfile_t & sf,
 			asio_ns::executor executor,
 			asio_ns::ip::tcp::socket & socket,
+			sendfile_buffer_t & buffer,
 			after_sendfile_cb_t after_sendfile_cb )
-			:	base_type_t{ sf, std::move( executor), socket, std::move( after_sendfile_cb ) }
+			:	base_type_t{
+					sf,
+					std::move( executor),
+					socket,
+					buffer,
+					std::move( after_sendfile_cb ) }
 		{
 			// We have passed sf.file_descriptor() to m_file_handle object.
 			// It means that file description will be closed automatically
@@ -331,7 +348,6 @@ class sendfile_operation_runner_t < asio_ns::ip::tcp::socket > final
 		}
 
 	private:
-		std::unique_ptr< char[] > m_buffer{ new char [ m_chunk_size ] };
 		asio_ns::windows::random_access_handle m_file_handle{
 				asio_details::executor_or_context_from_socket(m_socket),
 				m_file_descriptor
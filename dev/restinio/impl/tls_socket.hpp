@@ -16,6 +16,8 @@
   #include <boost/asio/ssl.hpp>
 #endif
 
+#include <chrono>
+
 namespace restinio
 {
 
@@ -56,6 +58,7 @@ class tls_socket_t
 		{
 			std::swap( m_context, sock.m_context );
 			std::swap( m_socket, sock.m_socket );
+			std::swap( m_handshake_duration, sock.m_handshake_duration );
 		}
 
 		auto &
@@ -150,6 +153,14 @@ class tls_socket_t
 		void
 		close( Args &&... args )
 		{
+			// The connection is closed without close_notify alert.
+			// Since TLS 1.1 it is not a reason to make the session
+			// non-resumable, but OpenSSL removes such a session from
+			// the session cache.
+			::SSL_set_shutdown(
+				m_socket->native_handle(),
+				SSL_SENT_SHUTDOWN | SSL_RECEIVED_SHUTDOWN );
+
 			this->lowest_layer().close( std::forward< Args >( args )... );
 		}
 
@@ -160,9 +171,41 @@ class tls_socket_t
 			return m_socket->async_handshake( std::forward< Args >( args )... );
 		}
 
+		//! Was the session resumed during the handshake?
+		/*!
+			@since v.0.6.2
+		*/
+		bool
+		session_resumed() const noexcept
+		{
+			return 1 == ::SSL_session_reused(
+					const_cast< socket_t & >( *m_socket ).native_handle() );
+		}
+
+		//! Time spent on the handshake.
+		/*!
+			@since v.0.6.2
+		*/
+		std::chrono::steady_clock::duration
+		handshake_duration() const noexcept
+		{
+			return m_handshake_duration;
+		}
+
+		//! Set time spent on the handshake.
+		/*!
+			@since v.0.6.2
+		*/
+		void
+		handshake_duration( std::chrono::steady_clock::duration v ) noexcept
+		{
+			m_handshake_duration = v;
+		}
+
 	private:
 		context_handle_t m_context;
 		std::unique_ptr< socket_t > m_socket;
+		std::chrono::steady_clock::duration m_handshake_duration{};
 };
 
 } /* namespace impl */
@@ -143,9 +143,11 @@ class write_group_output_ctx_t
 
 				explicit file_write_operation_t(
 					sendfile_t & sendfile,
-					sendfile_operation_shared_ptr_t & sendfile_operation ) noexcept
+					sendfile_operation_shared_ptr_t & sendfile_operation,
+					sendfile_buffer_t & sendfile_buffer ) noexcept
 					:	m_sendfile{ &sendfile }
 					,	m_sendfile_operation{ &sendfile_operation }
+					,	m_sendfile_buffer{ &sendfile_buffer }
 				{}
 
 			public:
@@ -181,6 +183,7 @@ class write_group_output_ctx_t
 							*m_sendfile,
 							std::move( executor ),
 							socket,
+							*m_sendfile_buffer,
 							std::move( after_sendfile_cb ) );
 
 					*m_sendfile_operation = std::move( sendfile_operation );
@@ -220,6 +223,10 @@ class write_group_output_ctx_t
 					file_write_operation_t instance (in order to avoid circle links).
 				*/
 				sendfile_operation_shared_ptr_t * m_sendfile_operation;
+
+				//! A buffer for file data of the operation.
+				//! \since v.0.6.2
+				sendfile_buffer_t * m_sendfile_buffer;
 		};
 
 		//! None write operation.
@@ -359,7 +366,8 @@ class write_group_output_ctx_t
 			auto & sf =
 				m_current_wg->items()[ m_next_writable_item_index++ ].sendfile_operation();
 
-			return file_write_operation_t{ sf, m_sendfile_operation };
+			return file_write_operation_t{
+					sf, m_sendfile_operation, m_sendfile_buffer };
 		}
 
 		//! Real buffers with data.
@@ -377,6 +385,10 @@ class write_group_output_ctx_t
 
 		//! Sendfile operation storage context.
 		sendfile_operation_shared_ptr_t m_sendfile_operation;
+
+		//! A buffer for file data reused by sendfile operations.
+		//! \since v.0.6.2
+		sendfile_buffer_t m_sendfile_buffer;
 };
 
 } /* namespace impl */
@@ -0,0 +1,202 @@
+/*
+ * RESTinio
+ */
+
+/*!
+ * @file
+ * @brief Stuff related to incremental (streaming) handling of request body.
+ *
+ * @since v.0.6.2
+ */
+
+#pragma once
+
+#include <memory>
+#include <functional>
+
+#include <restinio/string_view.hpp>
+#include <restinio/http_headers.hpp>
+#include <restinio/impl/connection_base.hpp>
+
+namespace restinio
+{
+
+//
+// incoming_body_flow_t
+//
+/*!
+ * @brief Enumeration of possible reactions of body consumer
+ * to a new chunk of request body.
+ *
+ * @since v.0.6.2
+ */
+enum class incoming_body_flow_t
+{
+	//! Chunk is handled, reading of the body can be continued.
+	proceed,
+	//! Chunk is taken for handling, reading of the body should
+	//! be suspended until incoming_body_consumer_t::resume_reading()
+	//! is called.
+	suspend
+};
+
+/*!
+ * @brief Shorthand for incoming_body_flow_t::proceed.
+ *
+ * @since v.0.6.2
+ */
+inline constexpr incoming_body_flow_t
+incoming_body_proceed() noexcept { return incoming_body_flow_t::proceed; }
+
+/*!
+ * @brief Shorthand for incoming_body_flow_t::suspend.
+ *
+ * @since v.0.6.2
+ */
+inline constexpr incoming_body_flow_t
+incoming_body_suspend() noexcept { return incoming_body_flow_t::suspend; }
+
+class incoming_body_consumer_t;
+
+namespace impl
+{
+
+void
+attach_connection_to_body_consumer(
+	incoming_body_consumer_t & consumer,
+	std::weak_ptr< connection_base_t > connection ) noexcept;
+
+} /* namespace impl */
+
+//
+// incoming_body_consumer_t
+//
+/*!
+ * @brief An interface of consumer of request body chunks.
+ *
+ * By default RESTinio collects the whole body of a request into
+ * a std::string and passes it to request handler only when the request
+ * is received completely. It can be unacceptable for big uploads.
+ *
+ * If incoming_body_consumer_factory is set in server settings, then
+ * that factory is called just after the headers of a request are parsed.
+ * If the factory returns an actual consumer object then all body chunks
+ * are passed to that consumer as they are received from the socket and
+ * are not stored in request_t. Memory consumption per connection is
+ * bounded by the size of the input buffer in that case.
+ *
+ * Consumer has an ability to suspend reading of the body by returning
+ * incoming_body_flow_t::suspend from consume_chunk(). In that case
+ * nothing will be read from the connection until resume_reading() is
+ * called. The memory pointed by \a chunk remains valid until
+ * resume_reading() is called. So the chunk can be written to a file
+ * or a socket asynchronously without making a copy of it.
+ *
+ * When the body is completely received the request handler is called
+ * as usual. The consumer is available via request_t::incoming_body_consumer().
+ *
+ * Usage example:
+ * @code
+ * class file_writer_t final : public restinio::incoming_body_consumer_t {
+ * 	std::ofstream m_file;
+ * public:
+ * 	file_writer_t(const std::string & file_name) : m_file{file_name} {}
+ *
+ * 	restinio::incoming_body_flow_t
+ * 	consume_chunk(restinio::string_view_t chunk) override {
+ * 		m_file.write(chunk.data(), chunk.size());
+ * 		return restinio::incoming_body_proceed();
+ * 	}
+ * };
+ * ...
+ * restinio::run(restinio::on_this_thread()
+ * 	.incoming_body_consumer_factory(
+ * 		[](const restinio::http_request_header_t & h)
+ * 			-> restinio::incoming_body_consumer_handle_t {
+ * 			if(restinio::http_method_post() == h.method() && "/upload" == h.path())
+ * 				return std::make_shared<file_writer_t>(make_temp_file_name());
+ * 			return {}; // Body will be collected as usual.
+ * 		})
+ * 	.request_handler(...));
+ * @endcode
+ *
+ * @since v.0.6.2
+ */
+class incoming_body_consumer_t
+{
+	friend void
+	impl::attach_connection_to_body_consumer(
+		incoming_body_consumer_t & consumer,
+		std::weak_ptr< impl::connection_base_t > connection ) noexcept;
+
+	public:
+		incoming_body_consumer_t() = default;
+		incoming_body_consumer_t( const incoming_body_consumer_t & ) = delete;
+		incoming_body_consumer_t & operator=( const incoming_body_consumer_t & ) = delete;
+
+		virtual ~incoming_body_consumer_t() = default;
+
+		//! Handle next chunk of request body.
+		/*!
+		 * Called on the context of connection. Exceptions thrown
+		 * from this method lead to the closing of the connection.
+		 *
+		 * @note
+		 * If incoming_body_flow_t::proceed is returned then \a chunk
+		 * is invalidated right after the return.
+		 */
+		virtual incoming_body_flow_t
+		consume_chunk( string_view_t chunk ) = 0;
+
+		//! Resume reading of request body after suspension.
+		/*!
+		 * Can be called from any thread. Does nothing if the connection
+		 * is already closed.
+		 */
+		void
+		resume_reading()
+		{
+			if( auto conn = m_connection.lock() )
+				conn->resume_incoming_body();
+		}
+
+	private:
+		//! Connection that owns the request being consumed.
+		std::weak_ptr< impl::connection_base_t > m_connection;
+};
+
+//! An alias for shared pointer to incoming body consumer.
+using incoming_body_consumer_handle_t =
+		std::shared_ptr< incoming_body_consumer_t >;
+
+//
+// incoming_body_consumer_factory_t
+//
+/*!
+ * @brief A type of factory for creation of body consumer for a request.
+ *
+ * The factory is called when request headers are parsed. If the factory
+ * returns an empty pointer the body of the request is collected into
+ * request_t as usual. It allows to use body consumers only for
+ * specific routes.
+ *
+ * @since v.0.6.2
+ */
+using incoming_body_consumer_factory_t =
+		std::function<
+				incoming_body_consumer_handle_t ( const http_request_header_t & ) >;
+
+namespace impl
+{
+
+inline void
+attach_connection_to_body_consumer(
+	incoming_body_consumer_t & consumer,
+	std::weak_ptr< connection_base_t > connection ) noexcept
+{
+	consumer.m_connection = std::move( connection );
+}
+
+} /* namespace impl */
+
+} /* namespace restinio */
@@ -0,0 +1,186 @@
+/*
+	restinio
+*/
+
+/*!
+	Limits for incoming http messages.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace restinio
+{
+
+//
+// incoming_http_msg_limit_t
+//
+
+//! A kind of limit for incoming http messages.
+/*!
+	@since v.0.6.2
+*/
+enum class incoming_http_msg_limit_t
+{
+	//! Length of the request target.
+	url_size,
+	//! Total size of the request target, field names and values.
+	header_size,
+	//! Count of header fields.
+	field_count,
+	//! Size of the body.
+	body_size
+};
+
+//! Get the name of a limit.
+/*!
+	@since v.0.6.2
+*/
+inline const char *
+limit_name( incoming_http_msg_limit_t limit ) noexcept
+{
+	const char * result = "unknown";
+
+	switch( limit )
+	{
+		case incoming_http_msg_limit_t::url_size: result = "url_size"; break;
+		case incoming_http_msg_limit_t::header_size: result = "header_size"; break;
+		case incoming_http_msg_limit_t::field_count: result = "field_count"; break;
+		case incoming_http_msg_limit_t::body_size: result = "body_size"; break;
+	}
+
+	return result;
+}
+
+//
+// incoming_http_msg_limits_t
+//
+
+//! Limits for incoming http messages.
+/*!
+	Limits are checked by parser callbacks before the data is stored,
+	so a client can't force a connection to hold more memory than
+	allowed. If a limit is exceeded the parsing is stopped,
+	a response with status 414 (for url_size), 431 (for header_size and
+	field_count) or 413 (for body_size) is sent and the connection
+	is closed.
+
+	The body limit is applied only to bodies collected by RESTinio,
+	bodies passed to incoming body consumers are not limited.
+
+	All limits are turned off by default.
+
+	Usage example:
+	\code
+	restinio::run(
+		restinio::on_this_thread()
+			.incoming_http_msg_limits(
+				restinio::incoming_http_msg_limits_t{}
+					.max_url_size( 2 * 1024 )
+					.max_header_size( 16 * 1024 )
+					.max_field_count( 64 )
+					.max_body_size( 1024 * 1024 ) )
+			...
+	\endcode
+
+	@since v.0.6.2
+*/
+class incoming_http_msg_limits_t
+{
+	public:
+		static constexpr std::size_t unlimited_size =
+				std::numeric_limits< std::size_t >::max();
+
+		static constexpr std::uint64_t unlimited_body_size =
+				std::numeric_limits< std::uint64_t >::max();
+
+		//! Max length of the request target.
+		//! \{
+		incoming_http_msg_limits_t &
+		max_url_size( std::size_t v ) & noexcept
+		{
+			m_max_url_size = v;
+			return *this;
+		}
+
+		incoming_http_msg_limits_t &&
+		max_url_size( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_url_size( v ) );
+		}
+
+		std::size_t
+		max_url_size() const noexcept { return m_max_url_size; }
+		//! \}
+
+		//! Max total size of the request target, field names and values.
+		//! \{
+		incoming_http_msg_limits_t &
+		max_header_size( std::size_t v ) & noexcept
+		{
+			m_max_header_size = v;
+			return *this;
+		}
+
+		incoming_http_msg_limits_t &&
+		max_header_size( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_header_size( v ) );
+		}
+
+		std::size_t
+		max_header_size() const noexcept { return m_max_header_size; }
+		//! \}
+
+		//! Max count of header fields.
+		//! \{
+		incoming_http_msg_limits_t &
+		max_field_count( std::size_t v ) & noexcept
+		{
+			m_max_field_count = v;
+			return *this;
+		}
+
+		incoming_http_msg_limits_t &&
+		max_field_count( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_field_count( v ) );
+		}
+
+		std::size_t
+		max_field_count() const noexcept { return m_max_field_count; }
+		//! \}
+
+		//! Max size of the body.
+		//! \{
+		incoming_http_msg_limits_t &
+		max_body_size( std::uint64_t v ) & noexcept
+		{
+			m_max_body_size = v;
+			return *this;
+		}
+
+		incoming_http_msg_limits_t &&
+		max_body_size( std::uint64_t v ) && noexcept
+		{
+			return std::move( this->max_body_size( v ) );
+		}
+
+		std::uint64_t
+		max_body_size() const noexcept { return m_max_body_size; }
+		//! \}
+
+	private:
+		std::size_t m_max_url_size{ unlimited_size };
+		std::size_t m_max_header_size{ unlimited_size };
+		std::size_t m_max_field_count{ unlimited_size };
+		std::uint64_t m_max_body_size{ unlimited_body_size };
+};
+
+} /* namespace restinio */
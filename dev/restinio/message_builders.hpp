@@ -10,6 +10,8 @@
 
 #include <ctime>
 #include <chrono>
+#include <cstring>
+#include <cstdint>
 
 #include <restinio/impl/include_fmtlib.hpp>
 
@@ -24,25 +26,141 @@
 namespace restinio
 {
 
+namespace impl
+{
+
+//
+// format_http_date()
+//
+
+//! The length of a date in the format of HTTP Date field.
+constexpr std::size_t http_date_length = 29u;
+
+//! Format a time to `Sun, 06 Nov 1994 08:49:37 GMT` form.
+/*!
+	Does the same as strftime() with "%a, %d %b %Y %H:%M:%S GMT"
+	format but doesn't depend on the locale.
+
+	@since v.0.6.2
+*/
+inline void
+format_http_date( const std::tm & t, char * out ) noexcept
+{
+	constexpr const char days[] = "SunMonTueWedThuFriSat";
+	constexpr const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+
+	const auto put_2_digits = [&out]( int v ) noexcept {
+		*out++ = static_cast< char >( '0' + v / 10 );
+		*out++ = static_cast< char >( '0' + v % 10 );
+	};
+
+	std::memcpy( out, days + 3 * ( t.tm_wday % 7 ), 3u );
+	out += 3;
+	*out++ = ',';
+	*out++ = ' ';
+	put_2_digits( t.tm_mday );
+	*out++ = ' ';
+	std::memcpy( out, months + 3 * ( t.tm_mon % 12 ), 3u );
+	out += 3;
+	*out++ = ' ';
+	const int year = t.tm_year + 1900;
+	put_2_digits( year / 100 % 100 );
+	put_2_digits( year % 100 );
+	*out++ = ' ';
+	put_2_digits( t.tm_hour );
+	*out++ = ':';
+	put_2_digits( t.tm_min );
+	*out++ = ':';
+	put_2_digits( t.tm_sec );
+	std::memcpy( out, " GMT", 4u );
+}
+
+//
+// chunk_size_line_t
+//
+
+//! A line with the size of a chunk in chunked transfer encoding.
+/*!
+	Holds `[\r\n]<hex-size>\r\n` in a fixed-width inline buffer.
+	It is a Datasizeable type small enough to be stored
+	inside writable_item_t itself, so no dynamic memory is used for it.
+
+	@since v.0.6.2
+*/
+class chunk_size_line_t
+{
+	public:
+		//! Max length of a line: "\r\n" + 16 hex digits + "\r\n".
+		static constexpr std::size_t max_length = 2u + 2u * sizeof( std::size_t ) + 2u;
+
+		chunk_size_line_t(
+			//! The size of a chunk.
+			std::size_t chunk_size,
+			//! Should the line start with "\r\n" ending the previous chunk.
+			bool end_previous_chunk ) noexcept
+		{
+			constexpr const char hex_digits[] = "0123456789ABCDEF";
+
+			char * out = m_data + max_length;
+			*--out = '\n';
+			*--out = '\r';
+			do
+			{
+				*--out = hex_digits[ chunk_size & 0xFu ];
+				chunk_size >>= 4;
+			}
+			while( 0u != chunk_size );
+
+			if( end_previous_chunk )
+			{
+				*--out = '\n';
+				*--out = '\r';
+			}
+
+			m_offset = static_cast< std::uint8_t >( out - m_data );
+		}
+
+		const char * data() const noexcept { return m_data + m_offset; }
+
+		std::size_t size() const noexcept { return max_length - m_offset; }
+
+	private:
+		//! The line is written to the end of the buffer.
+		char m_data[ max_length ];
+		//! The offset of the first char of the line.
+		std::uint8_t m_offset;
+};
+
+} /* namespace impl */
+
 //
 // make_date_field_value()
 //
 
 //! Format a timepoint to a string of a propper format.
+/*!
+	Since v.0.6.2 the last formatted value is cached for every thread,
+	so the value for the current time is formatted once a second.
+*/
 inline std::string
 make_date_field_value( std::time_t t )
 {
-	const auto tpoint = make_gmtime( t );
-
-	std::array< char, 64 > buf;
-	// TODO: is there a faster way to get time string?
-	strftime(
-		buf.data(),
-		buf.size(),
-		"%a, %d %b %Y %H:%M:%S GMT",
-		&tpoint );
-
-	return std::string{ buf.data() };
+	struct cached_value_t
+	{
+		bool m_valid;
+		std::time_t m_time;
+		char m_value[ impl::http_date_length ];
+	};
+	static thread_local cached_value_t cached{};
+
+	if( !cached.m_valid || cached.m_time != t )
+	{
+		impl::format_http_date( make_gmtime( t ), cached.m_value );
+		cached.m_time = t;
+		cached.m_valid = true;
+	}
+
+	return std::string{ cached.m_value, impl::http_date_length };
 }
 
 inline std::string
@@ -814,19 +932,18 @@ class response_builder_t< chunked_output_t > final
 						impl::content_length_field_presence_t::skip_content_length ) );
 			}
 
-			const char * format_string = "{:X}\r\n";
+			bool end_previous_chunk = false;
 			for( auto & chunk : m_chunks )
 			{
+				// Size line is stored inside writable_item_t,
+				// so it doesn't require a separate allocation.
 				bufs.emplace_back(
-					fmt::format(
-						format_string,
-						asio_ns::buffer_size( chunk.buf() ) ) );
+					impl::chunk_size_line_t{ chunk.size(), end_previous_chunk } );
 
-				// Now include "\r\n"-ending for a previous chunk to format string.
-				format_string = "\r\n{:X}\r\n";
+				// Now include "\r\n"-ending for a previous chunk to size line.
+				end_previous_chunk = true;
 
 				bufs.emplace_back( std::move( chunk ) );
-
 			}
 
 			const char * const ending_representation = "\r\n" "0\r\n\r\n";
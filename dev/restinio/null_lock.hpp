@@ -0,0 +1,28 @@
+/*
+	restinio
+*/
+
+/*!
+	Fake lock for single-threaded usage of lock-parameterized classes.
+*/
+
+#pragma once
+
+namespace restinio
+{
+
+//
+// null_lock_t
+//
+
+//! Fake lock.
+struct null_lock_t
+{
+	constexpr void lock() const noexcept {}
+
+	constexpr bool try_lock() const noexcept { return true; }
+
+	constexpr void unlock() const noexcept {}
+};
+
+} /* namespace restinio */
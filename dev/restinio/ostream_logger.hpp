@@ -15,22 +15,10 @@
 
 #include <restinio/impl/include_fmtlib.hpp>
 
-namespace restinio
-{
-
-//
-// null_lock_t
-//
+#include <restinio/null_lock.hpp>
 
-//! Fake lock.
-struct null_lock_t
+namespace restinio
 {
-	constexpr void lock() const noexcept {}
-
-	constexpr bool try_lock() const noexcept { return true; }
-
-	constexpr void unlock() const noexcept {}
-};
 
 //
 // ostream_logger_t
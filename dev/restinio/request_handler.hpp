@@ -13,7 +13,9 @@
 
 #include <restinio/exception.hpp>
 #include <restinio/http_headers.hpp>
+#include <restinio/http_header_view.hpp>
 #include <restinio/message_builders.hpp>
+#include <restinio/incoming_body.hpp>
 #include <restinio/impl/connection_base.hpp>
 
 namespace restinio
@@ -50,15 +52,40 @@ class request_t final
 			http_request_header_t header,
 			std::string body,
 			impl::connection_handle_t connection,
-			endpoint_t remote_endpoint )
+			endpoint_t remote_endpoint,
+			//! Views of header fields (since v.0.6.2).
+			http_request_header_view_t header_view = {} )
 			:	m_request_id{ request_id }
 			,	m_header{ std::move( header ) }
+			,	m_header_view{ std::move( header_view ) }
 			,	m_body{ std::move( body ) }
 			,	m_connection{ std::move( connection ) }
 			,	m_connection_id{ m_connection->connection_id() }
 			,	m_remote_endpoint{ std::move( remote_endpoint ) }
 		{}
 
+		//! Constructor for the case when request body was passed
+		//! to a body consumer instead of being collected.
+		/*!
+			\since
+			v.0.6.2
+		*/
+		request_t(
+			request_id_t request_id,
+			http_request_header_t header,
+			incoming_body_consumer_handle_t body_consumer,
+			impl::connection_handle_t connection,
+			endpoint_t remote_endpoint,
+			http_request_header_view_t header_view = {} )
+			:	m_request_id{ request_id }
+			,	m_header{ std::move( header ) }
+			,	m_header_view{ std::move( header_view ) }
+			,	m_body_consumer{ std::move( body_consumer ) }
+			,	m_connection{ std::move( connection ) }
+			,	m_connection_id{ m_connection->connection_id() }
+			,	m_remote_endpoint{ std::move( remote_endpoint ) }
+		{}
+
 		//! Get request header.
 		const http_request_header_t &
 		header() const noexcept
@@ -66,6 +93,20 @@ class request_t final
 			return m_header;
 		}
 
+		//! Get views of header fields.
+		/*!
+			Is filled only if zero-copy header parsing is turned on,
+			otherwise it is empty and fields are available via header().
+
+			\since
+			v.0.6.2
+		*/
+		const http_request_header_view_t &
+		header_view() const noexcept
+		{
+			return m_header_view;
+		}
+
 		//! Get request body.
 		const std::string &
 		body() const noexcept
@@ -73,6 +114,20 @@ class request_t final
 			return m_body;
 		}
 
+		//! Get a consumer the body of that request was passed to.
+		/*!
+			Returns an empty pointer if the body was collected as usual
+			and is available via body().
+
+			\since
+			v.0.6.2
+		*/
+		const incoming_body_consumer_handle_t &
+		incoming_body_consumer() const noexcept
+		{
+			return m_body_consumer;
+		}
+
 		template < typename Output = restinio_controlled_output_t >
 		auto
 		create_response( http_status_line_t status_line = status_ok() )
@@ -107,8 +162,18 @@ class request_t final
 
 		const request_id_t m_request_id;
 		const http_request_header_t m_header;
+
+		//! Views of header fields for zero-copy header parsing.
+		/*!
+			\since
+			v.0.6.2
+		*/
+		const http_request_header_view_t m_header_view;
 		const std::string m_body;
 
+		//! Consumer of the request body (if any).
+		const incoming_body_consumer_handle_t m_body_consumer;
+
 		impl::connection_handle_t m_connection;
 		const connection_id_t m_connection_id;
 
@@ -0,0 +1,833 @@
+/*
+	restinio
+*/
+
+/*!
+	Router with routes that are parsed and checked at compile time.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/request_handler.hpp>
+#include <restinio/optional.hpp>
+
+#include <restinio/utils/from_string.hpp>
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace restinio
+{
+
+namespace router
+{
+
+namespace ct
+{
+
+namespace impl
+{
+
+//! Errors of a route.
+/*!
+	These functions are not constexpr, so a call to any of them
+	during the parsing of a route at compile time breaks the compilation
+	and the name of the function gets into the error message.
+	At run time they throw.
+*/
+//! \{
+[[noreturn]] inline void
+route_must_start_with_slash()
+{
+	throw exception_t{ "route must start with '/'" };
+}
+
+[[noreturn]] inline void
+route_must_not_end_with_slash()
+{
+	throw exception_t{ "route must not end with '/'" };
+}
+
+[[noreturn]] inline void
+route_must_not_have_empty_segments()
+{
+	throw exception_t{ "route must not have empty segments" };
+}
+
+[[noreturn]] inline void
+route_param_must_have_name()
+{
+	throw exception_t{ "route parameter must have a name" };
+}
+
+[[noreturn]] inline void
+route_param_name_must_contain_only_alnum_and_underscore()
+{
+	throw exception_t{
+		"route parameter name must contain only letters, digits and '_'" };
+}
+
+[[noreturn]] inline void
+route_segment_contains_unsupported_char()
+{
+	throw exception_t{ "route segment contains unsupported char" };
+}
+
+[[noreturn]] inline void
+route_param_names_must_be_unique()
+{
+	throw exception_t{ "route parameter names must be unique" };
+}
+
+[[noreturn]] inline void
+route_does_not_match_its_type()
+{
+	throw exception_t{
+		"route doesn't match the count of segments and parameters of its type" };
+}
+//! \}
+
+constexpr bool
+is_param_name_char( char c ) noexcept
+{
+	return ( 'a' <= c && c <= 'z' ) || ( 'A' <= c && c <= 'Z' ) ||
+		( '0' <= c && c <= '9' ) || '_' == c;
+}
+
+constexpr bool
+is_unsupported_char( char c ) noexcept
+{
+	return ':' == c || '(' == c || ')' == c || '\\' == c ||
+		'*' == c || '+' == c || '?' == c;
+}
+
+//! Find the end of a segment that starts at \a begin.
+constexpr std::size_t
+segment_end( const char * path, std::size_t size, std::size_t begin ) noexcept
+{
+	while( begin != size && '/' != path[ begin ] )
+		++begin;
+
+	return begin;
+}
+
+constexpr bool
+is_same_text(
+	const char * path,
+	std::size_t a_begin,
+	std::size_t a_end,
+	std::size_t b_begin,
+	std::size_t b_end ) noexcept
+{
+	if( a_end - a_begin != b_end - b_begin )
+		return false;
+
+	for( ; a_begin != a_end; ++a_begin, ++b_begin )
+		if( path[ a_begin ] != path[ b_begin ] )
+			return false;
+
+	return true;
+}
+
+//! Check that the name of a parameter isn't used by previous segments.
+constexpr void
+check_param_name_is_unique(
+	const char * path,
+	std::size_t size,
+	std::size_t name_begin,
+	std::size_t name_end )
+{
+	std::size_t begin = 1u;
+	while( begin != name_begin - 1u )
+	{
+		const auto end = segment_end( path, size, begin );
+		if( ':' == path[ begin ] &&
+			is_same_text( path, begin + 1u, end, name_begin, name_end ) )
+			route_param_names_must_be_unique();
+
+		begin = end + 1u;
+	}
+}
+
+//! Check a route and get the count of its segments.
+/*!
+	A route consists of plain segments and named parameters
+	that occupy the whole segment, e.g. `/users/:id/orders/:order`.
+	A root route (`/`) has no segments.
+*/
+constexpr std::size_t
+segments_count( const char * path, std::size_t size )
+{
+	if( 0u == size || '/' != path[ 0 ] )
+		route_must_start_with_slash();
+
+	if( 1u == size )
+		return 0u;
+
+	if( '/' == path[ size - 1u ] )
+		route_must_not_end_with_slash();
+
+	std::size_t count = 0u;
+	std::size_t begin = 1u;
+	while( begin < size )
+	{
+		const auto end = segment_end( path, size, begin );
+		if( begin == end )
+			route_must_not_have_empty_segments();
+
+		if( ':' == path[ begin ] )
+		{
+			if( begin + 1u == end )
+				route_param_must_have_name();
+
+			for( auto i = begin + 1u; i != end; ++i )
+				if( !is_param_name_char( path[ i ] ) )
+					route_param_name_must_contain_only_alnum_and_underscore();
+
+			check_param_name_is_unique( path, size, begin + 1u, end );
+		}
+		else
+		{
+			for( auto i = begin; i != end; ++i )
+				if( is_unsupported_char( path[ i ] ) )
+					route_segment_contains_unsupported_char();
+		}
+
+		++count;
+		begin = end + 1u;
+	}
+
+	return count;
+}
+
+template< std::size_t N >
+constexpr std::size_t
+segments_count( const char (&path)[ N ] )
+{
+	return segments_count( path, N - 1u );
+}
+
+//! Get the count of parameters in a route.
+constexpr std::size_t
+params_count( const char * path, std::size_t size ) noexcept
+{
+	std::size_t count = 0u;
+	for( std::size_t i = 0u; i != size; ++i )
+		if( ':' == path[ i ] )
+			++count;
+
+	return count;
+}
+
+template< std::size_t N >
+constexpr std::size_t
+params_count( const char (&path)[ N ] ) noexcept
+{
+	return params_count( path, N - 1u );
+}
+
+constexpr std::size_t
+max_of() noexcept
+{
+	return 0u;
+}
+
+template< typename... Rest >
+constexpr std::size_t
+max_of( std::size_t v, Rest... rest ) noexcept
+{
+	return v < max_of( rest... ) ? max_of( rest... ) : v;
+}
+
+//
+// segment_t
+//
+
+//! A segment of a route.
+struct segment_t
+{
+	bool m_is_param{ false };
+	//! Position of the plain text of a segment or of the name of a parameter.
+	std::size_t m_begin{ 0u };
+	std::size_t m_size{ 0u };
+};
+
+//
+// handler_traits_t
+//
+
+//! Types of arguments of a handler that follow the request handle.
+template< typename Handler >
+struct handler_traits_t
+	:	public handler_traits_t< decltype( &Handler::operator() ) >
+{};
+
+template< typename R, typename Req, typename... Args >
+struct handler_traits_t< R (*)( Req, Args... ) >
+{
+	using args_t = std::tuple< std::decay_t< Args >... >;
+};
+
+template< typename C, typename R, typename Req, typename... Args >
+struct handler_traits_t< R (C::*)( Req, Args... ) >
+	:	public handler_traits_t< R (*)( Req, Args... ) >
+{};
+
+template< typename C, typename R, typename Req, typename... Args >
+struct handler_traits_t< R (C::*)( Req, Args... ) const >
+	:	public handler_traits_t< R (*)( Req, Args... ) >
+{};
+
+#if defined(__cpp_noexcept_function_type)
+template< typename R, typename Req, typename... Args >
+struct handler_traits_t< R (*)( Req, Args... ) noexcept >
+	:	public handler_traits_t< R (*)( Req, Args... ) >
+{};
+
+template< typename C, typename R, typename Req, typename... Args >
+struct handler_traits_t< R (C::*)( Req, Args... ) noexcept >
+	:	public handler_traits_t< R (*)( Req, Args... ) >
+{};
+
+template< typename C, typename R, typename Req, typename... Args >
+struct handler_traits_t< R (C::*)( Req, Args... ) const noexcept >
+	:	public handler_traits_t< R (*)( Req, Args... ) >
+{};
+#endif
+
+} /* namespace impl */
+
+//
+// route_t
+//
+
+//! A route parsed at compile time.
+/*!
+	The count of segments and the count of parameters are the part
+	of the type, so the router can check handlers and reserve
+	the storage for a lookup at compile time.
+
+	Use RESTINIO_CT_ROUTE() to get a route from a string literal.
+
+	\note
+	The route keeps a pointer to the string it is created from,
+	so it must be created from a string literal.
+*/
+template< std::size_t Segments_Count, std::size_t Params_Count >
+class route_t
+{
+	public:
+		static constexpr std::size_t segments_count = Segments_Count;
+		static constexpr std::size_t params_count = Params_Count;
+
+		template< std::size_t N >
+		constexpr route_t( const char (&path)[ N ] )
+			:	m_path{ path }
+			,	m_size{ N - 1u }
+		{
+			if( Segments_Count != impl::segments_count( path ) ||
+				Params_Count != impl::params_count( path ) )
+				impl::route_does_not_match_its_type();
+
+			std::size_t begin = 1u;
+			for( std::size_t i = 0u; i != Segments_Count; ++i )
+			{
+				const auto end = impl::segment_end( m_path, m_size, begin );
+				auto & s = m_segments[ i ];
+				s.m_is_param = ':' == m_path[ begin ];
+				s.m_begin = s.m_is_param ? begin + 1u : begin;
+				s.m_size = end - s.m_begin;
+
+				begin = end + 1u;
+			}
+		}
+
+		constexpr string_view_t
+		path() const noexcept
+		{
+			return string_view_t{ m_path, m_size };
+		}
+
+		//! Get the text of the first segment if it is a plain one.
+		/*!
+			An empty view is returned if the first segment is a parameter
+			or the route has no segments.
+		*/
+		string_view_t
+		first_plain_segment() const noexcept
+		{
+			if( 0u == Segments_Count || m_segments[ 0 ].m_is_param )
+				return string_view_t{};
+
+			return string_view_t{ m_path + m_segments[ 0 ].m_begin, m_segments[ 0 ].m_size };
+		}
+
+		//! Check segments of a path and collect the values of parameters.
+		/*!
+			\a segments must contain exactly segments_count items.
+		*/
+		bool
+		match(
+			const string_view_t * segments,
+			string_view_t * values ) const noexcept
+		{
+			for( std::size_t i = 0u; i != Segments_Count; ++i )
+			{
+				const auto & s = m_segments[ i ];
+				if( s.m_is_param )
+				{
+					if( segments[ i ].empty() )
+						return false;
+
+					*values++ = segments[ i ];
+				}
+				else if( segments[ i ] != string_view_t{ m_path + s.m_begin, s.m_size } )
+					return false;
+			}
+
+			return true;
+		}
+
+	private:
+		const char * m_path;
+		std::size_t m_size;
+
+		impl::segment_t m_segments[ Segments_Count ? Segments_Count : 1u ]{};
+};
+
+//! Make a route from a string literal.
+/*!
+	The route is checked at compile time: an invalid route leads to
+	an error that contains a name like `route_must_start_with_slash`.
+
+	Usage example:
+	@code
+	auto router = restinio::router::ct::make_router(
+		restinio::router::ct::http_get(
+			RESTINIO_CT_ROUTE( "/users/:id/orders/:order" ),
+			[]( restinio::request_handle_t req, std::uint64_t id, restinio::string_view_t order ) {
+				...
+			} ) );
+	@endcode
+*/
+#define RESTINIO_CT_ROUTE( path ) \
+	::restinio::router::ct::route_t< \
+		::restinio::router::ct::impl::segments_count( path ), \
+		::restinio::router::ct::impl::params_count( path ) >{ path }
+
+//
+// route_entry_t
+//
+
+//! A route with its handler.
+/*!
+	Handler is called with the request handle and a value for each
+	parameter of the route (in the order of appearance in the route).
+	Values are converted to the types of arguments of the handler
+	by restinio::utils::from_string(), so a handler can take
+	string_view_t, std::string or numeric types. If a value can't be
+	converted then the route doesn't match the request.
+
+	\note
+	Values of string_view_t type refer to the request and
+	are valid while the request is alive.
+*/
+template< typename Route, typename Handler >
+class route_entry_t
+{
+		using args_t = typename impl::handler_traits_t< Handler >::args_t;
+
+		static_assert(
+			std::tuple_size< args_t >::value == Route::params_count,
+			"handler must take the request and a value for each route parameter" );
+
+	public:
+		using route_type = Route;
+
+		route_entry_t(
+			http_method_id_t method,
+			Route route,
+			Handler handler )
+			:	m_method{ method }
+			,	m_route{ route }
+			,	m_handler{ std::move( handler ) }
+		{}
+
+		const Route &
+		route() const noexcept { return m_route; }
+
+		//! Call the handler if the route matches the request.
+		bool
+		try_handle(
+			request_handle_t & req,
+			const string_view_t * segments,
+			std::size_t segments_count,
+			request_handling_status_t & status ) const
+		{
+			std::array< string_view_t, Route::params_count ? Route::params_count : 1u >
+				values;
+
+			if( Route::segments_count != segments_count ||
+				m_method != req->header().method() ||
+				!m_route.match( segments, values.data() ) )
+				return false;
+
+			optional_t< args_t > args;
+			if( !convert(
+				values.data(),
+				args,
+				std::make_index_sequence< Route::params_count >{} ) )
+				return false;
+
+			status = call(
+				req,
+				*args,
+				std::make_index_sequence< Route::params_count >{} );
+
+			return true;
+		}
+
+	private:
+		template< std::size_t... I >
+		static bool
+		convert(
+			const string_view_t * values,
+			optional_t< args_t > & args,
+			std::index_sequence< I... > ) noexcept
+		{
+			try
+			{
+				args.emplace(
+					utils::from_string< std::tuple_element_t< I, args_t > >(
+						values[ I ] )... );
+			}
+			catch( const std::exception & )
+			{
+				return false;
+			}
+
+			return true;
+		}
+
+		template< std::size_t... I >
+		request_handling_status_t
+		call(
+			request_handle_t & req,
+			args_t & args,
+			std::index_sequence< I... > ) const
+		{
+			return m_handler( std::move( req ), std::move( std::get< I >( args ) )... );
+		}
+
+		http_method_id_t m_method;
+		Route m_route;
+		Handler m_handler;
+};
+
+//! Make route entries.
+//! \{
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+add_handler( http_method_id_t method, Route route, Handler && handler )
+{
+	return { method, route, std::forward< Handler >( handler ) };
+}
+
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+http_delete( Route route, Handler && handler )
+{
+	return add_handler( http_method_delete(), route, std::forward< Handler >( handler ) );
+}
+
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+http_get( Route route, Handler && handler )
+{
+	return add_handler( http_method_get(), route, std::forward< Handler >( handler ) );
+}
+
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+http_head( Route route, Handler && handler )
+{
+	return add_handler( http_method_head(), route, std::forward< Handler >( handler ) );
+}
+
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+http_post( Route route, Handler && handler )
+{
+	return add_handler( http_method_post(), route, std::forward< Handler >( handler ) );
+}
+
+template< typename Route, typename Handler >
+route_entry_t< Route, std::decay_t< Handler > >
+http_put( Route route, Handler && handler )
+{
+	return add_handler( http_method_put(), route, std::forward< Handler >( handler ) );
+}
+//! \}
+
+//
+// router_t
+//
+
+//! Router with a set of routes known at compile time.
+/*!
+	Routes are checked in the order they are given to make_router()
+	and the first one that matches the request is used.
+
+	The path of a request is split into segments once. Routes are
+	indexed by the count of their segments and by the text of their
+	first segment when the router is created, so a request is tried
+	only against routes with the same count of segments whose first
+	segment is either the same or a parameter. The check of a route
+	is generated from its type: there is no regex, no memory allocation
+	during a lookup (except the one made by from_string() for
+	std::string values) and no virtual calls.
+
+	As with express_router_t the trailing slash of the path is optional.
+	Matching is case sensitive.
+
+	@since v.0.6.2
+*/
+template< typename... Entries >
+class router_t
+{
+		static constexpr std::size_t max_segments_count =
+			impl::max_of( Entries::route_type::segments_count... );
+
+		using segments_t =
+			std::array< string_view_t, max_segments_count ? max_segments_count : 1u >;
+
+	public:
+		explicit router_t( std::tuple< Entries... > entries )
+			:	m_entries{ std::move( entries ) }
+		{
+			build_index( std::index_sequence_for< Entries... >{} );
+		}
+
+		request_handling_status_t
+		operator () ( request_handle_t req ) const
+		{
+			segments_t segments;
+			const auto segments_count = split_path( req->header().path(), segments );
+
+			request_handling_status_t status{ request_rejected() };
+			if( !try_entries( req, segments.data(), segments_count, status ) )
+			{
+				// Here: none of the routes matches this handler.
+
+				if( m_non_matched_request_handler )
+				{
+					// If non matched request handler is set
+					// then call it.
+					return m_non_matched_request_handler( std::move( req ) );
+				}
+			}
+
+			return status;
+		}
+
+		//! Set handler for requests that don't match any route.
+		void
+		non_matched_request_handler( non_matched_request_handler_t nmrh )
+		{
+			m_non_matched_request_handler= std::move( nmrh );
+		}
+
+	private:
+		//! Split a path into segments.
+		/*!
+			Returns a value greater than max_segments_count if the path
+			can't be matched by any route.
+		*/
+		static std::size_t
+		split_path( string_view_t path, segments_t & segments ) noexcept
+		{
+			if( path.empty() || '/' != path.front() )
+				return max_segments_count + 1u;
+
+			path.remove_prefix( 1u );
+			if( !path.empty() && '/' == path.back() )
+				path.remove_suffix( 1u );
+
+			if( path.empty() )
+				return 0u;
+
+			std::size_t count = 0u;
+			for(;;)
+			{
+				if( max_segments_count == count )
+					return max_segments_count + 1u;
+
+				const auto slash_pos = path.find( '/' );
+				segments[ count++ ] = path.substr( 0u, slash_pos );
+				if( string_view_t::npos == slash_pos )
+					return count;
+
+				path.remove_prefix( slash_pos + 1u );
+			}
+		}
+
+		//! An entry with a plain first segment.
+		using plain_entry_t = std::pair< string_view_t, std::size_t >;
+
+		//! Entries with the same count of segments.
+		struct bucket_t
+		{
+			//! Entries with a plain first segment sorted by the segment
+			//! and then by the index of an entry.
+			std::vector< plain_entry_t > m_plain;
+
+			//! Indexes of entries with a parameter as the first segment
+			//! (or without segments) in ascending order.
+			std::vector< std::size_t > m_params;
+		};
+
+		//! Comparison of the first segment of an entry with a path segment.
+		struct plain_entry_less_t
+		{
+			bool
+			operator()( const plain_entry_t & a, string_view_t b ) const noexcept
+			{
+				return a.first < b;
+			}
+
+			bool
+			operator()( string_view_t a, const plain_entry_t & b ) const noexcept
+			{
+				return a < b.first;
+			}
+		};
+
+		//! Type of a function that tries an entry by its index.
+		using try_entry_fn_t = bool (*)(
+				const router_t &,
+				request_handle_t &,
+				const string_view_t *,
+				std::size_t,
+				request_handling_status_t & );
+
+		template< std::size_t I >
+		static bool
+		try_entry(
+			const router_t & router,
+			request_handle_t & req,
+			const string_view_t * segments,
+			std::size_t segments_count,
+			request_handling_status_t & status )
+		{
+			return std::get< I >( router.m_entries ).try_handle(
+					req, segments, segments_count, status );
+		}
+
+		//! Get a table of functions for trying entries by index.
+		template< std::size_t... I >
+		static const try_entry_fn_t *
+		try_entry_functions( std::index_sequence< I... > ) noexcept
+		{
+			static constexpr try_entry_fn_t functions[ sizeof...( I ) ? sizeof...( I ) : 1u ]{
+					&try_entry< I >... };
+
+			return functions;
+		}
+
+		template< std::size_t... I >
+		void
+		build_index( std::index_sequence< I... > )
+		{
+			(void)std::initializer_list< int >{
+				( add_to_index( I, std::get< I >( m_entries ).route() ), 0 )... };
+
+			for( auto & b : m_buckets )
+				std::sort( b.m_plain.begin(), b.m_plain.end() );
+		}
+
+		template< typename Route >
+		void
+		add_to_index( std::size_t index, const Route & route )
+		{
+			auto & bucket = m_buckets[ Route::segments_count ];
+
+			const auto first = route.first_plain_segment();
+			if( first.empty() )
+				bucket.m_params.push_back( index );
+			else
+				bucket.m_plain.emplace_back( first, index );
+		}
+
+		//! Try entries that can match the path in their order.
+		bool
+		try_entries(
+			request_handle_t & req,
+			const string_view_t * segments,
+			std::size_t segments_count,
+			request_handling_status_t & status ) const
+		{
+			if( max_segments_count < segments_count )
+				return false;
+
+			const auto & bucket = m_buckets[ segments_count ];
+
+			auto plain = std::make_pair( bucket.m_plain.end(), bucket.m_plain.end() );
+			if( 0u != segments_count )
+				plain = std::equal_range(
+						bucket.m_plain.begin(),
+						bucket.m_plain.end(),
+						segments[ 0 ],
+						plain_entry_less_t{} );
+
+			const auto functions =
+				try_entry_functions( std::index_sequence_for< Entries... >{} );
+
+			// Both sequences are ordered by index of entries,
+			// they are merged to keep the order of routes.
+			auto param = bucket.m_params.begin();
+			while( plain.first != plain.second || param != bucket.m_params.end() )
+			{
+				std::size_t index;
+				if( param == bucket.m_params.end() ||
+					( plain.first != plain.second && plain.first->second < *param ) )
+					index = (plain.first++)->second;
+				else
+					index = *(param++);
+
+				if( functions[ index ]( *this, req, segments, segments_count, status ) )
+					return true;
+			}
+
+			return false;
+		}
+
+		std::tuple< Entries... > m_entries;
+
+		//! Entries by the count of segments.
+		std::array< bucket_t, max_segments_count + 1u > m_buckets;
+
+		//! Handler that is called for requests that don't match any route.
+		non_matched_request_handler_t m_non_matched_request_handler;
+};
+
+//! Make a router from a set of route entries.
+template< typename... Entries >
+router_t< std::decay_t< Entries >... >
+make_router( Entries &&... entries )
+{
+	return router_t< std::decay_t< Entries >... >{
+			std::make_tuple( std::forward< Entries >( entries )... ) };
+}
+
+} /* namespace ct */
+
+} /* namespace router */
+
+} /* namespace restinio */
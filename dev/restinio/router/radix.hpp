@@ -0,0 +1,931 @@
+/*
+	restinio
+*/
+
+/*!
+	Express.js style router based on a prefix tree of route segments.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/router/express.hpp>
+#include <restinio/impl/string_caseless_compare.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+
+namespace restinio
+{
+
+namespace router
+{
+
+namespace impl
+{
+
+namespace radix
+{
+
+//! The max count of parameters in a route that is placed into the tree.
+/*!
+	Routes with more parameters are handled by regex.
+*/
+constexpr std::size_t max_params_count = 16u;
+
+//! A value of route index that means no route.
+constexpr std::size_t no_route = std::numeric_limits< std::size_t >::max();
+
+//
+// segment_t
+//
+
+//! A single segment of route (a part between '/').
+struct segment_t
+{
+	enum class kind_t { plain, named_param, indexed_param };
+
+	kind_t m_kind;
+
+	//! Plain text of the segment or name of the parameter.
+	std::string m_value;
+
+	//! Pattern for parameter (empty for parameters without constraints).
+	std::string m_pattern;
+};
+
+using segments_container_t = std::vector< segment_t >;
+
+//
+// is_single_segment_pattern()
+//
+
+//! Checks that a pattern of a parameter cannot match a part of the path
+//! that goes beyond a single segment.
+/*!
+	The check is conservative: patterns with '.', negated sets,
+	negated character classes and slashes are treated as unsafe.
+*/
+inline bool
+is_single_segment_pattern( string_view_t pattern ) noexcept
+{
+	for( std::size_t i = 0; i < pattern.size(); ++i )
+	{
+		const char c = pattern[ i ];
+		if( '\\' == c )
+		{
+			if( ++i == pattern.size() )
+				return false;
+
+			const char n = pattern[ i ];
+			// \D, \W, \S and so on can match '/'.
+			if( ( 'A' <= n && n <= 'Z' ) || '/' == n )
+				return false;
+		}
+		else if( '.' == c || '/' == c )
+			return false;
+		else if( '[' == c && i + 1 < pattern.size() && '^' == pattern[ i + 1 ] )
+			return false;
+	}
+
+	return true;
+}
+
+//
+// find_group_end()
+//
+
+//! Find the position of ')' that closes a group started at \a from.
+inline std::size_t
+find_group_end( string_view_t route, std::size_t from ) noexcept
+{
+	for( std::size_t i = from + 1u; i < route.size(); ++i )
+	{
+		const char c = route[ i ];
+		if( '\\' == c )
+			++i;
+		else if( '(' == c )
+			return string_view_t::npos;
+		else if( ')' == c )
+			return i;
+	}
+
+	return string_view_t::npos;
+}
+
+//
+// is_param_name_char()
+//
+
+inline bool
+is_param_name_char( char c ) noexcept
+{
+	return ( 'a' <= c && c <= 'z' ) || ( 'A' <= c && c <= 'Z' ) ||
+		( '0' <= c && c <= '9' ) || '_' == c;
+}
+
+//
+// try_split_route()
+//
+
+//! Try to represent a route as a sequence of plain segments and
+//! parameters that occupy the whole segment.
+/*!
+	Returns false if the route uses features of path2regex that
+	cannot be handled by the tree (optional and repeated parameters,
+	parameters in the middle of a segment, escaped chars, trailing slash,
+	non default options and so on). Such routes are handled by regex.
+*/
+inline bool
+try_split_route(
+	string_view_t route,
+	const path2regex::options_t & options,
+	segments_container_t & segments )
+{
+	if( !options.ending() || options.strict() ||
+		"/" != options.delimiter() ||
+		std::string::npos == options.delimiters().find( '/' ) ||
+		!options.ends_with().empty() )
+		return false;
+
+	if( route.empty() || '/' != route.front() )
+		return false;
+
+	route.remove_prefix( 1u );
+	if( route.empty() )
+		return true;
+
+	// Non-strict route with trailing slash requires the slash.
+	if( '/' == route.back() )
+		return false;
+
+	std::size_t params_count = 0u;
+	while( !route.empty() )
+	{
+		// Find the end of the segment.
+		std::size_t end = 0u;
+		for( ; end < route.size() && '/' != route[ end ]; ++end )
+		{
+			if( '(' == route[ end ] )
+			{
+				end = find_group_end( route, end );
+				if( string_view_t::npos == end )
+					return false;
+			}
+		}
+
+		const auto seg = route.substr( 0u, end );
+		route.remove_prefix( end == route.size() ? end : end + 1u );
+
+		if( seg.empty() )
+			return false;
+
+		segment_t segment;
+		std::size_t group_begin = string_view_t::npos;
+		if( ':' == seg.front() )
+		{
+			std::size_t name_end = 1u;
+			while( name_end < seg.size() && is_param_name_char( seg[ name_end ] ) )
+				++name_end;
+
+			if( 1u == name_end )
+				return false;
+
+			segment.m_kind = segment_t::kind_t::named_param;
+			segment.m_value.assign( seg.data() + 1u, name_end - 1u );
+
+			if( name_end != seg.size() )
+			{
+				if( '(' != seg[ name_end ] )
+					return false;
+				group_begin = name_end;
+			}
+		}
+		else if( '(' == seg.front() )
+		{
+			segment.m_kind = segment_t::kind_t::indexed_param;
+			group_begin = 0u;
+		}
+		else
+		{
+			for( const char c : seg )
+				if( ':' == c || '(' == c || ')' == c || '\\' == c ||
+					'*' == c || '+' == c || '?' == c )
+					return false;
+
+			segment.m_kind = segment_t::kind_t::plain;
+			segment.m_value.assign( seg.data(), seg.size() );
+		}
+
+		if( string_view_t::npos != group_begin )
+		{
+			// Group must finish the segment (no modifiers allowed).
+			const auto group_end = find_group_end( seg, group_begin );
+			if( seg.size() - 1u != group_end || group_begin + 1u == group_end )
+				return false;
+
+			const auto pattern =
+				seg.substr( group_begin + 1u, group_end - group_begin - 1u );
+			if( !is_single_segment_pattern( pattern ) )
+				return false;
+
+			segment.m_pattern = path2regex::impl::escape_group(
+					std::string{ pattern.data(), pattern.size() } );
+		}
+
+		if( segment_t::kind_t::plain != segment.m_kind &&
+			max_params_count < ++params_count )
+			return false;
+
+		segments.push_back( std::move( segment ) );
+	}
+
+	return true;
+}
+
+//
+// segment_less()
+//
+
+//! Ordering of plain segments of the same node.
+/*!
+	Segments are ordered by size first, then by (lowercased for
+	case insensitive routes) characters.
+*/
+inline bool
+segment_less( string_view_t a, string_view_t b, bool sensitive ) noexcept
+{
+	if( a.size() != b.size() )
+		return a.size() < b.size();
+
+	if( sensitive )
+		return a < b;
+
+	const unsigned char * const table =
+			restinio::impl::to_lower_lut< unsigned char >();
+
+	for( std::size_t i = 0u; i != a.size(); ++i )
+	{
+		const auto ca = table[ static_cast< unsigned char >( a[ i ] ) ];
+		const auto cb = table[ static_cast< unsigned char >( b[ i ] ) ];
+		if( ca != cb )
+			return ca < cb;
+	}
+
+	return false;
+}
+
+//
+// param_description_t
+//
+
+//! Description of a parameter of a route placed into the tree.
+struct param_description_t
+{
+	//! Name of the parameter (empty for indexed parameters).
+	string_view_t m_name;
+	bool m_named;
+};
+
+//
+// leaf_t
+//
+
+//! A route that ends in a node of the tree.
+struct leaf_t
+{
+	http_method_id_t m_method;
+
+	//! Index of the route in the order of addition.
+	std::size_t m_index;
+
+	//! Position of the route data in the router.
+	std::size_t m_route_pos;
+};
+
+//
+// node_t
+//
+
+//! A node of the tree.
+template < typename Regex_Engine >
+struct node_t
+{
+	using regex_t = typename Regex_Engine::compiled_regex_t;
+
+	node_t() = default;
+	node_t( const node_t & ) = delete;
+	node_t & operator = ( const node_t & ) = delete;
+	node_t( node_t && ) = default;
+	node_t & operator = ( node_t && ) = default;
+
+	//! Child for a plain segment.
+	struct plain_child_t
+	{
+		std::string m_segment;
+		std::unique_ptr< node_t > m_node;
+	};
+
+	//! Child for a parameter.
+	struct param_child_t
+	{
+		//! Pattern of the parameter (empty if there are no constraints).
+		std::string m_pattern;
+		//! Compiled pattern (if any).
+		std::unique_ptr< regex_t > m_regex;
+		std::unique_ptr< node_t > m_node;
+	};
+
+	//! Children for plain segments.
+	/*!
+		Sorted by segment_less(), so a child is found by binary search.
+	*/
+	std::vector< plain_child_t > m_plain_children;
+	std::vector< param_child_t > m_param_children;
+
+	//! Routes ending in this node (in the order of addition).
+	std::vector< leaf_t > m_leaves;
+
+	//! The minimal index of routes in the subtree.
+	/*!
+		Used for skipping the subtrees that can't contain
+		a route that was added before already found one.
+	*/
+	std::size_t m_min_index{ no_route };
+};
+
+//
+// match_state_t
+//
+
+//! Data for a single lookup in the tree.
+/*!
+	All data is kept on the stack, so the lookup doesn't allocate.
+*/
+struct match_state_t
+{
+	match_state_t( http_method_id_t method )
+		:	m_method{ method }
+	{}
+
+	const http_method_id_t m_method;
+
+	//! Values of parameters for the current path in the tree.
+	std::array< string_view_t, max_params_count > m_values;
+
+	//! The best route found so far.
+	//! \{
+	const leaf_t * m_best{ nullptr };
+	std::array< string_view_t, max_params_count > m_best_values;
+	//! \}
+
+	std::size_t
+	best_index() const noexcept
+	{
+		return m_best ? m_best->m_index : no_route;
+	}
+};
+
+} /* namespace radix */
+
+} /* namespace impl */
+
+//
+// radix_router_t
+//
+
+//! Express.js style router with lookup in a prefix tree.
+/*!
+	Accepts the same route syntax and options as express_router_t
+	and picks the same handler for a request (the first added route
+	that matches the request).
+
+	Routes that consist only of plain segments and parameters that occupy
+	the whole segment (e.g. `/users/:id`, `/users/:id(\d+)/orders`) are placed
+	into a tree keyed by segments. The lookup costs depend on the length
+	of the request path rather than on the count of routes, and regex
+	is used only for parameters with constraints.
+
+	Routes that use other features of path2regex (optional and repeated
+	parameters, several parameters in a segment, non default options and so
+	on) are matched by regex as it is done by express_router_t.
+
+	\note
+	The values of parameters are collected during the lookup without
+	memory allocation. route_params_t is filled only once for the selected
+	route.
+
+	@since v.0.6.2
+*/
+template < typename Regex_Engine = std_regex_engine_t >
+class radix_router_t
+{
+		using node_t = impl::radix::node_t< Regex_Engine >;
+		using regex_t = typename Regex_Engine::compiled_regex_t;
+		using match_results_t = typename Regex_Engine::match_results_t;
+
+	public:
+		radix_router_t() = default;
+		radix_router_t( radix_router_t && ) = default;
+
+		request_handling_status_t
+		operator () ( request_handle_t req ) const
+		{
+			const auto & header = req->header();
+			const auto path = header.path();
+
+			impl::radix::match_state_t state{ header.method() };
+			lookup_in_tree( path, state );
+
+			// Routes handled by regex can be added before
+			// the route found in the tree.
+			route_params_t params;
+			for( const auto & r : m_regex_routes )
+			{
+				if( state.best_index() <= r.m_index )
+					break;
+
+				if( r.m_entry.match( header, params ) )
+					return r.m_entry.handle( std::move( req ), std::move( params ) );
+			}
+
+			if( state.m_best )
+			{
+				const auto & route = m_tree_routes[ state.m_best->m_route_pos ];
+				fill_params( route, path, state.m_best_values, params );
+
+				return route.m_handler( std::move( req ), std::move( params ) );
+			}
+
+			// Here: none of the routes matches this handler.
+
+			if( m_non_matched_request_handler )
+			{
+				// If non matched request handler is set
+				// then call it.
+				return m_non_matched_request_handler( std::move( req ) );
+			}
+
+			return request_rejected();
+		}
+
+		//! Add handlers.
+		//! \{
+		void
+		add_handler(
+			http_method_id_t method,
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				method,
+				route_path,
+				path2regex::options_t{},
+				std::move( handler ) );
+		}
+
+		void
+		add_handler(
+			http_method_id_t method,
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			const auto index = m_routes_count;
+
+			impl::radix::segments_container_t segments;
+			if( impl::radix::try_split_route( route_path, options, segments ) )
+			{
+				try
+				{
+					add_tree_route(
+						method, index, segments, options.sensitive(), std::move( handler ) );
+				}
+				catch( const std::exception & ex )
+				{
+					throw exception_t{
+						fmt::format( "unable to process route \"{}\": {}",
+							route_path, ex.what() ) };
+				}
+			}
+			else
+			{
+				m_regex_routes.push_back( regex_route_t{
+						index,
+						route_entry_t{ method, route_path, options, std::move( handler ) } } );
+			}
+
+			++m_routes_count;
+		}
+
+		void
+		http_delete(
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_delete(),
+				route_path,
+				std::move( handler ) );
+		}
+
+		void
+		http_delete(
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_delete(),
+				route_path,
+				options,
+				std::move( handler ) );
+		}
+
+		void
+		http_get(
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_get(),
+				route_path,
+				std::move( handler ) );
+		}
+
+		void
+		http_get(
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_get(),
+				route_path,
+				options,
+				std::move( handler ) );
+		}
+
+		void
+		http_head(
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_head(),
+				route_path,
+				std::move( handler ) );
+		}
+
+		void
+		http_head(
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_head(),
+				route_path,
+				options,
+				std::move( handler ) );
+		}
+
+		void
+		http_post(
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_post(),
+				route_path,
+				std::move( handler ) );
+		}
+
+		void
+		http_post(
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_post(),
+				route_path,
+				options,
+				std::move( handler ) );
+		}
+
+		void
+		http_put(
+			string_view_t route_path,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_put(),
+				route_path,
+				std::move( handler ) );
+		}
+
+		void
+		http_put(
+			string_view_t route_path,
+			const path2regex::options_t & options,
+			express_request_handler_t handler )
+		{
+			add_handler(
+				http_method_put(),
+				route_path,
+				options,
+				std::move( handler ) );
+		}
+		//! \}
+
+		//! Set handler for requests that don't match any route.
+		void
+		non_matched_request_handler( non_matched_request_handler_t nmrh )
+		{
+			m_non_matched_request_handler= std::move( nmrh );
+		}
+
+	private:
+		using route_entry_t = express_route_entry_t< Regex_Engine >;
+
+		//! Data of a route placed into the tree.
+		struct tree_route_t
+		{
+			express_request_handler_t m_handler;
+
+			//! Buffer for names of parameters.
+			std::shared_ptr< std::string > m_names_buffer;
+
+			//! Parameters in the order of appearance in the route.
+			std::vector< impl::radix::param_description_t > m_params;
+		};
+
+		//! A route that is matched by regex.
+		struct regex_route_t
+		{
+			//! Index of the route in the order of addition.
+			std::size_t m_index;
+			route_entry_t m_entry;
+		};
+
+		void
+		add_tree_route(
+			http_method_id_t method,
+			std::size_t index,
+			const impl::radix::segments_container_t & segments,
+			bool sensitive,
+			express_request_handler_t handler )
+		{
+			using impl::radix::segment_t;
+
+			tree_route_t route;
+			route.m_handler = std::move( handler );
+			route.m_names_buffer = std::make_shared< std::string >();
+
+			// Reserve the buffer to keep string views valid.
+			std::size_t names_size = 0u;
+			for( const auto & s : segments )
+				if( segment_t::kind_t::named_param == s.m_kind )
+					names_size += s.m_value.size();
+			route.m_names_buffer->reserve( names_size );
+
+			node_t * node = sensitive ? &m_sensitive_root : &m_insensitive_root;
+			node->m_min_index = (std::min)( node->m_min_index, index );
+
+			for( const auto & s : segments )
+			{
+				if( segment_t::kind_t::plain == s.m_kind )
+					node = &plain_child( *node, s.m_value, sensitive );
+				else
+				{
+					node = &param_child( *node, s.m_pattern, sensitive );
+
+					impl::radix::param_description_t param{ string_view_t{}, false };
+					if( segment_t::kind_t::named_param == s.m_kind )
+					{
+						auto & names = *route.m_names_buffer;
+						const auto pos = names.size();
+						names += s.m_value;
+						param = impl::radix::param_description_t{
+								string_view_t{ names.data() + pos, s.m_value.size() },
+								true };
+					}
+					route.m_params.push_back( param );
+				}
+
+				node->m_min_index = (std::min)( node->m_min_index, index );
+			}
+
+			node->m_leaves.push_back(
+					impl::radix::leaf_t{ method, index, m_tree_routes.size() } );
+			m_tree_routes.push_back( std::move( route ) );
+		}
+
+		static node_t &
+		plain_child( node_t & node, const std::string & segment, bool sensitive )
+		{
+			auto & children = node.m_plain_children;
+			auto it = find_plain_child( children, segment, sensitive );
+			if( children.end() != it &&
+				is_same_segment( it->m_segment, segment, sensitive ) )
+				return *it->m_node;
+
+			it = children.insert( it,
+					typename node_t::plain_child_t{
+							segment, std::make_unique< node_t >() } );
+
+			return *it->m_node;
+		}
+
+		//! Find the first plain child that isn't less than \a segment.
+		template< typename Children >
+		static auto
+		find_plain_child(
+			Children & children,
+			string_view_t segment,
+			bool sensitive ) noexcept
+		{
+			return std::lower_bound(
+					children.begin(), children.end(), segment,
+					[sensitive]( const auto & c, string_view_t v ) {
+						return impl::radix::segment_less( c.m_segment, v, sensitive );
+					} );
+		}
+
+		static node_t &
+		param_child( node_t & node, const std::string & pattern, bool sensitive )
+		{
+			for( auto & c : node.m_param_children )
+				if( c.m_pattern == pattern )
+					return *c.m_node;
+
+			std::unique_ptr< regex_t > regex;
+			if( !pattern.empty() )
+				regex = std::make_unique< regex_t >(
+						Regex_Engine::compile_regex(
+								"^(?:" + pattern + ")$", sensitive ) );
+
+			node.m_param_children.push_back(
+					typename node_t::param_child_t{
+							pattern, std::move( regex ), std::make_unique< node_t >() } );
+
+			return *node.m_param_children.back().m_node;
+		}
+
+		static bool
+		is_same_segment( string_view_t a, string_view_t b, bool sensitive ) noexcept
+		{
+			return sensitive ? a == b : restinio::impl::is_equal_caseless( a, b );
+		}
+
+		//! Find the first added route that matches a path.
+		void
+		lookup_in_tree(
+			string_view_t path,
+			impl::radix::match_state_t & state ) const
+		{
+			if( path.empty() || '/' != path.front() )
+				return;
+
+			// The trailing slash is optional for routes in the tree.
+			path.remove_prefix( 1u );
+			if( !path.empty() && '/' == path.back() )
+				path.remove_suffix( 1u );
+
+			lookup_in_node( m_sensitive_root, path, !path.empty(), 0u, true, state );
+			lookup_in_node( m_insensitive_root, path, !path.empty(), 0u, false, state );
+		}
+
+		void
+		lookup_in_node(
+			const node_t & node,
+			//! The rest of the path.
+			string_view_t path,
+			//! Are there any segments left?
+			bool has_segments,
+			//! Count of captured parameters.
+			std::size_t depth,
+			bool sensitive,
+			impl::radix::match_state_t & state ) const
+		{
+			if( state.best_index() <= node.m_min_index )
+				return;
+
+			if( !has_segments )
+			{
+				for( const auto & leaf : node.m_leaves )
+				{
+					if( state.best_index() <= leaf.m_index )
+						break;
+
+					if( leaf.m_method == state.m_method )
+					{
+						state.m_best = &leaf;
+						std::copy(
+							state.m_values.begin(),
+							state.m_values.begin() + depth,
+							state.m_best_values.begin() );
+						break;
+					}
+				}
+				return;
+			}
+
+			const auto slash_pos = path.find( '/' );
+			const auto segment = path.substr( 0u, slash_pos );
+			const bool has_more_segments = string_view_t::npos != slash_pos;
+			const auto rest = has_more_segments ?
+					path.substr( slash_pos + 1u ) : string_view_t{};
+
+			const auto it = find_plain_child(
+					node.m_plain_children, segment, sensitive );
+			if( node.m_plain_children.end() != it &&
+				is_same_segment( it->m_segment, segment, sensitive ) )
+			{
+				lookup_in_node(
+					*it->m_node, rest, has_more_segments, depth, sensitive, state );
+			}
+
+			for( const auto & c : node.m_param_children )
+			{
+				if( c.m_regex )
+				{
+					match_results_t matches;
+					if( !Regex_Engine::try_match( segment, *c.m_regex, matches ) )
+						continue;
+				}
+				else if( segment.empty() )
+					continue;
+
+				state.m_values[ depth ] = segment;
+				lookup_in_node(
+					*c.m_node, rest, has_more_segments, depth + 1u, sensitive, state );
+			}
+		}
+
+		//! Fill route params for the route found in the tree.
+		static void
+		fill_params(
+			const tree_route_t & route,
+			string_view_t path,
+			const std::array< string_view_t, impl::radix::max_params_count > & values,
+			route_params_t & params )
+		{
+			std::unique_ptr< char[] > captured_params{ new char[ path.size() ] };
+			std::memcpy( captured_params.get(), path.data(), path.size() );
+
+			const auto rebase = [&]( string_view_t v ) {
+				return string_view_t{
+						captured_params.get() + ( v.data() - path.data() ),
+						v.size() };
+			};
+
+			route_params_t::named_parameters_container_t named_parameters;
+			route_params_t::indexed_parameters_container_t indexed_parameters;
+
+			for( std::size_t i = 0u; i != route.m_params.size(); ++i )
+			{
+				const auto & p = route.m_params[ i ];
+				if( p.m_named )
+					named_parameters.emplace_back( p.m_name, rebase( values[ i ] ) );
+				else
+					indexed_parameters.emplace_back( rebase( values[ i ] ) );
+			}
+
+			const string_view_t match{ captured_params.get(), path.size() };
+
+			impl::route_params_accessor_t::match(
+					params,
+					std::move( captured_params ),
+					route.m_names_buffer,
+					match,
+					std::move( named_parameters ),
+					std::move( indexed_parameters ) );
+		}
+
+		//! Roots of the trees for case sensitive and insensitive routes.
+		//! \{
+		node_t m_sensitive_root;
+		node_t m_insensitive_root;
+		//! \}
+
+		//! Routes placed into the tree.
+		std::vector< tree_route_t > m_tree_routes;
+
+		//! Routes that are matched by regex (in the order of addition).
+		std::vector< regex_route_t > m_regex_routes;
+
+		//! The count of added routes.
+		std::size_t m_routes_count{ 0u };
+
+		//! Handler that is called for requests that don't match any route.
+		non_matched_request_handler_t m_non_matched_request_handler;
+};
+
+} /* namespace router */
+
+} /* namespace restinio */
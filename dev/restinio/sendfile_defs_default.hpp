@@ -84,6 +84,41 @@ get_file_meta( file_descriptor_t fd )
 	return META{ fsize, std::chrono::system_clock::now() };
 }
 
+//! Read data from the current position of a file.
+/*!
+	Returns the count of bytes read, it is less than \a size only if
+	the end of the file is reached.
+
+	@since v.0.6.2
+*/
+inline std::size_t
+read_file_data( file_descriptor_t fd, char * buf, std::size_t size )
+{
+	const auto n = std::fread( buf, 1, size, fd );
+	if( n < size && std::ferror( fd ) )
+		throw exception_t{ "std::fread failed" };
+
+	return n;
+}
+
+//! Check that a path refers to a regular file.
+/*!
+	The type of a file can't be obtained via <cstdio>, so only
+	the possibility to open the file is checked.
+
+	@since v.0.6.2
+*/
+inline bool
+is_regular_file( const char * file_path ) noexcept
+{
+	std::FILE * f = std::fopen( file_path, "rb" );
+	if( !f )
+		return false;
+
+	std::fclose( f );
+	return true;
+}
+
 //! Close file by its descriptor.
 inline void
 close_file( file_descriptor_t fd )
@@ -101,6 +101,51 @@ get_file_meta( file_descriptor_t fd )
 	return META{ static_cast< file_size_t >( file_stat.st_size ), last_modified };
 }
 
+//! Read data from the current position of a file.
+/*!
+	Returns the count of bytes read, it is less than \a size only if
+	the end of the file is reached.
+
+	@since v.0.6.2
+*/
+inline std::size_t
+read_file_data( file_descriptor_t fd, char * buf, std::size_t size )
+{
+	std::size_t total = 0u;
+	while( total < size )
+	{
+		const auto n = ::read( fd, buf + total, size - total );
+		if( -1 == n )
+		{
+			if( EINTR == errno )
+				continue;
+
+			throw exception_t{
+				fmt::format( "unable to read file: {}", strerror( errno ) ) };
+		}
+		else if( 0 == n )
+			break;
+
+		total += static_cast< std::size_t >( n );
+	}
+
+	return total;
+}
+
+//! Check that a path refers to a regular file.
+/*!
+	A directory can be opened for reading too, but it fails
+	only when its data is read.
+
+	@since v.0.6.2
+*/
+inline bool
+is_regular_file( const char * file_path ) noexcept
+{
+	struct stat file_stat;
+	return 0 == ::stat( file_path, &file_stat ) && S_ISREG( file_stat.st_mode );
+}
+
 //! Close file by its descriptor.
 inline void
 close_file( file_descriptor_t fd )
@@ -12,6 +12,7 @@
 
 #if defined(RESTINIO_ASIO_HAS_WINDOWS_OVERLAPPED_PTR)
 
+#include <algorithm>
 #include <cstdio>
 
 namespace restinio
@@ -115,6 +116,71 @@ get_file_meta( file_descriptor_t fd )
 	return META{ fsize, flastmodified};
 }
 
+//! Read data from the beginning of a file.
+/*!
+	Returns the count of bytes read, it is less than \a size only if
+	the end of the file is reached.
+
+	@since v.0.6.2
+*/
+inline std::size_t
+read_file_data( file_descriptor_t fd, char * buf, std::size_t size )
+{
+	std::size_t total = 0u;
+	while( total < size )
+	{
+		// File is opened for overlapped IO, so the offset is
+		// always specified and the result is waited for.
+		OVERLAPPED overlapped{};
+		const auto offset = static_cast< std::uint64_t >( total );
+		overlapped.Offset = static_cast< DWORD >( offset & 0xFFFFFFFFu );
+		overlapped.OffsetHigh = static_cast< DWORD >( offset >> 32 );
+
+		const auto part = static_cast< DWORD >(
+			std::min< std::size_t >( size - total, 0x40000000u ) );
+
+		DWORD n = 0;
+		if( !ReadFile( fd, buf + total, part, nullptr, &overlapped ) )
+		{
+			const auto error = GetLastError();
+			if( ERROR_HANDLE_EOF == error )
+				break;
+			else if( ERROR_IO_PENDING != error )
+				throw exception_t{
+					fmt::format( "unable to read file: error code:{}", error ) };
+		}
+
+		if( !GetOverlappedResult( fd, &overlapped, &n, TRUE ) )
+		{
+			const auto error = GetLastError();
+			if( ERROR_HANDLE_EOF == error )
+				break;
+
+			throw exception_t{
+				fmt::format( "unable to read file: error code:{}", error ) };
+		}
+
+		if( 0 == n )
+			break;
+
+		total += n;
+	}
+
+	return total;
+}
+
+//! Check that a path refers to a regular file.
+/*!
+	@since v.0.6.2
+*/
+inline bool
+is_regular_file( const char * file_path ) noexcept
+{
+	const auto attributes = GetFileAttributesA( file_path );
+	return INVALID_FILE_ATTRIBUTES != attributes &&
+		0 == ( attributes & ( FILE_ATTRIBUTE_DIRECTORY | FILE_ATTRIBUTE_DEVICE ) );
+}
+
 //! Close file by its descriptor.
 inline void
 close_file( file_descriptor_t fd )
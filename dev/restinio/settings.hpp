@@ -15,6 +15,7 @@
 #include <restinio/asio_include.hpp>
 
 #include <restinio/exception.hpp>
+#include <restinio/incoming_http_msg_limits.hpp>
 #include <restinio/request_handler.hpp>
 #include <restinio/traits.hpp>
 
@@ -639,6 +640,154 @@ class basic_server_settings_t
 		}
 		//! \}
 
+		//! Batch dispatching of pipelined requests.
+		/*!
+			If enabled then all complete requests that are already
+			in the input buffer of a connection are parsed and passed
+			to the request handler in one pass. Responses created
+			during that pass are not written one by one: ready responses
+			are coalesced into a single write operation.
+
+			It makes sense only if max_pipelined_requests() is greater than 1.
+
+			Disabled by default.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Derived &
+		batch_pipelined_requests( bool enable ) &
+		{
+			m_batch_pipelined_requests = enable;
+			return reference_to_derived();
+		}
+
+		Derived &&
+		batch_pipelined_requests( bool enable ) &&
+		{
+			return std::move( this->batch_pipelined_requests( enable ) );
+		}
+
+		bool
+		batch_pipelined_requests() const noexcept
+		{
+			return m_batch_pipelined_requests;
+		}
+		//! \}
+
+		//! Size of per-connection arena for data of incoming requests.
+		/*!
+			If size is not zero then every connection preallocates
+			a buffer of that size and the container of header fields
+			and request_t objects are placed there. The buffer is reused
+			for every request on the connection, so most of requests
+			don't require allocation of that data from the heap.
+
+			If the buffer is exhausted (e.g. because of several pipelined
+			requests held by request handler) the data is allocated
+			from the heap.
+
+			Value 0 (the default) disables arenas.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Derived &
+		request_arena_size( std::size_t size ) &
+		{
+			m_request_arena_size = size;
+			return reference_to_derived();
+		}
+
+		Derived &&
+		request_arena_size( std::size_t size ) &&
+		{
+			return std::move( this->request_arena_size( size ) );
+		}
+
+		std::size_t
+		request_arena_size() const noexcept
+		{
+			return m_request_arena_size;
+		}
+		//! \}
+
+		//! Zero-copy parsing of header fields.
+		/*!
+			If turned on then header fields of incoming requests are not
+			copied to separate strings. The raw header block is collected
+			into a single buffer instead and fields are available via
+			request_t::header_view() as views into that buffer. request_t::header() contains
+			the method, the request target and other request line data
+			and only those fields that are used by RESTinio itself and by
+			its helpers: Content-Type, Content-Encoding, Transfer-Encoding,
+			Accept-Encoding, If-None-Match and If-Modified-Since.
+			Body consumer factory also sees only those fields.
+
+			All fields of upgrade requests are also copied to
+			request_t::header(), so websocket upgrade works as usual.
+
+			Turned off by default.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Derived &
+		zero_copy_header_parsing( bool enable ) &
+		{
+			m_zero_copy_header_parsing = enable;
+			return reference_to_derived();
+		}
+
+		Derived &&
+		zero_copy_header_parsing( bool enable ) &&
+		{
+			return std::move( this->zero_copy_header_parsing( enable ) );
+		}
+
+		bool
+		zero_copy_header_parsing() const noexcept
+		{
+			return m_zero_copy_header_parsing;
+		}
+		//! \}
+
+		//! Limits for incoming http messages.
+		/*!
+			Limits are checked during parsing, so the memory for
+			a too big header or body isn't allocated at all.
+			If a limit is exceeded a response with status 413, 414 or 431
+			is sent, the connection is closed and the connection state
+			listener (if any) is informed by
+			connection_state::limit_exceeded_t notice.
+
+			See incoming_http_msg_limits_t for details.
+
+			All limits are turned off by default.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Derived &
+		incoming_http_msg_limits( incoming_http_msg_limits_t limits ) & noexcept
+		{
+			m_incoming_http_msg_limits = limits;
+			return reference_to_derived();
+		}
+
+		Derived &&
+		incoming_http_msg_limits( incoming_http_msg_limits_t limits ) && noexcept
+		{
+			return std::move( this->incoming_http_msg_limits( limits ) );
+		}
+
+		const incoming_http_msg_limits_t &
+		incoming_http_msg_limits() const noexcept
+		{
+			return m_incoming_http_msg_limits;
+		}
+		//! \}
+
 
 		//! Request handler.
 		//! \{
@@ -879,6 +1028,41 @@ class basic_server_settings_t
 		}
 		//! \}
 
+		/*!
+		 * @brief Factory of consumers for request bodies.
+		 *
+		 * If the factory is set it is called for every request just after
+		 * the request headers are parsed. If the factory returns
+		 * an actual consumer then the body of the request is passed
+		 * to that consumer chunk by chunk instead of being collected in
+		 * request_t. See incoming_body_consumer_t for more details.
+		 *
+		 * @since v.0.6.2
+		 */
+		//! \{
+		Derived &
+		incoming_body_consumer_factory(
+			incoming_body_consumer_factory_t factory ) &
+		{
+			m_incoming_body_consumer_factory = std::move( factory );
+			return reference_to_derived();
+		}
+
+		Derived &&
+		incoming_body_consumer_factory(
+			incoming_body_consumer_factory_t factory ) &&
+		{
+			return std::move( this->incoming_body_consumer_factory(
+					std::move( factory ) ) );
+		}
+
+		const incoming_body_consumer_factory_t &
+		incoming_body_consumer_factory() const noexcept
+		{
+			return m_incoming_body_consumer_factory;
+		}
+		//! \}
+
 		/*!
 		 * @brief Setter for connection state listener.
 		 *
@@ -1165,6 +1349,18 @@ class basic_server_settings_t
 		//! Max pipelined requests to receive on single connection.
 		std::size_t m_max_pipelined_requests{ 1 };
 
+		//! Are pipelined requests dispatched in batches?
+		bool m_batch_pipelined_requests{ false };
+
+		//! Size of per-connection arena for requests data.
+		std::size_t m_request_arena_size{ 0 };
+
+		//! Is zero-copy parsing of header fields used?
+		bool m_zero_copy_header_parsing{ false };
+
+		//! Limits for incoming http messages.
+		incoming_http_msg_limits_t m_incoming_http_msg_limits;
+
 		//! Request handler.
 		std::unique_ptr< request_handler_t > m_request_handler;
 
@@ -1187,6 +1383,9 @@ class basic_server_settings_t
 
 		//! Optional cleanup functor.
 		cleanup_functor_t m_cleanup_functor;
+
+		//! Optional factory of consumers for request bodies.
+		incoming_body_consumer_factory_t m_incoming_body_consumer_factory;
 };
 
 //
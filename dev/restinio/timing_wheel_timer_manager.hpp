@@ -0,0 +1,404 @@
+/*
+	restinio
+*/
+
+/*!
+	Timer factory implementation based on hashed timing wheel.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <memory>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include <restinio/asio_include.hpp>
+
+#include <restinio/utils/suppress_exceptions.hpp>
+
+#include <restinio/timer_common.hpp>
+#include <restinio/null_lock.hpp>
+#include <restinio/compiler_features.hpp>
+
+namespace restinio
+{
+
+namespace timing_wheel_details
+{
+
+//
+// node_t
+//
+
+//! An item of timing wheel slot.
+/*!
+	Slots of the wheel are intrusive circular doubly linked lists,
+	so an item can be inserted or removed in O(1) without any
+	memory allocation.
+
+	@since v.0.6.2
+*/
+struct node_t
+{
+	node_t() noexcept = default;
+	node_t( const node_t & ) = delete;
+	node_t & operator=( const node_t & ) = delete;
+
+	node_t * m_prev{ this };
+	node_t * m_next{ this };
+
+	//! Context to be checked when the slot of the node is expired.
+	tcp_connection_ctx_weak_handle_t m_weak_handle;
+
+	bool
+	is_linked() const noexcept { return this != m_next; }
+
+	//! Insert this node before \a pos.
+	void
+	link_before( node_t & pos ) noexcept
+	{
+		m_prev = pos.m_prev;
+		m_next = &pos;
+		pos.m_prev->m_next = this;
+		pos.m_prev = this;
+	}
+
+	void
+	unlink() noexcept
+	{
+		m_prev->m_next = m_next;
+		m_next->m_prev = m_prev;
+		m_prev = m_next = this;
+	}
+};
+
+} /* namespace timing_wheel_details */
+
+//
+// basic_timing_wheel_timer_manager_t
+//
+
+//! Timer factory implementation based on hashed timing wheel.
+/*!
+	Unlike asio_timer_manager_t that creates a separate asio timer
+	for every connection this manager uses a single ticking timer
+	for all connections served on the io_context. Every tick
+	the manager moves to the next slot of the wheel and invokes
+	timeout checks for all contexts scheduled into that slot.
+
+	Both scheduling and cancelation are O(1) and don't allocate memory,
+	so the cost of re-arming a timeout guard on every I/O operation
+	doesn't depend on the count of connections.
+
+	The accuracy of timeout checks is limited by \a tick_period:
+	a context is checked not earlier than `check_period - tick_period`
+	after scheduling and not later than `check_period`.
+
+	\tparam Lock a type of lock for protecting the wheel.
+	std::mutex should be used if the server runs on a thread pool,
+	null_lock_t is enough for single-threaded server.
+
+	Usage example:
+	\code
+	using traits_t =
+		restinio::traits_t<
+			restinio::timing_wheel_timer_manager_t,
+			restinio::single_threaded_ostream_logger_t >;
+
+	restinio::run(
+		restinio::on_thread_pool< traits_t >( 4 )
+			.timer_manager( std::chrono::seconds{ 1 }, std::chrono::milliseconds{ 100 } )
+			.request_handler( ... ) );
+	\endcode
+
+	@since v.0.6.2
+*/
+template < typename Lock >
+class basic_timing_wheel_timer_manager_t final
+	:	public std::enable_shared_from_this< basic_timing_wheel_timer_manager_t< Lock > >
+{
+		using node_t = timing_wheel_details::node_t;
+
+	public:
+		basic_timing_wheel_timer_manager_t(
+			asio_ns::io_context & io_context,
+			std::chrono::steady_clock::duration check_period,
+			std::chrono::steady_clock::duration tick_period )
+			:	m_tick_period{ normalize_tick_period( check_period, tick_period ) }
+			,	m_ticks_per_check{
+					calculate_ticks_per_check( check_period, m_tick_period ) }
+			,	m_slots( m_ticks_per_check + 1u )
+			,	m_ticking_timer{ io_context }
+		{}
+
+		basic_timing_wheel_timer_manager_t(
+			const basic_timing_wheel_timer_manager_t & ) = delete;
+		basic_timing_wheel_timer_manager_t & operator=(
+			const basic_timing_wheel_timer_manager_t & ) = delete;
+
+		//! Timer guard for async operations.
+		class timer_guard_t final
+		{
+			public:
+				timer_guard_t(
+					std::shared_ptr< basic_timing_wheel_timer_manager_t > manager )
+					:	m_manager{ std::move( manager ) }
+					,	m_node{ std::make_unique< node_t >() }
+				{}
+
+				timer_guard_t( timer_guard_t && ) = default;
+				timer_guard_t & operator=( timer_guard_t && ) = delete;
+
+				~timer_guard_t()
+				{
+					if( m_node )
+						cancel();
+				}
+
+				//! Schedule timeouts check invocation.
+				/*!
+					If the guard is already scheduled then it is rescheduled.
+				*/
+				void
+				schedule( tcp_connection_ctx_weak_handle_t weak_handle )
+				{
+					m_manager->schedule( *m_node, std::move( weak_handle ) );
+				}
+
+				//! Cancel timeout guard if any.
+				void
+				cancel() noexcept
+				{
+					m_manager->cancel( *m_node );
+				}
+
+			private:
+				std::shared_ptr< basic_timing_wheel_timer_manager_t > m_manager;
+
+				//! Item of the wheel.
+				/*!
+					Is allocated dynamically to keep its address stable
+					even if the guard is moved.
+				*/
+				std::unique_ptr< node_t > m_node;
+		};
+
+		//! Create guard for connection.
+		timer_guard_t
+		create_timer_guard()
+		{
+			return timer_guard_t{ this->shared_from_this() };
+		}
+
+		//! @name Start/stop timer manager.
+		///@{
+		void
+		start()
+		{
+			std::lock_guard< Lock > lock{ m_lock };
+			if( !m_running )
+			{
+				m_running = true;
+				schedule_next_tick();
+			}
+		}
+
+		void
+		stop() noexcept
+		{
+			std::lock_guard< Lock > lock{ m_lock };
+			m_running = false;
+			restinio::utils::suppress_exceptions_quietly(
+					[this]{ m_ticking_timer.cancel(); } );
+		}
+		///@}
+
+		struct factory_t final
+		{
+			//! Check period for timer events.
+			const std::chrono::steady_clock::duration
+				m_check_period{ std::chrono::seconds{ 1 } };
+
+			//! Period of wheel ticks.
+			const std::chrono::steady_clock::duration
+				m_tick_period{ std::chrono::milliseconds{ 100 } };
+
+			factory_t() noexcept = default;
+			factory_t( std::chrono::steady_clock::duration check_period ) noexcept
+				:	m_check_period{ check_period }
+				,	m_tick_period{ check_period / 10 }
+			{}
+			factory_t(
+				std::chrono::steady_clock::duration check_period,
+				std::chrono::steady_clock::duration tick_period ) noexcept
+				:	m_check_period{ check_period }
+				,	m_tick_period{ tick_period }
+			{}
+
+			//! Create an instance of timer manager.
+			auto
+			create( asio_ns::io_context & io_context ) const
+			{
+				return std::make_shared< basic_timing_wheel_timer_manager_t >(
+						io_context, m_check_period, m_tick_period );
+			}
+		};
+
+	private:
+		static std::chrono::steady_clock::duration
+		normalize_tick_period(
+			std::chrono::steady_clock::duration check_period,
+			std::chrono::steady_clock::duration tick_period ) noexcept
+		{
+			using duration_t = std::chrono::steady_clock::duration;
+
+			if( tick_period <= duration_t::zero() || tick_period > check_period )
+				tick_period = check_period;
+			if( tick_period <= duration_t::zero() )
+				tick_period = std::chrono::milliseconds{ 1 };
+
+			return tick_period;
+		}
+
+		static std::size_t
+		calculate_ticks_per_check(
+			std::chrono::steady_clock::duration check_period,
+			std::chrono::steady_clock::duration tick_period ) noexcept
+		{
+			// Round up to cover the whole check period.
+			const auto ticks =
+					( check_period + tick_period - std::chrono::steady_clock::duration{ 1 } )
+					/ tick_period;
+
+			return 0 < ticks ? static_cast< std::size_t >( ticks ) : 1u;
+		}
+
+		void
+		schedule( node_t & node, tcp_connection_ctx_weak_handle_t weak_handle )
+		{
+			std::lock_guard< Lock > lock{ m_lock };
+
+			if( node.is_linked() )
+				node.unlink();
+
+			node.m_weak_handle = std::move( weak_handle );
+			node.link_before(
+					m_slots[ ( m_current_slot + m_ticks_per_check ) % m_slots.size() ] );
+		}
+
+		void
+		cancel( node_t & node ) noexcept
+		{
+			std::lock_guard< Lock > lock{ m_lock };
+
+			if( node.is_linked() )
+			{
+				node.unlink();
+				node.m_weak_handle.reset();
+			}
+		}
+
+		//! Arm the ticking timer.
+		/*!
+			\note
+			Must be called under the lock.
+		*/
+		void
+		schedule_next_tick()
+		{
+			m_ticking_timer.expires_after( m_tick_period );
+			m_ticking_timer.async_wait(
+					[ weak_self = std::weak_ptr< basic_timing_wheel_timer_manager_t >{
+							this->shared_from_this() } ]( const auto & ec ){
+						if( !ec )
+						{
+							if( auto self = weak_self.lock() )
+								self->on_tick();
+						}
+					} );
+		}
+
+		//! Move to the next slot and check all contexts from it.
+		void
+		on_tick()
+		{
+			{
+				std::lock_guard< Lock > lock{ m_lock };
+				if( !m_running )
+					return;
+
+				m_current_slot = ( m_current_slot + 1u ) % m_slots.size();
+
+				// Expired items are unlinked under the lock but contexts are
+				// invoked without it: check_timeout can reschedule the context
+				// in the same thread.
+				auto & slot = m_slots[ m_current_slot ];
+				while( slot.is_linked() )
+				{
+					node_t & node = *slot.m_next;
+					m_expired.push_back( std::move( node.m_weak_handle ) );
+					node.unlink();
+				}
+			}
+
+			for( auto & weak_handle : m_expired )
+			{
+				// An exception from one context must not stop the wheel.
+				restinio::utils::suppress_exceptions_quietly( [&weak_handle] {
+						if( auto h = weak_handle.lock() )
+						{
+							h->check_timeout( h );
+						}
+					} );
+			}
+			m_expired.clear();
+
+			std::lock_guard< Lock > lock{ m_lock };
+			if( m_running )
+				schedule_next_tick();
+		}
+
+		//! Duration of a single tick.
+		const std::chrono::steady_clock::duration m_tick_period;
+
+		//! Count of ticks that form check period.
+		const std::size_t m_ticks_per_check;
+
+		//! Lock for protecting the wheel.
+		Lock m_lock;
+
+		//! Is manager started.
+		bool m_running{ false };
+
+		//! Slots of the wheel.
+		/*!
+			Every slot is a head of circular list of nodes.
+		*/
+		std::vector< node_t > m_slots;
+
+		//! Index of the slot for the current tick.
+		std::size_t m_current_slot{ 0u };
+
+		//! Handles extracted from expired slot.
+		/*!
+			Is accessed only from tick handler and is kept as a member
+			to reuse its capacity.
+		*/
+		std::vector< tcp_connection_ctx_weak_handle_t > m_expired;
+
+		//! The only asio timer used by the manager.
+		asio_ns::steady_timer m_ticking_timer;
+};
+
+//! Timing wheel timer manager for servers running on a thread pool.
+using timing_wheel_timer_manager_t =
+	basic_timing_wheel_timer_manager_t< std::mutex >;
+
+//! Timing wheel timer manager for single-threaded servers.
+using single_threaded_timing_wheel_timer_manager_t =
+	basic_timing_wheel_timer_manager_t< null_lock_t >;
+
+} /* namespace restinio */
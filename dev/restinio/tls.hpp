@@ -10,6 +10,9 @@
 
 #include <restinio/traits.hpp>
 #include <restinio/impl/tls_socket.hpp>
+#include <restinio/tls_session_resumption.hpp>
+
+#include <atomic>
 
 namespace restinio
 {
@@ -90,6 +93,106 @@ public:
 	{
 		return m_tls_socket.asio_ssl_stream().native_handle();
 	}
+
+	/*!
+	 * @brief Was the TLS session resumed instead of a full handshake?
+	 *
+	 * @since v.0.6.2
+	 */
+	RESTINIO_NODISCARD
+	bool session_resumed() const noexcept
+	{
+		return m_tls_socket.session_resumed();
+	}
+
+	/*!
+	 * @brief Time spent on the TLS handshake.
+	 *
+	 * @since v.0.6.2
+	 */
+	RESTINIO_NODISCARD
+	std::chrono::steady_clock::duration handshake_duration() const noexcept
+	{
+		return m_tls_socket.handshake_duration();
+	}
+};
+
+/*!
+ * @brief Thread-safe counters of TLS handshakes.
+ *
+ * Can be used by a connection state listener:
+ * \code
+ * struct my_state_listener_t {
+ * 	restinio::connection_state::tls_handshake_counters_t m_handshakes;
+ *
+ * 	void state_changed( const restinio::connection_state::notice_t & notice ) {
+ * 		const auto cause = notice.cause();
+ * 		if( auto * accepted = restinio::get_if<
+ * 				restinio::connection_state::accepted_t >( &cause ) )
+ * 			accepted->try_inspect_tls( [this]( const auto & tls ) {
+ * 				m_handshakes.handshake_completed( tls );
+ * 			} );
+ * 	}
+ * };
+ * \endcode
+ *
+ * @since v.0.6.2
+ */
+class tls_handshake_counters_t
+{
+	std::atomic< std::uint64_t > m_full{ 0u };
+	std::atomic< std::uint64_t > m_resumed{ 0u };
+	std::atomic< std::uint64_t > m_full_duration_us{ 0u };
+	std::atomic< std::uint64_t > m_resumed_duration_us{ 0u };
+
+public:
+	//! Count a completed handshake.
+	void
+	handshake_completed( const tls_accessor_t & tls ) noexcept
+	{
+		const auto us = static_cast< std::uint64_t >(
+				std::chrono::duration_cast< std::chrono::microseconds >(
+						tls.handshake_duration() ).count() );
+
+		if( tls.session_resumed() )
+		{
+			++m_resumed;
+			m_resumed_duration_us += us;
+		}
+		else
+		{
+			++m_full;
+			m_full_duration_us += us;
+		}
+	}
+
+	//! Count of full handshakes.
+	RESTINIO_NODISCARD
+	std::uint64_t full() const noexcept { return m_full.load(); }
+
+	//! Count of handshakes with resumed sessions.
+	RESTINIO_NODISCARD
+	std::uint64_t resumed() const noexcept { return m_resumed.load(); }
+
+	//! Total time spent on full handshakes.
+	RESTINIO_NODISCARD
+	std::chrono::microseconds
+	full_duration() const noexcept
+	{
+		return std::chrono::microseconds(
+				static_cast< std::chrono::microseconds::rep >(
+						m_full_duration_us.load() ) );
+	}
+
+	//! Total time spent on handshakes with resumed sessions.
+	RESTINIO_NODISCARD
+	std::chrono::microseconds
+	resumed_duration() const noexcept
+	{
+		return std::chrono::microseconds(
+				static_cast< std::chrono::microseconds::rep >(
+						m_resumed_duration_us.load() ) );
+	}
 };
 
 //
@@ -169,7 +272,13 @@ prepare_connection_and_start_read(
 		asio_ns::ssl::stream_base::server,
 		[ start_read_cb = std::move( start_read_cb ),
 			failed_cb = std::move( failed_cb ),
-			con = con.shared_from_this() ]( const asio_ns::error_code & ec ){
+			con = con.shared_from_this(),
+			&socket,
+			started_at = std::chrono::steady_clock::now() ]
+		( const asio_ns::error_code & ec ){
+			socket.handshake_duration(
+					std::chrono::steady_clock::now() - started_at );
+
 			if( !ec )
 				start_read_cb();
 			else
@@ -217,6 +326,63 @@ public:
 			return asio_ns::ssl::context{ std::move( m_tls_context ) };
 		}
 
+		//! Server-side cache of TLS sessions.
+		/*!
+			If it isn't set then the internal cache of OpenSSL is used.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Settings &
+		tls_session_cache( std::shared_ptr< tls_session_cache_t > cache ) &
+		{
+			m_tls_session_cache = std::move( cache );
+			return upcast_reference();
+		}
+
+		Settings &&
+		tls_session_cache( std::shared_ptr< tls_session_cache_t > cache ) &&
+		{
+			return std::move( this->tls_session_cache( std::move( cache ) ) );
+		}
+
+		const std::shared_ptr< tls_session_cache_t > &
+		tls_session_cache() const noexcept
+		{
+			return m_tls_session_cache;
+		}
+		//! \}
+
+		//! Rotated keys for stateless session tickets.
+		/*!
+			If it isn't set then OpenSSL uses a single key generated
+			at the start.
+
+			@since v.0.6.2
+		*/
+		//! \{
+		Settings &
+		tls_session_ticket_keys(
+			std::shared_ptr< tls_session_ticket_keys_t > keys ) &
+		{
+			m_tls_session_ticket_keys = std::move( keys );
+			return upcast_reference();
+		}
+
+		Settings &&
+		tls_session_ticket_keys(
+			std::shared_ptr< tls_session_ticket_keys_t > keys ) &&
+		{
+			return std::move( this->tls_session_ticket_keys( std::move( keys ) ) );
+		}
+
+		const std::shared_ptr< tls_session_ticket_keys_t > &
+		tls_session_ticket_keys() const noexcept
+		{
+			return m_tls_session_ticket_keys;
+		}
+		//! \}
+
 	private:
 		Settings &
 		upcast_reference()
@@ -225,6 +391,9 @@ public:
 		}
 
 		asio_ns::ssl::context m_tls_context{ asio_ns::ssl::context::sslv23 };
+
+		std::shared_ptr< tls_session_cache_t > m_tls_session_cache;
+		std::shared_ptr< tls_session_ticket_keys_t > m_tls_session_ticket_keys;
 };
 
 namespace impl
@@ -254,6 +423,14 @@ class socket_supplier_t< tls_socket_t >
 			:	m_tls_context{ std::make_shared< asio_ns::ssl::context >( settings.tls_context() ) }
 			,	m_io_context{ io_context }
 		{
+			if( settings.tls_session_cache() )
+				use_tls_session_cache(
+					*m_tls_context, settings.tls_session_cache() );
+
+			if( settings.tls_session_ticket_keys() )
+				use_tls_session_ticket_keys(
+					*m_tls_context, settings.tls_session_ticket_keys() );
+
 			m_sockets.reserve( settings.concurrent_accepts_count() );
 
 			while( m_sockets.size() < settings.concurrent_accepts_count() )
@@ -0,0 +1,792 @@
+/*
+	restinio
+*/
+
+/*!
+	TLS session resumption: server-side session cache and
+	session ticket keys.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/asio_include.hpp>
+#include <restinio/exception.hpp>
+
+#if !defined(RESTINIO_USE_BOOST_ASIO)
+  #include <asio/ssl.hpp>
+#else
+  #include <boost/asio/ssl.hpp>
+#endif
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	#include <openssl/core_names.h>
+#else
+	#include <openssl/hmac.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace restinio
+{
+
+//
+// tls_session_cache_params_t
+//
+
+//! Parameters of tls_session_cache_t.
+/*!
+	@since v.0.6.2
+*/
+class tls_session_cache_params_t
+{
+	public:
+		//! Max count of sessions kept in the cache.
+		//! \{
+		tls_session_cache_params_t &
+		max_sessions( std::size_t v ) & noexcept
+		{
+			m_max_sessions = v;
+			return *this;
+		}
+
+		tls_session_cache_params_t &&
+		max_sessions( std::size_t v ) && noexcept
+		{
+			return std::move( this->max_sessions( v ) );
+		}
+
+		std::size_t
+		max_sessions() const noexcept { return m_max_sessions; }
+		//! \}
+
+		//! Count of independent parts of the cache.
+		/*!
+			Every shard has its own lock, so handshakes on different
+			threads rarely wait for each other.
+		*/
+		//! \{
+		tls_session_cache_params_t &
+		shards_count( std::size_t v ) &
+		{
+			if( 0u == v )
+				throw exception_t{ "shards_count can't be zero" };
+
+			m_shards_count = v;
+			return *this;
+		}
+
+		tls_session_cache_params_t &&
+		shards_count( std::size_t v ) &&
+		{
+			return std::move( this->shards_count( v ) );
+		}
+
+		std::size_t
+		shards_count() const noexcept { return m_shards_count; }
+		//! \}
+
+		//! Lifetime of a session.
+		/*!
+			It is also used as the lifetime of session tickets.
+		*/
+		//! \{
+		tls_session_cache_params_t &
+		timeout( std::chrono::seconds v ) & noexcept
+		{
+			m_timeout = v;
+			return *this;
+		}
+
+		tls_session_cache_params_t &&
+		timeout( std::chrono::seconds v ) && noexcept
+		{
+			return std::move( this->timeout( v ) );
+		}
+
+		std::chrono::seconds
+		timeout() const noexcept { return m_timeout; }
+		//! \}
+
+	private:
+		std::size_t m_max_sessions{ 20 * 1024 };
+		std::size_t m_shards_count{ 16 };
+		std::chrono::seconds m_timeout{ 3600 };
+};
+
+//
+// tls_session_cache_stats_t
+//
+
+//! Counters of tls_session_cache_t.
+/*!
+	@since v.0.6.2
+*/
+struct tls_session_cache_stats_t
+{
+	std::uint64_t m_hits{ 0 };
+	std::uint64_t m_misses{ 0 };
+	//! Sessions removed to free space for new ones.
+	std::uint64_t m_evictions{ 0 };
+	//! Sessions removed because they are expired.
+	std::uint64_t m_timeouts{ 0 };
+	std::size_t m_sessions_count{ 0 };
+};
+
+//
+// tls_session_cache_t
+//
+
+//! Server-side cache of TLS sessions for resumption by session id.
+/*!
+	Replaces the internal cache of OpenSSL that is protected by a single
+	lock. The cache is split into shards selected by session id.
+	Every shard has its own lock and its own LRU list, so the count
+	of sessions is bounded by tls_session_cache_params_t::max_sessions().
+
+	One instance can be shared by several servers.
+
+	Usage example:
+	\code
+	auto cache = std::make_shared< restinio::tls_session_cache_t >(
+		restinio::tls_session_cache_params_t{}.max_sessions( 100000 ) );
+
+	restinio::run(
+		restinio::on_thread_pool< restinio::default_tls_traits_t >( 4 )
+			.tls_context( std::move( tls_context ) )
+			.tls_session_cache( cache )
+			...
+	\endcode
+
+	This class is thread safe.
+
+	@since v.0.6.2
+*/
+class tls_session_cache_t
+{
+	public:
+		explicit tls_session_cache_t(
+			tls_session_cache_params_t params = tls_session_cache_params_t{} )
+			:	m_params{ std::move( params ) }
+			,	m_shards( m_params.shards_count() )
+		{
+			const auto per_shard = m_params.max_sessions() / m_shards.size();
+			for( auto & s : m_shards )
+				s.m_capacity = std::max< std::size_t >( 1u, per_shard );
+		}
+
+		tls_session_cache_t( const tls_session_cache_t & ) = delete;
+		tls_session_cache_t & operator = ( const tls_session_cache_t & ) = delete;
+
+		~tls_session_cache_t()
+		{
+			clear();
+		}
+
+		const tls_session_cache_params_t &
+		params() const noexcept { return m_params; }
+
+		//! Store a session.
+		/*!
+			The cache takes one reference to \a session.
+		*/
+		void
+		insert( SSL_SESSION * session )
+		{
+			const auto id = session_id( session );
+			auto & s = shard( id );
+
+			std::vector< SSL_SESSION * > to_free;
+			{
+				std::lock_guard< std::mutex > lock{ s.m_lock };
+
+				const auto it = s.m_index.find( id );
+				if( it != s.m_index.end() )
+				{
+					to_free.push_back( it->second->m_session );
+					s.m_lru.erase( it->second );
+					s.m_index.erase( it );
+				}
+
+				while( s.m_capacity <= s.m_index.size() )
+				{
+					to_free.push_back( s.m_lru.front().m_session );
+					s.m_index.erase( s.m_lru.front().m_id );
+					s.m_lru.pop_front();
+					++s.m_stats.m_evictions;
+				}
+
+				s.m_lru.push_back( entry_t{ id, session } );
+				s.m_index.emplace( id, std::prev( s.m_lru.end() ) );
+			}
+
+			for( auto * p : to_free )
+				::SSL_SESSION_free( p );
+		}
+
+		//! Find a session.
+		/*!
+			Returns a new reference to the found session
+			or nullptr if there is no such session or it is expired.
+		*/
+		SSL_SESSION *
+		find( const std::string & id )
+		{
+			auto & s = shard( id );
+
+			SSL_SESSION * expired = nullptr;
+			SSL_SESSION * result = nullptr;
+			{
+				std::lock_guard< std::mutex > lock{ s.m_lock };
+
+				const auto it = s.m_index.find( id );
+				if( it == s.m_index.end() )
+				{
+					++s.m_stats.m_misses;
+					return nullptr;
+				}
+
+				auto * session = it->second->m_session;
+				if( is_expired( session ) )
+				{
+					expired = session;
+					s.m_lru.erase( it->second );
+					s.m_index.erase( it );
+					++s.m_stats.m_timeouts;
+					++s.m_stats.m_misses;
+				}
+				else
+				{
+					::SSL_SESSION_up_ref( session );
+					s.m_lru.splice( s.m_lru.end(), s.m_lru, it->second );
+					++s.m_stats.m_hits;
+					result = session;
+				}
+			}
+
+			if( expired )
+				::SSL_SESSION_free( expired );
+
+			return result;
+		}
+
+		//! Remove a session.
+		void
+		remove( const std::string & id )
+		{
+			auto & s = shard( id );
+
+			SSL_SESSION * session = nullptr;
+			{
+				std::lock_guard< std::mutex > lock{ s.m_lock };
+
+				const auto it = s.m_index.find( id );
+				if( it == s.m_index.end() )
+					return;
+
+				session = it->second->m_session;
+				s.m_lru.erase( it->second );
+				s.m_index.erase( it );
+			}
+
+			::SSL_SESSION_free( session );
+		}
+
+		//! Remove all sessions.
+		void
+		clear()
+		{
+			for( auto & s : m_shards )
+			{
+				std::list< entry_t > lru;
+				{
+					std::lock_guard< std::mutex > lock{ s.m_lock };
+					s.m_index.clear();
+					lru.swap( s.m_lru );
+				}
+
+				for( auto & e : lru )
+					::SSL_SESSION_free( e.m_session );
+			}
+		}
+
+		tls_session_cache_stats_t
+		stats() const
+		{
+			tls_session_cache_stats_t result;
+			for( auto & s : m_shards )
+			{
+				std::lock_guard< std::mutex > lock{ s.m_lock };
+				result.m_hits += s.m_stats.m_hits;
+				result.m_misses += s.m_stats.m_misses;
+				result.m_evictions += s.m_stats.m_evictions;
+				result.m_timeouts += s.m_stats.m_timeouts;
+				result.m_sessions_count += s.m_index.size();
+			}
+
+			return result;
+		}
+
+		static std::string
+		session_id( const SSL_SESSION * session )
+		{
+			unsigned int len = 0u;
+			const auto * id = ::SSL_SESSION_get_id( session, &len );
+			return std::string{ reinterpret_cast< const char * >( id ), len };
+		}
+
+	private:
+		struct entry_t
+		{
+			std::string m_id;
+			SSL_SESSION * m_session;
+		};
+
+		struct shard_t
+		{
+			mutable std::mutex m_lock;
+			std::size_t m_capacity{ 1u };
+			//! The least recently used session is the first.
+			std::list< entry_t > m_lru;
+			std::unordered_map< std::string, std::list< entry_t >::iterator > m_index;
+			tls_session_cache_stats_t m_stats;
+		};
+
+		shard_t &
+		shard( const std::string & id )
+		{
+			return m_shards[ std::hash< std::string >{}( id ) % m_shards.size() ];
+		}
+
+		static bool
+		is_expired( const SSL_SESSION * session ) noexcept
+		{
+			const auto expires_at =
+				::SSL_SESSION_get_time( session ) + ::SSL_SESSION_get_timeout( session );
+			return expires_at <= static_cast< long >( std::time( nullptr ) );
+		}
+
+		const tls_session_cache_params_t m_params;
+		std::vector< shard_t > m_shards;
+};
+
+//
+// tls_session_ticket_keys_t
+//
+
+//! Keys for encryption of stateless TLS session tickets.
+/*!
+	OpenSSL generates a single random ticket key for a context
+	and uses it for the whole lifetime of the process. This class
+	replaces the key by a new random one every \a rotation_interval.
+	Tickets encrypted by previous \a keys_kept - 1 keys are still
+	accepted and are renewed by the new key.
+
+	The same instance is used by all threads that serve connections
+	of a server and can be shared by several servers.
+
+	Usage example:
+	\code
+	restinio::run(
+		restinio::on_thread_pool< restinio::default_tls_traits_t >( 4 )
+			.tls_context( std::move( tls_context ) )
+			.tls_session_ticket_keys(
+				std::make_shared< restinio::tls_session_ticket_keys_t >(
+					std::chrono::hours( 1 ) ) )
+			...
+	\endcode
+
+	This class is thread safe.
+
+	@since v.0.6.2
+*/
+class tls_session_ticket_keys_t
+{
+	public:
+		struct key_t
+		{
+			std::array< unsigned char, 16 > m_name;
+			std::array< unsigned char, 32 > m_aes_key;
+			std::array< unsigned char, 32 > m_hmac_key;
+		};
+
+		explicit tls_session_ticket_keys_t(
+			std::chrono::steady_clock::duration rotation_interval =
+				std::chrono::hours( 1 ),
+			std::size_t keys_kept = 2u )
+			:	m_rotation_interval{ rotation_interval }
+			,	m_keys_kept{ std::max< std::size_t >( 1u, keys_kept ) }
+		{
+			rotate();
+		}
+
+		//! Replace the current key by a new one.
+		void
+		rotate()
+		{
+			auto key = make_key();
+
+			std::lock_guard< std::mutex > lock{ m_lock };
+			push_key( key, std::chrono::steady_clock::now() );
+		}
+
+		//! Get the key for encryption of a new ticket.
+		/*!
+			The key is rotated if the rotation interval has passed.
+		*/
+		key_t
+		current_key()
+		{
+			const auto now = std::chrono::steady_clock::now();
+
+			std::unique_lock< std::mutex > lock{ m_lock };
+			if( m_next_rotation <= now )
+			{
+				lock.unlock();
+				auto key = make_key();
+				lock.lock();
+
+				// Another thread could do the rotation at the same time.
+				if( m_next_rotation <= now )
+					push_key( key, now );
+			}
+
+			return m_keys.front();
+		}
+
+		//! Find the key for decryption of a ticket.
+		/*!
+			\retval 0 if the key isn't found.
+			\retval 1 if the key is the current one.
+			\retval 2 if the key is an old one and the ticket should be renewed.
+		*/
+		int
+		find_key( const unsigned char * name, key_t & key ) const
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+
+			const auto it = std::find_if( m_keys.begin(), m_keys.end(),
+				[name]( const key_t & k ) {
+					return 0 == std::memcmp( k.m_name.data(), name, k.m_name.size() );
+				} );
+
+			if( it == m_keys.end() )
+				return 0;
+
+			key = *it;
+			return it == m_keys.begin() ? 1 : 2;
+		}
+
+		//! Count of keys that are accepted for decryption.
+		std::size_t
+		keys_count() const
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			return m_keys.size();
+		}
+
+	private:
+		static key_t
+		make_key()
+		{
+			key_t key;
+			if( 1 != ::RAND_bytes( key.m_name.data(), static_cast< int >( key.m_name.size() ) ) ||
+				1 != ::RAND_bytes( key.m_aes_key.data(), static_cast< int >( key.m_aes_key.size() ) ) ||
+				1 != ::RAND_bytes( key.m_hmac_key.data(), static_cast< int >( key.m_hmac_key.size() ) ) )
+				throw exception_t{ "unable to generate TLS session ticket key" };
+
+			return key;
+		}
+
+		void
+		push_key( const key_t & key, std::chrono::steady_clock::time_point now )
+		{
+			m_keys.push_front( key );
+			if( m_keys_kept < m_keys.size() )
+				m_keys.pop_back();
+
+			m_next_rotation = now + m_rotation_interval;
+		}
+
+		const std::chrono::steady_clock::duration m_rotation_interval;
+		const std::size_t m_keys_kept;
+
+		mutable std::mutex m_lock;
+		//! The current key is the first.
+		std::deque< key_t > m_keys;
+		std::chrono::steady_clock::time_point m_next_rotation;
+};
+
+namespace impl
+{
+
+namespace tls_session_resumption_details
+{
+
+template< typename T >
+void
+free_ctx_ex_data( void *, void * ptr, CRYPTO_EX_DATA *, int, long, void * )
+{
+	delete static_cast< std::shared_ptr< T > * >( ptr );
+}
+
+//! Index of ex_data of SSL_CTX for an object of type T.
+/*!
+	A heap allocated std::shared_ptr<T> is stored in ex_data,
+	so the object lives as long as SSL_CTX.
+*/
+template< typename T >
+int
+ctx_ex_data_index()
+{
+	static const int index = ::SSL_CTX_get_ex_new_index(
+			0, nullptr, nullptr, nullptr, &free_ctx_ex_data< T > );
+
+	return index;
+}
+
+template< typename T >
+void
+attach_to_ctx( SSL_CTX * ctx, std::shared_ptr< T > obj )
+{
+	const auto index = ctx_ex_data_index< T >();
+	if( index < 0 )
+		throw exception_t{ "unable to allocate ex_data index for SSL_CTX" };
+
+	std::unique_ptr< std::shared_ptr< T > > holder{
+		new std::shared_ptr< T >{ std::move( obj ) } };
+
+	delete static_cast< std::shared_ptr< T > * >(
+			::SSL_CTX_get_ex_data( ctx, index ) );
+
+	if( 1 != ::SSL_CTX_set_ex_data( ctx, index, holder.get() ) )
+		throw exception_t{ "unable to set ex_data for SSL_CTX" };
+
+	holder.release();
+}
+
+template< typename T >
+T *
+get_from_ctx( SSL_CTX * ctx ) noexcept
+{
+	const auto * holder = static_cast< std::shared_ptr< T > * >(
+			::SSL_CTX_get_ex_data( ctx, ctx_ex_data_index< T >() ) );
+
+	return holder ? holder->get() : nullptr;
+}
+
+inline int
+new_session_cb( SSL * ssl, SSL_SESSION * session ) noexcept
+{
+	auto * cache = get_from_ctx< tls_session_cache_t >( ::SSL_get_SSL_CTX( ssl ) );
+	if( !cache )
+		return 0;
+
+	try
+	{
+		cache->insert( session );
+		// The cache owns the reference now.
+		return 1;
+	}
+	catch( ... )
+	{
+		return 0;
+	}
+}
+
+inline SSL_SESSION *
+get_session_cb(
+	SSL * ssl,
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+	const unsigned char * id,
+#else
+	unsigned char * id,
+#endif
+	int len,
+	int * copy ) noexcept
+{
+	// The reference is already taken by the cache.
+	*copy = 0;
+
+	auto * cache = get_from_ctx< tls_session_cache_t >( ::SSL_get_SSL_CTX( ssl ) );
+	if( !cache )
+		return nullptr;
+
+	try
+	{
+		return cache->find(
+			std::string{ reinterpret_cast< const char * >( id ),
+				static_cast< std::size_t >( len ) } );
+	}
+	catch( ... )
+	{
+		return nullptr;
+	}
+}
+
+inline void
+remove_session_cb( SSL_CTX * ctx, SSL_SESSION * session ) noexcept
+{
+	auto * cache = get_from_ctx< tls_session_cache_t >( ctx );
+	if( !cache )
+		return;
+
+	try
+	{
+		cache->remove( tls_session_cache_t::session_id( session ) );
+	}
+	catch( ... )
+	{}
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+using ticket_mac_ctx_t = EVP_MAC_CTX;
+
+inline bool
+init_ticket_mac( EVP_MAC_CTX * hctx, const tls_session_ticket_keys_t::key_t & key ) noexcept
+{
+	char digest[] = "SHA256";
+	OSSL_PARAM params[] = {
+		::OSSL_PARAM_construct_octet_string(
+			OSSL_MAC_PARAM_KEY,
+			const_cast< unsigned char * >( key.m_hmac_key.data() ),
+			key.m_hmac_key.size() ),
+		::OSSL_PARAM_construct_utf8_string( OSSL_MAC_PARAM_DIGEST, digest, 0 ),
+		::OSSL_PARAM_construct_end()
+	};
+
+	return 1 == ::EVP_MAC_CTX_set_params( hctx, params );
+}
+#else
+using ticket_mac_ctx_t = HMAC_CTX;
+
+inline bool
+init_ticket_mac( HMAC_CTX * hctx, const tls_session_ticket_keys_t::key_t & key ) noexcept
+{
+	return 1 == ::HMAC_Init_ex(
+			hctx,
+			key.m_hmac_key.data(),
+			static_cast< int >( key.m_hmac_key.size() ),
+			::EVP_sha256(),
+			nullptr );
+}
+#endif
+
+inline int
+ticket_key_cb(
+	SSL * ssl,
+	unsigned char * key_name,
+	unsigned char * iv,
+	EVP_CIPHER_CTX * cctx,
+	ticket_mac_ctx_t * hctx,
+	int enc ) noexcept
+{
+	auto * keys = get_from_ctx< tls_session_ticket_keys_t >( ::SSL_get_SSL_CTX( ssl ) );
+	if( !keys )
+		return -1;
+
+	try
+	{
+		tls_session_ticket_keys_t::key_t key;
+		if( enc )
+		{
+			key = keys->current_key();
+
+			const auto iv_len = ::EVP_CIPHER_iv_length( ::EVP_aes_256_cbc() );
+			if( 1 != ::RAND_bytes( iv, iv_len ) )
+				return -1;
+
+			std::memcpy( key_name, key.m_name.data(), key.m_name.size() );
+
+			if( 1 != ::EVP_EncryptInit_ex(
+					cctx, ::EVP_aes_256_cbc(), nullptr, key.m_aes_key.data(), iv ) ||
+				!init_ticket_mac( hctx, key ) )
+				return -1;
+
+			return 1;
+		}
+
+		const auto found = keys->find_key( key_name, key );
+		if( 0 == found )
+			// Unknown or too old key, a full handshake is necessary.
+			return 0;
+
+		if( 1 != ::EVP_DecryptInit_ex(
+				cctx, ::EVP_aes_256_cbc(), nullptr, key.m_aes_key.data(), iv ) ||
+			!init_ticket_mac( hctx, key ) )
+			return -1;
+
+		return found;
+	}
+	catch( ... )
+	{
+		return -1;
+	}
+}
+
+} /* namespace tls_session_resumption_details */
+
+//! Make \a ctx use \a cache as the server-side session cache.
+inline void
+use_tls_session_cache(
+	asio_ns::ssl::context & ctx,
+	std::shared_ptr< tls_session_cache_t > cache )
+{
+	using namespace tls_session_resumption_details;
+
+	auto * native = ctx.native_handle();
+	const auto timeout = cache->params().timeout();
+
+	attach_to_ctx( native, std::move( cache ) );
+
+	static const unsigned char session_id_context[] = "restinio";
+	::SSL_CTX_set_session_id_context(
+		native, session_id_context, sizeof( session_id_context ) - 1u );
+
+	::SSL_CTX_set_session_cache_mode(
+		native, SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL );
+	::SSL_CTX_set_timeout( native, static_cast< long >( timeout.count() ) );
+	::SSL_CTX_sess_set_new_cb( native, &new_session_cb );
+	::SSL_CTX_sess_set_get_cb( native, &get_session_cb );
+	::SSL_CTX_sess_set_remove_cb( native, &remove_session_cb );
+}
+
+//! Make \a ctx use \a keys for session tickets.
+inline void
+use_tls_session_ticket_keys(
+	asio_ns::ssl::context & ctx,
+	std::shared_ptr< tls_session_ticket_keys_t > keys )
+{
+	using namespace tls_session_resumption_details;
+
+	auto * native = ctx.native_handle();
+
+	attach_to_ctx( native, std::move( keys ) );
+
+	::SSL_CTX_clear_options( native, SSL_OP_NO_TICKET );
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	::SSL_CTX_set_tlsext_ticket_key_evp_cb( native, &ticket_key_cb );
+#else
+	::SSL_CTX_set_tlsext_ticket_key_cb( native, &ticket_key_cb );
+#endif
+}
+
+} /* namespace impl */
+
+} /* namespace restinio */
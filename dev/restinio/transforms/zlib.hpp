@@ -21,8 +21,16 @@
 
 #include <zlib.h>
 
-#include <string>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 namespace restinio
 {
@@ -37,6 +45,10 @@ namespace zlib
 //! @since v.0.4.4
 constexpr std::size_t default_output_reserve_buffer_size = 256 * 1024;
 
+//! Recommended size of a block for streaming body appenders.
+//! @since v.0.6.2
+constexpr std::size_t default_streaming_block_size = 16 * 1024;
+
 /** @name Default values for zlib tuning parameters.
  * @brief Constants are defined with values provided by zlib.
  *
@@ -79,6 +91,14 @@ class params_t
 			deflate,
 			//! gzip format
 			gzip,
+			//! Raw deflate data without zlib header and trailer.
+			/*!
+				Used by permessage-deflate WebSocket extension (RFC 7692).
+				It isn't a content coding and can't be used with body appenders.
+
+				@since v.0.6.2
+			*/
+			raw_deflate,
 			//! Identity. With semantics descrobed here: https://developer.mozilla.org/en-US/docs/Web/HTTP/Headers/Accept-Encoding
 			/*
 				Means that no compression will be used and no header/trailer will be applied.
@@ -186,13 +206,15 @@ class params_t
 			// stream.
 
 			if( ( window_bits_value < 8 || window_bits_value > MAX_WBITS ) &&
-				( 0 != window_bits_value || operation_t::decompress != operation() ) )
+				( 0 != window_bits_value ||
+					operation_t::decompress != operation() ||
+					format_t::raw_deflate == format() ) )
 			{
 				throw exception_t{
 					fmt::format(
 						"invalid window_bits: {}, must be "
 						"an integer value in the range of 8 to {} or "
-						"0 for decompress operation",
+						"0 for decompress operation of non raw format",
 						window_bits_value,
 						MAX_WBITS ) };
 			}
@@ -333,6 +355,51 @@ class params_t
 			return std::move( this->reserve_buffer_size( size ) );
 		}
 
+		//! Get the size of a block for streaming body appenders.
+		/*!
+			If the value is not zero then body appenders for
+			chunked_output_t and user_controlled_output_t
+			send compressed data to the client as soon as at least
+			that amount of it is ready. Input data is fed to zlib
+			by pieces of the same size, so the memory used by a response
+			stays bounded regardless of the size of the body.
+
+			Zero (the default) means that compressed data is sent
+			only on explicit calls to make_chunk() and flush().
+
+			The value is ignored for restinio_controlled_output_t.
+
+			@since v.0.6.2
+		*/
+		std::size_t streaming_block_size() const { return m_streaming_block_size; }
+
+		//! Set the size of a block for streaming body appenders.
+		/*!
+			@since v.0.6.2
+		*/
+		params_t &
+		streaming_block_size( std::size_t size ) &
+		{
+			if( 0UL != size && size < 10UL )
+			{
+				throw exception_t{ "too small streaming block size" };
+			}
+
+			m_streaming_block_size = size;
+
+			return reference_to_self();
+		}
+
+		//! Set the size of a block for streaming body appenders.
+		/*!
+			@since v.0.6.2
+		*/
+		params_t &&
+		streaming_block_size( std::size_t size ) &&
+		{
+			return std::move( this->streaming_block_size( size ) );
+		}
+
 	private:
 		//! Get the reference to self.
 		params_t & reference_to_self() { return *this; }
@@ -355,6 +422,12 @@ class params_t
 
 		//! Size initially reserved for buffer.
 		std::size_t m_reserve_buffer_size{ default_output_reserve_buffer_size };
+
+		//! Size of a block for streaming body appenders.
+		/*!
+			@since v.0.6.2
+		*/
+		std::size_t m_streaming_block_size{ 0 };
 };
 
 /** @name Create parameters for zlib transformators.
@@ -410,6 +483,25 @@ make_gzip_decompress_params()
 			params_t::format_t::gzip };
 }
 
+//! @since v.0.6.2
+inline params_t
+make_raw_deflate_compress_params( int compression_level = -1 )
+{
+	return params_t{
+			params_t::operation_t::compress,
+			params_t::format_t::raw_deflate,
+			compression_level };
+}
+
+//! @since v.0.6.2
+inline params_t
+make_raw_deflate_decompress_params()
+{
+	return params_t{
+			params_t::operation_t::decompress,
+			params_t::format_t::raw_deflate };
+}
+
 inline params_t
 make_identity_params()
 {
@@ -417,6 +509,461 @@ make_identity_params()
 }
 ///@}
 
+//
+// stream_pool_stats_t
+//
+
+//! Counters of the pool of zlib streams.
+/*!
+	Counters are collected over all threads.
+
+	@since v.0.6.2
+*/
+struct stream_pool_stats_t
+{
+	//! Count of streams taken from the pool.
+	std::uint64_t m_hits{ 0 };
+	//! Count of streams created because there was no suitable one in the pool.
+	std::uint64_t m_misses{ 0 };
+	//! Count of streams returned to the pool.
+	std::uint64_t m_returned{ 0 };
+	//! Count of streams destroyed instead of being kept in the pool.
+	std::uint64_t m_dropped{ 0 };
+
+	//! Get the part of streams taken from the pool.
+	double
+	hit_rate() const noexcept
+	{
+		const auto total = m_hits + m_misses;
+		return 0u != total ?
+			static_cast< double >( m_hits ) / static_cast< double >( total ) :
+			0.0;
+	}
+};
+
+//! Default count of idle zlib streams kept in the pool by a thread.
+//! @since v.0.6.2
+constexpr std::size_t default_stream_pool_capacity = 4;
+
+namespace impl
+{
+
+//
+// zlib_arena_t
+//
+
+//! Arena for zlib stream allocations.
+/*!
+	zlib allocates all the memory for a stream on initialization
+	and frees it only when the stream ends. So the arena only takes
+	memory from big blocks and releases all of them at once.
+
+	@since v.0.6.2
+*/
+class zlib_arena_t
+{
+	public:
+		zlib_arena_t() = default;
+
+		zlib_arena_t( const zlib_arena_t & ) = delete;
+		zlib_arena_t & operator = ( const zlib_arena_t & ) = delete;
+
+		//! Function for z_stream::zalloc.
+		static voidpf
+		alloc( voidpf opaque, uInt items, uInt size ) noexcept
+		{
+			return static_cast< zlib_arena_t * >( opaque )->allocate(
+				static_cast< std::size_t >( items ) * size );
+		}
+
+		//! Function for z_stream::zfree.
+		/*!
+			Memory is released with the arena.
+		*/
+		static void
+		free( voidpf, voidpf ) noexcept
+		{}
+
+	private:
+		static constexpr std::size_t block_size = 64 * 1024;
+		static constexpr std::size_t alignment = alignof( std::max_align_t );
+
+		void *
+		allocate( std::size_t size ) noexcept
+		{
+			size = ( size + alignment - 1u ) & ~( alignment - 1u );
+
+			if( m_available < size )
+			{
+				const auto new_block_size = std::max( size, block_size );
+				std::unique_ptr< char[] > block{
+					new( std::nothrow ) char[ new_block_size ] };
+
+				if( !block )
+					return Z_NULL;
+
+				try
+				{
+					m_blocks.push_back( std::move( block ) );
+				}
+				catch( ... )
+				{
+					return Z_NULL;
+				}
+
+				m_pos = m_blocks.back().get();
+				m_available = new_block_size;
+			}
+
+			void * result = m_pos;
+			m_pos += size;
+			m_available -= size;
+
+			return result;
+		}
+
+		std::vector< std::unique_ptr< char[] > > m_blocks;
+		char * m_pos{ nullptr };
+		std::size_t m_available{ 0 };
+};
+
+//
+// pooled_stream_t
+//
+
+//! Initialized zlib stream that can be reused.
+/*!
+	@since v.0.6.2
+*/
+class pooled_stream_t
+{
+	public:
+		//! Parameters that are fixed by stream initialization.
+		struct key_t
+		{
+			params_t::operation_t m_operation;
+			int m_window_bits;
+			int m_level;
+			int m_mem_level;
+			int m_strategy;
+
+			explicit key_t( const params_t & params )
+				:	m_operation{ params.operation() }
+				,	m_window_bits{ make_window_bits( params ) }
+				,	m_level{ params.level() }
+				,	m_mem_level{ params.mem_level() }
+				,	m_strategy{ params.strategy() }
+			{}
+
+			//! Window bits in the form expected by deflateInit2()/inflateInit2().
+			static int
+			make_window_bits( const params_t & params ) noexcept
+			{
+				switch( params.format() )
+				{
+					case params_t::format_t::gzip:
+						return params.window_bits() + 16;
+					case params_t::format_t::raw_deflate:
+						return -params.window_bits();
+					default:
+						return params.window_bits();
+				}
+			}
+
+			bool
+			operator==( const key_t & o ) const noexcept
+			{
+				// Only window bits matter for decompression.
+				return m_operation == o.m_operation &&
+					m_window_bits == o.m_window_bits &&
+					( params_t::operation_t::decompress == m_operation ||
+						( m_level == o.m_level &&
+							m_mem_level == o.m_mem_level &&
+							m_strategy == o.m_strategy ) );
+			}
+		};
+
+		explicit pooled_stream_t( const key_t & key )
+			:	m_key{ key }
+		{
+			m_stream.zalloc = &zlib_arena_t::alloc;
+			m_stream.zfree = &zlib_arena_t::free;
+			m_stream.opaque = &m_arena;
+			m_stream.next_in = Z_NULL;
+			m_stream.avail_in = 0;
+
+			int init_result;
+
+			if( is_compress() )
+			{
+				init_result =
+					deflateInit2(
+						&m_stream,
+						m_key.m_level,
+						Z_DEFLATED,
+						m_key.m_window_bits,
+						m_key.m_mem_level,
+						m_key.m_strategy );
+			}
+			else
+			{
+				init_result =
+					inflateInit2(
+						&m_stream,
+						m_key.m_window_bits );
+			}
+
+			if( Z_OK != init_result )
+			{
+				throw exception_t{
+					fmt::format(
+						"Failed to initialize zlib stream: {}, {}",
+						init_result,
+						m_stream.msg ? m_stream.msg : "<no zlib error description>" ) };
+			}
+		}
+
+		pooled_stream_t( const pooled_stream_t & ) = delete;
+		pooled_stream_t & operator = ( const pooled_stream_t & ) = delete;
+
+		~pooled_stream_t()
+		{
+			if( is_compress() )
+				deflateEnd( &m_stream );
+			else
+				inflateEnd( &m_stream );
+		}
+
+		const key_t & key() const noexcept { return m_key; }
+
+		z_stream & stream() noexcept { return m_stream; }
+
+		//! Prepare stream for a new operation.
+		bool
+		reset() noexcept
+		{
+			const int r = is_compress() ?
+				deflateReset( &m_stream ) : inflateReset( &m_stream );
+
+			return Z_OK == r;
+		}
+
+	private:
+		bool
+		is_compress() const noexcept
+		{
+			return params_t::operation_t::compress == m_key.m_operation;
+		}
+
+		const key_t m_key;
+		zlib_arena_t m_arena;
+		z_stream m_stream;
+};
+
+using pooled_stream_unique_ptr_t = std::unique_ptr< pooled_stream_t >;
+
+//! Global counters of the pool.
+struct stream_pool_counters_t
+{
+	std::atomic< std::uint64_t > m_hits{ 0 };
+	std::atomic< std::uint64_t > m_misses{ 0 };
+	std::atomic< std::uint64_t > m_returned{ 0 };
+	std::atomic< std::uint64_t > m_dropped{ 0 };
+	std::atomic< std::size_t > m_capacity{ default_stream_pool_capacity };
+};
+
+inline stream_pool_counters_t &
+stream_pool_counters() noexcept
+{
+	static stream_pool_counters_t counters;
+	return counters;
+}
+
+//
+// stream_pool_t
+//
+
+//! Per-thread pool of initialized zlib streams.
+/*!
+	Streams are reused with deflateReset()/inflateReset(), so
+	a zlib_t doesn't allocate and initialize zlib state each time.
+
+	A stream can be returned to the pool of another thread,
+	streams don't share any data.
+
+	A zlib_t can outlive the pool of its thread (e.g. if it is held
+	by a static or thread_local object). In that case its stream
+	is just destroyed, see acquire_stream() and release_stream().
+
+	@since v.0.6.2
+*/
+class stream_pool_t
+{
+	public:
+		stream_pool_t() = default;
+
+		stream_pool_t( const stream_pool_t & ) = delete;
+		stream_pool_t & operator = ( const stream_pool_t & ) = delete;
+
+		~stream_pool_t()
+		{
+			is_destroyed() = true;
+		}
+
+		//! Get pool of the current thread.
+		/*!
+			\return nullptr if the pool of the current thread is
+			already destroyed.
+		*/
+		static stream_pool_t *
+		thread_instance() noexcept
+		{
+			if( is_destroyed() )
+				return nullptr;
+
+			thread_local stream_pool_t pool;
+			return &pool;
+		}
+
+		//! Get a stream from the pool of the current thread.
+		static pooled_stream_unique_ptr_t
+		acquire_stream( const params_t & params )
+		{
+			if( auto * pool = thread_instance() )
+				return pool->acquire( params );
+
+			stream_pool_counters().m_misses.fetch_add(
+					1u, std::memory_order_relaxed );
+			return std::make_unique< pooled_stream_t >(
+					pooled_stream_t::key_t{ params } );
+		}
+
+		//! Return a stream to the pool of the current thread.
+		/*!
+			The stream is destroyed if the pool is already destroyed.
+		*/
+		static void
+		release_stream( pooled_stream_unique_ptr_t stream ) noexcept
+		{
+			if( auto * pool = thread_instance() )
+				pool->release( std::move( stream ) );
+			else
+				stream_pool_counters().m_dropped.fetch_add(
+						1u, std::memory_order_relaxed );
+		}
+
+		//! Get a stream for given params.
+		pooled_stream_unique_ptr_t
+		acquire( const params_t & params )
+		{
+			const pooled_stream_t::key_t key{ params };
+			auto & counters = stream_pool_counters();
+
+			// Most recently returned streams are at the end.
+			for( auto it = m_streams.rbegin(); it != m_streams.rend(); ++it )
+			{
+				if( (*it)->key() == key )
+				{
+					auto result = std::move( *it );
+					m_streams.erase( std::next( it ).base() );
+					counters.m_hits.fetch_add( 1u, std::memory_order_relaxed );
+					return result;
+				}
+			}
+
+			counters.m_misses.fetch_add( 1u, std::memory_order_relaxed );
+			return std::make_unique< pooled_stream_t >( key );
+		}
+
+		//! Return a stream to the pool.
+		/*!
+			If the pool is full the least recently used stream is destroyed.
+		*/
+		void
+		release( pooled_stream_unique_ptr_t stream ) noexcept
+		{
+			auto & counters = stream_pool_counters();
+			const auto capacity =
+				counters.m_capacity.load( std::memory_order_relaxed );
+
+			while( !m_streams.empty() && capacity <= m_streams.size() )
+			{
+				m_streams.erase( m_streams.begin() );
+				counters.m_dropped.fetch_add( 1u, std::memory_order_relaxed );
+			}
+
+			if( 0u != capacity && stream->reset() )
+			{
+				try
+				{
+					m_streams.push_back( std::move( stream ) );
+					counters.m_returned.fetch_add( 1u, std::memory_order_relaxed );
+					return;
+				}
+				catch( ... )
+				{}
+			}
+
+			counters.m_dropped.fetch_add( 1u, std::memory_order_relaxed );
+		}
+
+	private:
+		//! Flag that is set when the pool of the current thread is destroyed.
+		/*!
+			Has trivial destructor, so it can be checked even after
+			destruction of the pool during the thread exit.
+		*/
+		static bool &
+		is_destroyed() noexcept
+		{
+			thread_local bool destroyed{ false };
+			return destroyed;
+		}
+
+		std::vector< pooled_stream_unique_ptr_t > m_streams;
+};
+
+} /* namespace impl */
+
+/** @name Control the pool of zlib streams.
+ * @brief Streams used by zlib_t are kept in per-thread pools and reused.
+ *
+ * Capacity of a pool is the max count of idle streams kept by a thread.
+ * Zero capacity turns pooling off. The same capacity is used by all threads.
+ *
+ * @since v.0.6.2
+*/
+///@{
+inline void
+stream_pool_capacity( std::size_t capacity ) noexcept
+{
+	impl::stream_pool_counters().m_capacity.store(
+		capacity, std::memory_order_relaxed );
+}
+
+inline std::size_t
+stream_pool_capacity() noexcept
+{
+	return impl::stream_pool_counters().m_capacity.load(
+		std::memory_order_relaxed );
+}
+
+//! Get counters of the pool.
+inline stream_pool_stats_t
+stream_pool_stats() noexcept
+{
+	const auto & counters = impl::stream_pool_counters();
+
+	stream_pool_stats_t result;
+	result.m_hits = counters.m_hits.load( std::memory_order_relaxed );
+	result.m_misses = counters.m_misses.load( std::memory_order_relaxed );
+	result.m_returned = counters.m_returned.load( std::memory_order_relaxed );
+	result.m_dropped = counters.m_dropped.load( std::memory_order_relaxed );
+
+	return result;
+}
+///@}
+
 //
 // zlib_t
 //
@@ -469,6 +1016,10 @@ make_identity_params()
 	\endcode
 
 
+	Since v.0.6.2 initialized zlib streams are taken from a per-thread
+	pool and are returned there on destruction, see stream_pool_capacity()
+	and stream_pool_stats().
+
 	@since v.0.4.4
 */
 class zlib_t
@@ -479,53 +1030,11 @@ class zlib_t
 		{
 			if( !is_identity() )
 			{
-				// Setting allocator stuff before initializing
-				// TODO: allocation can be done with user defined allocator.
-				m_zlib_stream.zalloc = Z_NULL;
-				m_zlib_stream.zfree = Z_NULL;
-				m_zlib_stream.opaque = Z_NULL;
-
-				// Track initialization result.
-				int init_result;
-
-				// Compression.
-				auto current_window_bits = m_params.window_bits();
-
-				if( params_t::format_t::gzip == m_params.format() )
-				{
-					current_window_bits += 16;
-				}
-
-				if( params_t::operation_t::compress == m_params.operation() )
-				{
-					// zlib format.
-					init_result =
-						deflateInit2(
-							&m_zlib_stream,
-							m_params.level(),
-							Z_DEFLATED,
-							current_window_bits,
-							m_params.mem_level(),
-							m_params.strategy() );
-				}
-				else
-				{
-					init_result =
-						inflateInit2(
-							&m_zlib_stream,
-							current_window_bits );
-				}
-
-				if( Z_OK != init_result )
-				{
-					throw exception_t{
-						fmt::format(
-							"Failed to initialize zlib stream: {}, {}",
-							init_result,
-							get_error_msg() ) };
-				}
-
-				m_zlib_stream_initialized = true;
+				// Initialized stream is taken from the pool of current thread
+				// or is created with allocations done by an arena.
+				m_pooled_stream =
+					impl::stream_pool_t::acquire_stream( m_params );
+				m_zlib_stream = &m_pooled_stream->stream();
 
 				// Reserve initial buffer.
 				inc_buffer();
@@ -540,16 +1049,9 @@ class zlib_t
 
 		~zlib_t()
 		{
-			if( m_zlib_stream_initialized )
+			if( m_pooled_stream )
 			{
-				if( params_t::operation_t::compress == m_params.operation() )
-				{
-					deflateEnd( &m_zlib_stream );
-				}
-				else
-				{
-					inflateEnd( &m_zlib_stream );
-				}
+				impl::stream_pool_t::release_stream( std::move( m_pooled_stream ) );
 			}
 		}
 
@@ -573,22 +1075,22 @@ class zlib_t
 			}
 			else
 			{
-				if( std::numeric_limits< decltype( m_zlib_stream.avail_in ) >::max() < input.size() )
+				if( std::numeric_limits< decltype( m_zlib_stream->avail_in ) >::max() < input.size() )
 				{
 					throw exception_t{
 						fmt::format(
 							"input data is too large: {} (max possible: {}), "
 							"try to break large data into pieces",
 							input.size(),
-							std::numeric_limits< decltype( m_zlib_stream.avail_in ) >::max() ) };
+							std::numeric_limits< decltype( m_zlib_stream->avail_in ) >::max() ) };
 				}
 
 				if( 0 < input.size() )
 				{
-					m_zlib_stream.next_in =
+					m_zlib_stream->next_in =
 						reinterpret_cast< Bytef* >( const_cast< char* >( input.data() ) );
 
-					m_zlib_stream.avail_in = static_cast< uInt >( input.size() );
+					m_zlib_stream->avail_in = static_cast< uInt >( input.size() );
 
 					if( params_t::operation_t::compress == m_params.operation() )
 					{
@@ -614,8 +1116,8 @@ class zlib_t
 
 			if( !is_identity() )
 			{
-				m_zlib_stream.next_in = nullptr;
-				m_zlib_stream.avail_in = static_cast< uInt >( 0 );
+				m_zlib_stream->next_in = nullptr;
+				m_zlib_stream->avail_in = static_cast< uInt >( 0 );
 
 				if( params_t::operation_t::compress == m_params.operation() )
 				{
@@ -636,8 +1138,8 @@ class zlib_t
 
 			if( !is_identity() )
 			{
-				m_zlib_stream.next_in = nullptr;
-				m_zlib_stream.avail_in = static_cast< uInt >( 0 );
+				m_zlib_stream->next_in = nullptr;
+				m_zlib_stream->avail_in = static_cast< uInt >( 0 );
 
 				if( params_t::operation_t::compress == m_params.operation() )
 				{
@@ -702,8 +1204,8 @@ class zlib_t
 		get_error_msg() const
 		{
 			const char * err_msg = "<no zlib error description>";
-			if( m_zlib_stream.msg )
-				err_msg = m_zlib_stream.msg;
+			if( m_zlib_stream->msg )
+				err_msg = m_zlib_stream->msg;
 
 			return err_msg;
 		}
@@ -728,13 +1230,13 @@ class zlib_t
 		auto
 		prepare_out_buffer()
 		{
-			m_zlib_stream.next_out =
+			m_zlib_stream->next_out =
 				reinterpret_cast< Bytef* >(
 					const_cast< char* >( m_out_buffer.data() + m_write_pos ) );
 
 			const auto provided_out_buffer_size =
 				m_out_buffer.size() - m_write_pos;
-			m_zlib_stream.avail_out =
+			m_zlib_stream->avail_out =
 				static_cast<uInt>( provided_out_buffer_size );
 
 			return provided_out_buffer_size;
@@ -743,7 +1245,7 @@ class zlib_t
 		//! Handle incoming data for compression operation.
 		/*
 			Data and its size must be already in
-			`m_zlib_stream.next_in`, `m_zlib_stream.avail_in`.
+			`m_zlib_stream->next_in`, `m_zlib_stream->avail_in`.
 		*/
 		void
 		write_compress_impl( int flush )
@@ -752,15 +1254,15 @@ class zlib_t
 			{
 				const auto provided_out_buffer_size = prepare_out_buffer();
 
-				int operation_result = deflate( &m_zlib_stream, flush );
+				int operation_result = deflate( m_zlib_stream, flush );
 
 				if( !( Z_OK == operation_result ||
 						Z_BUF_ERROR == operation_result ||
 						( Z_STREAM_END == operation_result && Z_FINISH == flush ) ) )
 				{
 					const char * err_msg = "<no error desc>";
-					if( m_zlib_stream.msg )
-						err_msg = m_zlib_stream.msg;
+					if( m_zlib_stream->msg )
+						err_msg = m_zlib_stream->msg;
 
 					throw exception_t{
 						fmt::format(
@@ -769,9 +1271,9 @@ class zlib_t
 							err_msg ) };
 				}
 
-				m_write_pos += provided_out_buffer_size - m_zlib_stream.avail_out;
+				m_write_pos += provided_out_buffer_size - m_zlib_stream->avail_out;
 
-				if( 0 == m_zlib_stream.avail_out && Z_STREAM_END != operation_result )
+				if( 0 == m_zlib_stream->avail_out && Z_STREAM_END != operation_result )
 				{
 					// Looks like not all the output was obtained.
 					// There is a minor chance that it just happened to
@@ -781,7 +1283,7 @@ class zlib_t
 					continue;
 				}
 
-				if( 0 == m_zlib_stream.avail_in )
+				if( 0 == m_zlib_stream->avail_in )
 				{
 					// All the input was consumed.
 					break;
@@ -792,7 +1294,7 @@ class zlib_t
 		//! Handle incoming data for decompression operation.
 		/*
 			Data and its size must be already in
-			`m_zlib_stream.next_in`, `m_zlib_stream.avail_in`.
+			`m_zlib_stream->next_in`, `m_zlib_stream->avail_in`.
 		*/
 		void
 		write_decompress_impl( int flush )
@@ -801,7 +1303,7 @@ class zlib_t
 			{
 				const auto provided_out_buffer_size = prepare_out_buffer();
 
-				int operation_result = inflate( &m_zlib_stream, flush );
+				int operation_result = inflate( m_zlib_stream, flush );
 				if( !( Z_OK == operation_result ||
 						Z_BUF_ERROR == operation_result ||
 						Z_STREAM_END == operation_result ) )
@@ -813,9 +1315,9 @@ class zlib_t
 							get_error_msg() ) };
 				}
 
-				m_write_pos += provided_out_buffer_size - m_zlib_stream.avail_out;
+				m_write_pos += provided_out_buffer_size - m_zlib_stream->avail_out;
 
-				if( 0 == m_zlib_stream.avail_out && Z_STREAM_END != operation_result )
+				if( 0 == m_zlib_stream->avail_out && Z_STREAM_END != operation_result )
 				{
 					// Looks like not all the output was obtained.
 					// There is a minor chance that it just happened to
@@ -825,9 +1327,11 @@ class zlib_t
 					continue;
 				}
 
-				if( 0 == m_zlib_stream.avail_in )
+				if( 0 == m_zlib_stream->avail_in ||
+					Z_STREAM_END == operation_result )
 				{
-					// All the input was consumed.
+					// All the input was consumed or the end of the stream
+					// is reached (the rest of the input can't be consumed).
 					break;
 				}
 			}
@@ -836,15 +1340,14 @@ class zlib_t
 		//! Parameters for zlib.
 		const params_t m_params;
 
-		//! Flag: was m_zlib_stream initialized properly.
+		//! Initialized zlib stream owned by this transformator.
 		/*!
-			If deflateInit2()/inflateInit2() was completed successfully
-			it is needed to call deflateEnd()/inflateEnd().
+			Is returned to the pool of the current thread on destruction.
 		*/
-		bool m_zlib_stream_initialized{ false };
+		impl::pooled_stream_unique_ptr_t m_pooled_stream;
 
 		//! zlib stream.
-		z_stream m_zlib_stream;
+		z_stream * m_zlib_stream{ nullptr };
 
 		//! Output buffer.
 		std::string m_out_buffer;
@@ -953,10 +1456,39 @@ inline std::string content_encoding_token( params_t::format_t f )
 	{
 		result.assign( "gzip" );
 	}
+	if( params_t::format_t::raw_deflate == f )
+	{
+		throw exception_t{ "raw deflate format isn't a content coding" };
+	}
 
 	return result;
 }
 
+//! Get params for zlib transformator of a body appender.
+/*!
+	Streaming is turned off for restinio_controlled_output_t.
+	For streaming appenders the reserve buffer is limited by
+	the size of a block, because the output is sent by blocks.
+
+	@since v.0.6.2
+*/
+template < typename Response_Output_Strategy >
+params_t
+make_appender_params( params_t params )
+{
+	if( std::is_same< Response_Output_Strategy, restinio_controlled_output_t >::value )
+	{
+		params.streaming_block_size( 0u );
+	}
+	else if( 0u != params.streaming_block_size() &&
+		params.streaming_block_size() < params.reserve_buffer_size() )
+	{
+		params.reserve_buffer_size( params.streaming_block_size() );
+	}
+
+	return params;
+}
+
 } /* namespace impl */
 
 //
@@ -971,7 +1503,10 @@ class body_appender_base_t
 		using resp_t = response_builder_t< Response_Output_Strategy >;
 
 		body_appender_base_t( const params_t & params, resp_t & resp )
-			:	m_ztransformator{ std::make_unique< zlib_t >( params ) }
+			:	m_ztransformator{
+					std::make_unique< zlib_t >(
+						impl::make_appender_params< Response_Output_Strategy >(
+							params ) ) }
 			,	m_resp{ resp }
 		{
 			impl::ensure_is_compression_operation(
@@ -995,6 +1530,51 @@ class body_appender_base_t
 		virtual ~body_appender_base_t() {}
 
 	protected:
+		//! Write a piece of data to zlib transformator.
+		/*!
+			If streaming is turned on then the input is written by
+			blocks and ready compressed data is sent
+			by send_ready_output() each time its size reaches
+			the size of a block.
+
+			@since v.0.6.2
+		*/
+		void
+		write_input( string_view_t input )
+		{
+			impl::ensure_valid_transforator( m_ztransformator.get() );
+
+			const auto block_size = m_ztransformator->params().streaming_block_size();
+
+			if( 0u == block_size )
+			{
+				m_ztransformator->write( input );
+				return;
+			}
+
+			while( !input.empty() )
+			{
+				const auto part = input.substr( 0u, block_size );
+				input.remove_prefix( part.size() );
+
+				m_ztransformator->write( part );
+
+				if( block_size <= m_ztransformator->output_size() )
+				{
+					send_ready_output();
+				}
+			}
+		}
+
+		//! Send compressed data that is ready to the client.
+		/*!
+			Is called only if streaming is turned on.
+
+			@since v.0.6.2
+		*/
+		virtual void
+		send_ready_output() {}
+
 		std::unique_ptr< zlib_t > m_ztransformator;
 		resp_t & m_resp;
 };
@@ -1013,8 +1593,7 @@ class x_controlled_output_body_appender_base_t
 		Descendant &
 		append( string_view_t input )
 		{
-			impl::ensure_valid_transforator( this->m_ztransformator.get() );
-			this->m_ztransformator->write( input );
+			this->write_input( input );
 			return static_cast< Descendant & >( *this );
 		}
 
@@ -1097,6 +1676,10 @@ class body_appender_t< restinio_controlled_output_t >
  * resp.done();
  * \endcode
  *
+ * If params_t::streaming_block_size() is set then append() sends
+ * ready compressed data to the client each time its size
+ * reaches the size of a block (since v.0.6.2).
+ *
  * @since v.0.4.4
 */
 template <>
@@ -1124,6 +1707,15 @@ class body_appender_t< user_controlled_output_t > final
 
 			return *this;
 		}
+
+	protected:
+		void
+		send_ready_output() override
+		{
+			m_resp
+				.append_body( m_ztransformator->giveaway_output() )
+				.flush();
+		}
 };
 
 
@@ -1157,6 +1749,19 @@ class body_appender_t< user_controlled_output_t > final
  * resp.done();
  * \endcode
  *
+ * Since v.0.6.2 compressed data can be sent by blocks of fixed size
+ * as soon as it is produced, so a big body isn't held in memory:
+ * \code
+ * auto ba = rtz::body_appender(
+ *   resp,
+ *   rtz::make_gzip_compress_params()
+ *     .streaming_block_size( rtz::default_streaming_block_size ) );
+ * for( const auto & piece : big_json_export )
+ *   ba.append( piece ); // Chunks are sent here when ready.
+ * ba.complete();
+ * resp.done();
+ * \endcode
+ *
  * @since v.0.4.4
 */
 template <>
@@ -1177,13 +1782,15 @@ class body_appender_t< chunked_output_t > final
 		/*!
 			Function only adds data to anderlying zlib stream
 			and it doesn't affect target response right on here.
+
+			If params_t::streaming_block_size() is set then
+			ready compressed data is sent to the client as
+			a new chunk each time its size reaches the size of a block.
 		*/
 		auto &
 		append( string_view_t input )
 		{
-			impl::ensure_valid_transforator( m_ztransformator.get() );
-
-			m_ztransformator->write( input );
+			write_input( input );
 			return *this;
 		}
 
@@ -1231,6 +1838,15 @@ class body_appender_t< chunked_output_t > final
 			m_ztransformator->complete();
 			m_resp.append_chunk( m_ztransformator->giveaway_output() );
 		}
+
+	protected:
+		void
+		send_ready_output() override
+		{
+			m_resp
+				.append_chunk( m_ztransformator->giveaway_output() )
+				.flush();
+		}
 };
 
 //! Create body appender with given zlib transformation parameters.
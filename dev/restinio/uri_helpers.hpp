@@ -15,7 +15,10 @@
 
 #include <restinio/exception.hpp>
 #include <restinio/utils/percent_encoding.hpp>
+#include <restinio/utils/from_string.hpp>
 #include <restinio/optional.hpp>
+#include <array>
+#include <type_traits>
 #include <utility>
 
 namespace restinio
@@ -326,4 +329,199 @@ parse_query(
 	};
 }
 
+//
+// query_string_view_t
+//
+
+//! Lazy view of a query string.
+/*!
+	Unlike parse_query() it doesn't copy the query string and doesn't
+	build a container of parameters. Every access scans the raw query
+	string for the key and only the value of that key is unescaped.
+	It is faster than parse_query() if only a few of many parameters
+	are used.
+
+	Parameters are separated by `&` or `;`. Segments without `=`
+	are ignored. If a key is repeated the first value is used.
+
+	The view doesn't own the query string, so it must outlive the view.
+
+	Usage example:
+	\code
+	restinio::query_string_view_t qs{ req->header().query() };
+	const auto limit = qs.get_param< std::uint32_t >( "limit" );
+	const auto text = qs.get< std::string >( "q" );
+	\endcode
+
+	@since v.0.6.2
+*/
+template< typename Parse_Traits = parse_query_traits::restinio_defaults >
+class query_string_view_t final
+{
+	public:
+		explicit query_string_view_t( string_view_t query ) noexcept
+			:	m_query{ query }
+		{}
+
+		//! Check parameter.
+		bool
+		has( string_view_t key ) const noexcept
+		{
+			return static_cast< bool >( raw_param( key ) );
+		}
+
+		//! Get the raw (escaped) value of a parameter if it exists.
+		optional_t< string_view_t >
+		raw_param( string_view_t key ) const noexcept
+		{
+			const char * const end = m_query.data() + m_query.size();
+			const char * pos = m_query.data();
+
+			while( pos < end )
+			{
+				// Key is compared while the segment is scanned, so the most
+				// of segments are skipped after one or two chars.
+				const char * key_end = match_key( pos, end, key );
+				if( key_end )
+				{
+					const char * value_end = find_separator( key_end + 1, end );
+					return string_view_t{
+							key_end + 1,
+							static_cast< std::size_t >( value_end - key_end - 1 ) };
+				}
+
+				pos = find_separator( pos, end ) + 1;
+			}
+
+			return nullopt;
+		}
+
+		//! Get the value of a parameter converted to Value_Type
+		//! if the parameter exists.
+		/*!
+			Throws if the value is not a valid percent-encoded string
+			or can't be converted to Value_Type.
+
+			@note
+			string_view_t can't be used as Value_Type because an unescaped
+			value has no storage. Use raw_param() or std::string.
+		*/
+		template< typename Value_Type >
+		optional_t< Value_Type >
+		get_param( string_view_t key ) const
+		{
+			static_assert( !std::is_same< Value_Type, string_view_t >::value,
+				"string_view_t can't refer to an unescaped value, "
+				"use raw_param() or std::string" );
+
+			const auto raw = raw_param( key );
+			if( !raw )
+				return nullopt;
+
+			return convert< Value_Type >( *raw );
+		}
+
+		//! Get the value of a parameter converted to Value_Type.
+		/*!
+			Throws if there is no such parameter.
+		*/
+		template< typename Value_Type >
+		Value_Type
+		get( string_view_t key ) const
+		{
+			auto result = get_param< Value_Type >( key );
+			if( !result )
+				throw exception_t{
+					fmt::format(
+						"unable to find parameter \"{}\"",
+						std::string{ key.data(), key.size() } ) };
+
+			return std::move( *result );
+		}
+
+		//! Get the raw query string.
+		string_view_t
+		query() const noexcept { return m_query; }
+
+	private:
+		//! Values that fit into this buffer are unescaped on the stack.
+		static constexpr std::size_t inline_buffer_size = 64u;
+
+		static bool
+		is_separator( char c ) noexcept
+		{
+			return '&' == c || ';' == c;
+		}
+
+		static const char *
+		find_separator( const char * pos, const char * end ) noexcept
+		{
+			while( pos < end && !is_separator( *pos ) )
+				++pos;
+
+			return pos;
+		}
+
+		//! Try to match a raw (escaped) key of a segment with an unescaped one.
+		/*!
+			Returns a pointer to `=` after the key if it is matched
+			or nullptr otherwise.
+		*/
+		static const char *
+		match_key( const char * pos, const char * end, string_view_t key ) noexcept
+		{
+			std::size_t k = 0u;
+			while( pos < end && '=' != *pos && !is_separator( *pos ) )
+			{
+				char c = *pos;
+				if( '+' == c )
+				{
+					c = ' ';
+					++pos;
+				}
+				else if( '%' == c )
+				{
+					if( end - pos < 3 ||
+						!utils::impl::is_hexdigit( pos[ 1 ] ) ||
+						!utils::impl::is_hexdigit( pos[ 2 ] ) )
+						return nullptr;
+
+					c = static_cast< char >( utils::impl::extract_escaped_char(
+							static_cast< unsigned char >( pos[ 1 ] ),
+							static_cast< unsigned char >( pos[ 2 ] ) ) );
+					pos += 3;
+				}
+				else
+					++pos;
+
+				if( key.size() == k || key[ k ] != c )
+					return nullptr;
+				++k;
+			}
+
+			return ( key.size() == k && pos < end && '=' == *pos ) ? pos : nullptr;
+		}
+
+		template< typename Value_Type >
+		static Value_Type
+		convert( string_view_t raw )
+		{
+			if( inline_buffer_size < raw.size() )
+				return utils::from_string< Value_Type >(
+						utils::unescape_percent_encoding< Parse_Traits >( raw ) );
+
+			std::array< char, inline_buffer_size > buffer;
+			std::memcpy( buffer.data(), raw.data(), raw.size() );
+
+			const auto size =
+				utils::inplace_unescape_percent_encoding< Parse_Traits >(
+						buffer.data(), raw.size() );
+
+			return utils::from_string< Value_Type >(
+					string_view_t{ buffer.data(), size } );
+		}
+
+		string_view_t m_query;
+};
+
 } /* namespace restinio */
@@ -0,0 +1,386 @@
+/*
+	restinio
+*/
+
+/*!
+	Sending the same message to many websockets.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <restinio/websocket/websocket.hpp>
+
+namespace restinio
+{
+
+namespace websocket
+{
+
+namespace basic
+{
+
+//
+// subscriber_settings_t
+//
+
+//! Settings of a websocket subscribed to broadcast_hub_t.
+/*!
+	@since v.0.6.2
+*/
+class subscriber_settings_t
+{
+	public:
+		//! Max count of awaiting outgoing frames of a websocket.
+		/*!
+			If a websocket has that many frames not written yet
+			it is treated as a slow consumer.
+		*/
+		std::size_t max_queue_depth() const noexcept
+		{
+			return m_max_queue_depth;
+		}
+
+		//! Set max_queue_depth.
+		subscriber_settings_t &
+		max_queue_depth( std::size_t value ) & noexcept
+		{
+			m_max_queue_depth = value;
+			return *this;
+		}
+
+		//! Set max_queue_depth.
+		subscriber_settings_t &&
+		max_queue_depth( std::size_t value ) && noexcept
+		{
+			return std::move( this->max_queue_depth( value ) );
+		}
+
+		//! What to do with a new frame for a slow consumer.
+		slow_consumer_policy_t slow_consumer_policy() const noexcept
+		{
+			return m_slow_consumer_policy;
+		}
+
+		//! Set slow_consumer_policy.
+		subscriber_settings_t &
+		slow_consumer_policy( slow_consumer_policy_t value ) & noexcept
+		{
+			m_slow_consumer_policy = value;
+			return *this;
+		}
+
+		//! Set slow_consumer_policy.
+		subscriber_settings_t &&
+		slow_consumer_policy( slow_consumer_policy_t value ) && noexcept
+		{
+			return std::move( this->slow_consumer_policy( value ) );
+		}
+
+	private:
+		std::size_t m_max_queue_depth{ 64u };
+		slow_consumer_policy_t m_slow_consumer_policy{ slow_consumer_policy_t::drop };
+};
+
+//
+// broadcast_hub_t
+//
+
+//! A set of websockets that receive the same messages.
+/*!
+	A message is encoded into a frame only once, and the same buffer is
+	written to every subscribed websocket. Subscribers are grouped by
+	io_context, so only one handler is posted to each io_context
+	per message.
+
+	If a subscriber has too many awaiting outgoing frames the
+	slow_consumer_policy from its settings is applied.
+
+	Messages are sent uncompressed even if permessage-deflate is
+	negotiated for a websocket.
+
+	\note A message must not be broadcast to a websocket that is
+	sending a fragmented message at the moment.
+
+	\note The order of broadcast messages and messages sent by
+	ws_t::send_message() isn't guaranteed if a websocket uses a strand.
+
+	\note The hub holds weak references to connections of websockets.
+	A subscriber whose connection is closed is skipped but remains
+	in the hub until unsubscribe() is called.
+
+	All methods are thread-safe.
+
+	Usage example:
+	\code
+	restinio::websocket::basic::broadcast_hub_t hub{
+		restinio::websocket::basic::subscriber_settings_t{}
+			.max_queue_depth( 16u )
+			.slow_consumer_policy(
+				restinio::websocket::basic::slow_consumer_policy_t::coalesce ) };
+
+	// In the request handler:
+	auto wsh = restinio::websocket::basic::upgrade< traits_t >( *req, ... );
+	hub.subscribe( wsh );
+
+	// In a producer thread:
+	hub.broadcast( restinio::websocket::basic::opcode_t::text_frame, update );
+	\endcode
+
+	@since v.0.6.2
+*/
+class broadcast_hub_t
+{
+	public:
+		broadcast_hub_t() = default;
+
+		//! Create a hub with settings for subscribers.
+		explicit broadcast_hub_t( subscriber_settings_t default_settings )
+			:	m_default_settings{ std::move( default_settings ) }
+		{}
+
+		broadcast_hub_t( const broadcast_hub_t & ) = delete;
+		broadcast_hub_t & operator = ( const broadcast_hub_t & ) = delete;
+
+		//! Subscribe a websocket with default settings of the hub.
+		/*!
+			\return false if the websocket is already subscribed.
+		*/
+		bool
+		subscribe( const ws_handle_t & ws )
+		{
+			return subscribe( ws, m_default_settings );
+		}
+
+		//! Subscribe a websocket with its own settings.
+		/*!
+			\return false if the websocket is already subscribed.
+		*/
+		bool
+		subscribe( const ws_handle_t & ws, subscriber_settings_t settings )
+		{
+			auto con = connection_of( *ws );
+			if( !con )
+				throw exception_t{ "websocket is not available" };
+
+			const auto id = id_of( *ws );
+			auto executor = con->io_executor();
+			const auto context = &executor.context();
+
+			std::lock_guard< std::mutex > lock{ m_lock };
+
+			if( !m_index.emplace( id, context ).second )
+				return false;
+
+			try
+			{
+				auto & group = m_groups.emplace(
+						context, group_t{ std::move( executor ), {} } ).first->second;
+
+				modifiable_subscribers( group ).push_back( subscriber_t{
+						id, con, std::move( settings ) } );
+			}
+			catch( ... )
+			{
+				m_index.erase( id );
+
+				const auto it = m_groups.find( context );
+				if( m_groups.end() != it &&
+					( !it->second.m_subscribers || it->second.m_subscribers->empty() ) )
+					m_groups.erase( it );
+
+				throw;
+			}
+
+			return true;
+		}
+
+		//! Unsubscribe a websocket.
+		/*!
+			Can be used after the websocket is closed.
+
+			\return false if the websocket isn't subscribed.
+		*/
+		bool
+		unsubscribe( const ws_handle_t & ws )
+		{
+			return unsubscribe( id_of( *ws ) );
+		}
+
+		//! Unsubscribe a websocket by id of its connection.
+		/*!
+			Can be used when ws_t is already destroyed.
+
+			\return false if the websocket isn't subscribed.
+		*/
+		bool
+		unsubscribe( connection_id_t id )
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+
+			const auto index_it = m_index.find( id );
+			if( m_index.end() == index_it )
+				return false;
+
+			const auto group_it = m_groups.find( index_it->second );
+			m_index.erase( index_it );
+
+			auto & subscribers = modifiable_subscribers( group_it->second );
+			const auto it = std::find_if(
+				subscribers.begin(), subscribers.end(),
+				[id]( const subscriber_t & s ) { return id == s.m_id; } );
+
+			// The order of subscribers doesn't matter.
+			*it = std::move( subscribers.back() );
+			subscribers.pop_back();
+
+			if( subscribers.empty() )
+				m_groups.erase( group_it );
+
+			return true;
+		}
+
+		//! Get the count of subscribed websockets.
+		std::size_t
+		subscribers_count() const
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			return m_index.size();
+		}
+
+		//! Send a message to all subscribers.
+		/*!
+			\note Continuation and close frames can't be broadcast.
+		*/
+		void
+		broadcast( opcode_t opcode, string_view_t payload )
+		{
+			if( opcode_t::continuation_frame == opcode ||
+				opcode_t::connection_close_frame == opcode )
+			{
+				throw exception_t{
+					fmt::format(
+						"{} can't be broadcast",
+						opcode_to_string( opcode ) ) };
+			}
+
+			auto frame = impl::write_message_details(
+					final_frame, opcode, payload.size() );
+			frame.append( payload.data(), payload.size() );
+
+			const impl::shared_frame_t shared_frame =
+				std::make_shared< const std::string >( std::move( frame ) );
+
+			std::lock_guard< std::mutex > lock{ m_lock };
+
+			for( const auto & g : m_groups )
+			{
+				asio_ns::post(
+					g.second.m_executor,
+					[ source_key = static_cast< const void * >( this ),
+						subscribers = g.second.m_subscribers,
+						shared_frame ]
+					{
+						for( const auto & s : *subscribers )
+						{
+							// ws_t isn't touched here, it can be closed
+							// by its owner at the same time.
+							auto con = s.m_connection.lock();
+							if( con )
+							{
+								con->write_shared_frame(
+									shared_frame,
+									impl::shared_frame_write_params_t{
+										s.m_settings.max_queue_depth(),
+										s.m_settings.slow_consumer_policy(),
+										source_key } );
+							}
+						}
+					} );
+			}
+		}
+
+		//! Send a message to all subscribers.
+		void
+		broadcast( const message_t & msg )
+		{
+			broadcast( msg.opcode(), msg.payload() );
+		}
+
+	private:
+		static impl::ws_connection_handle_t
+		connection_of( ws_t & ws )
+		{
+			return ws.m_ws_connection_handle;
+		}
+
+		//! Get the id of the websocket's connection.
+		/*!
+			The id is kept by ws_t, so it is available after
+			the connection handle is released by shutdown() or kill().
+		*/
+		static connection_id_t
+		id_of( const ws_t & ws ) noexcept
+		{
+			return ws.m_connection_id;
+		}
+
+		struct subscriber_t
+		{
+			connection_id_t m_id;
+			//! Connection of the websocket taken at subscription.
+			std::weak_ptr< impl::ws_connection_base_t > m_connection;
+			subscriber_settings_t m_settings;
+		};
+
+		using subscribers_container_t = std::vector< subscriber_t >;
+
+		//! Subscribers served by the same io_context.
+		struct group_t
+		{
+			asio_ns::executor m_executor;
+
+			//! Subscribers of the group.
+			/*!
+				Is shared with handlers posted by broadcast() and
+				is copied on modification if such handlers exist.
+			*/
+			std::shared_ptr< subscribers_container_t > m_subscribers;
+		};
+
+		//! Get subscribers of the group that can be modified.
+		static subscribers_container_t &
+		modifiable_subscribers( group_t & group )
+		{
+			if( !group.m_subscribers )
+				group.m_subscribers = std::make_shared< subscribers_container_t >();
+			else if( 1 != group.m_subscribers.use_count() )
+				group.m_subscribers =
+					std::make_shared< subscribers_container_t >( *group.m_subscribers );
+
+			return *group.m_subscribers;
+		}
+
+		const subscriber_settings_t m_default_settings;
+
+		mutable std::mutex m_lock;
+
+		//! Groups of subscribers by io_context.
+		std::map< asio_ns::execution_context *, group_t > m_groups;
+
+		//! io_context of subscriber by connection id.
+		std::unordered_map< connection_id_t, asio_ns::execution_context * > m_index;
+};
+
+} /* namespace basic */
+
+} /* namespace websocket */
+
+} /* namespace restinio */
@@ -12,6 +12,8 @@
 
 #include <restinio/string_view.hpp>
 
+#include <restinio/websocket/impl/vectorized_ops.hpp>
+
 namespace restinio
 {
 
@@ -109,6 +111,37 @@ class utf8_checker_t
 			return m_state == state_t::valid || m_state == state_t::may_be_overlong;
 		}
 
+		//! Process a sequence of bytes.
+		/*!
+			Runs of ASCII symbols between multibyte symbols
+			are skipped by vectorized check.
+
+			\since
+			v.0.6.2
+		*/
+		bool
+		process_bytes( const char * data, std::size_t size )
+		{
+			std::size_t i = 0;
+			while( i < size )
+			{
+				// ASCII symbols don't change the state of the checker
+				// if they are not inside a multibyte symbol.
+				if( 0 == m_current_symbol_rest_bytes )
+				{
+					i += vectorized::ascii_prefix_size( data + i, size - i );
+					if( i == size )
+						break;
+				}
+
+				if( !process_byte( static_cast<std::uint8_t>( data[ i ] ) ) )
+					return false;
+				++i;
+			}
+
+			return m_state == state_t::valid || m_state == state_t::may_be_overlong;
+		}
+
 		bool
 		final() const
 		{
@@ -204,15 +237,7 @@ check_utf8_is_correct( string_view_t sv )
 {
 	utf8_checker_t checker;
 
-	for( const auto & ch : sv )
-	{
-		if( ! checker.process_byte( static_cast<std::uint8_t>(ch) ))
-		{
-			return false;
-		}
-	}
-
-	return checker.final();
+	return checker.process_bytes( sv.data(), sv.size() ) && checker.final();
 }
 
 } /* namespace impl */
@@ -0,0 +1,376 @@
+/*
+	restinio
+*/
+
+/*!
+	Vectorized operations with websocket payload.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && \
+		(defined(__GNUC__) || defined(__clang__))
+	#define RESTINIO_WS_X86_SIMD_GCC
+	#include <immintrin.h>
+#elif defined(_MSC_VER) && defined(_M_X64)
+	#define RESTINIO_WS_X86_SIMD_MSVC
+	#include <intrin.h>
+	#include <immintrin.h>
+#endif
+
+#if defined(RESTINIO_WS_X86_SIMD_GCC) || defined(RESTINIO_WS_X86_SIMD_MSVC)
+	#define RESTINIO_WS_X86_SIMD
+#endif
+
+#if defined(RESTINIO_WS_X86_SIMD_GCC)
+	#define RESTINIO_WS_TARGET_SSE2 __attribute__((target("sse2")))
+	#define RESTINIO_WS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+	#define RESTINIO_WS_TARGET_SSE2
+	#define RESTINIO_WS_TARGET_AVX2
+#endif
+
+namespace restinio
+{
+
+namespace websocket
+{
+
+namespace basic
+{
+
+namespace impl
+{
+
+namespace vectorized
+{
+
+//
+// implementation_t
+//
+
+//! Available implementations of payload operations.
+enum class implementation_t
+{
+	//! Byte by byte processing.
+	scalar,
+	//! Processing by 64-bit words.
+	word,
+	//! Processing by 128-bit SSE2 registers.
+	sse2,
+	//! Processing by 256-bit AVX2 registers.
+	avx2
+};
+
+//! Detect the best implementation supported by the current CPU.
+inline implementation_t
+detect_best_implementation() noexcept
+{
+#if defined(RESTINIO_WS_X86_SIMD_GCC)
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) )
+		return implementation_t::avx2;
+	if( __builtin_cpu_supports( "sse2" ) )
+		return implementation_t::sse2;
+#elif defined(RESTINIO_WS_X86_SIMD_MSVC)
+	int regs[ 4 ];
+	__cpuid( regs, 0 );
+	if( 7 <= regs[ 0 ] )
+	{
+		__cpuid( regs, 1 );
+		const bool osxsave = 0 != ( regs[ 2 ] & ( 1 << 27 ) );
+		const bool avx = 0 != ( regs[ 2 ] & ( 1 << 28 ) );
+
+		__cpuidex( regs, 7, 0 );
+		const bool avx2 = 0 != ( regs[ 1 ] & ( 1 << 5 ) );
+
+		// OS must save YMM registers on context switches.
+		if( osxsave && avx && avx2 && 6u == ( _xgetbv( 0 ) & 6u ) )
+			return implementation_t::avx2;
+	}
+	// SSE2 is always available on x64.
+	return implementation_t::sse2;
+#endif
+
+	return implementation_t::word;
+}
+
+//! Get the best implementation.
+/*!
+	CPU features are detected only once.
+*/
+inline implementation_t
+best_implementation() noexcept
+{
+	static const implementation_t impl = detect_best_implementation();
+	return impl;
+}
+
+//! Masking key in the order of bytes on the wire.
+using mask_t = std::array< std::uint8_t, 4 >;
+
+namespace details
+{
+
+//! Fill a block of \a N bytes with masking key.
+/*!
+	Masking key is rotated to start from byte with index \a offset.
+*/
+template< std::size_t N >
+std::array< std::uint8_t, N >
+make_mask_block( const mask_t & mask, std::size_t offset ) noexcept
+{
+	std::array< std::uint8_t, N > result;
+	for( std::size_t i = 0; i != N; ++i )
+		result[ i ] = mask[ ( offset + i ) % mask.size() ];
+
+	return result;
+}
+
+inline void
+mask_unmask_tail(
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	for( std::size_t i = 0; i != size; ++i )
+		data[ i ] = static_cast< char >(
+				static_cast< std::uint8_t >( data[ i ] ) ^
+				mask[ ( offset + i ) % mask.size() ] );
+}
+
+inline std::size_t
+mask_unmask_word_blocks(
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	const auto bytes = make_mask_block< sizeof( std::uint64_t ) >( mask, offset );
+	std::uint64_t block_mask;
+	std::memcpy( &block_mask, bytes.data(), sizeof( block_mask ) );
+
+	std::size_t i = 0;
+	for( ; i + sizeof( std::uint64_t ) <= size; i += sizeof( std::uint64_t ) )
+	{
+		std::uint64_t w;
+		std::memcpy( &w, data + i, sizeof( w ) );
+		w ^= block_mask;
+		std::memcpy( data + i, &w, sizeof( w ) );
+	}
+
+	return i;
+}
+
+#if defined(RESTINIO_WS_X86_SIMD)
+
+RESTINIO_WS_TARGET_SSE2 inline std::size_t
+mask_unmask_sse2_blocks(
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	const auto bytes = make_mask_block< 16u >( mask, offset );
+	const __m128i block_mask = _mm_loadu_si128(
+			reinterpret_cast< const __m128i * >( bytes.data() ) );
+
+	std::size_t i = 0;
+	for( ; i + 16u <= size; i += 16u )
+	{
+		auto * p = reinterpret_cast< __m128i * >( data + i );
+		_mm_storeu_si128( p, _mm_xor_si128( _mm_loadu_si128( p ), block_mask ) );
+	}
+
+	return i;
+}
+
+RESTINIO_WS_TARGET_AVX2 inline std::size_t
+mask_unmask_avx2_blocks(
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	const auto bytes = make_mask_block< 32u >( mask, offset );
+	const __m256i block_mask = _mm256_loadu_si256(
+			reinterpret_cast< const __m256i * >( bytes.data() ) );
+
+	std::size_t i = 0;
+	for( ; i + 32u <= size; i += 32u )
+	{
+		auto * p = reinterpret_cast< __m256i * >( data + i );
+		_mm256_storeu_si256( p, _mm256_xor_si256( _mm256_loadu_si256( p ), block_mask ) );
+	}
+
+	return i;
+}
+
+#endif
+
+inline std::size_t
+ascii_word_blocks( const char * data, std::size_t size ) noexcept
+{
+	std::size_t i = 0;
+	for( ; i + sizeof( std::uint64_t ) <= size; i += sizeof( std::uint64_t ) )
+	{
+		std::uint64_t w;
+		std::memcpy( &w, data + i, sizeof( w ) );
+		if( 0u != ( w & 0x8080808080808080ull ) )
+			break;
+	}
+
+	return i;
+}
+
+#if defined(RESTINIO_WS_X86_SIMD)
+
+RESTINIO_WS_TARGET_SSE2 inline std::size_t
+ascii_sse2_blocks( const char * data, std::size_t size ) noexcept
+{
+	std::size_t i = 0;
+	for( ; i + 16u <= size; i += 16u )
+	{
+		const __m128i v = _mm_loadu_si128(
+				reinterpret_cast< const __m128i * >( data + i ) );
+		if( 0 != _mm_movemask_epi8( v ) )
+			break;
+	}
+
+	return i;
+}
+
+RESTINIO_WS_TARGET_AVX2 inline std::size_t
+ascii_avx2_blocks( const char * data, std::size_t size ) noexcept
+{
+	std::size_t i = 0;
+	for( ; i + 32u <= size; i += 32u )
+	{
+		const __m256i v = _mm256_loadu_si256(
+				reinterpret_cast< const __m256i * >( data + i ) );
+		if( 0 != _mm256_movemask_epi8( v ) )
+			break;
+	}
+
+	return i;
+}
+
+#endif
+
+} /* namespace details */
+
+//! XOR payload with masking key.
+/*!
+	\a offset is the index of the byte in masking key that should
+	be applied to the first byte of \a data. It allows to process
+	payload by parts.
+*/
+inline void
+mask_unmask(
+	implementation_t impl,
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	std::size_t processed = 0u;
+	switch( impl )
+	{
+		case implementation_t::scalar:
+		break;
+
+		case implementation_t::word:
+			processed = details::mask_unmask_word_blocks( mask, offset, data, size );
+		break;
+
+#if defined(RESTINIO_WS_X86_SIMD)
+		case implementation_t::sse2:
+			processed = details::mask_unmask_sse2_blocks( mask, offset, data, size );
+		break;
+
+		case implementation_t::avx2:
+			processed = details::mask_unmask_avx2_blocks( mask, offset, data, size );
+		break;
+#else
+		default:
+			processed = details::mask_unmask_word_blocks( mask, offset, data, size );
+#endif
+	}
+
+	// Size of every block is a multiple of masking key size,
+	// so the offset is the same for the rest of data.
+	details::mask_unmask_tail(
+			mask, offset, data + processed, size - processed );
+}
+
+//! XOR payload with masking key using the best implementation.
+inline void
+mask_unmask(
+	const mask_t & mask,
+	std::size_t offset,
+	char * data,
+	std::size_t size ) noexcept
+{
+	mask_unmask( best_implementation(), mask, offset, data, size );
+}
+
+//! Get the length of the prefix of \a data that contains only ASCII symbols.
+inline std::size_t
+ascii_prefix_size(
+	implementation_t impl,
+	const char * data,
+	std::size_t size ) noexcept
+{
+	std::size_t i = 0u;
+	switch( impl )
+	{
+		case implementation_t::scalar:
+		break;
+
+		case implementation_t::word:
+			i = details::ascii_word_blocks( data, size );
+		break;
+
+#if defined(RESTINIO_WS_X86_SIMD)
+		case implementation_t::sse2:
+			i = details::ascii_sse2_blocks( data, size );
+		break;
+
+		case implementation_t::avx2:
+			i = details::ascii_avx2_blocks( data, size );
+		break;
+#else
+		default:
+			i = details::ascii_word_blocks( data, size );
+#endif
+	}
+
+	while( i < size && 0u == ( static_cast< std::uint8_t >( data[ i ] ) & 0x80u ) )
+		++i;
+
+	return i;
+}
+
+//! Get the length of ASCII prefix using the best implementation.
+inline std::size_t
+ascii_prefix_size( const char * data, std::size_t size ) noexcept
+{
+	return ascii_prefix_size( best_implementation(), data, size );
+}
+
+} /* namespace vectorized */
+
+} /* namespace impl */
+
+} /* namespace basic */
+
+} /* namespace websocket */
+
+} /* namespace restinio */
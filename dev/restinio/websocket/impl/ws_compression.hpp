@@ -0,0 +1,128 @@
+/*
+	restinio
+*/
+
+/*!
+	Interfaces for compression of websocket messages.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include <restinio/string_view.hpp>
+#include <restinio/optional.hpp>
+#include <restinio/websocket/message.hpp>
+
+namespace restinio
+{
+
+namespace websocket
+{
+
+namespace basic
+{
+
+namespace impl
+{
+
+//
+// compressed_frame_t
+//
+
+//! Payload of an outgoing frame after compression.
+/*!
+	@since v.0.6.2
+*/
+struct compressed_frame_t
+{
+	//! Should RSV1 bit be set for the frame.
+	/*!
+		Only the first frame of a compressed message has RSV1 bit.
+	*/
+	bool m_rsv1_flag;
+
+	//! Compressed payload.
+	std::string m_payload;
+};
+
+//
+// message_compressor_t
+//
+
+//! Compressor of outgoing messages.
+/*!
+	An instance is created for a websocket if a compression extension
+	is negotiated. Frames must be passed in the order they are sent.
+
+	@since v.0.6.2
+*/
+class message_compressor_t
+{
+	public:
+		virtual ~message_compressor_t() = default;
+
+		//! Compress the payload of a data frame.
+		/*!
+			\return empty value if the frame is sent as it is.
+
+			\note Control frames must not be passed here.
+		*/
+		virtual optional_t< compressed_frame_t >
+		compress_frame(
+			opcode_t opcode,
+			bool final_frame,
+			string_view_t payload ) = 0;
+};
+
+using message_compressor_unique_ptr_t = std::unique_ptr< message_compressor_t >;
+
+//
+// message_decompressor_t
+//
+
+//! Decompressor of incoming messages.
+/*!
+	@since v.0.6.2
+*/
+class message_decompressor_t
+{
+	public:
+		virtual ~message_decompressor_t() = default;
+
+		//! Decompress the payload of a frame of a compressed message.
+		/*!
+			Throws if the payload can't be decompressed.
+		*/
+		virtual void
+		decompress_frame( bool final_frame, std::string & payload ) = 0;
+};
+
+using message_decompressor_unique_ptr_t = std::unique_ptr< message_decompressor_t >;
+
+//
+// ws_compression_t
+//
+
+//! Compressor and decompressor negotiated for a websocket.
+/*!
+	Both are empty if no compression extension is used.
+
+	@since v.0.6.2
+*/
+struct ws_compression_t
+{
+	message_compressor_unique_ptr_t m_compressor;
+	message_decompressor_unique_ptr_t m_decompressor;
+};
+
+} /* namespace impl */
+
+} /* namespace basic */
+
+} /* namespace websocket */
+
+} /* namespace restinio */
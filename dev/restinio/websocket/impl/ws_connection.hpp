@@ -8,7 +8,9 @@
 
 #pragma once
 
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <deque>
 
 #include <restinio/asio_include.hpp>
 
@@ -22,6 +24,7 @@
 #include <restinio/websocket/message.hpp>
 #include <restinio/websocket/impl/ws_parser.hpp>
 #include <restinio/websocket/impl/ws_protocol_validator.hpp>
+#include <restinio/websocket/impl/ws_compression.hpp>
 
 #include <restinio/utils/impl/safe_uint_truncate.hpp>
 
@@ -39,8 +42,6 @@ namespace basic
 namespace impl
 {
 
-using write_groups_queue_t = std::queue< write_group_t >;
-
 //! Max possible size of websocket frame header (a part before payload).
 constexpr size_t
 websocket_header_max_size()
@@ -60,7 +61,81 @@ class ws_outgoing_data_t
 		void
 		append( write_group_t wg )
 		{
-			m_awaiting_write_groups.emplace( std::move( wg ) );
+			append( std::move( wg ), nullptr );
+		}
+
+		//! Add buffers of a frame from a source of shared frames.
+		/*!
+			@since v.0.6.2
+		*/
+		void
+		append( write_group_t wg, const void * source_key )
+		{
+			const auto size = write_group_size( wg );
+			m_awaiting_write_groups.emplace_back( std::move( wg ), source_key, size );
+			m_queued_bytes += size;
+		}
+
+		//! Replace the latest awaiting buffers from the source.
+		/*!
+			\return false if there are no buffers from the source.
+			\a wg isn't changed in that case.
+
+			@since v.0.6.2
+		*/
+		bool
+		replace( write_group_t & wg, const void * source_key )
+		{
+			const auto it = std::find_if(
+				m_awaiting_write_groups.rbegin(),
+				m_awaiting_write_groups.rend(),
+				[source_key]( const awaiting_write_group_t & awg ) {
+					return source_key == awg.m_source_key;
+				} );
+
+			if( m_awaiting_write_groups.rend() == it )
+				return false;
+
+			const auto size = write_group_size( wg );
+			m_queued_bytes = m_queued_bytes - it->m_size + size;
+
+			it->m_wg = std::move( wg );
+			it->m_size = size;
+			return true;
+		}
+
+		//! Get the count of awaiting write groups.
+		/*!
+			@since v.0.6.2
+		*/
+		std::size_t
+		queue_depth() const noexcept
+		{
+			return m_awaiting_write_groups.size();
+		}
+
+		//! Get the size of data in awaiting write groups.
+		/*!
+			@since v.0.6.2
+		*/
+		std::size_t
+		queued_bytes() const noexcept
+		{
+			return m_queued_bytes;
+		}
+
+		//! Get the size of data in a write group.
+		/*!
+			@since v.0.6.2
+		*/
+		static std::size_t
+		write_group_size( const write_group_t & wg )
+		{
+			std::size_t result = 0u;
+			for( const auto & item : wg.items() )
+				result += item.size();
+
+			return result;
 		}
 
 		optional_t< write_group_t >
@@ -70,16 +145,41 @@ class ws_outgoing_data_t
 
 			if( !m_awaiting_write_groups.empty() )
 			{
-				result = std::move( m_awaiting_write_groups.front() );
-				m_awaiting_write_groups.pop();
+				m_queued_bytes -= m_awaiting_write_groups.front().m_size;
+				result = std::move( m_awaiting_write_groups.front().m_wg );
+				m_awaiting_write_groups.pop_front();
 			}
 
 			return result;
 		}
 
 	private:
+		//! Awaiting buffers with the key of their source.
+		struct awaiting_write_group_t
+		{
+			awaiting_write_group_t(
+				write_group_t wg,
+				const void * source_key,
+				std::size_t size )
+				:	m_wg{ std::move( wg ) }
+				,	m_source_key{ source_key }
+				,	m_size{ size }
+			{}
+
+			write_group_t m_wg;
+
+			//! Is null if buffers are not from a source of shared frames.
+			const void * m_source_key;
+
+			//! Size of data in the write group.
+			std::size_t m_size;
+		};
+
 		//! A queue of buffers.
-		write_groups_queue_t m_awaiting_write_groups;
+		std::deque< awaiting_write_group_t > m_awaiting_write_groups;
+
+		//! Size of data in awaiting write groups.
+		std::size_t m_queued_bytes{ 0u };
 };
 
 //
@@ -145,7 +245,9 @@ class ws_connection_t final
 			restinio::impl::connection_settings_handle_t< Traits > settings,
 			stream_socket_t socket,
 			//! \}
-			message_handler_t msg_handler )
+			message_handler_t msg_handler,
+			//! Compressor and decompressor if compression is negotiated.
+			ws_compression_t compression = ws_compression_t{} )
 			:	ws_connection_base_t{ conn_id }
 			,	executor_wrapper_base_t{ socket.get_executor() }
 			,	m_settings{ std::move( settings ) }
@@ -154,7 +256,12 @@ class ws_connection_t final
 			,	m_input{ websocket_header_max_size() }
 			,	m_msg_handler{ std::move( msg_handler ) }
 			,	m_logger{ *( m_settings->m_logger ) }
+			,	m_compressor{ std::move( compression.m_compressor ) }
+			,	m_decompressor{ std::move( compression.m_decompressor ) }
 		{
+			if( m_decompressor )
+				m_protocol_validator.allow_compressed_messages();
+
 			// Notify of a new connection instance.
 			m_logger.trace( [&]{
 					return fmt::format(
@@ -357,6 +464,145 @@ class ws_connection_t final
 					}
 				} );
 		}
+
+		//! Write a frame of a message.
+		virtual void
+		write_frame(
+			final_frame_flag_t final_flag,
+			opcode_t opcode,
+			writable_item_t payload,
+			write_status_cb_t wscb ) override
+		{
+			//! Run write message on io_context loop if possible.
+			asio_ns::dispatch(
+				this->get_executor(),
+				[ this,
+					final_flag,
+					opcode,
+					payload = std::move( payload ),
+					wscb = std::move( wscb ),
+					ctx = shared_from_this() ]
+				// NOTE: this lambda is noexcept.
+				() mutable noexcept
+				{
+					try
+					{
+						if( write_state_t::write_enabled == m_write_state )
+							write_frame_impl(
+								final_flag,
+								opcode,
+								std::move( payload ),
+								std::move( wscb ) );
+						else
+						{
+							m_logger.warn( [&]{
+								return fmt::format(
+										"[ws_connection:{}] cannot write to websocket: "
+										"write operations disabled",
+										connection_id() );
+							} );
+						}
+					}
+					catch( const std::exception & ex )
+					{
+						trigger_error_and_close(
+							status_code_t::unexpected_condition,
+							[&]{
+								return fmt::format(
+									"[ws_connection:{}] unable to write frame: {}",
+									connection_id(),
+									ex.what() );
+							} );
+					}
+				} );
+		}
+
+		//! Write a frame shared between several websockets.
+		virtual void
+		write_shared_frame(
+			shared_frame_t frame,
+			shared_frame_write_params_t params ) override
+		{
+			//! Run write message on io_context loop if possible.
+			asio_ns::dispatch(
+				this->get_executor(),
+				[ this,
+					frame = std::move( frame ),
+					ctx = shared_from_this(),
+					params ]
+				// NOTE: this lambda is noexcept.
+				() mutable noexcept
+				{
+					try
+					{
+						if( write_state_t::write_enabled == m_write_state &&
+							m_socket.is_open() )
+							write_shared_frame_impl( std::move( frame ), params );
+					}
+					catch( const std::exception & ex )
+					{
+						trigger_error_and_close(
+							status_code_t::unexpected_condition,
+							[&]{
+								return fmt::format(
+									"[ws_connection:{}] unable to write shared frame: {}",
+									connection_id(),
+									ex.what() );
+							} );
+					}
+				} );
+		}
+
+		virtual asio_ns::executor
+		io_executor() override
+		{
+			return m_socket.get_executor();
+		}
+
+		//! Set limits for outgoing data.
+		virtual void
+		set_outgoing_queue_limits( outgoing_queue_limits_t limits ) override
+		{
+			asio_ns::dispatch(
+				this->get_executor(),
+				[ this,
+					limits = std::move( limits ),
+					ctx = shared_from_this() ]
+				// NOTE: this lambda is noexcept.
+				() mutable noexcept
+				{
+					try
+					{
+						m_outgoing_queue_limits = std::move( limits );
+						update_outgoing_queue_state();
+					}
+					catch( const std::exception & ex )
+					{
+						trigger_error_and_close(
+							status_code_t::unexpected_condition,
+							[&]{
+								return fmt::format(
+									"[ws_connection:{}] unable to set outgoing queue limits: {}",
+									connection_id(),
+									ex.what() );
+							} );
+					}
+				} );
+		}
+
+		virtual outgoing_queue_stats_t
+		outgoing_queue_stats() const noexcept override
+		{
+			return outgoing_queue_stats_t{
+				m_queue_depth_stat.load( std::memory_order_relaxed ),
+				m_queued_bytes_stat.load( std::memory_order_relaxed ) };
+		}
+
+		virtual bool
+		is_writable() const noexcept override
+		{
+			return m_writable.load( std::memory_order_acquire );
+		}
 	private:
 		//! Standard close routine.
 		/*!
@@ -430,6 +676,7 @@ class ws_connection_t final
 
 			bufs.emplace_back( std::move( payload ) );
 			m_outgoing_data.append( write_group_t{ std::move( bufs ) } );
+			update_outgoing_queue_state();
 
 			init_write_if_necessary();
 
@@ -932,6 +1179,12 @@ class ws_connection_t final
 		{
 			auto & md = m_input.m_parser.current_message();
 
+			// Frames skipped while waiting for close frame aren't decompressed.
+			if( read_state_t::read_any_frame == m_read_state &&
+				m_protocol_validator.is_compressed_message() &&
+				!decompress_current_payload( md ) )
+				return;
+
 			const auto validation_result = m_protocol_validator.finish_frame();
 			if( validation_state_t::frame_is_valid == validation_result )
 			{
@@ -995,6 +1248,41 @@ class ws_connection_t final
 			}
 		}
 
+		//! Decompress the payload of the current frame.
+		/*!
+			\return false if payload is invalid and the case is handled.
+
+			\since v.0.6.2
+		*/
+		bool
+		decompress_current_payload( const message_details_t & md )
+		{
+			try
+			{
+				m_decompressor->decompress_frame( md.m_final_flag, m_input.m_payload );
+			}
+			catch( const std::exception & ex )
+			{
+				m_logger.error( [&]{
+					return fmt::format(
+							"[ws_connection:{}] unable to decompress payload: {}",
+							connection_id(),
+							ex.what() );
+				} );
+
+				m_protocol_validator.reset();
+				handle_invalid_payload( validation_state_t::invalid_compressed_data );
+
+				return false;
+			}
+
+			m_protocol_validator.process_decompressed_payload_part(
+				m_input.m_payload.data(),
+				m_input.m_payload.size() );
+
+			return true;
+		}
+
 		void
 		call_close_handler_if_necessary( status_code_t status )
 		{
@@ -1033,6 +1321,7 @@ class ws_connection_t final
 
 				// Push write_group to queue.
 				m_outgoing_data.append( std::move( wg ) );
+				update_outgoing_queue_state();
 
 				init_write_if_necessary();
 			}
@@ -1055,6 +1344,248 @@ class ws_connection_t final
 			}
 		}
 
+		//! Implementation of writing a frame performed on the asio_ns::io_context.
+		void
+		write_frame_impl(
+			final_frame_flag_t final_flag,
+			opcode_t opcode,
+			writable_item_t payload,
+			write_status_cb_t wscb )
+		{
+			const bool is_close_frame = opcode_t::connection_close_frame == opcode;
+
+			if( m_socket.is_open() && !is_close_frame &&
+				should_reject_frame( final_flag, opcode ) )
+			{
+				handle_outgoing_queue_overflow( wscb );
+				return;
+			}
+
+			message_details_t details{
+				final_flag, opcode, asio_ns::buffer_size( payload.buf() ) };
+
+			// Frames are compressed in the order they are written,
+			// the peer decompresses them in the same order.
+			if( m_compressor && !is_control_frame( opcode ) )
+				compress_payload( details, payload );
+
+			writable_items_container_t bufs;
+			bufs.reserve( 2 );
+			bufs.emplace_back( write_message_details( details ) );
+			bufs.emplace_back( std::move( payload ) );
+
+			write_group_t wg{ std::move( bufs ) };
+			if( wscb )
+				wg.after_write_notificator( std::move( wscb ) );
+
+			write_data_impl( std::move( wg ), is_close_frame );
+		}
+
+		//! Should a new frame be rejected by the overflow policy.
+		/*!
+			The decision is made for the first frame of a message
+			and the rest frames of the message follow it. So a message
+			is either sent or rejected as a whole, and a rejected message
+			never gets to the compressor.
+
+			A control frame can't be fragmented and is decided on its own.
+
+			\since v.0.6.2
+		*/
+		bool
+		should_reject_frame( final_frame_flag_t final_flag, opcode_t opcode )
+		{
+			const bool overflow =
+				m_above_high_watermark &&
+				queue_overflow_policy_t::accept !=
+					m_outgoing_queue_limits.overflow_policy();
+
+			if( is_control_frame( opcode ) )
+				return overflow;
+
+			if( opcode_t::continuation_frame != opcode )
+				m_rejecting_message = overflow;
+
+			const bool result = m_rejecting_message;
+			if( final_frame == final_flag )
+				m_rejecting_message = false;
+
+			return result;
+		}
+
+		//! Replace payload of a data frame with compressed one if necessary.
+		void
+		compress_payload(
+			message_details_t & details,
+			writable_item_t & payload )
+		{
+			const auto buf = payload.buf();
+			auto compressed = m_compressor->compress_frame(
+					details.m_opcode,
+					details.m_final_flag,
+					string_view_t{
+						static_cast< const char * >( buf.data() ),
+						buf.size() } );
+
+			if( compressed )
+			{
+				details = message_details_t{
+					details.m_final_flag ? final_frame : not_final_frame,
+					details.m_opcode,
+					compressed->m_payload.size() };
+				details.m_rsv1_flag = compressed->m_rsv1_flag;
+
+				payload = writable_item_t{ std::move( compressed->m_payload ) };
+			}
+		}
+
+		//! Implementation of writing a shared frame performed on the asio_ns::io_context.
+		void
+		write_shared_frame_impl(
+			shared_frame_t frame,
+			const shared_frame_write_params_t & params )
+		{
+			writable_items_container_t bufs;
+			bufs.reserve( 1 );
+			bufs.emplace_back( std::move( frame ) );
+
+			write_group_t wg{ std::move( bufs ) };
+
+			if( params.m_max_queue_depth <= m_outgoing_data.queue_depth() )
+			{
+				switch( params.m_policy )
+				{
+					case slow_consumer_policy_t::drop:
+						m_logger.trace( [&]{
+							return fmt::format(
+									"[ws_connection:{}] shared frame dropped, "
+									"queue depth: {}",
+									connection_id(),
+									m_outgoing_data.queue_depth() );
+						} );
+					return;
+
+					case slow_consumer_policy_t::coalesce:
+						if( m_outgoing_data.replace( wg, params.m_source_key ) )
+						{
+							update_outgoing_queue_state();
+							return;
+						}
+					break;
+
+					case slow_consumer_policy_t::disconnect:
+						close_slow_consumer();
+					return;
+				}
+			}
+
+			m_outgoing_data.append( std::move( wg ), params.m_source_key );
+			update_outgoing_queue_state();
+
+			init_write_if_necessary();
+		}
+
+		//! Apply the overflow policy to a new frame.
+		void
+		handle_outgoing_queue_overflow( write_status_cb_t & wscb )
+		{
+			if( queue_overflow_policy_t::drop ==
+				m_outgoing_queue_limits.overflow_policy() )
+			{
+				m_logger.trace( [&]{
+					return fmt::format(
+							"[ws_connection:{}] outgoing message dropped, "
+							"queued bytes: {}",
+							connection_id(),
+							m_outgoing_data.queued_bytes() + m_current_write_group_size );
+				} );
+			}
+			else
+			{
+				close_slow_consumer();
+			}
+
+			if( wscb )
+				wscb( make_asio_compaible_error(
+					asio_convertible_error_t::write_was_not_executed ) );
+		}
+
+		//! Close the connection because the peer doesn't read data fast enough.
+		void
+		close_slow_consumer()
+		{
+			m_logger.warn( [&]{
+				return fmt::format(
+						"[ws_connection:{}] slow consumer is disconnected, "
+						"queue depth: {}, queued bytes: {}",
+						connection_id(),
+						m_outgoing_data.queue_depth(),
+						m_outgoing_data.queued_bytes() + m_current_write_group_size );
+			} );
+
+			m_close_frame_to_peer.disable();
+			call_close_handler_if_necessary( status_code_t::policy_violation );
+			close_impl();
+		}
+
+		//! Update the state of the outgoing queue visible to producers.
+		/*!
+			Calls writable_again_handler if the amount of queued data
+			drops to the low watermark.
+		*/
+		void
+		update_outgoing_queue_state()
+		{
+			const auto queued_bytes =
+				m_outgoing_data.queued_bytes() + m_current_write_group_size;
+
+			m_queue_depth_stat.store(
+				m_outgoing_data.queue_depth() +
+					( m_write_output_ctx.transmitting() ? 1u : 0u ),
+				std::memory_order_relaxed );
+			m_queued_bytes_stat.store( queued_bytes, std::memory_order_relaxed );
+
+			if( !m_above_high_watermark &&
+				m_outgoing_queue_limits.high_watermark() <= queued_bytes )
+			{
+				m_above_high_watermark = true;
+				m_writable.store( false, std::memory_order_release );
+			}
+			else if( m_above_high_watermark &&
+				m_outgoing_queue_limits.low_watermark() >= queued_bytes )
+			{
+				m_above_high_watermark = false;
+				m_writable.store( true, std::memory_order_release );
+
+				call_writable_again_handler();
+			}
+		}
+
+		void
+		call_writable_again_handler()
+		{
+			const auto & handler = m_outgoing_queue_limits.writable_again_handler();
+			if( !handler )
+				return;
+
+			if( auto wsh = m_websocket_weak_handle.lock() )
+			{
+				try
+				{
+					handler( std::move( wsh ) );
+				}
+				catch( const std::exception & ex )
+				{
+					m_logger.error( [&]{
+						return fmt::format(
+							"[ws_connection:{}] execute writable again handler error: {}",
+							connection_id(),
+							ex.what() );
+					} );
+				}
+			}
+		}
+
 		//! Checks if there is something to write,
 		//! and if so starts write operation.
 		void
@@ -1084,6 +1615,9 @@ class ws_connection_t final
 						next_write_group->items_count() );
 				} );
 
+				m_current_write_group_size =
+					ws_outgoing_data_t::write_group_size( *next_write_group );
+
 				// Initialize write context with a new write group.
 				m_write_output_ctx.start_next_write_group(
 					std::move( next_write_group ) );
@@ -1202,6 +1736,9 @@ class ws_connection_t final
 			// Group notificators are called from here (if exist):
 			m_write_output_ctx.finish_write_group();
 
+			m_current_write_group_size = 0u;
+			update_outgoing_queue_state();
+
 			// Start another write opertion
 			// if there is something to send.
 			init_write_if_necessary();
@@ -1357,12 +1894,52 @@ class ws_connection_t final
 		//! Logger for operation
 		logger_t & m_logger;
 
+		//! Compressor of outgoing messages.
+		/*!
+			Is empty if compression isn't negotiated.
+
+			\since v.0.6.2
+		*/
+		message_compressor_unique_ptr_t m_compressor;
+
+		//! Decompressor of incoming messages.
+		/*!
+			Is empty if compression isn't negotiated.
+
+			\since v.0.6.2
+		*/
+		message_decompressor_unique_ptr_t m_decompressor;
+
 		//! Write to socket operation context.
 		restinio::impl::write_group_output_ctx_t m_write_output_ctx;
 
 		//! Output buffers queue.
 		ws_outgoing_data_t m_outgoing_data;
 
+		//! Size of the write group that is being written.
+		//! \since v.0.6.2
+		std::size_t m_current_write_group_size{ 0u };
+
+		//! Limits for outgoing data.
+		//! \since v.0.6.2
+		outgoing_queue_limits_t m_outgoing_queue_limits;
+
+		//! Has the amount of queued data reached the high watermark.
+		//! \since v.0.6.2
+		bool m_above_high_watermark{ false };
+
+		//! Are frames of the current outgoing message rejected.
+		//! \since v.0.6.2
+		bool m_rejecting_message{ false };
+
+		//! The state of the outgoing queue for reading from other threads.
+		//! \since v.0.6.2
+		//! \{
+		std::atomic< std::size_t > m_queue_depth_stat{ 0u };
+		std::atomic< std::size_t > m_queued_bytes_stat{ 0u };
+		std::atomic< bool > m_writable{ true };
+		//! \}
+
 		//! A waek handler for owning ws_t to use it when call message handler.
 		ws_weak_handle_t m_websocket_weak_handle;
 
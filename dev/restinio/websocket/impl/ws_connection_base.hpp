@@ -8,11 +8,16 @@
 
 #pragma once
 
+#include <functional>
+#include <limits>
 #include <memory>
+#include <string>
 
 #include <restinio/tcp_connection_ctx_base.hpp>
 #include <restinio/common_types.hpp>
 #include <restinio/buffers.hpp>
+#include <restinio/exception.hpp>
+#include <restinio/websocket/message.hpp>
 
 namespace restinio
 {
@@ -26,9 +31,214 @@ namespace basic
 class ws_t;
 using ws_handle_t = std::shared_ptr< ws_t >;
 
+//
+// slow_consumer_policy_t
+//
+
+//! What to do with a frame shared between several websockets
+//! if a websocket has too many awaiting outgoing frames.
+/*!
+	@since v.0.6.2
+*/
+enum class slow_consumer_policy_t
+{
+	//! The frame is not sent to this websocket.
+	drop,
+	//! The frame replaces the awaiting frame from the same source.
+	/*!
+		If there is no such frame the new frame is queued.
+	*/
+	coalesce,
+	//! The connection is closed.
+	disconnect
+};
+
+//
+// queue_overflow_policy_t
+//
+
+//! What to do with a new outgoing message if the amount of
+//! queued outgoing data is above the high watermark.
+/*!
+	@since v.0.6.2
+*/
+enum class queue_overflow_policy_t
+{
+	//! The message is queued. A producer should check ws_t::is_writable().
+	accept,
+	//! The message is not sent.
+	/*!
+		The write status callback of the message is called with an error.
+
+		A fragmented message is dropped as a whole: the decision is made
+		for its first frame. Frames of a message that was started before
+		the overflow are still sent.
+	*/
+	drop,
+	//! The connection is closed.
+	close
+};
+
+//! A handler called when a websocket becomes writable again.
+/*!
+	@since v.0.6.2
+*/
+using writable_again_handler_t = std::function< void( ws_handle_t ) >;
+
+//
+// outgoing_queue_limits_t
+//
+
+//! Limits for the amount of outgoing data queued by a websocket.
+/*!
+	When the amount of queued data reaches the high watermark the
+	websocket becomes not writable. It becomes writable again when the
+	amount of queued data drops to the low watermark.
+
+	There are no limits by default.
+
+	@since v.0.6.2
+*/
+class outgoing_queue_limits_t
+{
+	public:
+		//! Get the low watermark in bytes.
+		std::size_t low_watermark() const noexcept { return m_low_watermark; }
+
+		//! Get the high watermark in bytes.
+		std::size_t high_watermark() const noexcept { return m_high_watermark; }
+
+		//! Set low and high watermarks in bytes.
+		outgoing_queue_limits_t &
+		watermarks( std::size_t low, std::size_t high ) &
+		{
+			if( low > high )
+				throw exception_t{
+					"low watermark can't be greater than high watermark" };
+
+			m_low_watermark = low;
+			m_high_watermark = high;
+			return *this;
+		}
+
+		//! Set low and high watermarks in bytes.
+		outgoing_queue_limits_t &&
+		watermarks( std::size_t low, std::size_t high ) &&
+		{
+			return std::move( this->watermarks( low, high ) );
+		}
+
+		//! What to do with new messages above the high watermark.
+		queue_overflow_policy_t overflow_policy() const noexcept
+		{
+			return m_overflow_policy;
+		}
+
+		//! Set overflow_policy.
+		outgoing_queue_limits_t &
+		overflow_policy( queue_overflow_policy_t value ) & noexcept
+		{
+			m_overflow_policy = value;
+			return *this;
+		}
+
+		//! Set overflow_policy.
+		outgoing_queue_limits_t &&
+		overflow_policy( queue_overflow_policy_t value ) && noexcept
+		{
+			return std::move( this->overflow_policy( value ) );
+		}
+
+		//! Get the handler called when a websocket becomes writable again.
+		const writable_again_handler_t &
+		writable_again_handler() const noexcept
+		{
+			return m_writable_again_handler;
+		}
+
+		//! Set writable_again_handler.
+		/*!
+			The handler is called on the context of the websocket.
+		*/
+		outgoing_queue_limits_t &
+		writable_again_handler( writable_again_handler_t handler ) &
+		{
+			m_writable_again_handler = std::move( handler );
+			return *this;
+		}
+
+		//! Set writable_again_handler.
+		outgoing_queue_limits_t &&
+		writable_again_handler( writable_again_handler_t handler ) &&
+		{
+			return std::move( this->writable_again_handler( std::move( handler ) ) );
+		}
+
+	private:
+		std::size_t m_low_watermark{ std::numeric_limits< std::size_t >::max() };
+		std::size_t m_high_watermark{ std::numeric_limits< std::size_t >::max() };
+		queue_overflow_policy_t m_overflow_policy{ queue_overflow_policy_t::accept };
+		writable_again_handler_t m_writable_again_handler;
+};
+
+//
+// outgoing_queue_stats_t
+//
+
+//! The state of the queue of outgoing data of a websocket.
+/*!
+	Includes the data that is being written at the moment.
+
+	@since v.0.6.2
+*/
+struct outgoing_queue_stats_t
+{
+	//! Count of write groups (frames) not written yet.
+	std::size_t m_queue_depth;
+
+	//! Size of the data not written yet.
+	std::size_t m_queued_bytes;
+};
+
 namespace impl
 {
 
+//
+// shared_frame_t
+//
+
+//! A frame encoded once and sent to several websockets.
+/*!
+	Contains both the header and the payload of the frame.
+
+	@since v.0.6.2
+*/
+using shared_frame_t = std::shared_ptr< const std::string >;
+
+//
+// shared_frame_write_params_t
+//
+
+//! Parameters for writing a shared frame to a particular websocket.
+/*!
+	@since v.0.6.2
+*/
+struct shared_frame_write_params_t
+{
+	//! Max count of awaiting outgoing frames before the policy is applied.
+	std::size_t m_max_queue_depth;
+
+	//! What to do if there are too many awaiting frames.
+	slow_consumer_policy_t m_policy;
+
+	//! A key of the source of frames.
+	/*!
+		Awaiting frames with the same key are replaced
+		by slow_consumer_policy_t::coalesce.
+	*/
+	const void * m_source_key;
+};
+
 //
 // ws_connection_base_t
 //
@@ -59,6 +269,60 @@ class ws_connection_base_t
 		write_data(
 			write_group_t wg,
 			bool is_close_frame ) = 0;
+
+		//! Write a frame of a message.
+		/*!
+			The header of the frame is made on the context of
+			the connection, so the payload can be compressed there
+			in the order the frames are written.
+
+			@since v.0.6.2
+		*/
+		virtual void
+		write_frame(
+			final_frame_flag_t final_flag,
+			opcode_t opcode,
+			writable_item_t payload,
+			write_status_cb_t wscb ) = 0;
+
+		//! Write a frame shared between several websockets.
+		/*!
+			@since v.0.6.2
+		*/
+		virtual void
+		write_shared_frame(
+			shared_frame_t frame,
+			shared_frame_write_params_t params ) = 0;
+
+		//! Get the executor of the underlying socket.
+		/*!
+			Allows to group websockets by io_context.
+
+			@since v.0.6.2
+		*/
+		virtual asio_ns::executor
+		io_executor() = 0;
+
+		//! Set limits for outgoing data.
+		/*!
+			@since v.0.6.2
+		*/
+		virtual void
+		set_outgoing_queue_limits( outgoing_queue_limits_t limits ) = 0;
+
+		//! Get the state of the queue of outgoing data.
+		/*!
+			@since v.0.6.2
+		*/
+		virtual outgoing_queue_stats_t
+		outgoing_queue_stats() const noexcept = 0;
+
+		//! Is the amount of queued outgoing data below the high watermark.
+		/*!
+			@since v.0.6.2
+		*/
+		virtual bool
+		is_writable() const noexcept = 0;
 };
 
 //! Alias for WebSocket connection handle.
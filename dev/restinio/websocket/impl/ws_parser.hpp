@@ -13,6 +13,8 @@
 
 #include <restinio/utils/impl/bitops.hpp>
 
+#include <restinio/websocket/impl/vectorized_ops.hpp>
+
 #include <cstdint>
 #include <vector>
 #include <list>
@@ -489,22 +491,14 @@ mask_unmask_payload( std::uint32_t masking_key, raw_data_t & payload )
 {
 	using namespace ::restinio::utils::impl::bitops;
 
-	const std::size_t MASK_SIZE = 4;
-	const uint8_t mask[ MASK_SIZE ] = {
+	const vectorized::mask_t mask{ {
 		n_bits_from< std::uint8_t, 24 >(masking_key),
 		n_bits_from< std::uint8_t, 16 >(masking_key),
 		n_bits_from< std::uint8_t, 8 >(masking_key),
 		n_bits_from< std::uint8_t, 0 >(masking_key),
-	};
+	} };
 
-	const auto payload_size = payload.size();
-	for( std::size_t i = 0; i < payload_size; )
-	{
-		for( std::size_t j = 0; j < MASK_SIZE && i < payload_size; ++j, ++i )
-		{
-			payload[ i ] ^= mask[ j ];
-		}
-	}
+	vectorized::mask_unmask( mask, 0u, &payload[ 0 ], payload.size() );
 }
 
 //! Serialize websocket message details into bytes buffer.
@@ -8,6 +8,10 @@
 #include <restinio/websocket/impl/utf8.hpp>
 #include <restinio/websocket/impl/ws_parser.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 namespace restinio
 {
 
@@ -43,7 +47,10 @@ enum class validation_state_t
 	new_data_frame_without_finishing_previous,
 	// payload validation error codes
 	invalid_close_code,
-	incorrect_utf8_data
+	incorrect_utf8_data,
+	//! Compressed payload can't be decompressed.
+	//! @since v.0.6.2
+	invalid_compressed_data
 };
 
 //
@@ -68,7 +75,8 @@ validation_state_str( validation_state_t state )
 		"continuation_frame_without_data_frame",
 		"new_data_frame_without_finishing_previous",
 		"invalid_close_code",
-		"incorrect_utf8_data"
+		"incorrect_utf8_data",
+		"invalid_compressed_data"
 	};
 
 	return table[static_cast<unsigned int>(state)];
@@ -143,6 +151,19 @@ struct unmasker_t
 		return masked_byte ^ m_mask[ (m_processed_bytes_count++) % 4 ];
 	}
 
+	//! Do unmask operation with a sequence of bytes.
+	/*!
+		\since
+		v.0.6.2
+	*/
+	void
+	unmask_bytes( char * data, std::size_t size ) noexcept
+	{
+		vectorized::mask_unmask(
+				m_mask, m_processed_bytes_count % m_mask.size(), data, size );
+		m_processed_bytes_count += size;
+	}
+
 	//! Reset to initial state.
 	void
 	reset( uint32_t masking_key )
@@ -202,6 +223,31 @@ class ws_protocol_validator_t
 		{
 		}
 
+		//! Allow compressed messages (RSV1 bit in the first frame of a message).
+		/*!
+			Is used when permessage-deflate extension is negotiated.
+			Text payload of compressed messages isn't validated
+			until it is decompressed, see process_decompressed_payload_part().
+
+			\since v.0.6.2
+		*/
+		void
+		allow_compressed_messages() noexcept
+		{
+			m_compressed_messages_allowed = true;
+		}
+
+		//! Does the current frame belong to a compressed message.
+		/*!
+			\since v.0.6.2
+		*/
+		bool
+		is_compressed_message() const noexcept
+		{
+			return m_compressed_message &&
+				!is_control_frame( m_current_frame.m_opcode );
+		}
+
 		//! Start work with new frame.
 		/*!
 			\attention methods finish_frame() or reset() should be called before
@@ -221,11 +267,13 @@ class ws_protocol_validator_t
 					case opcode_t::text_frame:
 						if( !frame.m_final_flag )
 							m_previous_data_frame = previous_data_frame_t::text;
+						m_compressed_message = frame.m_rsv1_flag;
 					break;
 
 					case opcode_t::binary_frame:
 						if( !frame.m_final_flag )
 							m_previous_data_frame = previous_data_frame_t::binary;
+						m_compressed_message = frame.m_rsv1_flag;
 					break;
 
 					case opcode_t::connection_close_frame:
@@ -261,14 +309,24 @@ class ws_protocol_validator_t
 			else
 				return m_validation_state;
 
-			for( size_t i = 0; i < size; ++i )
+			if( m_unmask_flag )
 			{
-				process_payload_byte(
-					static_cast<std::uint8_t>(data[i]) );
+				// Source data can't be modified, so it is unmasked
+				// by small blocks.
+				std::array< char, 512 > block;
+				for( size_t pos = 0; pos < size &&
+					m_validation_state == validation_state_t::payload_part_is_valid;
+					pos += block.size() )
+				{
+					const auto n = std::min( block.size(), size - pos );
+					std::memcpy( block.data(), data + pos, n );
 
-				if( m_validation_state != validation_state_t::payload_part_is_valid )
-					break;
+					m_unmasker.unmask_bytes( block.data(), n );
+					validate_unmasked_payload_part( block.data(), n );
+				}
 			}
+			else
+				validate_unmasked_payload_part( data, size );
 
 			return m_validation_state;
 		}
@@ -286,13 +344,29 @@ class ws_protocol_validator_t
 			else
 				return m_validation_state;
 
-			for( size_t i = 0; i < size; ++i )
-			{
-				data[i] = static_cast<char>(process_payload_byte(
-					static_cast<std::uint8_t>(data[i]) ));
+			if( m_unmask_flag )
+				m_unmasker.unmask_bytes( data, size );
 
-				if( m_validation_state != validation_state_t::payload_part_is_valid )
-					break;
+			validate_unmasked_payload_part( data, size );
+
+			return m_validation_state;
+		}
+
+		//! Validate next part of decompressed payload of the current frame.
+		/*!
+			\since v.0.6.2
+		*/
+		validation_state_t
+		process_decompressed_payload_part( const char * data, size_t size )
+		{
+			if( m_working_state == working_state_t::empty_state )
+				throw exception_t( "current state is empty" );
+
+			if( is_state_still_valid() && is_text_message() )
+			{
+				if( !m_utf8_checker.process_bytes( data, size ) )
+					set_validation_state(
+						validation_state_t::incorrect_utf8_data );
 			}
 
 			return m_validation_state;
@@ -327,6 +401,12 @@ class ws_protocol_validator_t
 					previous_data_frame_t::none;
 			}
 
+			if( !is_control_frame(m_current_frame.m_opcode) &&
+				m_current_frame.m_final_flag )
+			{
+				m_compressed_message = false;
+			}
+
 			// Remember current frame vaidation state and return this value.
 			auto this_frame_validation_state = m_validation_state;
 
@@ -344,6 +424,7 @@ class ws_protocol_validator_t
 			m_working_state = working_state_t::empty_state;
 			m_previous_data_frame =
 				previous_data_frame_t::none;
+			m_compressed_message = false;
 
 			m_utf8_checker.reset();
 		}
@@ -378,7 +459,9 @@ class ws_protocol_validator_t
 				set_validation_state(
 					validation_state_t::empty_mask_from_client_side );
 			}
-			else if( frame.m_rsv1_flag != 0 ||
+			else if( ( frame.m_rsv1_flag &&
+					!( m_compressed_messages_allowed &&
+						is_data_frame( frame.m_opcode ) ) ) ||
 				frame.m_rsv2_flag != 0 ||
 				frame.m_rsv3_flag != 0)
 			{
@@ -395,52 +478,72 @@ class ws_protocol_validator_t
 			return validation_state_t::frame_header_is_valid == m_validation_state;
 		}
 
-		//! Process payload byte.
-		/*!
-			Do all necessary validations with payload byte.
-
-			\return unmasked byte if unmask flag is set.
-			\return copy of original byte if unmask flag isn't set.
-		*/
-		std::uint8_t
-		process_payload_byte( std::uint8_t byte )
+		//! Do all necessary validations with unmasked part of payload.
+		void
+		validate_unmasked_payload_part( const char * data, size_t size )
 		{
-			byte = m_unmask_flag?
-				m_unmasker.unmask_byte( byte ): byte;
-
-			if( m_current_frame.m_opcode == opcode_t::text_frame ||
-				(m_current_frame.m_opcode == opcode_t::continuation_frame &&
-					m_previous_data_frame == previous_data_frame_t::text) )
+			if( is_text_payload() )
 			{
-				if( !m_utf8_checker.process_byte( byte ) )
-				{
+				// Text payload is validated by the whole part at once.
+				// Compressed payload is validated after decompression.
+				if( !m_utf8_checker.process_bytes( data, size ) )
 					set_validation_state(
 						validation_state_t::incorrect_utf8_data );
-				}
 			}
 			else if( m_current_frame.m_opcode == opcode_t::connection_close_frame )
 			{
-				if( !m_expected_close_code.all_bytes_loaded() )
+				for( size_t i = 0; i < size; ++i )
 				{
-					if( m_expected_close_code.add_byte_and_check_size(byte) )
-					{
-						uint16_t status_code{0};
-
-						read_number_from_big_endian_bytes(
-							status_code,m_expected_close_code.m_loaded_data );
+					process_close_frame_payload_byte(
+						static_cast<std::uint8_t>(data[i]) );
 
-						validate_close_code( status_code );
-					}
+					if( m_validation_state != validation_state_t::payload_part_is_valid )
+						break;
 				}
-				else
+			}
+		}
+
+		//! Does the current frame belong to a text message.
+		bool
+		is_text_message() const noexcept
+		{
+			return m_current_frame.m_opcode == opcode_t::text_frame ||
+				(m_current_frame.m_opcode == opcode_t::continuation_frame &&
+					m_previous_data_frame == previous_data_frame_t::text);
+		}
+
+		//! Does the current frame contain text payload.
+		bool
+		is_text_payload() const noexcept
+		{
+			return is_text_message() && !m_compressed_message;
+		}
+
+		//! Process an unmasked byte of close frame payload.
+		/*!
+			Do all necessary validations with payload byte.
+		*/
+		void
+		process_close_frame_payload_byte( std::uint8_t byte )
+		{
+			if( !m_expected_close_code.all_bytes_loaded() )
+			{
+				if( m_expected_close_code.add_byte_and_check_size(byte) )
 				{
-					if( !m_utf8_checker.process_byte( byte ) )
-						set_validation_state(
-							validation_state_t::incorrect_utf8_data );
+					uint16_t status_code{0};
+
+					read_number_from_big_endian_bytes(
+						status_code,m_expected_close_code.m_loaded_data );
+
+					validate_close_code( status_code );
 				}
 			}
-
-			return byte;
+			else
+			{
+				if( !m_utf8_checker.process_byte( byte ) )
+					set_validation_state(
+						validation_state_t::incorrect_utf8_data );
+			}
 		}
 
 		//! Check previous frame type.
@@ -576,6 +679,14 @@ class ws_protocol_validator_t
 		//! This flag set if it's need to unmask payload parts.
 		bool m_unmask_flag{ false };
 
+		//! Can messages be compressed.
+		//! \since v.0.6.2
+		bool m_compressed_messages_allowed{ false };
+
+		//! Is the current data message compressed.
+		//! \since v.0.6.2
+		bool m_compressed_message{ false };
+
 		//! Unmask payload coming from client side.
 		unmasker_t m_unmasker;
 };
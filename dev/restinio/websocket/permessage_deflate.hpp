@@ -0,0 +1,799 @@
+/*
+	restinio
+*/
+
+/*!
+	permessage-deflate WebSocket extension (RFC 7692).
+
+	Requires zlib, so it isn't included by restinio/websocket/websocket.hpp.
+
+	@since v.0.6.2
+*/
+
+#pragma once
+
+#include <restinio/websocket/websocket.hpp>
+#include <restinio/transforms/zlib.hpp>
+#include <restinio/helpers/http_field_parsers/sec-websocket-extensions.hpp>
+
+namespace restinio
+{
+
+namespace websocket
+{
+
+namespace basic
+{
+
+//
+// permessage_deflate_params_t
+//
+
+//! Parameters of permessage-deflate extension acceptable for a server.
+/*!
+	An offer of a client is accepted with the restrictions of these
+	parameters. For example, if server_no_context_takeover(true) is set then
+	the server resets its compression context after each message
+	regardless of the offer.
+
+	Usage example:
+	\code
+	namespace rws = restinio::websocket::basic;
+
+	auto wsh = rws::upgrade< traits_t >(
+		*req,
+		rws::activation_t::immediate,
+		rws::permessage_deflate_params_t{}
+			.server_max_window_bits( 12 )
+			.compression_threshold( 256 ),
+		[]( auto wsh, auto m ){ ... } );
+	\endcode
+
+	@since v.0.6.2
+*/
+class permessage_deflate_params_t
+{
+	public:
+		//! Must the server reset its compression context after each message.
+		bool server_no_context_takeover() const noexcept
+		{
+			return m_server_no_context_takeover;
+		}
+
+		//! Set server_no_context_takeover.
+		permessage_deflate_params_t &
+		server_no_context_takeover( bool value ) & noexcept
+		{
+			m_server_no_context_takeover = value;
+			return *this;
+		}
+
+		//! Set server_no_context_takeover.
+		permessage_deflate_params_t &&
+		server_no_context_takeover( bool value ) && noexcept
+		{
+			return std::move( this->server_no_context_takeover( value ) );
+		}
+
+		//! Must a client reset its compression context after each message.
+		bool client_no_context_takeover() const noexcept
+		{
+			return m_client_no_context_takeover;
+		}
+
+		//! Set client_no_context_takeover.
+		permessage_deflate_params_t &
+		client_no_context_takeover( bool value ) & noexcept
+		{
+			m_client_no_context_takeover = value;
+			return *this;
+		}
+
+		//! Set client_no_context_takeover.
+		permessage_deflate_params_t &&
+		client_no_context_takeover( bool value ) && noexcept
+		{
+			return std::move( this->client_no_context_takeover( value ) );
+		}
+
+		//! Max size of LZ77 sliding window used by the server.
+		int server_max_window_bits() const noexcept
+		{
+			return m_server_max_window_bits;
+		}
+
+		//! Set server_max_window_bits.
+		/*!
+			Must be an integer value in the range of 9 to 15,
+			zlib doesn't support window of 8 bits for raw deflate.
+		*/
+		permessage_deflate_params_t &
+		server_max_window_bits( int value ) &
+		{
+			if( value < 9 || value > 15 )
+			{
+				throw exception_t{
+					fmt::format(
+						"invalid server_max_window_bits: {}, must be "
+						"an integer value in the range of 9 to 15",
+						value ) };
+			}
+
+			m_server_max_window_bits = value;
+			return *this;
+		}
+
+		//! Set server_max_window_bits.
+		permessage_deflate_params_t &&
+		server_max_window_bits( int value ) &&
+		{
+			return std::move( this->server_max_window_bits( value ) );
+		}
+
+		//! Max size of LZ77 sliding window used by a client.
+		/*!
+			\note It can be applied only if a client offers
+			client_max_window_bits parameter.
+		*/
+		int client_max_window_bits() const noexcept
+		{
+			return m_client_max_window_bits;
+		}
+
+		//! Set client_max_window_bits.
+		/*!
+			Must be an integer value in the range of 8 to 15.
+		*/
+		permessage_deflate_params_t &
+		client_max_window_bits( int value ) &
+		{
+			if( value < 8 || value > 15 )
+			{
+				throw exception_t{
+					fmt::format(
+						"invalid client_max_window_bits: {}, must be "
+						"an integer value in the range of 8 to 15",
+						value ) };
+			}
+
+			m_client_max_window_bits = value;
+			return *this;
+		}
+
+		//! Set client_max_window_bits.
+		permessage_deflate_params_t &&
+		client_max_window_bits( int value ) &&
+		{
+			return std::move( this->client_max_window_bits( value ) );
+		}
+
+		//! Compression level.
+		int compression_level() const noexcept { return m_compression_level; }
+
+		//! Set compression level.
+		/*!
+			Must be an integer value in the range of -1 to 9.
+		*/
+		permessage_deflate_params_t &
+		compression_level( int value ) &
+		{
+			// Let zlib params check the value.
+			transforms::zlib::make_raw_deflate_compress_params( value );
+
+			m_compression_level = value;
+			return *this;
+		}
+
+		//! Set compression level.
+		permessage_deflate_params_t &&
+		compression_level( int value ) &&
+		{
+			return std::move( this->compression_level( value ) );
+		}
+
+		//! Memory level of compression.
+		int mem_level() const noexcept { return m_mem_level; }
+
+		//! Set memory level of compression.
+		/*!
+			Must be an integer value in the range of 1 to 9.
+			Every websocket with context takeover keeps its compression
+			state, so a lower value reduces memory used per connection.
+		*/
+		permessage_deflate_params_t &
+		mem_level( int value ) &
+		{
+			// Let zlib params check the value.
+			transforms::zlib::make_raw_deflate_compress_params().mem_level( value );
+
+			m_mem_level = value;
+			return *this;
+		}
+
+		//! Set memory level of compression.
+		permessage_deflate_params_t &&
+		mem_level( int value ) &&
+		{
+			return std::move( this->mem_level( value ) );
+		}
+
+		//! Min size of an outgoing message to be compressed.
+		/*!
+			Smaller messages are sent uncompressed.
+		*/
+		std::size_t compression_threshold() const noexcept
+		{
+			return m_compression_threshold;
+		}
+
+		//! Set min size of an outgoing message to be compressed.
+		permessage_deflate_params_t &
+		compression_threshold( std::size_t value ) & noexcept
+		{
+			m_compression_threshold = value;
+			return *this;
+		}
+
+		//! Set min size of an outgoing message to be compressed.
+		permessage_deflate_params_t &&
+		compression_threshold( std::size_t value ) && noexcept
+		{
+			return std::move( this->compression_threshold( value ) );
+		}
+
+		//! Max size of an incoming message after decompression.
+		/*!
+			Connection is closed if a message exceeds this size.
+		*/
+		std::size_t max_decompressed_message_size() const noexcept
+		{
+			return m_max_decompressed_message_size;
+		}
+
+		//! Set max size of an incoming message after decompression.
+		permessage_deflate_params_t &
+		max_decompressed_message_size( std::size_t value ) & noexcept
+		{
+			m_max_decompressed_message_size = value;
+			return *this;
+		}
+
+		//! Set max size of an incoming message after decompression.
+		permessage_deflate_params_t &&
+		max_decompressed_message_size( std::size_t value ) && noexcept
+		{
+			return std::move( this->max_decompressed_message_size( value ) );
+		}
+
+	private:
+		bool m_server_no_context_takeover{ false };
+		bool m_client_no_context_takeover{ false };
+		int m_server_max_window_bits{ 15 };
+		int m_client_max_window_bits{ 15 };
+		int m_compression_level{ -1 };
+		int m_mem_level{ transforms::zlib::default_mem_level };
+		std::size_t m_compression_threshold{ 64u };
+		std::size_t m_max_decompressed_message_size{ 64u * 1024u * 1024u };
+};
+
+//
+// permessage_deflate_config_t
+//
+
+//! Parameters of permessage-deflate extension negotiated for a websocket.
+/*!
+	@since v.0.6.2
+*/
+struct permessage_deflate_config_t
+{
+	bool m_server_no_context_takeover{ false };
+	bool m_client_no_context_takeover{ false };
+
+	//! Is set if the parameter is included in the response.
+	optional_t< int > m_server_max_window_bits;
+
+	//! Is set if the parameter is included in the response.
+	optional_t< int > m_client_max_window_bits;
+
+	//! Get the value of Sec-WebSocket-Extensions field for the response.
+	std::string
+	response_field_value() const
+	{
+		std::string result{ "permessage-deflate" };
+
+		if( m_server_no_context_takeover )
+			result += "; server_no_context_takeover";
+		if( m_client_no_context_takeover )
+			result += "; client_no_context_takeover";
+		if( m_server_max_window_bits )
+			result += fmt::format(
+					"; server_max_window_bits={}", *m_server_max_window_bits );
+		if( m_client_max_window_bits )
+			result += fmt::format(
+					"; client_max_window_bits={}", *m_client_max_window_bits );
+
+		return result;
+	}
+};
+
+namespace impl
+{
+
+//
+// parse_window_bits()
+//
+
+//! Parse the value of server_max_window_bits/client_max_window_bits.
+/*!
+	The value must be a decimal integer in the range of 8 to 15
+	without leading zeros.
+
+	@since v.0.6.2
+*/
+inline optional_t< int >
+parse_window_bits( string_view_t value ) noexcept
+{
+	optional_t< int > result;
+
+	if( 1u == value.size() && ( '8' == value[ 0 ] || '9' == value[ 0 ] ) )
+		result = value[ 0 ] - '0';
+	else if( 2u == value.size() && '1' == value[ 0 ] &&
+		'0' <= value[ 1 ] && value[ 1 ] <= '5' )
+		result = 10 + ( value[ 1 ] - '0' );
+
+	return result;
+}
+
+//
+// try_accept_permessage_deflate_offer()
+//
+
+//! Try to accept an offer of permessage-deflate extension.
+/*!
+	\return empty value if the offer is invalid or can't be accepted.
+
+	@since v.0.6.2
+*/
+inline optional_t< permessage_deflate_config_t >
+try_accept_permessage_deflate_offer(
+	const http_field_parsers::sec_websocket_extensions_value_t::extension_t & offer,
+	const permessage_deflate_params_t & params )
+{
+	bool server_no_context_takeover = false;
+	bool client_no_context_takeover = false;
+	optional_t< int > server_max_window_bits;
+	bool client_max_window_bits_offered = false;
+	optional_t< int > client_max_window_bits;
+
+	for( const auto & p : offer.params )
+	{
+		if( "server_no_context_takeover" == p.first &&
+			!server_no_context_takeover && !p.second )
+		{
+			server_no_context_takeover = true;
+		}
+		else if( "client_no_context_takeover" == p.first &&
+			!client_no_context_takeover && !p.second )
+		{
+			client_no_context_takeover = true;
+		}
+		else if( "server_max_window_bits" == p.first &&
+			!server_max_window_bits && p.second )
+		{
+			server_max_window_bits = parse_window_bits( *p.second );
+			if( !server_max_window_bits )
+				return nullopt;
+		}
+		else if( "client_max_window_bits" == p.first &&
+			!client_max_window_bits_offered )
+		{
+			client_max_window_bits_offered = true;
+			if( p.second )
+			{
+				client_max_window_bits = parse_window_bits( *p.second );
+				if( !client_max_window_bits )
+					return nullopt;
+			}
+		}
+		else
+		{
+			// Unknown or duplicated parameter, or invalid value.
+			return nullopt;
+		}
+	}
+
+	permessage_deflate_config_t result;
+	result.m_server_no_context_takeover =
+		server_no_context_takeover || params.server_no_context_takeover();
+	result.m_client_no_context_takeover =
+		client_no_context_takeover || params.client_no_context_takeover();
+
+	const int server_window_bits = std::min(
+			params.server_max_window_bits(),
+			server_max_window_bits.value_or( 15 ) );
+	// zlib can't produce raw deflate data with window of 8 bits.
+	if( server_window_bits < 9 )
+		return nullopt;
+	if( server_max_window_bits || server_window_bits < 15 )
+		result.m_server_max_window_bits = server_window_bits;
+
+	// Window of a client can be limited only if the client allows that.
+	if( client_max_window_bits_offered )
+	{
+		const int client_window_bits = std::min(
+				params.client_max_window_bits(),
+				client_max_window_bits.value_or( 15 ) );
+		if( client_max_window_bits || client_window_bits < 15 )
+			result.m_client_max_window_bits = client_window_bits;
+	}
+
+	return result;
+}
+
+} /* namespace impl */
+
+//
+// negotiate_permessage_deflate()
+//
+
+//! Negotiate permessage-deflate extension.
+/*!
+	Offers are checked in the order of preference of a client,
+	the first acceptable one is used.
+
+	\return empty value if there is no acceptable offer.
+
+	@since v.0.6.2
+*/
+inline optional_t< permessage_deflate_config_t >
+negotiate_permessage_deflate(
+	//! The value of Sec-WebSocket-Extensions field of upgrade request.
+	string_view_t sec_websocket_extensions,
+	//! Parameters acceptable for the server.
+	const permessage_deflate_params_t & params )
+{
+	using http_field_parsers::sec_websocket_extensions_value_t;
+
+	const auto parsed =
+		sec_websocket_extensions_value_t::try_parse( sec_websocket_extensions );
+
+	if( parsed )
+	{
+		for( const auto & offer : parsed->extensions )
+		{
+			if( "permessage-deflate" == offer.name )
+			{
+				auto result =
+					impl::try_accept_permessage_deflate_offer( offer, params );
+				if( result )
+					return result;
+			}
+		}
+	}
+
+	return nullopt;
+}
+
+//! Negotiate permessage-deflate extension for upgrade request.
+/*!
+	All Sec-WebSocket-Extensions fields of the request are handled.
+
+	@since v.0.6.2
+*/
+inline optional_t< permessage_deflate_config_t >
+negotiate_permessage_deflate(
+	const http_request_header_t & upgrade_request_header,
+	const permessage_deflate_params_t & params )
+{
+	std::string extensions;
+	upgrade_request_header.for_each_field( [&extensions]( const auto & f ) {
+			if( http_field::sec_websocket_extensions == f.field_id() )
+			{
+				if( !extensions.empty() )
+					extensions += ", ";
+				extensions += f.value();
+			}
+		} );
+
+	if( extensions.empty() )
+		return nullopt;
+
+	return negotiate_permessage_deflate( extensions, params );
+}
+
+namespace impl
+{
+
+//
+// deflate_compressor_t
+//
+
+//! Compressor of outgoing messages for permessage-deflate.
+/*!
+	Each frame is compressed and flushed separately, so
+	fragmented messages are compressed on the fly.
+
+	@since v.0.6.2
+*/
+class deflate_compressor_t final : public message_compressor_t
+{
+	public:
+		deflate_compressor_t(
+			transforms::zlib::params_t zlib_params,
+			bool no_context_takeover,
+			std::size_t compression_threshold )
+			:	m_zlib_params{ std::move( zlib_params ) }
+			,	m_no_context_takeover{ no_context_takeover }
+			,	m_compression_threshold{ compression_threshold }
+		{}
+
+		optional_t< compressed_frame_t >
+		compress_frame(
+			opcode_t opcode,
+			bool final_frame,
+			string_view_t payload ) override
+		{
+			const bool first_frame = opcode_t::continuation_frame != opcode;
+
+			// The size of a fragmented message is unknown,
+			// so such messages are always compressed.
+			if( first_frame )
+				m_compress_current_message =
+					!final_frame || m_compression_threshold <= payload.size();
+
+			if( !m_compress_current_message )
+				return nullopt;
+
+			if( !m_zlib )
+				m_zlib = std::make_unique< transforms::zlib::zlib_t >( m_zlib_params );
+
+			m_zlib->write( payload );
+			m_zlib->flush();
+
+			compressed_frame_t result{ first_frame, m_zlib->giveaway_output() };
+
+			if( final_frame )
+			{
+				// Remove the tail of an empty block added by Z_SYNC_FLUSH
+				// (RFC 7692, section 7.2.1).
+				auto & data = result.m_payload;
+				if( 4u <= data.size() &&
+					0 == data.compare( data.size() - 4u, 4u, "\x00\x00\xff\xff", 4u ) )
+					data.resize( data.size() - 4u );
+
+				if( data.empty() )
+					data.push_back( '\x00' );
+
+				if( m_no_context_takeover )
+					m_zlib.reset();
+			}
+
+			return result;
+		}
+
+	private:
+		const transforms::zlib::params_t m_zlib_params;
+		const bool m_no_context_takeover;
+		const std::size_t m_compression_threshold;
+
+		//! Compression stream. Kept between messages with context takeover.
+		std::unique_ptr< transforms::zlib::zlib_t > m_zlib;
+
+		//! Is the message that is being sent compressed.
+		bool m_compress_current_message{ false };
+};
+
+//
+// deflate_decompressor_t
+//
+
+//! Decompressor of incoming messages for permessage-deflate.
+/*!
+	@since v.0.6.2
+*/
+class deflate_decompressor_t final : public message_decompressor_t
+{
+	public:
+		deflate_decompressor_t(
+			transforms::zlib::params_t zlib_params,
+			bool no_context_takeover,
+			std::size_t max_message_size )
+			:	m_zlib_params{ std::move( zlib_params ) }
+			,	m_no_context_takeover{ no_context_takeover }
+			,	m_max_message_size{ max_message_size }
+		{}
+
+		void
+		decompress_frame( bool final_frame, std::string & payload ) override
+		{
+			if( !m_zlib )
+				m_zlib = std::make_unique< transforms::zlib::zlib_t >( m_zlib_params );
+
+			std::string result;
+
+			// Payload is decompressed by blocks to check
+			// the size of the output before it grows too much.
+			constexpr std::size_t block_size = 16u * 1024u;
+			string_view_t rest{ payload };
+			while( !rest.empty() )
+			{
+				const auto n = std::min( block_size, rest.size() );
+				m_zlib->write( rest.substr( 0u, n ) );
+				rest.remove_prefix( n );
+
+				append_output( result );
+			}
+
+			if( final_frame )
+			{
+				// Restore the tail removed by a sender.
+				m_zlib->write( string_view_t{ "\x00\x00\xff\xff", 4u } );
+			}
+			m_zlib->flush();
+			append_output( result );
+
+			if( final_frame )
+			{
+				m_message_size = 0u;
+
+				if( m_no_context_takeover )
+					m_zlib.reset();
+			}
+
+			payload = std::move( result );
+		}
+
+	private:
+		void
+		append_output( std::string & to )
+		{
+			m_message_size += m_zlib->output_size();
+			if( m_max_message_size < m_message_size )
+			{
+				throw exception_t{
+					fmt::format(
+						"decompressed message is too big, max size: {}",
+						m_max_message_size ) };
+			}
+
+			if( to.empty() )
+				to = m_zlib->giveaway_output();
+			else
+				to += m_zlib->giveaway_output();
+		}
+
+		const transforms::zlib::params_t m_zlib_params;
+		const bool m_no_context_takeover;
+		const std::size_t m_max_message_size;
+
+		//! Decompression stream. Kept between messages with context takeover.
+		std::unique_ptr< transforms::zlib::zlib_t > m_zlib;
+
+		//! The size of the current decompressed message.
+		std::size_t m_message_size{ 0u };
+};
+
+//
+// make_permessage_deflate_compression()
+//
+
+//! Create compressor and decompressor for negotiated permessage-deflate.
+/*!
+	@since v.0.6.2
+*/
+inline ws_compression_t
+make_permessage_deflate_compression(
+	const permessage_deflate_config_t & config,
+	const permessage_deflate_params_t & params )
+{
+	// Most of messages are small, so the output buffer is enlarged by
+	// small blocks.
+	constexpr std::size_t reserve_buffer_size = 4u * 1024u;
+
+	ws_compression_t result;
+
+	result.m_compressor = std::make_unique< deflate_compressor_t >(
+			transforms::zlib::make_raw_deflate_compress_params(
+					params.compression_level() )
+				.window_bits( config.m_server_max_window_bits.value_or( 15 ) )
+				.mem_level( params.mem_level() )
+				.reserve_buffer_size( reserve_buffer_size ),
+			config.m_server_no_context_takeover,
+			params.compression_threshold() );
+
+	result.m_decompressor = std::make_unique< deflate_decompressor_t >(
+			transforms::zlib::make_raw_deflate_decompress_params()
+				.window_bits( config.m_client_max_window_bits.value_or( 15 ) )
+				.reserve_buffer_size( reserve_buffer_size ),
+			config.m_client_no_context_takeover,
+			params.max_decompressed_message_size() );
+
+	return result;
+}
+
+} /* namespace impl */
+
+//
+// upgrade()
+//
+
+//! Upgrade http-connection of a current request to a websocket connection
+//! with negotiation of permessage-deflate extension.
+/*!
+	If the request offers acceptable permessage-deflate parameters
+	then Sec-WebSocket-Extensions field is added to the response and
+	messages are compressed.
+
+	@since v.0.6.2
+*/
+template <
+		typename Traits,
+		typename WS_Message_Handler >
+ws_handle_t
+upgrade(
+	//! Upgrade request.
+	request_t & req,
+	//! Activation policy.
+	activation_t activation_flag,
+	//! Response header fields.
+	http_header_fields_t upgrade_response_header_fields,
+	//! Parameters of permessage-deflate acceptable for the server.
+	const permessage_deflate_params_t & deflate_params,
+	//! Message handler.
+	WS_Message_Handler ws_message_handler )
+{
+	impl::ws_compression_t compression;
+
+	const auto config = negotiate_permessage_deflate( req.header(), deflate_params );
+	if( config )
+	{
+		upgrade_response_header_fields.set_field(
+			http_field::sec_websocket_extensions,
+			config->response_field_value() );
+
+		compression =
+			impl::make_permessage_deflate_compression( *config, deflate_params );
+	}
+
+	return impl::do_upgrade< Traits, WS_Message_Handler >(
+			req,
+			activation_flag,
+			std::move( upgrade_response_header_fields ),
+			std::move( ws_message_handler ),
+			std::move( compression ) );
+}
+
+//! Upgrade http-connection of a current request to a websocket connection
+//! with negotiation of permessage-deflate extension.
+/*!
+	@since v.0.6.2
+*/
+template <
+		typename Traits,
+		typename WS_Message_Handler >
+ws_handle_t
+upgrade(
+	request_t & req,
+	activation_t activation_flag,
+	const permessage_deflate_params_t & deflate_params,
+	WS_Message_Handler ws_message_handler )
+{
+	http_header_fields_t upgrade_response_header_fields;
+	upgrade_response_header_fields.set_field(
+		http_field::sec_websocket_accept,
+		impl::make_sec_websocket_accept_field_value( req ) );
+
+	return
+		upgrade< Traits, WS_Message_Handler >(
+			req,
+			activation_flag,
+			std::move( upgrade_response_header_fields ),
+			deflate_params,
+			std::move( ws_message_handler ) );
+}
+
+} /* namespace basic */
+
+} /* namespace websocket */
+
+} /* namespace restinio */
@@ -13,6 +13,7 @@
 #include <restinio/websocket/message.hpp>
 #include <restinio/websocket/impl/ws_connection_base.hpp>
 #include <restinio/websocket/impl/ws_connection.hpp>
+#include <restinio/websocket/impl/ws_compression.hpp>
 #include <restinio/utils/base64.hpp>
 #include <restinio/utils/sha1.hpp>
 
@@ -25,6 +26,8 @@ namespace websocket
 namespace basic
 {
 
+class broadcast_hub_t;
+
 //
 // ws_t
 //
@@ -38,6 +41,8 @@ namespace basic
 class ws_t
 	:	public std::enable_shared_from_this< ws_t >
 {
+		friend class broadcast_hub_t;
+
 	public:
 		//
 		// activate()
@@ -56,9 +61,16 @@ class ws_t
 
 		ws_t(
 			impl::ws_connection_handle_t ws_connection_handle,
-			endpoint_t remote_endpoint )
+			endpoint_t remote_endpoint,
+			//! Is compression of messages negotiated.
+			//! \since v.0.6.2
+			bool compression_used = false )
 			:	m_ws_connection_handle{ std::move( ws_connection_handle ) }
 			,	m_remote_endpoint{ std::move( remote_endpoint ) }
+			,	m_compression_used{ compression_used }
+			,	m_connection_id{
+					m_ws_connection_handle ?
+						m_ws_connection_handle->connection_id() : 0 }
 		{}
 
 		~ws_t()
@@ -119,41 +131,24 @@ class ws_t
 				if( restinio::writable_item_type_t::trivial_write_operation ==
 					payload.write_type() )
 				{
-					writable_items_container_t bufs;
-					bufs.reserve( 2 );
-
-					// Create header serialize it and append to bufs .
-					impl::message_details_t details{
-						final_flag, opcode, asio_ns::buffer_size( payload.buf() ) };
-
-					bufs.emplace_back(
-						impl::write_message_details( details ) );
-
-					bufs.emplace_back( std::move( payload ) );
-
-					write_group_t wg{ std::move( bufs ) };
-
-					if( wscb )
-					{
-						wg.after_write_notificator( std::move( wscb ) );
-					}
-
-					// TODO: set flag.
-					const bool is_close_frame =
-						opcode_t::connection_close_frame == opcode;
-
-					if( is_close_frame )
+					// The header is made and the payload is compressed
+					// on the context of the connection.
+					if( opcode_t::connection_close_frame == opcode )
 					{
 						auto con = std::move( m_ws_connection_handle );
-						con->write_data(
-							std::move( wg ),
-							is_close_frame );
+						con->write_frame(
+							final_flag,
+							opcode,
+							std::move( payload ),
+							std::move( wscb ) );
 					}
 					else
 					{
-						m_ws_connection_handle->write_data(
-							std::move( wg ),
-							is_close_frame );
+						m_ws_connection_handle->write_frame(
+							final_flag,
+							opcode,
+							std::move( payload ),
+							std::move( wscb ) );
 					}
 				}
 				else
@@ -180,11 +175,86 @@ class ws_t
 		//! Get the remote endpoint of the underlying connection.
 		const endpoint_t & remote_endpoint() const noexcept { return m_remote_endpoint; }
 
+		//! Is compression of messages negotiated for this websocket.
+		//! \since v.0.6.2
+		bool is_compression_used() const noexcept { return m_compression_used; }
+
+		//! Set limits for the amount of queued outgoing data.
+		/*!
+			\code
+			ws->set_outgoing_queue_limits(
+				restinio::websocket::basic::outgoing_queue_limits_t{}
+					.watermarks( 64u * 1024u, 1024u * 1024u )
+					.writable_again_handler(
+						[]( restinio::websocket::basic::ws_handle_t wsh ) {
+							// Resume sending messages to wsh.
+						} ) );
+			\endcode
+
+			\note The writable_again_handler is called only
+			after the websocket is activated.
+
+			\since v.0.6.2
+		*/
+		void
+		set_outgoing_queue_limits( outgoing_queue_limits_t limits )
+		{
+			if( m_ws_connection_handle )
+				m_ws_connection_handle->set_outgoing_queue_limits( std::move( limits ) );
+			else
+				throw exception_t{ "websocket is not available" };
+		}
+
+		//! Get the state of the queue of outgoing data.
+		/*!
+			The state is updated on the context of the websocket,
+			so it doesn't include messages passed to send_message()
+			from other threads that are not processed yet.
+
+			\since v.0.6.2
+		*/
+		outgoing_queue_stats_t
+		outgoing_queue_stats() const noexcept
+		{
+			return m_ws_connection_handle ?
+				m_ws_connection_handle->outgoing_queue_stats() :
+				outgoing_queue_stats_t{ 0u, 0u };
+		}
+
+		//! Is the amount of queued outgoing data below the high watermark.
+		/*!
+			A producer should stop sending messages if websocket
+			isn't writable and wait for writable_again_handler.
+
+			\return false if websocket is closed.
+
+			\since v.0.6.2
+		*/
+		bool
+		is_writable() const noexcept
+		{
+			return m_ws_connection_handle &&
+				m_ws_connection_handle->is_writable();
+		}
+
 	private:
 		impl::ws_connection_handle_t m_ws_connection_handle;
 
 		//! Remote endpoint for this ws-connection.
 		const endpoint_t m_remote_endpoint;
+
+		//! Is compression of messages negotiated.
+		//! \since v.0.6.2
+		const bool m_compression_used;
+
+		//! Id of the connection the websocket was created for.
+		/*!
+			Unlike connection_id() it remains the same after
+			the connection is closed and can be read from any thread.
+
+			\since v.0.6.2
+		*/
+		const connection_id_t m_connection_id;
 };
 
 //! Alias for ws_t handle.
@@ -203,16 +273,22 @@ enum class activation_t
 	delayed
 };
 
+namespace impl
+{
+
 //
-// upgrade()
+// do_upgrade()
 //
 
 //! Upgrade http-connection of a current request to a websocket connection.
+/*!
+	@since v.0.6.2
+*/
 template <
 		typename Traits,
 		typename WS_Message_Handler >
 ws_handle_t
-upgrade(
+do_upgrade(
 	//! Upgrade request.
 	request_t & req,
 	//! Activation policy.
@@ -220,7 +296,9 @@ upgrade(
 	//! Response header fields.
 	http_header_fields_t upgrade_response_header_fields,
 	//! Message handler.
-	WS_Message_Handler ws_message_handler )
+	WS_Message_Handler ws_message_handler,
+	//! Negotiated compression.
+	ws_compression_t compression )
 {
 	// TODO: check if upgrade request?
 
@@ -245,7 +323,9 @@ upgrade(
 	}
 	auto & con = dynamic_cast< connection_t & >( *conn_ptr );
 
-	using ws_connection_t = impl::ws_connection_t< Traits, WS_Message_Handler >;
+	using ws_connection_t = ws_connection_t< Traits, WS_Message_Handler >;
+
+	const bool compression_used = !!compression.m_compressor;
 
 	auto upgrade_internals = con.move_upgrade_internals();
 	auto ws_connection =
@@ -253,7 +333,8 @@ upgrade(
 			con.connection_id(),
 			std::move( upgrade_internals.m_settings ),
 			std::move( upgrade_internals.m_socket ),
-			std::move( ws_message_handler ) );
+			std::move( ws_message_handler ),
+			std::move( compression ) );
 
 	writable_items_container_t upgrade_response_bufs;
 	{
@@ -275,7 +356,10 @@ upgrade(
 		false );
 
 	auto result =
-		std::make_shared< ws_t >( std::move( ws_connection ), req.remote_endpoint() );
+		std::make_shared< ws_t >(
+			std::move( ws_connection ),
+			req.remote_endpoint(),
+			compression_used );
 
 	if( activation_t::immediate == activation_flag )
 	{
@@ -286,6 +370,56 @@ upgrade(
 	return result;
 }
 
+//
+// make_sec_websocket_accept_field_value()
+//
+
+//! Make the value of Sec-WebSocket-Accept field for upgrade request.
+/*!
+	@since v.0.6.2
+*/
+inline std::string
+make_sec_websocket_accept_field_value( const request_t & req )
+{
+	const char * websocket_accept_field_suffix = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+	const auto ws_key =
+		req.header().get_field( restinio::http_field::sec_websocket_key ) +
+		websocket_accept_field_suffix;
+
+	auto digest = restinio::utils::sha1::make_digest( ws_key );
+
+	return utils::base64::encode( utils::sha1::to_string( digest ) );
+}
+
+} /* namespace impl */
+
+//
+// upgrade()
+//
+
+//! Upgrade http-connection of a current request to a websocket connection.
+template <
+		typename Traits,
+		typename WS_Message_Handler >
+ws_handle_t
+upgrade(
+	//! Upgrade request.
+	request_t & req,
+	//! Activation policy.
+	activation_t activation_flag,
+	//! Response header fields.
+	http_header_fields_t upgrade_response_header_fields,
+	//! Message handler.
+	WS_Message_Handler ws_message_handler )
+{
+	return impl::do_upgrade< Traits, WS_Message_Handler >(
+			req,
+			activation_flag,
+			std::move( upgrade_response_header_fields ),
+			std::move( ws_message_handler ),
+			impl::ws_compression_t{} );
+}
+
 template <
 		typename Traits,
 		typename WS_Message_Handler >
@@ -346,20 +480,10 @@ upgrade(
 	activation_t activation_flag,
 	WS_Message_Handler ws_message_handler )
 {
-	const char * websocket_accept_field_suffix = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
-	const auto ws_key =
-		req.header().get_field( restinio::http_field::sec_websocket_key ) +
-		websocket_accept_field_suffix;
-
-	auto digest = restinio::utils::sha1::make_digest( ws_key );
-
-	std::string sec_websocket_accept_field_value = utils::base64::encode(
-		utils::sha1::to_string( digest ) );
-
 	http_header_fields_t upgrade_response_header_fields;
 	upgrade_response_header_fields.set_field(
 		http_field::sec_websocket_accept,
-		std::move( sec_websocket_accept_field_value ) );
+		impl::make_sec_websocket_accept_field_value( req ) );
 
 	return
 		upgrade< Traits, WS_Message_Handler >(
@@ -21,6 +21,8 @@ class connection_listener_t
 			return "closed";
 		else if( restinio::holds_alternative< upgraded_to_websocket_t >( cause ) )
 			return "upgraded_to_websocket";
+		else if( restinio::holds_alternative< limit_exceeded_t >( cause ) )
+			return "limit_exceeded";
 		else
 			return "unknown";
 	}
@@ -209,6 +209,12 @@ public:
 		{
 			m_user_connections.remove( m_notice.connection_id() );
 		}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & ) const noexcept
+		{
+			// Connection will be closed, closed_t will be received later.
+		}
 	};
 };
 
@@ -0,0 +1,208 @@
+/*
+	restinio
+*/
+
+/*!
+	Async logger.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/async_logger.hpp>
+
+#include <test/common/pub.hpp>
+
+#include <sstream>
+
+std::size_t
+count_lines( const std::string & what, const std::string & pattern )
+{
+	std::size_t result = 0u;
+	for( auto pos = what.find( pattern );
+		std::string::npos != pos;
+		pos = what.find( pattern, pos + 1u ) )
+		++result;
+
+	return result;
+}
+
+//! Stream buffer that blocks the writer until it is opened.
+class gate_streambuf_t : public std::stringbuf
+{
+	public:
+		void
+		open()
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			m_opened = true;
+			m_cv.notify_all();
+		}
+
+	protected:
+		std::streamsize
+		xsputn( const char * s, std::streamsize n ) override
+		{
+			std::unique_lock< std::mutex > lock{ m_lock };
+			m_cv.wait( lock, [this]{ return m_opened; } );
+			lock.unlock();
+
+			return std::stringbuf::xsputn( s, n );
+		}
+
+	private:
+		std::mutex m_lock;
+		std::condition_variable m_cv;
+		bool m_opened{ false };
+};
+
+TEST_CASE( "Levels" , "[async_logger][levels]" )
+{
+	std::ostringstream out;
+	int built = 0;
+
+	{
+		restinio::async_logger_t< restinio::log_level_t::info > logger{
+			out, restinio::log_level_t::info };
+
+		// Below the compile-time level.
+		logger.trace( [&]{ ++built; return std::string{ "trace message" }; } );
+
+		logger.info( [&]{ ++built; return std::string{ "info message" }; } );
+
+		logger.set_level( restinio::log_level_t::error );
+		REQUIRE( restinio::log_level_t::error == logger.level() );
+
+		// Below the runtime level.
+		logger.warn( [&]{ ++built; return std::string{ "warn message" }; } );
+
+		logger.error( [&]{ ++built; return std::string{ "error message" }; } );
+	}
+
+	REQUIRE( 2 == built );
+
+	const auto log = out.str();
+	REQUIRE( std::string::npos == log.find( "trace message" ) );
+	REQUIRE( std::string::npos == log.find( "warn message" ) );
+
+	const auto info_pos = log.find( " INFO: info message\n" );
+	const auto error_pos = log.find( "ERROR: error message\n" );
+	REQUIRE( std::string::npos != info_pos );
+	REQUIRE( std::string::npos != error_pos );
+	REQUIRE( info_pos < error_pos );
+}
+
+TEST_CASE( "Many producers" , "[async_logger][mpsc]" )
+{
+	constexpr int threads_count = 4;
+	constexpr int messages_per_thread = 10000;
+
+	std::ostringstream out;
+
+	{
+		restinio::async_logger_t<> logger{
+			out,
+			restinio::log_level_t::trace,
+			64u,
+			restinio::log_overflow_policy_t::block };
+
+		std::vector< std::thread > threads;
+		for( int t = 0; t < threads_count; ++t )
+		{
+			threads.emplace_back( [&logger, t]{
+				for( int i = 0; i < messages_per_thread; ++i )
+					logger.info( [&]{ return fmt::format( "msg-{}-{}", t, i ); } );
+			} );
+		}
+
+		for( auto & t : threads )
+			t.join();
+
+		REQUIRE( 0u == logger.dropped_count() );
+	}
+
+	const auto log = out.str();
+	REQUIRE( static_cast< std::size_t >( threads_count * messages_per_thread ) ==
+		count_lines( log, " INFO: msg-" ) );
+
+	// Order of messages from one thread is kept.
+	for( int t = 0; t < threads_count; ++t )
+	{
+		REQUIRE( log.find( fmt::format( "msg-{}-{}\n", t, 0 ) ) <
+			log.find( fmt::format( "msg-{}-{}\n", t, messages_per_thread - 1 ) ) );
+	}
+}
+
+TEST_CASE( "Drop on overflow" , "[async_logger][overflow]" )
+{
+	gate_streambuf_t buf;
+	std::ostream out{ &buf };
+
+	{
+		restinio::async_logger_t<> logger{
+			out,
+			restinio::log_level_t::trace,
+			4u,
+			restinio::log_overflow_policy_t::drop };
+
+		// The writer is blocked by the gate, so the queue becomes full.
+		for( int i = 0; i < 100; ++i )
+			logger.warn( [i]{ return fmt::format( "msg-{}", i ); } );
+
+		REQUIRE( 0u < logger.dropped_count() );
+
+		buf.open();
+	}
+
+	const auto log = buf.str();
+	REQUIRE( std::string::npos != log.find( "log messages dropped" ) );
+	REQUIRE( 100u > count_lines( log, " WARN: msg-" ) );
+}
+
+TEST_CASE( "Logger for server" , "[async_logger][server]" )
+{
+	using logger_t = restinio::async_logger_t< restinio::log_level_t::info >;
+
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				logger_t > >;
+
+	std::ostringstream out;
+
+	{
+		http_server_t http_server{
+			restinio::own_io_context(),
+			[&]( auto & settings ){
+				settings
+					.port( utest_default_port() )
+					.address( "127.0.0.1" )
+					.logger( out )
+					.request_handler(
+						[]( auto req ){
+							return req->create_response()
+								.set_body( "Hello" )
+								.done();
+						} );
+			}
+		};
+
+		other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+		other_thread.run();
+
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request(
+				"GET / HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Connection: close\r\n"
+				"\r\n" ) );
+		REQUIRE_THAT( response, Catch::Matchers::EndsWith( "Hello" ) );
+
+		other_thread.stop_and_join();
+	}
+
+	const auto log = out.str();
+	REQUIRE( std::string::npos != log.find( " INFO: init accept #0" ) );
+	REQUIRE( std::string::npos == log.find( "TRACE:" ) );
+}
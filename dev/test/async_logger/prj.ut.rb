@@ -0,0 +1,7 @@
+require 'mxx_ru/binary_unittest'
+
+Mxx_ru::setup_target(
+	Mxx_ru::Binary_unittest_target.new(
+		"test/async_logger/prj.ut.rb",
+		"test/async_logger/prj.rb" )
+)
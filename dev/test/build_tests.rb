@@ -16,6 +16,8 @@ MxxRu::Cpp::composite_target {
 	required_prj( "test/default_constructed_settings/prj.ut.rb" )
 	required_prj( "test/ref_qualifiers_settings/prj.ut.rb" )
 	required_prj( "test/buffers/prj.ut.rb" )
+	required_prj( "test/timing_wheel_timer_manager/prj.ut.rb" )
+	required_prj( "test/request_arena/prj.ut.rb" )
 	required_prj( "test/response_coordinator/prj.ut.rb" )
 	required_prj( "test/write_group_output_ctx/prj.ut.rb" )
 	required_prj( "test/from_string/prj.ut.rb" )
@@ -29,10 +31,14 @@ MxxRu::Cpp::composite_target {
 		if not $sanitizer_build or $sanitizer_build != 'thread_sanitizer'
 			required_prj( "test/socket_options_tls/prj.ut.rb" )
 		end
+
+		required_prj( "test/tls_session_resumption/prj.ut.rb" )
 	end
 
 	required_prj( "test/start_stop/prj.ut.rb" )
 
+	required_prj( "test/async_logger/prj.ut.rb" )
+
 	required_prj( "test/handle_requests/build_tests.rb" )
 
 	required_prj( "test/run_on_thread_pool/prj.rb" )
@@ -41,6 +47,7 @@ MxxRu::Cpp::composite_target {
 	required_prj( "test/http_pipelining/timeouts/prj.ut.rb" )
 
 	required_prj( "test/sendfile/prj.ut.rb" )
+	required_prj( "test/hot_file_cache/prj.ut.rb" )
 
 	# ================================================================
 	# Express router
@@ -68,6 +75,13 @@ MxxRu::Cpp::composite_target {
 
 	required_prj( "test/router/cmp_router_bench/prj.rb" )
 
+	# Radix router
+	required_prj( "test/router/radix_router/prj.ut.rb" )
+	required_prj( "test/router/radix_router_bench/prj.rb" )
+
+	# Compile time router
+	required_prj( "test/router/ct_router/prj.ut.rb" )
+
 	# ================================================================
 	# Transformators
 	required_prj( "test/transforms/zlib/prj.ut.rb" )
@@ -89,9 +103,17 @@ MxxRu::Cpp::composite_target {
 	required_prj( "test/websocket/validators/prj.ut.rb" )
 	required_prj( "test/websocket/ws_connection/prj.ut.rb" )
 	required_prj( "test/websocket/notificators/prj.ut.rb" )
+	required_prj( "test/websocket/permessage_deflate/prj.ut.rb" )
+	required_prj( "test/websocket/broadcast_hub/prj.ut.rb" )
+	required_prj( "test/websocket/outgoing_queue/prj.ut.rb" )
+	required_prj( "test/websocket/payload_bench/prj.rb" )
 
 	# ================================================================
 	# File upload support.
 	required_prj( "test/file_upload/prj.ut.rb" )
+
+	# ================================================================
+	# Static files serving.
+	required_prj( "test/static_files/prj.ut.rb" )
 }
 
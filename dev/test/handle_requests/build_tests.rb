@@ -7,16 +7,19 @@ MxxRu::Cpp::composite_target {
 		chunked_output
 		echo_body
 		method
+		msg_limits
 		notificators
 		output_and_buffers
 		remote_endpoint
 		connection_state
 		ip_blocker
+		incoming_body_consumer
 		slow_transmit
 		throw_exception
 		timeouts
 		upgrade
 		user_controlled_output
+		zero_copy_header
 	].each do |name|
 		required_prj "test/handle_requests/#{name}/prj.ut.rb"
 	end
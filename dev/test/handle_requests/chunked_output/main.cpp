@@ -7,6 +7,7 @@
 */
 
 #include <cstdlib>
+#include <limits>
 #include <thread>
 
 #include <catch2/catch.hpp>
@@ -286,3 +287,33 @@ TEST_CASE( "Using user chunked output response builder" , "[chunked_output]" )
 	other_thread.stop_and_join();
 }
 
+
+TEST_CASE( "Chunk size line" , "[chunked_output][chunk_size_line]" )
+{
+	const auto line = []( std::size_t size, bool end_previous_chunk ) {
+		const restinio::impl::chunk_size_line_t l{ size, end_previous_chunk };
+		return std::string{ l.data(), l.size() };
+	};
+
+	REQUIRE( "0\r\n" == line( 0u, false ) );
+	REQUIRE( "F\r\n" == line( 15u, false ) );
+	REQUIRE( "\r\n10\r\n" == line( 16u, true ) );
+	REQUIRE( "\r\nABCDEF\r\n" == line( 0xABCDEFu, true ) );
+	REQUIRE( "\r\nFFFFFFFF\r\n" == line( 0xFFFFFFFFu, true ) );
+
+	const auto max_size = std::numeric_limits< std::size_t >::max();
+	REQUIRE( "\r\n" + std::string( 2u * sizeof( std::size_t ), 'F' ) + "\r\n" ==
+		line( max_size, true ) );
+
+	// Line is stored inside writable_item_t and survives moves.
+	restinio::writable_item_t item{
+		restinio::impl::chunk_size_line_t{ 0x1234u, true } };
+	restinio::writable_items_container_t items;
+	items.emplace_back( std::move( item ) );
+	items.emplace_back( restinio::impl::chunk_size_line_t{ 1u, false } );
+
+	const auto buf = items.front().buf();
+	REQUIRE( "\r\n1234\r\n" == std::string{
+			static_cast< const char * >( buf.data() ), buf.size() } );
+	REQUIRE( 3u == items.back().size() );
+}
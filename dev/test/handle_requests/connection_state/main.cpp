@@ -15,6 +15,7 @@ struct state_listener_t
 	std::atomic< int > m_accepted{ 0 };
 	std::atomic< int > m_closed{ 0 };
 	std::atomic< int > m_upgraded_to_websocket{ 0 };
+	std::atomic< int > m_limit_exceeded{ 0 };
 
 	struct cause_visitor_t {
 		state_listener_t & m_self;
@@ -36,6 +37,12 @@ struct state_listener_t
 		{
 			++m_self.m_upgraded_to_websocket;
 		}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & ) const noexcept
+		{
+			++m_self.m_limit_exceeded;
+		}
 	};
 
 	void state_changed(
@@ -72,6 +79,10 @@ struct state_listener_that_throws_on_accept_t
 		{
 			++m_self.m_upgraded_to_websocket;
 		}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & ) const noexcept
+		{}
 	};
 
 	void state_changed(
@@ -108,6 +119,10 @@ struct state_listener_that_throws_on_close_t
 		{
 			++m_self.m_upgraded_to_websocket;
 		}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & ) const noexcept
+		{}
 	};
 
 	void state_changed(
@@ -144,6 +159,10 @@ struct state_listener_that_throws_on_ws_upgrade_t
 			++m_self.m_upgraded_to_websocket;
 			throw std::runtime_error( "Something wrong on upgrade!" );
 		}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & ) const noexcept
+		{}
 	};
 
 	void state_changed(
@@ -260,6 +279,7 @@ TEST_CASE( "ordinary connection" , "[ordinary_connection]" )
 	REQUIRE( 1 == state_listener->m_accepted.load() );
 	REQUIRE( 1 == state_listener->m_closed.load() );
 	REQUIRE( 0 == state_listener->m_upgraded_to_websocket.load() );
+	REQUIRE( 0 == state_listener->m_limit_exceeded.load() );
 }
 
 TEST_CASE( "connection state for WS" , "[connection_state][ws]" )
@@ -0,0 +1,257 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for incremental handling of request body.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+// Consumer that collects body chunks and can suspend reading
+// after every chunk.
+class collecting_consumer_t final
+	:	public restinio::incoming_body_consumer_t
+{
+	public:
+		explicit collecting_consumer_t(
+			bool suspend_reading,
+			std::chrono::milliseconds pause = std::chrono::milliseconds( 1 ) )
+			:	m_suspend_reading{ suspend_reading }
+			,	m_pause{ pause }
+		{}
+
+		~collecting_consumer_t() override
+		{
+			if( m_resumer.joinable() )
+				m_resumer.join();
+		}
+
+		restinio::incoming_body_flow_t
+		consume_chunk( restinio::string_view_t chunk ) override
+		{
+			m_body.append( chunk.data(), chunk.size() );
+			++m_chunks;
+
+			if( !m_suspend_reading )
+				return restinio::incoming_body_proceed();
+
+			// Resume reading from another thread.
+			if( m_resumer.joinable() )
+				m_resumer.join();
+			m_resumer = std::thread{ [this]{
+					std::this_thread::sleep_for( m_pause );
+					resume_reading();
+				} };
+
+			return restinio::incoming_body_suspend();
+		}
+
+		const std::string & body() const noexcept { return m_body; }
+		std::size_t chunks() const noexcept { return m_chunks; }
+
+	private:
+		const bool m_suspend_reading;
+		const std::chrono::milliseconds m_pause;
+		std::string m_body;
+		std::size_t m_chunks{ 0 };
+		std::thread m_resumer;
+};
+
+template< typename Settings >
+void
+make_settings( Settings & settings )
+{
+	settings
+		.port( utest_default_port() )
+		.address( "127.0.0.1" )
+		.buffer_size( 1024u )
+		.incoming_body_consumer_factory(
+			[]( const restinio::http_request_header_t & header )
+				-> restinio::incoming_body_consumer_handle_t
+			{
+				if( restinio::http_method_post() == header.method() )
+				{
+					if( "/upload" == header.path() )
+						return std::make_shared< collecting_consumer_t >( false );
+					else if( "/slow-upload" == header.path() )
+						return std::make_shared< collecting_consumer_t >( true );
+					else if( "/very-slow-upload" == header.path() )
+						return std::make_shared< collecting_consumer_t >(
+								true, std::chrono::milliseconds( 200 ) );
+				}
+
+				return {};
+			} )
+		.request_handler(
+			[]( auto req ){
+				std::string body = req->body();
+				std::string mode = "buffered";
+				if( req->incoming_body_consumer() )
+				{
+					const auto & consumer =
+						dynamic_cast< const collecting_consumer_t & >(
+							*(req->incoming_body_consumer()) );
+
+					body = consumer.body();
+					mode = req->body().empty() && 0u < consumer.chunks() ?
+							"consumer" : "consumer-with-errors";
+				}
+
+				req->create_response()
+					.append_header( "Server", "RESTinio utest server" )
+					.append_header( "X-Body-Mode", mode )
+					.set_body( body )
+					.done();
+
+				return restinio::request_accepted();
+			} );
+}
+
+std::string
+make_body( std::size_t size )
+{
+	std::string result;
+	result.reserve( size );
+	for( std::size_t i = 0; i != size; ++i )
+		result += static_cast< char >( 'A' + ( i % 26 ) );
+
+	return result;
+}
+
+std::string
+make_request( const std::string & target, const std::string & body )
+{
+	return
+		"POST " + target + " HTTP/1.0\r\n"
+		"From: unit-test\r\n"
+		"User-Agent: unit-test\r\n"
+		"Content-Type: application/octet-stream\r\n"
+		"Content-Length: " + std::to_string( body.size() ) + "\r\n"
+		"Connection: close\r\n"
+		"\r\n" +
+		body;
+}
+
+std::string
+make_chunked_request( const std::string & target, const std::string & body )
+{
+	std::string result =
+		"POST " + target + " HTTP/1.1\r\n"
+		"From: unit-test\r\n"
+		"User-Agent: unit-test\r\n"
+		"Content-Type: application/octet-stream\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"Connection: close\r\n"
+		"\r\n";
+
+	const std::size_t chunk_size = 700u;
+	for( std::size_t pos = 0; pos < body.size(); pos += chunk_size )
+	{
+		const auto part = body.substr( pos, chunk_size );
+		result += fmt::format( "{:X}\r\n", part.size() );
+		result += part;
+		result += "\r\n";
+	}
+	result += "0\r\n\r\n";
+
+	return result;
+}
+
+TEST_CASE( "Body consumer for some routes" , "[incoming_body][route]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ){ make_settings( settings ); } };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	const auto body = make_body( 10000u );
+	std::string response;
+
+	REQUIRE_NOTHROW( response = do_request( make_request( "/upload", body ) ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "X-Body-Mode: consumer\r\n" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( body ) );
+
+	REQUIRE_NOTHROW( response = do_request( make_request( "/other", body ) ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "X-Body-Mode: buffered\r\n" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( body ) );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Body consumer suspends reading" , "[incoming_body][suspend]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ){ make_settings( settings ); } };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	const auto body = make_body( 20000u );
+	std::string response;
+
+	REQUIRE_NOTHROW(
+			response = do_request( make_request( "/slow-upload", body ) ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "X-Body-Mode: consumer\r\n" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( body ) );
+
+	REQUIRE_NOTHROW(
+			response = do_request( make_chunked_request( "/slow-upload", body ) ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "X-Body-Mode: consumer\r\n" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( body ) );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Suspended reading isn't limited by read timeout" ,
+	"[incoming_body][suspend][timeout]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ){
+			make_settings( settings );
+			settings
+				.read_next_http_message_timelimit( std::chrono::milliseconds( 50 ) )
+				.timer_manager( std::chrono::milliseconds( 5 ) );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	// Every chunk is handled longer than the read timeout.
+	const auto body = make_body( 3000u );
+	std::string response;
+
+	REQUIRE_NOTHROW(
+			response = do_request( make_request( "/very-slow-upload", body ) ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "X-Body-Mode: consumer\r\n" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( body ) );
+
+	other_thread.stop_and_join();
+}
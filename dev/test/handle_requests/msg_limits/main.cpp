@@ -0,0 +1,296 @@
+/*
+	restinio
+*/
+
+/*!
+	Limits for incoming http messages.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+struct state_listener_t
+{
+	std::mutex m_lock;
+	std::vector< restinio::incoming_http_msg_limit_t > m_exceeded_limits;
+
+	struct cause_visitor_t {
+		state_listener_t & m_self;
+
+		void operator()(
+			const restinio::connection_state::accepted_t & ) const noexcept
+		{}
+
+		void operator()(
+			const restinio::connection_state::closed_t & ) const noexcept
+		{}
+
+		void operator()(
+			const restinio::connection_state::upgraded_to_websocket_t & ) const noexcept
+		{}
+
+		void operator()(
+			const restinio::connection_state::limit_exceeded_t & cause ) const
+		{
+			std::lock_guard< std::mutex > lock{ m_self.m_lock };
+			m_self.m_exceeded_limits.push_back( cause.limit() );
+		}
+	};
+
+	void state_changed(
+		const restinio::connection_state::notice_t & notice )
+	{
+		restinio::visit( cause_visitor_t{ *this }, notice.cause() );
+	}
+
+	std::vector< restinio::incoming_http_msg_limit_t >
+	exceeded_limits()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_exceeded_limits;
+	}
+};
+
+struct test_traits_t : public restinio::traits_t<
+		restinio::asio_timer_manager_t,
+		utest_logger_t >
+{
+	using connection_state_listener_t = state_listener_t;
+};
+
+using http_server_t = restinio::http_server_t< test_traits_t >;
+
+using limit_t = restinio::incoming_http_msg_limit_t;
+
+class test_server_t
+{
+	public:
+		test_server_t( bool zero_copy_header_parsing = false )
+			:	m_state_listener{ std::make_shared< state_listener_t >() }
+			,	m_server{
+					restinio::own_io_context(),
+					[this, zero_copy_header_parsing]( auto & settings ) {
+						settings
+							.port( utest_default_port() )
+							.address( "127.0.0.1" )
+							.max_pipelined_requests( 2 )
+							.zero_copy_header_parsing( zero_copy_header_parsing )
+							.connection_state_listener( m_state_listener )
+							.incoming_http_msg_limits(
+								restinio::incoming_http_msg_limits_t{}
+									.max_url_size( 32 )
+									.max_header_size( 256 )
+									.max_field_count( 4 )
+									.max_body_size( 16 ) )
+							.request_handler(
+								[this]( auto req ){
+									++m_handled_requests;
+
+									req->create_response()
+										.append_header( "Server", "RESTinio utest server" )
+										.set_body( req->body() )
+										.done();
+
+									return restinio::request_accepted();
+								} );
+					} }
+			,	m_other_thread{ m_server }
+		{
+			m_other_thread.run();
+		}
+
+		~test_server_t()
+		{
+			m_other_thread.stop_and_join();
+		}
+
+		std::vector< limit_t >
+		exceeded_limits() const
+		{
+			return m_state_listener->exceeded_limits();
+		}
+
+		int
+		handled_requests() const noexcept
+		{
+			return m_handled_requests.load();
+		}
+
+	private:
+		std::shared_ptr< state_listener_t > m_state_listener;
+		std::atomic< int > m_handled_requests{ 0 };
+		http_server_t m_server;
+		other_work_thread_for_server_t< http_server_t > m_other_thread;
+};
+
+TEST_CASE( "Message within limits" , "[limits][ok]" )
+{
+	test_server_t server{ GENERATE( false, true ) };
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"POST /0123456789/0123456789/012345678 HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Content-Type: text/plain\r\n"
+			"Content-Length: 16\r\n"
+			"Connection: close\r\n"
+			"\r\n"
+			"0123456789abcdef" ) );
+
+	REQUIRE_THAT( response, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( "0123456789abcdef" ) );
+
+	REQUIRE( server.exceeded_limits().empty() );
+	REQUIRE( 1 == server.handled_requests() );
+}
+
+TEST_CASE( "Too long URL" , "[limits][url]" )
+{
+	test_server_t server;
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"GET /0123456789/0123456789/0123456789 HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response,
+			Catch::Matchers::StartsWith( "HTTP/1.1 414 URI Too Long" ) );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "Connection: close" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::url_size } ==
+			server.exceeded_limits() );
+	REQUIRE( 0 == server.handled_requests() );
+}
+
+TEST_CASE( "Too big header" , "[limits][header_size]" )
+{
+	test_server_t server{ GENERATE( false, true ) };
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"GET / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"X-Long-Field: " + std::string( 256u, 'x' ) + "\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response,
+			Catch::Matchers::StartsWith(
+				"HTTP/1.1 431 Request Header Fields Too Large" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::header_size } ==
+			server.exceeded_limits() );
+	REQUIRE( 0 == server.handled_requests() );
+}
+
+TEST_CASE( "Too many fields" , "[limits][field_count]" )
+{
+	test_server_t server{ GENERATE( false, true ) };
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"GET / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"X-Field-1: 1\r\n"
+			"X-Field-2: 2\r\n"
+			"X-Field-3: 3\r\n"
+			"X-Field-4: 4\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response,
+			Catch::Matchers::StartsWith(
+				"HTTP/1.1 431 Request Header Fields Too Large" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::field_count } ==
+			server.exceeded_limits() );
+	REQUIRE( 0 == server.handled_requests() );
+}
+
+TEST_CASE( "Too big Content-Length" , "[limits][body_size]" )
+{
+	test_server_t server;
+
+	// Body itself isn't sent, the limit is checked before it.
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"POST / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Content-Length: 1000000000000\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response,
+			Catch::Matchers::StartsWith( "HTTP/1.1 413 Payload Too Large" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::body_size } ==
+			server.exceeded_limits() );
+	REQUIRE( 0 == server.handled_requests() );
+}
+
+TEST_CASE( "Too big chunked body" , "[limits][body_size][chunked]" )
+{
+	test_server_t server;
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"POST / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Transfer-Encoding: chunked\r\n"
+			"\r\n"
+			"a\r\n"
+			"0123456789\r\n"
+			"a\r\n"
+			"0123456789\r\n"
+			"0\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response,
+			Catch::Matchers::StartsWith( "HTTP/1.1 413 Payload Too Large" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::body_size } ==
+			server.exceeded_limits() );
+	REQUIRE( 0 == server.handled_requests() );
+}
+
+TEST_CASE( "Limit exceeded by pipelined request" , "[limits][pipelining]" )
+{
+	test_server_t server;
+
+	// The response to the first request goes before the error.
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"POST / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Content-Length: 5\r\n"
+			"\r\n"
+			"first"
+			"POST / HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Content-Length: 17\r\n"
+			"\r\n"
+			"0123456789abcdefg" ) );
+
+	const auto first = response.find( "HTTP/1.1 200 OK" );
+	const auto second = response.find( "HTTP/1.1 413 Payload Too Large" );
+	REQUIRE( std::string::npos != first );
+	REQUIRE( std::string::npos != second );
+	REQUIRE( first < second );
+	REQUIRE_THAT( response, Catch::Matchers::Contains( "first" ) );
+
+	REQUIRE( std::vector< limit_t >{ limit_t::body_size } ==
+			server.exceeded_limits() );
+	REQUIRE( 1 == server.handled_requests() );
+}
+
+TEST_CASE( "Limits are turned off by default" , "[limits][default]" )
+{
+	const restinio::incoming_http_msg_limits_t limits;
+
+	REQUIRE( std::numeric_limits< std::size_t >::max() == limits.max_url_size() );
+	REQUIRE( std::numeric_limits< std::size_t >::max() == limits.max_header_size() );
+	REQUIRE( std::numeric_limits< std::size_t >::max() == limits.max_field_count() );
+	REQUIRE( std::numeric_limits< std::uint64_t >::max() == limits.max_body_size() );
+}
@@ -0,0 +1,359 @@
+/*
+	restinio
+*/
+
+/*!
+	Zero-copy header parsing.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/helpers/multipart_body.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+using http_server_t =
+	restinio::http_server_t<
+		restinio::traits_t<
+			restinio::asio_timer_manager_t,
+			utest_logger_t > >;
+
+// Makes a description of request that is sent back in the response body.
+std::string
+describe_request( const restinio::request_t & req )
+{
+	const auto & view = req.header_view();
+
+	std::string result = fmt::format(
+			"[{}][{}][fields:{}/{}]",
+			view.request_target(),
+			req.header().path(),
+			view.fields_count(),
+			req.header().fields_count() );
+
+	view.for_each_field( [&]( const auto & f ) {
+		result += fmt::format( "[{}={}]", f.name(), f.value() );
+	} );
+
+	result += fmt::format( "[host:{}][agent:{}][dup:{}][missing:{}]",
+			view.value_of( restinio::http_field::host ),
+			view.value_of( "USER-AGENT" ),
+			view.opt_value_of( "X-Dup" ).value_or( "none" ),
+			view.has_field( "X-Missing" ) );
+
+	return result;
+}
+
+auto
+make_server_settings( std::size_t arena_size )
+{
+	return [arena_size]( auto & settings ) {
+		settings
+			.port( utest_default_port() )
+			.address( "127.0.0.1" )
+			.zero_copy_header_parsing( true )
+			.request_arena_size( arena_size )
+			.request_handler(
+				[]( auto req ){
+					req->create_response()
+						.append_header( "Server", "RESTinio utest server" )
+						.append_header( "Content-Type", "text/plain; charset=utf-8" )
+						.set_body( describe_request( *req ) )
+						.done();
+
+					return restinio::request_accepted();
+				} );
+	};
+}
+
+const std::string request{
+	"GET /api/v1/users/42?details=full HTTP/1.1\r\n"
+	"Host: 127.0.0.1\r\n"
+	"User-Agent: unit-test\r\n"
+	"X-Dup: first\r\n"
+	"Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+	"X-Dup: second\r\n"
+	"Connection: close\r\n"
+	"\r\n" };
+
+const std::string expected_description{
+	"[/api/v1/users/42?details=full][/api/v1/users/42][fields:6/0]"
+	"[Host=127.0.0.1][User-Agent=unit-test][X-Dup=first]"
+	"[Accept=text/html,application/xhtml+xml,application/xml;q=0.9]"
+	"[X-Dup=second][Connection=close]"
+	"[host:127.0.0.1][agent:unit-test][dup:second][missing:false]" };
+
+TEST_CASE( "Fields as views" , "[zero_copy][views]" )
+{
+	const std::size_t arena_size = GENERATE( 0u, 4096u );
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		make_server_settings( arena_size ) };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request( request ) );
+
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( expected_description ) );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Header received by parts" , "[zero_copy][slow]" )
+{
+	http_server_t http_server{
+		restinio::own_io_context(),
+		make_server_settings( 0u ) };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		// Names and values are split between reads.
+		for( std::size_t i = 0; i < request.size(); i += 5 )
+		{
+			REQUIRE_NOTHROW(
+				restinio::asio_ns::write( socket,
+					restinio::asio_ns::buffer(
+						request.data() + i,
+						std::min< std::size_t >( 5u, request.size() - i ) ) ) );
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+		}
+
+		std::string response;
+		restinio::asio_ns::error_code ec;
+		std::array< char, 1024 > data;
+		while( !ec )
+		{
+			const auto n = socket.read_some(
+					restinio::asio_ns::buffer( data ), ec );
+			response.append( data.data(), n );
+		}
+
+		REQUIRE_THAT( response, Catch::Matchers::EndsWith( expected_description ) );
+	} );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Fields of upgrade request" , "[zero_copy][upgrade]" )
+{
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ) {
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.zero_copy_header_parsing( true )
+				.request_handler(
+					[]( auto req ){
+						// Ordinary fields are available for upgrade requests.
+						req->create_response()
+							.append_header( "Server", "RESTinio utest server" )
+							.connection_close()
+							.set_body( fmt::format( "[{}][{}][{}]",
+									req->header().get_field( restinio::http_field::upgrade ),
+									req->header().fields_count(),
+									req->header_view().fields_count() ) )
+							.done();
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"GET /chat HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Upgrade: websocket\r\n"
+			"Connection: Upgrade\r\n"
+			"\r\n" ) );
+
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( "[websocket][3][3]" ) );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Empty view without zero-copy parsing" , "[zero_copy][disabled]" )
+{
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ) {
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[]( auto req ){
+						req->create_response()
+							.append_header( "Server", "RESTinio utest server" )
+							.set_body( fmt::format( "[{}][{}][{}]",
+									req->header_view().empty(),
+									req->header_view().fields_count(),
+									req->header().get_field( "User-Agent" ) ) )
+							.done();
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request( request ) );
+
+	REQUIRE_THAT( response, Catch::Matchers::EndsWith( "[true][0][unit-test]" ) );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Fields required by helpers" , "[zero_copy][helpers]" )
+{
+	std::mutex lock;
+	std::string content_type_seen_by_factory;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ) {
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.zero_copy_header_parsing( true )
+				.incoming_body_consumer_factory(
+					[&]( const restinio::http_request_header_t & header )
+						-> restinio::incoming_body_consumer_handle_t
+					{
+						std::lock_guard< std::mutex > l{ lock };
+						content_type_seen_by_factory = header.get_field_or(
+								restinio::http_field::content_type, "none" );
+
+						return {};
+					} )
+				.request_handler(
+					[]( auto req ){
+						std::string parts;
+						const auto result = restinio::multipart_body::enumerate_parts(
+								*req,
+								[&]( restinio::multipart_body::parsed_part_t part ) {
+									parts += fmt::format( "[{}]", part.body );
+									return restinio::multipart_body::handling_result_t::
+											continue_enumeration;
+								} );
+
+						req->create_response()
+							.append_header( "Server", "RESTinio utest server" )
+							.set_body( fmt::format( "[{}]{}[{}/{}]",
+									result ? *result : 0u,
+									parts,
+									req->header().fields_count(),
+									req->header_view().fields_count() ) )
+							.done();
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	const std::string body =
+		"--boundary\r\n"
+		"Content-Disposition: form-data; name=\"a\"\r\n"
+		"\r\n"
+		"first\r\n"
+		"--boundary\r\n"
+		"Content-Disposition: form-data; name=\"b\"\r\n"
+		"\r\n"
+		"second\r\n"
+		"--boundary--\r\n";
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			"POST /upload HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"User-Agent: unit-test\r\n"
+			"Content-Type: multipart/form-data; boundary=boundary\r\n"
+			"Content-Length: " + std::to_string( body.size() ) + "\r\n"
+			"Connection: close\r\n"
+			"\r\n" + body ) );
+
+	// Only Content-Type is copied to the ordinary header.
+	REQUIRE_THAT( response,
+			Catch::Matchers::EndsWith( "[2][first][second][1/5]" ) );
+
+	REQUIRE( "multipart/form-data; boundary=boundary" ==
+			content_type_seen_by_factory );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Views refer to the collected block" , "[zero_copy][builder]" )
+{
+	using restinio::impl::request_arena_handle_t;
+	using restinio::impl::arena_allocator_t;
+
+	request_arena_handle_t arena{ 4096u };
+	restinio::impl::header_view_builder_t builder;
+
+	const auto parse = [&]( const std::string & suffix ) {
+		builder.reset( arena_allocator_t< char >{ arena } );
+
+		builder.append_request_target( "/path", 5u );
+		builder.append_request_target( "?q=1", 4u );
+		builder.append_field_name( "Ho", 2u );
+		builder.append_field_name( "st", 2u );
+		builder.append_field_value( "localhost", 9u );
+		builder.append_field_name( "X-Data", 6u );
+		builder.append_field_value( suffix.data(), suffix.size() );
+
+		restinio::http_header_fields_t fields;
+		builder.on_headers_complete( fields, false );
+
+		return builder.make_view();
+	};
+
+	const auto check = [&]( const restinio::http_request_header_view_t & view,
+		const std::string & suffix )
+	{
+		REQUIRE( "/path?q=1" == view.request_target() );
+		REQUIRE( 2u == view.fields_count() );
+		REQUIRE( "localhost" == view.value_of( restinio::http_field::host ) );
+		REQUIRE( suffix == view.value_of( "x-data" ) );
+
+		// Data isn't copied: names and values follow the request target
+		// in the same block, and views are placed right after them.
+		const char * data = view.request_target().data();
+		REQUIRE( data + 9 == view.begin()->name().data() );
+		REQUIRE( data + 13 == view.begin()->value().data() );
+		REQUIRE( data + 22 == std::next( view.begin() )->name().data() );
+		REQUIRE( data + 28 == std::next( view.begin() )->value().data() );
+
+		const char * data_end = data + 28 + suffix.size();
+		const char * views = reinterpret_cast< const char * >( view.begin() );
+		REQUIRE( data_end <= views );
+		REQUIRE( views < data_end + alignof( restinio::http_header_field_view_t ) );
+	};
+
+	auto first = parse( "first" );
+	check( first, "first" );
+	REQUIRE( 1u == arena->alive_blocks() );
+
+	// The first view is alive, so the next request gets its own block.
+	auto second = parse( "the second value" );
+	check( second, "the second value" );
+	check( first, "first" );
+	REQUIRE( 2u == arena->alive_blocks() );
+
+	// Move keeps views valid.
+	restinio::http_request_header_view_t moved{ std::move( second ) };
+	check( moved, "the second value" );
+	REQUIRE( second.empty() );
+}
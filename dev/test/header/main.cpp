@@ -439,6 +439,165 @@ TEST_CASE( "Enumeration of fields" , "[header][fields][for_each]" )
 		} );
 }
 
+TEST_CASE( "Index of fields" , "[header][fields][index]" )
+{
+	// Names of fields in the order of addition.
+	const auto names_of = []( const http_header_fields_t & fields ) {
+		std::vector< std::string > result;
+		for( const auto & f : fields )
+			result.push_back( f.name() );
+		return result;
+	};
+
+	SECTION( "order of fields is preserved" )
+	{
+		http_header_fields_t fields;
+
+		fields.set_field( "X-First", "1" );
+		fields.set_field( http_field::host, "localhost" );
+		fields.set_field( "x-second", "2" );
+		fields.set_field( "Accept", "*/*" );
+		fields.set_field( "X-FIRST", "3" );
+
+		REQUIRE( names_of( fields ) == std::vector< std::string >{
+				"X-FIRST", "Host", "x-second", "Accept" } );
+
+		REQUIRE( fields.value_of( "x-first" ) == "3" );
+		REQUIRE( fields.value_of( "X-Second" ) == "2" );
+		REQUIRE( fields.value_of( "HOST" ) == "localhost" );
+		REQUIRE( fields.value_of( http_field::accept ) == "*/*" );
+		REQUIRE( fields.has_field( http_field::field_unspecified ) );
+		REQUIRE_FALSE( fields.has_field( "X-Third" ) );
+		REQUIRE_FALSE( fields.has_field( http_field::user_agent ) );
+	}
+
+	SECTION( "removal of fields" )
+	{
+		http_header_fields_t fields;
+
+		fields.set_field( "X-First", "1" );
+		fields.set_field( http_field::host, "localhost" );
+		fields.set_field( "X-Second", "2" );
+		fields.set_field( http_field::user_agent, "unit-test" );
+
+		fields.remove_field( "x-first" );
+		REQUIRE_FALSE( fields.has_field( "X-First" ) );
+		REQUIRE( fields.value_of( http_field::host ) == "localhost" );
+		REQUIRE( fields.value_of( "X-Second" ) == "2" );
+		REQUIRE( fields.value_of( http_field::user_agent ) == "unit-test" );
+
+		fields.remove_field( http_field::host );
+		REQUIRE_FALSE( fields.has_field( http_field::host ) );
+		REQUIRE( fields.value_of( "X-Second" ) == "2" );
+		REQUIRE( fields.value_of( "User-Agent" ) == "unit-test" );
+
+		fields.set_field( "X-First", "11" );
+		REQUIRE( names_of( fields ) == std::vector< std::string >{
+				"X-Second", "User-Agent", "X-First" } );
+		REQUIRE( fields.value_of( "X-First" ) == "11" );
+	}
+
+	SECTION( "many fields" )
+	{
+		http_header_fields_t fields;
+
+		// More fields than the index can hold.
+		for( int i = 0; i != 300; ++i )
+			fields.set_field(
+					"X-Field-" + std::to_string( i ),
+					std::to_string( i ) );
+		fields.set_field( http_field::host, "localhost" );
+
+		REQUIRE( 301 == fields.fields_count() );
+		for( int i = 0; i != 300; ++i )
+			REQUIRE( fields.value_of( "x-field-" + std::to_string( i ) ) ==
+					std::to_string( i ) );
+		REQUIRE( fields.value_of( http_field::host ) == "localhost" );
+
+		for( int i = 0; i != 290; ++i )
+			fields.remove_field( "X-Field-" + std::to_string( i ) );
+
+		REQUIRE( 11 == fields.fields_count() );
+		REQUIRE_FALSE( fields.has_field( "X-Field-0" ) );
+		REQUIRE( fields.value_of( "X-Field-295" ) == "295" );
+		REQUIRE( fields.value_of( http_field::host ) == "localhost" );
+	}
+
+	SECTION( "copy, move and swap" )
+	{
+		http_header_fields_t fields;
+		fields.set_field( "X-First", "1" );
+		fields.set_field( http_field::host, "localhost" );
+
+		http_header_fields_t copy{ fields };
+		copy.set_field( "X-Second", "2" );
+		REQUIRE( copy.value_of( "X-First" ) == "1" );
+		REQUIRE( copy.value_of( "X-Second" ) == "2" );
+		REQUIRE_FALSE( fields.has_field( "X-Second" ) );
+
+		http_header_fields_t moved{ std::move( fields ) };
+		REQUIRE( moved.value_of( http_field::host ) == "localhost" );
+		REQUIRE_FALSE( fields.has_field( http_field::host ) );
+		REQUIRE_FALSE( fields.has_field( "X-First" ) );
+
+		fields = std::move( copy );
+		REQUIRE( fields.value_of( "X-Second" ) == "2" );
+		REQUIRE_FALSE( copy.has_field( "X-Second" ) );
+
+		fields.swap_fields( moved );
+		REQUIRE( fields.value_of( http_field::host ) == "localhost" );
+		REQUIRE_FALSE( fields.has_field( "X-Second" ) );
+		REQUIRE( moved.value_of( "X-Second" ) == "2" );
+	}
+
+	SECTION( "copy, move and removal of fields with index" )
+	{
+		// Enough fields for the index to be created.
+		const int count = RESTINIO_HEADER_FIELDS_INDEX_THRESHOLD + 8;
+
+		http_header_fields_t fields;
+		for( int i = 0; i != count; ++i )
+			fields.set_field(
+					"X-Field-" + std::to_string( i ),
+					std::to_string( i ) );
+		fields.set_field( http_field::host, "localhost" );
+
+		http_header_fields_t copy{ fields };
+		copy.set_field( "X-Copy", "copy" );
+		REQUIRE( copy.value_of( "x-field-3" ) == "3" );
+		REQUIRE( copy.value_of( http_field::host ) == "localhost" );
+		REQUIRE( copy.value_of( "X-Copy" ) == "copy" );
+		REQUIRE_FALSE( fields.has_field( "X-Copy" ) );
+
+		http_header_fields_t moved{ std::move( fields ) };
+		REQUIRE( moved.value_of( http_field::host ) == "localhost" );
+		REQUIRE( 0u == fields.fields_count() );
+		REQUIRE_FALSE( fields.has_field( http_field::host ) );
+		REQUIRE_FALSE( fields.has_field( "X-Field-1" ) );
+
+		// The moved-from object can be used again.
+		fields.set_field( "X-Field-1", "one" );
+		REQUIRE( fields.value_of( "X-Field-1" ) == "one" );
+
+		fields = copy;
+		REQUIRE( fields.value_of( "X-Copy" ) == "copy" );
+		REQUIRE( fields.value_of( "X-Field-1" ) == "1" );
+
+		copy = std::move( moved );
+		REQUIRE( 0u == moved.fields_count() );
+		REQUIRE_FALSE( moved.has_field( http_field::host ) );
+		REQUIRE_FALSE( copy.has_field( "X-Copy" ) );
+		REQUIRE( copy.value_of( http_field::host ) == "localhost" );
+
+		// Removal of fields makes the header small again.
+		for( int i = 0; i != count; ++i )
+			copy.remove_field( "X-Field-" + std::to_string( i ) );
+		REQUIRE( 1u == copy.fields_count() );
+		REQUIRE( copy.value_of( "Host" ) == "localhost" );
+		REQUIRE_FALSE( copy.has_field( "X-Field-0" ) );
+	}
+}
+
 TEST_CASE( "Working with common header" , "[header][common]" )
 {
 	SECTION( "http version" )
@@ -773,6 +932,120 @@ TEST_CASE( "Connection" , "[header][connection]" )
 }
 
 
+TEST_CASE( "Header serialization" , "[header][serialization]" )
+{
+	{
+		http_response_header_t h{ status_ok() };
+		h.should_keep_alive( true );
+		h.content_length( 1234567890123ULL );
+		h.set_field( "Server", "RESTinio" );
+		h.set_field( http_field::content_type, "text/plain" );
+
+		REQUIRE( impl::create_header_string( h ) ==
+			"HTTP/1.1 200 OK\r\n"
+			"Connection: keep-alive\r\n"
+			"Content-Length: 1234567890123\r\n"
+			"Server: RESTinio\r\n"
+			"Content-Type: text/plain\r\n"
+			"\r\n" );
+	}
+
+	{
+		// Non-standard reason phrase.
+		http_response_header_t h{ http_status_line_t{ status_code::not_found, "Nope" } };
+
+		REQUIRE( impl::create_header_string( h ) ==
+			"HTTP/1.1 404 Nope\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 0\r\n"
+			"\r\n" );
+	}
+
+	{
+		http_response_header_t h{ status_gateway_time_out() };
+		h.http_minor( 0 );
+		h.content_length( 10 );
+
+		REQUIRE( impl::create_header_string( h,
+				impl::content_length_field_presence_t::skip_content_length ) ==
+			"HTTP/1.0 504 Gateway Timeout\r\n"
+			"Connection: close\r\n"
+			"\r\n" );
+	}
+
+	{
+		http_response_header_t h{ http_status_line_t{ http_status_code_t{ 299 }, "Custom" } };
+		h.content_length( 99 );
+
+		REQUIRE( impl::create_header_string( h ) ==
+			"HTTP/1.1 299 Custom\r\n"
+			"Connection: close\r\n"
+			"Content-Length: 99\r\n"
+			"\r\n" );
+	}
+
+	for( const std::uint64_t v : { 0ULL, 9ULL, 10ULL, 99ULL, 100ULL, 101ULL,
+		18446744073709551615ULL } )
+	{
+		char buf[ 32 ];
+		const auto digits = impl::decimal_digits_count( v );
+		REQUIRE( std::to_string( v ) == std::string(
+			buf, impl::write_decimal( buf, v, digits ) ) );
+	}
+}
+
+TEST_CASE( "Pre-rendered status lines" , "[header][serialization]" )
+{
+	std::size_t count = 0u;
+
+#define RESTINIO_GEN( code, reason ) \
+	{ \
+		http_response_header_t h{ \
+			http_status_line_t{ http_status_code_t{ code }, reason } }; \
+		const std::string expected{ \
+			"HTTP/1.1 " + std::to_string( code ) + " " + reason + "\r\n" }; \
+		REQUIRE( expected == restinio::cast_to< std::string >( \
+				impl::prerendered_status_line( h ) ) ); \
+		REQUIRE_THAT( impl::create_header_string( h ), \
+				Catch::StartsWith( expected + "Connection: close\r\n" ) ); \
+		++count; \
+	}
+
+	RESTINIO_HTTP_STATUS_LINES_MAP( RESTINIO_GEN )
+#undef RESTINIO_GEN
+
+	REQUIRE( 0u != count );
+
+	{
+		http_response_header_t h{ status_ok() };
+		h.http_minor( 0 );
+		REQUIRE( impl::prerendered_status_line( h ).empty() );
+	}
+
+	{
+		http_response_header_t h{ http_status_line_t{ status_code::ok, "Fine" } };
+		REQUIRE( impl::prerendered_status_line( h ).empty() );
+	}
+}
+
+TEST_CASE( "Date field" , "[header][date]" )
+{
+	for( const std::time_t t : { std::time_t{ 0 }, std::time_t{ 784111777 },
+		std::time_t{ 1700000000 }, std::time( nullptr ) } )
+	{
+		const auto tm = make_gmtime( t );
+		char buf[ 64 ];
+		std::strftime( buf, sizeof( buf ), "%a, %d %b %Y %H:%M:%S GMT", &tm );
+
+		REQUIRE( std::string{ buf } == make_date_field_value( t ) );
+		// Taken from the cache.
+		REQUIRE( std::string{ buf } == make_date_field_value( t ) );
+	}
+
+	REQUIRE( "Sun, 06 Nov 1994 08:49:37 GMT" ==
+		make_date_field_value( std::time_t{ 784111777 } ) );
+}
+
 TEST_CASE( "Query" , "[header][query string][query path]" )
 {
 	auto append = []( http_request_header_t & h, const std::string & part ){
@@ -0,0 +1,203 @@
+/*
+	restinio
+*/
+
+/*!
+	Hot file cache.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/hot_file_cache.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+#include <fstream>
+
+void
+write_file( const std::string & path, const std::string & content )
+{
+	std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+	out << content;
+}
+
+std::string
+to_string( const restinio::hot_file_cache_t::file_handle_t & file )
+{
+	return std::string{ file->data(), file->size() };
+}
+
+TEST_CASE( "Hits and misses" , "[hot_file_cache][get]" )
+{
+	write_file( "_hot_file_cache.1.txt", "first file" );
+
+	restinio::hot_file_cache_t cache;
+
+	auto f1 = cache.get( "_hot_file_cache.1.txt" );
+	REQUIRE( f1 );
+	REQUIRE( "first file" == to_string( f1 ) );
+	REQUIRE( 10u == f1->meta().file_total_size() );
+
+	auto f2 = cache.get( "_hot_file_cache.1.txt" );
+	REQUIRE( f1 == f2 );
+
+	REQUIRE_FALSE( cache.get( "_hot_file_cache.missing.txt" ) );
+
+	const auto stats = cache.stats();
+	REQUIRE( 1u == stats.m_hits );
+	REQUIRE( 2u == stats.m_misses );
+	REQUIRE( 1u == stats.m_files_count );
+	REQUIRE( 10u == stats.m_total_size );
+
+	cache.clear();
+	REQUIRE( 0u == cache.stats().m_files_count );
+	REQUIRE( 0u == cache.stats().m_total_size );
+
+	// Content is kept by handles after the removal from the cache.
+	REQUIRE( "first file" == to_string( f1 ) );
+}
+
+TEST_CASE( "Size limits" , "[hot_file_cache][limits]" )
+{
+	write_file( "_hot_file_cache.a.txt", std::string( 40u, 'a' ) );
+	write_file( "_hot_file_cache.b.txt", std::string( 40u, 'b' ) );
+	write_file( "_hot_file_cache.c.txt", std::string( 40u, 'c' ) );
+	write_file( "_hot_file_cache.big.txt", std::string( 101u, 'x' ) );
+
+	restinio::hot_file_cache_t cache{
+		restinio::hot_file_cache_params_t{}
+			.max_file_size( 100u )
+			.max_total_size( 100u ) };
+
+	REQUIRE_FALSE( cache.get( "_hot_file_cache.big.txt" ) );
+
+	REQUIRE( cache.get( "_hot_file_cache.a.txt" ) );
+	REQUIRE( cache.get( "_hot_file_cache.b.txt" ) );
+	// 'a' becomes the most recently used.
+	REQUIRE( cache.get( "_hot_file_cache.a.txt" ) );
+	// 'b' is evicted.
+	REQUIRE( cache.get( "_hot_file_cache.c.txt" ) );
+
+	auto stats = cache.stats();
+	REQUIRE( 1u == stats.m_evictions );
+	REQUIRE( 2u == stats.m_files_count );
+	REQUIRE( 80u == stats.m_total_size );
+
+	const auto hits = stats.m_hits;
+	REQUIRE( cache.get( "_hot_file_cache.a.txt" ) );
+	REQUIRE( hits + 1u == cache.stats().m_hits );
+
+	REQUIRE( cache.get( "_hot_file_cache.b.txt" ) );
+	REQUIRE( 2u == cache.stats().m_evictions );
+}
+
+TEST_CASE( "Invalidation" , "[hot_file_cache][invalidation]" )
+{
+	write_file( "_hot_file_cache.2.txt", "old content" );
+
+	restinio::hot_file_cache_t cache{
+		restinio::hot_file_cache_params_t{}
+			.revalidate_interval( std::chrono::seconds::zero() ) };
+
+	auto old_file = cache.get( "_hot_file_cache.2.txt" );
+	REQUIRE( "old content" == to_string( old_file ) );
+
+	// Not modified file is taken from the cache.
+	REQUIRE( old_file == cache.get( "_hot_file_cache.2.txt" ) );
+
+	write_file( "_hot_file_cache.2.txt", "new longer content" );
+
+	auto new_file = cache.get( "_hot_file_cache.2.txt" );
+	REQUIRE( "new longer content" == to_string( new_file ) );
+	REQUIRE( "old content" == to_string( old_file ) );
+	REQUIRE( 1u == cache.stats().m_invalidations );
+	REQUIRE( 1u == cache.stats().m_files_count );
+
+	std::remove( "_hot_file_cache.2.txt" );
+	REQUIRE_FALSE( cache.get( "_hot_file_cache.2.txt" ) );
+	REQUIRE( 0u == cache.stats().m_files_count );
+}
+
+TEST_CASE( "Too big files" , "[hot_file_cache][limits][invalidation]" )
+{
+	write_file( "_hot_file_cache.4.txt", std::string( 101u, 'x' ) );
+
+	const auto make_params = []( std::chrono::steady_clock::duration interval ) {
+		return restinio::hot_file_cache_params_t{}
+			.max_file_size( 100u )
+			.revalidate_interval( interval );
+	};
+
+	restinio::hot_file_cache_t long_interval_cache{
+		make_params( std::chrono::hours( 1 ) ) };
+	restinio::hot_file_cache_t zero_interval_cache{
+		make_params( std::chrono::seconds::zero() ) };
+
+	REQUIRE_FALSE( long_interval_cache.get( "_hot_file_cache.4.txt" ) );
+	REQUIRE_FALSE( zero_interval_cache.get( "_hot_file_cache.4.txt" ) );
+
+	write_file( "_hot_file_cache.4.txt", "small now" );
+
+	// The file isn't checked again until the revalidation.
+	REQUIRE_FALSE( long_interval_cache.get( "_hot_file_cache.4.txt" ) );
+	REQUIRE( 2u == long_interval_cache.stats().m_misses );
+	REQUIRE( 0u == long_interval_cache.stats().m_files_count );
+	REQUIRE( 0u == long_interval_cache.stats().m_total_size );
+
+	auto file = zero_interval_cache.get( "_hot_file_cache.4.txt" );
+	REQUIRE( file );
+	REQUIRE( "small now" == to_string( file ) );
+	REQUIRE( 1u == zero_interval_cache.stats().m_invalidations );
+	REQUIRE( 1u == zero_interval_cache.stats().m_files_count );
+}
+
+TEST_CASE( "Cached file as response body" , "[hot_file_cache][response]" )
+{
+	const std::string content( 100u * 1024u, 'z' );
+	write_file( "_hot_file_cache.3.txt", content );
+
+	auto cache = std::make_shared< restinio::hot_file_cache_t >();
+
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[cache]( auto req ){
+						return req->create_response()
+							.set_body( cache->get( "_hot_file_cache.3.txt" ) )
+							.done();
+					} );
+		}
+	};
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+	other_thread.run();
+
+	for( int i = 0; i < 2; ++i )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request(
+				"GET / HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Connection: close\r\n"
+				"\r\n" ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::Contains( "Content-Length: 102400\r\n" ) );
+		REQUIRE_THAT( response, Catch::Matchers::EndsWith( content ) );
+	}
+
+	other_thread.stop_and_join();
+
+	REQUIRE( 1u == cache->stats().m_hits );
+}
@@ -14,5 +14,6 @@ MxxRu::Cpp::exe_target {
 	cpp_source( "accept.cpp" )
 	cpp_source( "accept-encoding.cpp" )
 	cpp_source( "content-disposition.cpp" )
+	cpp_source( "sec-websocket-extensions.cpp" )
 }
 
@@ -0,0 +1,67 @@
+/*
+	restinio
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/helpers/http_field_parsers/sec-websocket-extensions.hpp>
+
+TEST_CASE( "Sec-WebSocket-Extensions Field", "[sec-websocket-extensions]" )
+{
+	using namespace restinio::http_field_parsers;
+	using namespace std::string_literals;
+
+	using params_t =
+		sec_websocket_extensions_value_t::extension_t::param_container_t;
+
+	{
+		const auto result = sec_websocket_extensions_value_t::try_parse(
+				"" );
+
+		REQUIRE( !result );
+	}
+
+	{
+		const auto result = sec_websocket_extensions_value_t::try_parse(
+				"permessage-deflate;" );
+
+		REQUIRE( !result );
+	}
+
+	{
+		const auto result = sec_websocket_extensions_value_t::try_parse(
+				"Permessage-Deflate" );
+
+		REQUIRE( result );
+		REQUIRE( 1u == result->extensions.size() );
+		REQUIRE( "permessage-deflate" == result->extensions[ 0 ].name );
+		REQUIRE( result->extensions[ 0 ].params.empty() );
+	}
+
+	{
+		const auto result = sec_websocket_extensions_value_t::try_parse(
+				"permessage-deflate; Client_Max_Window_Bits; "
+				"server_max_window_bits=10, "
+				"permessage-deflate ;server_max_window_bits=\"12\", "
+				"x-webkit-deflate-frame" );
+
+		REQUIRE( result );
+		REQUIRE( 3u == result->extensions.size() );
+
+		REQUIRE( "permessage-deflate" == result->extensions[ 0 ].name );
+		const params_t expected_first{
+			{ "client_max_window_bits"s, restinio::nullopt },
+			{ "server_max_window_bits"s, "10"s }
+		};
+		REQUIRE( expected_first == result->extensions[ 0 ].params );
+
+		REQUIRE( "permessage-deflate" == result->extensions[ 1 ].name );
+		const params_t expected_second{
+			{ "server_max_window_bits"s, "12"s }
+		};
+		REQUIRE( expected_second == result->extensions[ 1 ].params );
+
+		REQUIRE( "x-webkit-deflate-frame" == result->extensions[ 2 ].name );
+		REQUIRE( result->extensions[ 2 ].params.empty() );
+	}
+}
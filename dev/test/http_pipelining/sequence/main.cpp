@@ -219,9 +219,11 @@ TEST_CASE( "Long sequesnces HTTP piplining" , "[long_sequences]" )
 				utest_logger_t,
 				req_handler_t< 128 > > >;
 
+	const bool batch = GENERATE( false, true );
+
 	http_server_t http_server{
 		restinio::own_io_context(),
-		[]( auto & settings ){
+		[batch]( auto & settings ){
 			settings
 				.port( utest_default_port() )
 				.address( "127.0.0.1" )
@@ -231,7 +233,8 @@ TEST_CASE( "Long sequesnces HTTP piplining" , "[long_sequences]" )
 					std::chrono::hours( 24 ) )
 				.handle_request_timeout( std::chrono::hours( 24 ) )
 
-				.max_pipelined_requests( 128 );
+				.max_pipelined_requests( 128 )
+				.batch_pipelined_requests( batch );
 		} };
 
 	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
@@ -343,3 +346,50 @@ TEST_CASE( "Interrupt sequesnces HTTP piplining" , "[long_sequences][interrupt]"
 	other_thread.stop_and_join();
 }
 
+
+TEST_CASE( "Batched HTTP piplining" , "[batch]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.max_pipelined_requests( 16 )
+				.batch_pipelined_requests( true )
+				.request_handler( []( auto req ){
+					send_response_if_needed( std::move( req ) );
+					return restinio::request_accepted();
+				} );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	// More requests than can be handled at once.
+	std::ostringstream sout;
+	for( auto i = 0; i < 39; ++i )
+	{
+		sout << create_request( i );
+	}
+	sout << create_request( 39, "close" );
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request( sout.str() ) );
+
+	const auto resp_seq = get_response_sequence( response );
+	REQUIRE( 40 == resp_seq.size() );
+
+	for( auto i = 0; i < 40; ++i )
+	{
+		REQUIRE( i == resp_seq[ i ] );
+	}
+
+	other_thread.stop_and_join();
+}
@@ -0,0 +1,254 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for per-connection arena for requests.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+using restinio::impl::request_arena_handle_t;
+using restinio::impl::arena_allocator_t;
+
+TEST_CASE( "Arena reuse" , "[arena][reuse]" )
+{
+	request_arena_handle_t arena{ 1024u };
+
+	void * p1 = arena->allocate( 100u );
+	void * p2 = arena->allocate( 100u );
+	REQUIRE( p1 != p2 );
+	REQUIRE( 2u == arena->alive_blocks() );
+
+	arena->deallocate( p1 );
+	REQUIRE( 1u == arena->alive_blocks() );
+
+	// Memory is not reused while there are alive blocks.
+	void * p3 = arena->allocate( 100u );
+	REQUIRE( p3 != p1 );
+	REQUIRE( p3 != p2 );
+
+	arena->deallocate( p2 );
+	arena->deallocate( p3 );
+	REQUIRE( 0u == arena->alive_blocks() );
+
+	// All blocks are returned, the buffer is used from the beginning.
+	void * p4 = arena->allocate( 10u );
+	REQUIRE( p4 == p1 );
+
+	arena->deallocate( p4 );
+}
+
+TEST_CASE( "Arena exhausted" , "[arena][heap]" )
+{
+	request_arena_handle_t arena{ 256u };
+
+	void * p1 = arena->allocate( 200u );
+	REQUIRE( 1u == arena->alive_blocks() );
+
+	// There is no place for that block in the arena.
+	void * p2 = arena->allocate( 200u );
+	REQUIRE( 1u == arena->alive_blocks() );
+
+	arena->deallocate( p2 );
+	REQUIRE( 1u == arena->alive_blocks() );
+
+	arena->deallocate( p1 );
+	REQUIRE( 0u == arena->alive_blocks() );
+}
+
+TEST_CASE( "Header fields in arena" , "[arena][header]" )
+{
+	request_arena_handle_t arena{ 4096u };
+
+	std::unique_ptr< restinio::http_request_header_t > header{
+		new restinio::http_request_header_t{
+			restinio::http_request_header_t::allocator_t{ arena } } };
+
+	// Nothing is allocated until the first field.
+	REQUIRE( 0u == arena->alive_blocks() );
+
+	header->set_field( "Host", "localhost" );
+	header->set_field( restinio::http_field::user_agent, "unit-test" );
+	header->set_field( "X-Field", "value" );
+	REQUIRE( 0u != arena->alive_blocks() );
+
+	// Copy doesn't use the arena.
+	const auto arena_blocks = arena->alive_blocks();
+	restinio::http_request_header_t copy{ *header };
+	REQUIRE( arena_blocks == arena->alive_blocks() );
+	REQUIRE( "localhost" == copy.get_field( "Host" ) );
+	REQUIRE( "unit-test" == copy.get_field( restinio::http_field::user_agent ) );
+
+	// Moved header takes the arena with it.
+	restinio::http_request_header_t moved{ std::move( *header ) };
+	header.reset();
+	REQUIRE( arena_blocks == arena->alive_blocks() );
+	REQUIRE( "value" == moved.get_field( "X-Field" ) );
+
+	// Arena outlives the handle while the header is alive.
+	arena = request_arena_handle_t{};
+	REQUIRE( 3u == moved.fields_count() );
+}
+
+TEST_CASE( "Request in arena" , "[arena][request]" )
+{
+	request_arena_handle_t arena{ 4096u };
+
+	{
+		auto req = std::allocate_shared< int >(
+				arena_allocator_t< int >{ arena }, 42 );
+		REQUIRE( 1u == arena->alive_blocks() );
+		REQUIRE( 42 == *req );
+	}
+
+	REQUIRE( 0u == arena->alive_blocks() );
+}
+
+TEST_CASE( "Server with request arena" , "[arena][server]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t > >;
+
+	std::mutex requests_lock;
+	std::vector< restinio::request_handle_t > requests;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.max_pipelined_requests( 4 )
+				// Small arena to be exhausted by pipelined requests.
+				.request_arena_size( 512u )
+				.request_handler(
+					[&]( restinio::request_handle_t req ){
+						if( "/hold" == req->header().request_target() )
+						{
+							// Request will be completed later.
+							std::lock_guard< std::mutex > lock{ requests_lock };
+							requests.push_back( std::move( req ) );
+							return restinio::request_accepted();
+						}
+
+						return req->create_response()
+							.append_header( "Server", "RESTinio utest server" )
+							.append_header( "Content-Type", "text/plain; charset=utf-8" )
+							.set_body(
+								req->header().request_target() + ":" +
+								req->header().get_field( "X-Request-Field" ) + ":" +
+								req->body() )
+							.done();
+					} );
+		} };
+
+	other_work_thread_for_server_t< http_server_t > other_thread( http_server );
+	other_thread.run();
+
+	const auto make_request = []( const std::string & target, int n ) {
+		const std::string body = "body" + std::to_string( n );
+		return
+			"POST " + target + " HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"User-Agent: unit-test\r\n"
+			"Accept: text/html,application/xhtml+xml,application/xml;q=0.9\r\n"
+			"X-Request-Field: field" + std::to_string( n ) + "\r\n"
+			"Content-Length: " + std::to_string( body.size() ) + "\r\n"
+			"\r\n" + body;
+	};
+
+	SECTION( "sequential requests" )
+	{
+		do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+			for( int i = 0; i != 10; ++i )
+			{
+				const auto request = make_request( "/" + std::to_string( i ), i );
+				restinio::asio_ns::write( socket, restinio::asio_ns::buffer( request ) );
+
+				const std::string expected_body =
+					"/" + std::to_string( i ) + ":field" + std::to_string( i ) +
+					":body" + std::to_string( i );
+
+				std::string response;
+				while( std::string::npos == response.find( expected_body ) )
+				{
+					std::array< char, 1024 > data;
+					const auto n = socket.read_some(
+							restinio::asio_ns::buffer( data ) );
+					response.append( data.data(), n );
+				}
+
+				REQUIRE_THAT( response,
+						Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+			}
+		} );
+	}
+
+	SECTION( "pipelined requests" )
+	{
+		std::string pipelined;
+		for( int i = 0; i != 4; ++i )
+			pipelined += make_request( "/" + std::to_string( i ), i );
+
+		std::string response;
+		do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+			restinio::asio_ns::write( socket, restinio::asio_ns::buffer( pipelined ) );
+
+			while( std::string::npos == response.find( "/3:field3:body3" ) )
+			{
+				std::array< char, 1024 > data;
+				const auto n = socket.read_some(
+						restinio::asio_ns::buffer( data ) );
+				response.append( data.data(), n );
+			}
+		} );
+
+		for( int i = 0; i != 4; ++i )
+		{
+			const std::string expected_body =
+				"/" + std::to_string( i ) + ":field" + std::to_string( i ) +
+				":body" + std::to_string( i );
+			REQUIRE_THAT( response, Catch::Matchers::Contains( expected_body ) );
+		}
+	}
+
+	SECTION( "requests outlive connection" )
+	{
+		do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+			const auto request =
+				make_request( "/hold", 0 ) + make_request( "/hold", 1 );
+			restinio::asio_ns::write( socket, restinio::asio_ns::buffer( request ) );
+
+			for(;;)
+			{
+				std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+				std::lock_guard< std::mutex > lock{ requests_lock };
+				if( 2u == requests.size() )
+					break;
+			}
+		} );
+
+		// Connection is closed by the client but requests are still alive.
+		std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+
+		std::lock_guard< std::mutex > lock{ requests_lock };
+		REQUIRE( 2u == requests.size() );
+		REQUIRE( "field0" == requests[ 0 ]->header().get_field( "X-Request-Field" ) );
+		REQUIRE( "body0" == requests[ 0 ]->body() );
+		REQUIRE( "field1" == requests[ 1 ]->header().get_field( "X-Request-Field" ) );
+		REQUIRE( "body1" == requests[ 1 ]->body() );
+
+		requests.clear();
+	}
+
+	other_thread.stop_and_join();
+}
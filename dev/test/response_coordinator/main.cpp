@@ -1793,3 +1793,98 @@ TEST_CASE( "response_coordinator reset" , "[response_coordinator][connection_clo
 		coordinator.reset();
 	}
 }
+
+TEST_CASE( "response_coordinator_coalescing" , "[response_coordinator][coalescing]" )
+{
+	response_coordinator_t coordinator{ 5, true };
+
+	request_id_t req_id[ 5 ];
+	for( auto & id : req_id )
+		id = coordinator.register_new_request();
+
+	const auto append = [&]( std::size_t i, response_connection_attr_t conn ) {
+		coordinator.append_response(
+			req_id[ i ],
+			response_output_flags_t{ response_is_complete(), conn },
+			write_group_t{ make_buffers( { std::to_string( i ) + "a", std::to_string( i ) + "b" } ) } );
+	};
+
+	// #0 isn't ready yet.
+	append( 1, connection_should_keep_alive() );
+	REQUIRE_FALSE( coordinator.pop_ready_buffers() );
+
+	append( 0, connection_should_keep_alive() );
+
+	// #2 has an after-write notificator, so #3 isn't merged.
+	write_group_t wg{ make_buffers( { "2a", "2b" } ) };
+	wg.after_write_notificator( []( const auto & ){} );
+	coordinator.append_response(
+		req_id[ 2 ],
+		response_output_flags_t{
+			response_is_complete(),
+			connection_should_keep_alive() },
+		std::move( wg ) );
+	append( 3, connection_should_keep_alive() );
+
+	auto popped_wg = coordinator.pop_ready_buffers();
+	REQUIRE( popped_wg );
+	REQUIRE( req_id[ 0 ] == popped_wg->second );
+	REQUIRE( concat_bufs( popped_wg->first ) == "0a0b1a1b2a2b" );
+	REQUIRE( popped_wg->first.has_after_write_notificator() );
+
+	// #4 closes the connection, nothing can follow it.
+	append( 4, connection_should_close() );
+
+	popped_wg = coordinator.pop_ready_buffers();
+	REQUIRE( popped_wg );
+	REQUIRE( req_id[ 3 ] == popped_wg->second );
+	REQUIRE( concat_bufs( popped_wg->first ) == "3a3b4a4b" );
+	REQUIRE( coordinator.closed() );
+	REQUIRE( coordinator.empty() );
+}
+
+TEST_CASE( "response_coordinator_coalescing status lines" , "[response_coordinator][coalescing]" )
+{
+	response_coordinator_t coordinator{ 3, true };
+
+	request_id_t req_id[ 3 ];
+	for( auto & id : req_id )
+		id = coordinator.register_new_request();
+
+	const auto append = [&]( std::size_t i, std::size_t status_line_size ) {
+		write_group_t wg{ make_buffers( {
+				"HTTP/1.1 20" + std::to_string( i ) + " OK\r\n",
+				std::to_string( i ) } ) };
+		wg.status_line_size( status_line_size );
+
+		coordinator.append_response(
+			req_id[ i ],
+			response_output_flags_t{
+				response_is_complete(),
+				connection_should_keep_alive() },
+			std::move( wg ) );
+	};
+
+	append( 0, 17 );
+	append( 1, 0 );
+	append( 2, 15 );
+
+	coalesced_responses_t coalesced{
+		coalesced_response_t{ 42, 42, 42 } };
+
+	auto popped_wg = coordinator.pop_ready_buffers( &coalesced );
+	REQUIRE( popped_wg );
+	REQUIRE( req_id[ 0 ] == popped_wg->second );
+	REQUIRE( 6 == popped_wg->first.items_count() );
+	REQUIRE( 17 == popped_wg->first.status_line_size() );
+
+	REQUIRE( 1 == coalesced.size() );
+	REQUIRE( req_id[ 2 ] == coalesced[ 0 ].m_request_id );
+	REQUIRE( 4 == coalesced[ 0 ].m_item_index );
+	REQUIRE( 15 == coalesced[ 0 ].m_status_line_size );
+	REQUIRE( "HTTP/1.1 202 OK\r\n" ==
+		make_string( popped_wg->first.items()[ 4 ] ) );
+
+	REQUIRE_FALSE( coordinator.pop_ready_buffers( &coalesced ) );
+	REQUIRE( coalesced.empty() );
+}
@@ -0,0 +1,199 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for compile time router.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/router/ct_router.hpp>
+
+using namespace restinio;
+
+namespace ct = restinio::router::ct;
+
+struct fake_connection_t : public restinio::impl::connection_base_t
+{
+	fake_connection_t() : restinio::impl::connection_base_t{ 0 }
+	{}
+
+	virtual void
+	check_timeout( std::shared_ptr< tcp_connection_ctx_base_t > & ) override
+	{}
+
+	virtual void
+	write_response_parts(
+		request_id_t ,
+		response_output_flags_t ,
+		write_group_t ) override
+	{}
+};
+
+request_handle_t
+create_fake_request( std::string target, http_method_id_t method = http_method_get() )
+{
+	return
+		std::make_shared< request_t >(
+			0,
+			http_request_header_t{ method, std::move( target ) },
+			"",
+			std::make_shared< fake_connection_t >(),
+			restinio::endpoint_t{
+				restinio::asio_ns::ip::make_address_v4("127.0.0.1"),
+				3000 } );
+}
+
+// Routes are checked at compile time.
+constexpr auto orders_route = RESTINIO_CT_ROUTE( "/users/:id/orders/:order" );
+
+static_assert( 4u == decltype( orders_route )::segments_count, "4 segments expected" );
+static_assert( 2u == decltype( orders_route )::params_count, "2 params expected" );
+static_assert( 0u == ct::impl::segments_count( "/" ), "root has no segments" );
+
+TEST_CASE( "Invalid routes" , "[ct_router][route]" )
+{
+	// Checks made at compile time throw at run time.
+	REQUIRE_THROWS( ct::route_t< 0u, 0u >{ "" } );
+	REQUIRE_THROWS( ct::route_t< 1u, 0u >{ "users" } );
+	REQUIRE_THROWS( ct::route_t< 1u, 0u >{ "/users/" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 0u >{ "/users//orders" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 1u >{ "/users/:" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 1u >{ "/users/:id(\\d+)" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 0u >{ "/users/a*" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 2u >{ "/:id/:id" } );
+	REQUIRE_THROWS( ct::route_t< 2u, 2u >{ "/users/:id" } );
+
+	REQUIRE_NOTHROW( ct::route_t< 2u, 2u >{ "/:id/:id2" } );
+	REQUIRE( "/users/:id" == RESTINIO_CT_ROUTE( "/users/:id" ).path() );
+}
+
+TEST_CASE( "Typed params" , "[ct_router][params]" )
+{
+	std::string last;
+
+	auto router = ct::make_router(
+		ct::http_get( RESTINIO_CT_ROUTE( "/" ),
+			[&]( request_handle_t ){
+				last = "root";
+				return request_accepted();
+			} ),
+		ct::http_get( orders_route,
+			[&]( request_handle_t, std::uint32_t id, string_view_t order ){
+				last = fmt::format( "orders {} {}", id, order );
+				return request_accepted();
+			} ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/users/:id" ),
+			[&]( const request_handle_t &, int id ){
+				last = fmt::format( "user {}", id );
+				return request_accepted();
+			} ),
+		// Names that aren't numbers go here.
+		ct::http_get( RESTINIO_CT_ROUTE( "/users/:name" ),
+			[&]( request_handle_t, std::string name ){
+				last = "user by name " + name;
+				return request_accepted();
+			} ),
+		ct::http_post( RESTINIO_CT_ROUTE( "/users/:id" ),
+			[&]( request_handle_t, double id ){
+				last = fmt::format( "post user {}", id );
+				return request_accepted();
+			} ) );
+
+	const auto route = [&]( std::string target, http_method_id_t method ) {
+		last.clear();
+		const auto status = router( create_fake_request( std::move( target ), method ) );
+		return request_accepted() == status ? last : std::string{ "rejected" };
+	};
+
+	REQUIRE( "root" == route( "/", http_method_get() ) );
+	REQUIRE( "orders 42 a-7" == route( "/users/42/orders/a-7", http_method_get() ) );
+	REQUIRE( "orders 42 a-7" == route( "/users/42/orders/a-7/", http_method_get() ) );
+	REQUIRE( "user 42" == route( "/users/42?x=1", http_method_get() ) );
+	REQUIRE( "user by name bob" == route( "/users/bob", http_method_get() ) );
+	REQUIRE( "post user 1.5" == route( "/users/1.5", http_method_post() ) );
+
+	REQUIRE( "rejected" == route( "/users/-1/orders/1", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/users/bob", http_method_post() ) );
+	REQUIRE( "rejected" == route( "/users", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/Users/42", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/users//orders/1", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/users/1/orders/2/items", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/users/1/orders/2/items/3/x", http_method_get() ) );
+	REQUIRE( "rejected" == route( "/users/42", http_method_delete() ) );
+
+	router.non_matched_request_handler(
+		[&]( request_handle_t ){
+			last = "non matched";
+			return request_accepted();
+		} );
+
+	REQUIRE( "non matched" == route( "/users/42", http_method_delete() ) );
+}
+
+TEST_CASE( "Order of routes" , "[ct_router][order]" )
+{
+	std::string last;
+
+	const auto handler = [&]( const char * name ) {
+		return [&last, name]( request_handle_t, string_view_t ) {
+			last = name;
+			return request_accepted();
+		};
+	};
+
+	const auto handler2 = [&]( const char * name ) {
+		return [&last, name]( request_handle_t, string_view_t, string_view_t ) {
+			last = name;
+			return request_accepted();
+		};
+	};
+
+	// Routes with a parameter as the first segment and routes with
+	// a plain one are indexed separately but tried in the given order.
+	auto router = ct::make_router(
+		ct::http_get( RESTINIO_CT_ROUTE( "/:any/edit" ), handler( "any edit" ) ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/users/:id" ), handler( "user" ) ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/:any/:id" ), handler2( "any" ) ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/orders/:id" ), handler( "order" ) ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/abc/:id" ), handler( "abc" ) ),
+		ct::http_get( RESTINIO_CT_ROUTE( "/:any" ), handler( "single" ) ) );
+
+	const auto route = [&]( std::string target ) {
+		last.clear();
+		const auto status = router( create_fake_request( std::move( target ) ) );
+		return request_accepted() == status ? last : std::string{ "rejected" };
+	};
+
+	REQUIRE( "any edit" == route( "/users/edit" ) );
+	REQUIRE( "user" == route( "/users/42" ) );
+	REQUIRE( "any edit" == route( "/orders/edit" ) );
+	REQUIRE( "any" == route( "/orders/42" ) );
+	REQUIRE( "any" == route( "/abc/42" ) );
+	REQUIRE( "any" == route( "/ab/42" ) );
+	REQUIRE( "single" == route( "/users" ) );
+	REQUIRE( "rejected" == route( "/" ) );
+	REQUIRE( "rejected" == route( "/a/b/c" ) );
+}
+
+request_handling_status_t
+plain_function_handler( request_handle_t, std::uint64_t )
+{
+	return request_accepted();
+}
+
+TEST_CASE( "Plain function as handler" , "[ct_router][handler]" )
+{
+	auto router = ct::make_router(
+		ct::add_handler(
+			http_method_put(),
+			RESTINIO_CT_ROUTE( "/items/:id" ),
+			&plain_function_handler ) );
+
+	REQUIRE( request_accepted() ==
+		router( create_fake_request( "/items/100500", http_method_put() ) ) );
+	REQUIRE( request_rejected() ==
+		router( create_fake_request( "/items/x", http_method_put() ) ) );
+}
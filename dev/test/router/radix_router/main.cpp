@@ -0,0 +1,281 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for radix router.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <cctype>
+#include <iterator>
+
+#include <restinio/all.hpp>
+#include <restinio/router/radix.hpp>
+
+using namespace restinio;
+
+using express_router_t = restinio::router::radix_router_t<>;
+using restinio::router::route_params_t;
+
+#include "../express_router/tests.ipp"
+
+namespace
+{
+
+using params_dump_t = std::vector< std::string >;
+
+// Dumps parameters to compare results of different routers.
+params_dump_t
+dump_params( const route_params_t & params )
+{
+	params_dump_t result;
+	result.emplace_back( std::string{ params.match().data(), params.match().size() } );
+	result.emplace_back( std::to_string( params.named_parameters_size() ) );
+
+	for( const char * name : { "id", "name", "order", "ext", "file",
+			"rest", "last", "year", "month", "section" } )
+	{
+		if( params.has( name ) )
+		{
+			const auto v = params[ name ];
+			result.emplace_back( std::string{ name } + "=" + std::string{ v.data(), v.size() } );
+		}
+	}
+
+	for( std::size_t i = 0; i != params.indexed_parameters_size(); ++i )
+	{
+		const auto v = params[ i ];
+		result.emplace_back( std::string{ v.data(), v.size() } );
+	}
+
+	return result;
+}
+
+struct route_t
+{
+	http_method_id_t m_method;
+	std::string m_route;
+	path2regex::options_t m_options;
+};
+
+template < typename Router >
+void
+fill_router(
+	Router & router,
+	const std::vector< route_t > & routes,
+	int & last_handler_called,
+	params_dump_t & last_params )
+{
+	for( std::size_t i = 0; i != routes.size(); ++i )
+	{
+		router.add_handler(
+			routes[ i ].m_method,
+			routes[ i ].m_route,
+			routes[ i ].m_options,
+			[ &, i ]( auto, auto p ){
+				last_handler_called = static_cast< int >( i );
+				last_params = dump_params( p );
+				return request_accepted();
+			} );
+	}
+}
+
+} /* anonymous namespace */
+
+TEST_CASE( "Same choice as express router" , "[radix][express]" )
+{
+	const std::vector< route_t > routes{
+		{ http_method_get(), "/", {} },
+		{ http_method_get(), "/users", {} },
+		{ http_method_get(), "/users/new", {} },
+		{ http_method_get(), R"(/users/:id(\d+))", {} },
+		{ http_method_post(), "/users/:id", {} },
+		{ http_method_get(), "/users/:name", {} },
+		{ http_method_get(), "/users/:id/orders/:order", {} },
+		{ http_method_get(), "/users/:id/orders/:order?", {} },
+		{ http_method_get(), R"(/files/:name.:ext)", {} },
+		{ http_method_get(), R"(/files/(\d+))", {} },
+		{ http_method_get(), "/files/:file", {} },
+		{ http_method_get(), "/Sensitive", path2regex::options_t{}.sensitive( true ) },
+		{ http_method_get(), "/strict", path2regex::options_t{}.strict( true ) },
+		{ http_method_get(), "/prefix", path2regex::options_t{}.ending( false ) },
+		{ http_method_get(), "/any/:rest(.*)", {} },
+		{ http_method_get(), "/any/:last", {} },
+		{ http_method_get(), "/trailing/", {} },
+		{ http_method_get(), R"(/news/:year(\d{4})-:month(\d{2}))", {} },
+		{ http_method_get(), R"(/news/:year(\d{4}))", {} },
+		{ http_method_get(), "/:section/about", {} },
+	};
+
+	int express_handler = -1;
+	params_dump_t express_params;
+	restinio::router::express_router_t<> express;
+	fill_router( express, routes, express_handler, express_params );
+
+	int radix_handler = -1;
+	params_dump_t radix_params;
+	restinio::router::radix_router_t<> radix;
+	fill_router( radix, routes, radix_handler, radix_params );
+
+	const std::vector< std::pair< http_method_id_t, std::string > > requests{
+		{ http_method_get(), "/" },
+		{ http_method_get(), "//" },
+		{ http_method_get(), "" },
+		{ http_method_get(), "/users" },
+		{ http_method_get(), "/users/" },
+		{ http_method_get(), "/USERS" },
+		{ http_method_get(), "/users//" },
+		{ http_method_get(), "/users/new" },
+		{ http_method_get(), "/users/NEW/" },
+		{ http_method_get(), "/users/42" },
+		{ http_method_post(), "/users/42" },
+		{ http_method_put(), "/users/42" },
+		{ http_method_get(), "/users/john" },
+		{ http_method_get(), "/users/42/orders/7" },
+		{ http_method_get(), "/users/42/orders" },
+		{ http_method_get(), "/users/42/orders/" },
+		{ http_method_get(), "/users/42/orders/7/8" },
+		{ http_method_get(), "/files/a.txt" },
+		{ http_method_get(), "/files/123" },
+		{ http_method_get(), "/files/readme" },
+		{ http_method_get(), "/Sensitive" },
+		{ http_method_get(), "/sensitive" },
+		{ http_method_get(), "/strict" },
+		{ http_method_get(), "/strict/" },
+		{ http_method_get(), "/prefix/and/more" },
+		{ http_method_get(), "/any/a/b/c" },
+		{ http_method_get(), "/any/a" },
+		{ http_method_get(), "/trailing" },
+		{ http_method_get(), "/trailing/" },
+		{ http_method_get(), "/news/2020-01" },
+		{ http_method_get(), "/news/2020" },
+		{ http_method_get(), "/news/20201" },
+		{ http_method_get(), "/company/about" },
+		{ http_method_get(), "/company/about/" },
+		{ http_method_get(), "/a//about" },
+		{ http_method_get(), "/unknown/path" },
+	};
+
+	for( const auto & r : requests )
+	{
+		INFO( r.first.c_str() << " " << r.second );
+
+		express_handler = -1;
+		express_params.clear();
+		const auto express_result = express( create_fake_request( r.second, r.first ) );
+
+		radix_handler = -1;
+		radix_params.clear();
+		const auto radix_result = radix( create_fake_request( r.second, r.first ) );
+
+		REQUIRE( express_result == radix_result );
+		REQUIRE( express_handler == radix_handler );
+		REQUIRE( express_params == radix_params );
+	}
+}
+
+TEST_CASE( "Order of routes" , "[radix][order]" )
+{
+	int last_handler_called = -1;
+
+	express_router_t router;
+
+	// Regex route is added before the route from the tree.
+	router.http_get( "/items/:id?",
+		[&]( auto, auto ){
+			last_handler_called = 0;
+			return request_accepted();
+		} );
+
+	router.http_get( "/items/:id",
+		[&]( auto, auto ){
+			last_handler_called = 1;
+			return request_accepted();
+		} );
+
+	router.http_get( "/goods/:id",
+		[&]( auto, auto ){
+			last_handler_called = 2;
+			return request_accepted();
+		} );
+
+	router.http_get( "/goods/:id?",
+		[&]( auto, auto ){
+			last_handler_called = 3;
+			return request_accepted();
+		} );
+
+	REQUIRE( request_accepted() == router( create_fake_request( "/items/1" ) ) );
+	REQUIRE( 0 == last_handler_called );
+
+	REQUIRE( request_accepted() == router( create_fake_request( "/goods/1" ) ) );
+	REQUIRE( 2 == last_handler_called );
+
+	REQUIRE( request_accepted() == router( create_fake_request( "/goods" ) ) );
+	REQUIRE( 3 == last_handler_called );
+}
+
+TEST_CASE( "Invalid constraint" , "[radix][invalid]" )
+{
+	express_router_t router;
+
+	REQUIRE_THROWS_AS(
+		router.http_get( R"(/users/:id([a-z)))",
+			[]( auto, auto ){ return request_accepted(); } ),
+		restinio::exception_t );
+}
+
+TEST_CASE( "Many plain siblings" , "[radix][plain]" )
+{
+	int last_handler_called = -1;
+
+	express_router_t router;
+
+	const auto segment = []( int i ) {
+		// Segments of different sizes and unordered names.
+		return std::string( static_cast< std::size_t >( i % 3 + 1 ), 'x' ) +
+			std::to_string( ( i * 37 ) % 101 );
+	};
+
+	for( int i = 0; i != 100; ++i )
+		router.http_get( "/r/" + segment( i ) + "/X",
+			[&, i]( auto, auto ){
+				last_handler_called = i;
+				return request_accepted();
+			} );
+
+	router.add_handler( http_method_get(), "/r/Sensitive/X",
+		path2regex::options_t{}.sensitive( true ),
+		[&]( auto, auto ){
+			last_handler_called = 100;
+			return request_accepted();
+		} );
+
+	for( int i = 0; i != 100; ++i )
+	{
+		INFO( segment( i ) );
+
+		last_handler_called = -1;
+		REQUIRE( request_accepted() ==
+			router( create_fake_request( "/r/" + segment( i ) + "/x" ) ) );
+		REQUIRE( i == last_handler_called );
+
+		auto upper = segment( i );
+		for( auto & c : upper )
+			c = static_cast< char >( std::toupper( c ) );
+
+		last_handler_called = -1;
+		REQUIRE( request_accepted() ==
+			router( create_fake_request( "/R/" + upper + "/X" ) ) );
+		REQUIRE( i == last_handler_called );
+	}
+
+	REQUIRE( request_accepted() == router( create_fake_request( "/r/Sensitive/X" ) ) );
+	REQUIRE( 100 == last_handler_called );
+
+	REQUIRE( request_rejected() == router( create_fake_request( "/r/sensitive/X" ) ) );
+	REQUIRE( request_rejected() == router( create_fake_request( "/r/x1000/x" ) ) );
+	REQUIRE( request_rejected() == router( create_fake_request( "/r/x/x" ) ) );
+}
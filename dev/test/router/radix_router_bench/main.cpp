@@ -0,0 +1,158 @@
+/*
+	restinio
+*/
+
+/*!
+	Benchmark for dispatching requests with radix router
+	in comparison with express router.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <restinio/all.hpp>
+#include <restinio/router/radix.hpp>
+
+#include <fmt/format.h>
+
+using namespace restinio;
+
+struct fake_connection_t : public restinio::impl::connection_base_t
+{
+	fake_connection_t() : restinio::impl::connection_base_t{ 0 }
+	{}
+
+	virtual void
+	check_timeout( std::shared_ptr< tcp_connection_ctx_base_t > & ) override
+	{}
+
+	virtual void
+	write_response_parts(
+		request_id_t ,
+		response_output_flags_t ,
+		write_group_t ) override
+	{}
+};
+
+request_handle_t
+create_fake_request( std::string target, http_method_id_t method )
+{
+	return
+		std::make_shared< request_t >(
+			0,
+			http_request_header_t{ method, std::move( target ) },
+			"",
+			std::make_shared< fake_connection_t >(),
+			restinio::endpoint_t{
+				restinio::asio_ns::ip::make_address_v4("127.0.0.1"),
+				3000 } );
+}
+
+// Every resource gives 4 routes, the half of them have constrained params.
+template < typename Router >
+std::unique_ptr< Router >
+create_router( std::size_t routes_count, std::size_t & handled )
+{
+	auto router = std::make_unique< Router >();
+
+	auto handler = [&handled]( auto, auto ){
+		++handled;
+		return request_accepted();
+	};
+
+	for( std::size_t i = 0; i < routes_count; ++i )
+	{
+		const auto resource = fmt::format( "/resource{}", i / 4u );
+
+		switch( i % 4u )
+		{
+			case 0: router->http_get( resource, handler ); break;
+			case 1: router->http_post( resource, handler ); break;
+			case 2: router->http_get( resource + R"(/:id(\d+))", handler ); break;
+			case 3: router->http_get( resource + R"(/:id(\d+)/items/:name)", handler ); break;
+		}
+	}
+
+	return router;
+}
+
+std::vector< request_handle_t >
+create_requests( std::size_t routes_count )
+{
+	std::vector< request_handle_t > result;
+
+	for( std::size_t i = 0; i < 64u; ++i )
+	{
+		// Requests are spread across the whole route table.
+		const auto route = ( i * 7919u ) % routes_count;
+		const auto resource = fmt::format( "/resource{}", route / 4u );
+
+		switch( route % 4u )
+		{
+			case 0: result.push_back( create_fake_request( resource, http_method_get() ) ); break;
+			case 1: result.push_back( create_fake_request( resource, http_method_post() ) ); break;
+			case 2: result.push_back( create_fake_request( resource + "/42", http_method_get() ) ); break;
+			case 3: result.push_back( create_fake_request( resource + "/42/items/abc", http_method_get() ) ); break;
+		}
+	}
+
+	return result;
+}
+
+template < typename Router >
+double
+run_bench( std::size_t routes_count, std::size_t iterations )
+{
+	std::size_t handled = 0u;
+	auto router = create_router< Router >( routes_count, handled );
+	const auto requests = create_requests( routes_count );
+
+	const auto started_at = std::chrono::steady_clock::now();
+
+	for( std::size_t i = 0; i < iterations; ++i )
+		for( const auto & req : requests )
+			(*router)( req );
+
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	if( handled != iterations * requests.size() )
+		throw std::runtime_error{ "not all requests are handled" };
+
+	const double duration_ns = static_cast< double >(
+			std::chrono::duration_cast< std::chrono::nanoseconds >(
+					finished_at - started_at ).count() );
+
+	return duration_ns / static_cast< double >( handled );
+}
+
+int
+main( int argc, const char *argv[] )
+{
+	try
+	{
+		const std::size_t iterations =
+				1 < argc ? static_cast< std::size_t >( std::atoi( argv[ 1 ] ) ) : 100u;
+
+		std::cout << fmt::format( "{:>8} {:>16} {:>16}\n",
+				"routes", "express, ns/req", "radix, ns/req" );
+
+		for( const std::size_t routes_count : { 10u, 100u, 1000u } )
+		{
+			const auto express = run_bench<
+					restinio::router::express_router_t<> >( routes_count, iterations );
+			const auto radix = run_bench<
+					restinio::router::radix_router_t<> >( routes_count, iterations );
+
+			std::cout << fmt::format( "{:>8} {:>16.1f} {:>16.1f}\n",
+					routes_count, express, radix );
+		}
+	}
+	catch( const std::exception & ex )
+	{
+		std::cerr << "Error: " << ex.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
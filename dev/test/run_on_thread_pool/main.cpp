@@ -8,6 +8,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <map>
+
 #include <restinio/all.hpp>
 #include <restinio/websocket/websocket.hpp>
 
@@ -239,3 +241,86 @@ TEST_CASE( "server on thread pool runner" , "[on_pool_runner]" )
 	REQUIRE( "" != endpoint_value );
 }
 
+
+TEST_CASE( "io_context per thread" , "[io_context_per_thread]" )
+{
+	using traits_t =
+		restinio::single_thread_traits_t<
+			restinio::asio_timer_manager_t,
+			utest_logger_t >;
+
+	std::mutex lock;
+	// Threads on that requests are handled by index of server.
+	std::map< std::size_t, std::thread::id > handler_threads;
+
+	const auto served_servers = [&] {
+		std::lock_guard< std::mutex > l{ lock };
+		return handler_threads.size();
+	};
+
+	// The configurator is called for every server in the constructor.
+	std::size_t servers_created = 0u;
+
+	restinio::on_io_context_per_thread_runner_t< traits_t > runner{
+		restinio::on_io_context_per_thread< traits_t >(
+			2,
+			[&]( auto & settings ){
+				const auto server_index = servers_created++;
+
+				settings
+					.port( utest_default_port() )
+					.address( "127.0.0.1" )
+					.request_handler(
+						[&, server_index]( auto req ){
+							{
+								std::lock_guard< std::mutex > l{ lock };
+								handler_threads.emplace(
+									server_index, std::this_thread::get_id() );
+							}
+
+							req->create_response()
+								.append_header( "Server", "RESTinio utest server" )
+								.append_header_date_field()
+								.append_header( "Content-Type", "text/plain; charset=utf-8" )
+								.set_body(
+									restinio::const_buffer( req->header().method().c_str() ) )
+								.done();
+
+							return restinio::request_accepted();
+						} );
+			} ).pin_threads( false ) };
+
+	REQUIRE( 2u == servers_created );
+	REQUIRE( 2u == runner.size() );
+
+	runner.start();
+	REQUIRE( runner.started() );
+
+	const char * request_str =
+		"GET / HTTP/1.1\r\n"
+		"Host: 127.0.0.1\r\n"
+		"User-Agent: unit-test\r\n"
+		"Accept: */*\r\n"
+		"Connection: close\r\n"
+		"\r\n";
+
+	// The kernel distributes connections between acceptors by hash
+	// of addresses and ports, so several connections can be required
+	// for every io_context to serve one.
+	for( int i = 0; i != 200 && 2u != served_servers(); ++i )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = repeat_request( request_str ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::EndsWith( "GET" ) );
+	}
+
+	runner.stop();
+	REQUIRE_NOTHROW( runner.wait() );
+	REQUIRE_FALSE( runner.started() );
+
+	REQUIRE( 2u == handler_threads.size() );
+	REQUIRE( handler_threads[ 0u ] != handler_threads[ 1u ] );
+	for( const auto & t : handler_threads )
+		REQUIRE( std::this_thread::get_id() != t.second );
+}
@@ -0,0 +1,435 @@
+/*
+	restinio
+*/
+
+/*!
+	Static files cache.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/helpers/static_files.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+#include <fstream>
+#include <future>
+#include <mutex>
+
+#if defined( _MSC_VER ) || defined(__MINGW32__)
+	#include <direct.h>
+#else
+	#include <sys/stat.h>
+#endif
+
+namespace rsf = restinio::static_files;
+namespace rtz = restinio::transforms::zlib;
+
+const std::string root_dir{ "_static_files_test" };
+const std::string variants_dir{ "_static_files_test_variants" };
+
+void
+make_dir( const std::string & path )
+{
+#if defined( _MSC_VER ) || defined(__MINGW32__)
+	_mkdir( path.c_str() );
+#else
+	mkdir( path.c_str(), 0755 );
+#endif
+}
+
+void
+write_file( const std::string & path, const std::string & content )
+{
+	std::ofstream out{ path, std::ios::binary | std::ios::trunc };
+	out << content;
+}
+
+std::string
+make_js_content( std::size_t lines )
+{
+	std::string result;
+	for( std::size_t i = 0; i < lines; ++i )
+		result += fmt::format( "function f{}() {{ return {}; }}\n", i, i * 7 );
+
+	return result;
+}
+
+std::string
+header_value( const std::string & response, const std::string & name )
+{
+	const auto start = response.find( "\r\n" + name + ": " );
+	if( std::string::npos == start )
+		return std::string{};
+
+	const auto value_start = start + name.size() + 4;
+	return response.substr( value_start, response.find( "\r\n", value_start ) - value_start );
+}
+
+std::string
+body_of( const std::string & response )
+{
+	return response.substr( response.find( "\r\n\r\n" ) + 4 );
+}
+
+std::string
+make_request(
+	const std::string & target,
+	const std::string & extra_fields = std::string{} )
+{
+	return
+		"GET " + target + " HTTP/1.1\r\n"
+		"Host: 127.0.0.1\r\n" +
+		extra_fields +
+		"Connection: close\r\n"
+		"\r\n";
+}
+
+//! Make requests until the compressed variant is ready.
+std::string
+do_gzip_request(
+	const std::string & target,
+	const std::string & accept_encoding = "gzip" )
+{
+	std::string response;
+	for( int i = 0; i != 1000; ++i )
+	{
+		response = do_request( make_request(
+				target, "Accept-Encoding: " + accept_encoding + "\r\n" ) );
+		if( "gzip" == header_value( response, "Content-Encoding" ) )
+			break;
+
+		std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+	}
+
+	return response;
+}
+
+//! Executor that keeps jobs until they are run by a test.
+class manual_executor_t
+{
+	public:
+		rsf::compression_executor_t
+		executor()
+		{
+			return [this]( std::function< void() > job ) {
+				std::lock_guard< std::mutex > lock{ m_lock };
+				m_jobs.push_back( std::move( job ) );
+			};
+		}
+
+		std::size_t
+		size()
+		{
+			std::lock_guard< std::mutex > lock{ m_lock };
+			return m_jobs.size();
+		}
+
+		void
+		run_all()
+		{
+			std::vector< std::function< void() > > jobs;
+			{
+				std::lock_guard< std::mutex > lock{ m_lock };
+				jobs.swap( m_jobs );
+			}
+
+			for( auto & j : jobs )
+				j();
+		}
+
+	private:
+		std::mutex m_lock;
+		std::vector< std::function< void() > > m_jobs;
+};
+
+class test_server_t
+{
+	public:
+		test_server_t(
+			bool use_hot_file_cache,
+			rsf::compression_executor_t executor = rsf::compression_executor_t{} )
+			:	m_files{
+					rsf::settings_t{}
+						.root_dir( root_dir )
+						.variants_dir( variants_dir )
+						.compression_executor( std::move( executor ) )
+						.hot_file_cache( use_hot_file_cache ?
+							std::make_shared< restinio::hot_file_cache_t >(
+								restinio::hot_file_cache_params_t{}
+									.revalidate_interval(
+										std::chrono::seconds::zero() ) ) :
+							nullptr ) }
+			,	m_server{
+					restinio::own_io_context(),
+					[this]( auto & settings ) {
+						settings
+							.port( utest_default_port() )
+							.address( "127.0.0.1" )
+							.request_handler(
+								[this]( auto req ){
+									return m_files.serve( req, req->header().path() );
+								} );
+					} }
+			,	m_other_thread{ m_server }
+		{
+			m_other_thread.run();
+		}
+
+		~test_server_t()
+		{
+			m_other_thread.stop_and_join();
+		}
+
+	private:
+		using http_server_t = restinio::http_server_t<
+				restinio::traits_t<
+					restinio::asio_timer_manager_t,
+					utest_logger_t > >;
+
+		rsf::cache_t m_files;
+		http_server_t m_server;
+		other_work_thread_for_server_t< http_server_t > m_other_thread;
+};
+
+TEST_CASE( "static files" , "[static_files]" )
+{
+	make_dir( root_dir );
+	make_dir( variants_dir );
+
+	const auto js_content = make_js_content( 200 );
+	write_file( root_dir + "/app.js", js_content );
+	write_file( root_dir + "/style.css", "body { color: red; }\n" );
+	write_file( root_dir + "/style.css.gz", rtz::gzip_compress( "from sibling" ) );
+	make_dir( root_dir + "/subdir" );
+	write_file( root_dir + "/subdir/page.css", "p { margin: 0; }\n" );
+	make_dir( root_dir + "/subdir/page.css.gz" );
+
+	test_server_t server{ GENERATE( false, true ) };
+
+	SECTION( "identity" )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request( make_request( "/app.js" ) ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+		REQUIRE( header_value( response, "Content-Encoding" ).empty() );
+		REQUIRE( "application/javascript; charset=utf-8" ==
+			header_value( response, "Content-Type" ) );
+		REQUIRE( "Accept-Encoding" == header_value( response, "Vary" ) );
+		REQUIRE_FALSE( header_value( response, "ETag" ).empty() );
+		REQUIRE_FALSE( header_value( response, "Last-Modified" ).empty() );
+		REQUIRE( js_content == body_of( response ) );
+	}
+
+	SECTION( "compressed in background" )
+	{
+		std::string first;
+		REQUIRE_NOTHROW( first = do_gzip_request( "/app.js", "br, gzip;q=0.8" ) );
+
+		REQUIRE_THAT( first, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+		REQUIRE( "gzip" == header_value( first, "Content-Encoding" ) );
+		REQUIRE( body_of( first ).size() < js_content.size() );
+		REQUIRE( js_content == rtz::gzip_decompress( body_of( first ) ) );
+
+		// The second one is taken from the cache.
+		std::string second;
+		REQUIRE_NOTHROW( second = do_request(
+				make_request( "/app.js", "Accept-Encoding: *\r\n" ) ) );
+
+		REQUIRE( "gzip" == header_value( second, "Content-Encoding" ) );
+		REQUIRE( body_of( first ) == body_of( second ) );
+		REQUIRE( header_value( first, "ETag" ) == header_value( second, "ETag" ) );
+	}
+
+	SECTION( "gzip is not accepted" )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/app.js", "Accept-Encoding: gzip;q=0, deflate\r\n" ) ) );
+
+		REQUIRE( header_value( response, "Content-Encoding" ).empty() );
+		REQUIRE( js_content == body_of( response ) );
+	}
+
+	SECTION( "gz sibling" )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/style.css", "Accept-Encoding: gzip\r\n" ) ) );
+
+		REQUIRE( "gzip" == header_value( response, "Content-Encoding" ) );
+		REQUIRE( "text/css; charset=utf-8" == header_value( response, "Content-Type" ) );
+		REQUIRE( "from sibling" == rtz::gzip_decompress( body_of( response ) ) );
+
+		// A directory with the name of a sibling isn't used.
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/subdir/page.css", "Accept-Encoding: gzip\r\n" ) ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+		REQUIRE( header_value( response, "Content-Encoding" ).empty() );
+		REQUIRE( "p { margin: 0; }\n" == body_of( response ) );
+	}
+
+	SECTION( "conditional requests" )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_gzip_request( "/app.js" ) );
+
+		const auto etag = header_value( response, "ETag" );
+		const auto last_modified = header_value( response, "Last-Modified" );
+
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/app.js",
+					"Accept-Encoding: gzip\r\n"
+					"If-None-Match: \"other\", W/" + etag + "\r\n" ) ) );
+
+		REQUIRE_THAT( response,
+				Catch::Matchers::StartsWith( "HTTP/1.1 304 Not Modified" ) );
+		REQUIRE( etag == header_value( response, "ETag" ) );
+		REQUIRE( body_of( response ).empty() );
+
+		// ETag of the identity variant differs.
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/app.js", "If-None-Match: " + etag + "\r\n" ) ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/app.js",
+					"If-Modified-Since: " + last_modified + "\r\n" ) ) );
+
+		REQUIRE_THAT( response,
+				Catch::Matchers::StartsWith( "HTTP/1.1 304 Not Modified" ) );
+	}
+
+	SECTION( "modified file" )
+	{
+		std::string first;
+		REQUIRE_NOTHROW( first = do_gzip_request( "/app.js" ) );
+
+		const auto new_content = make_js_content( 300 );
+		write_file( root_dir + "/app.js", new_content );
+
+		std::string second;
+		REQUIRE_NOTHROW( second = do_gzip_request( "/app.js" ) );
+
+		REQUIRE( header_value( first, "ETag" ) != header_value( second, "ETag" ) );
+		REQUIRE( new_content == rtz::gzip_decompress( body_of( second ) ) );
+	}
+
+	SECTION( "not found" )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request( make_request( "/missing.js" ) ) );
+		REQUIRE_THAT( response,
+				Catch::Matchers::StartsWith( "HTTP/1.1 404 Not Found" ) );
+
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/../" + root_dir + "/app.js" ) ) );
+		REQUIRE_THAT( response,
+				Catch::Matchers::StartsWith( "HTTP/1.1 404 Not Found" ) );
+
+		// Directories aren't served.
+		for( const char * target : { "/subdir", "/subdir/", "/" } )
+		{
+			REQUIRE_NOTHROW( response = do_request( make_request( target ) ) );
+			REQUIRE_THAT( response,
+					Catch::Matchers::StartsWith( "HTTP/1.1 404 Not Found" ) );
+		}
+	}
+}
+
+TEST_CASE( "compression executor" , "[static_files][executor]" )
+{
+	make_dir( root_dir );
+	make_dir( variants_dir );
+
+	const auto js_content = make_js_content( 250 );
+	write_file( root_dir + "/lib.js", js_content );
+
+	manual_executor_t executor;
+	test_server_t server{ GENERATE( false, true ), executor.executor() };
+
+	// The original file is sent until the variant is compressed.
+	for( int i = 0; i != 2; ++i )
+	{
+		std::string response;
+		REQUIRE_NOTHROW( response = do_request(
+				make_request( "/lib.js", "Accept-Encoding: gzip\r\n" ) ) );
+
+		REQUIRE_THAT( response, Catch::Matchers::StartsWith( "HTTP/1.1 200 OK" ) );
+		REQUIRE( header_value( response, "Content-Encoding" ).empty() );
+		REQUIRE( js_content == body_of( response ) );
+		REQUIRE( 1u == executor.size() );
+	}
+
+	executor.run_all();
+
+	std::string response;
+	REQUIRE_NOTHROW( response = do_request(
+			make_request( "/lib.js", "Accept-Encoding: gzip\r\n" ) ) );
+
+	REQUIRE( "gzip" == header_value( response, "Content-Encoding" ) );
+	REQUIRE( js_content == rtz::gzip_decompress( body_of( response ) ) );
+	REQUIRE( 0u == executor.size() );
+}
+
+TEST_CASE( "compression worker" , "[static_files][worker]" )
+{
+	std::mutex lock;
+	std::vector< int > done;
+	const auto record = [&]( int v ) {
+		std::lock_guard< std::mutex > l{ lock };
+		done.push_back( v );
+	};
+	const auto done_count = [&] {
+		std::lock_guard< std::mutex > l{ lock };
+		return done.size();
+	};
+
+	{
+		rsf::impl::compression_worker_t worker;
+
+		// Jobs are run one by one in the order they are pushed.
+		for( int i = 0; i != 3; ++i )
+			worker.push( [&record, i]{ record( i ); } );
+
+		for( int i = 0; i != 1000 && 3u != done_count(); ++i )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+		REQUIRE( std::vector< int >{ 0, 1, 2 } == done );
+
+		// An exception doesn't stop the worker.
+		worker.push( []{ throw std::runtime_error{ "failure" }; } );
+		worker.push( [&record]{ record( 3 ); } );
+
+		for( int i = 0; i != 1000 && 4u != done_count(); ++i )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+		REQUIRE( 4u == done_count() );
+
+		// The current job is finished before the worker is destroyed.
+		std::promise< void > started;
+		worker.push( [&record, &started]{
+				started.set_value();
+				std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+				record( 4 );
+			} );
+
+		started.get_future().wait();
+	}
+
+	REQUIRE( 5u == done_count() );
+}
+
+TEST_CASE( "content type by extension" , "[static_files][content_type]" )
+{
+	REQUIRE( "text/html; charset=utf-8" ==
+		rsf::content_type_by_extension( "index.html" ) );
+	REQUIRE( "image/svg+xml" == rsf::content_type_by_extension( "a/b/logo.svg" ) );
+	REQUIRE( "application/octet-stream" ==
+		rsf::content_type_by_extension( "archive.tar" ) );
+}
@@ -0,0 +1,221 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for timing wheel timer manager.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/timing_wheel_timer_manager.hpp>
+
+#include <test/common/pub.hpp>
+
+using namespace std::chrono_literals;
+
+// Context that counts timeout checks.
+class counting_ctx_t final
+	:	public restinio::tcp_connection_ctx_base_t
+{
+	public:
+		counting_ctx_t()
+			:	restinio::tcp_connection_ctx_base_t{ 1u }
+		{}
+
+		void
+		check_timeout( restinio::tcp_connection_ctx_handle_t & ) override
+		{
+			++m_checks;
+		}
+
+		std::size_t checks() const noexcept { return m_checks; }
+
+	private:
+		std::size_t m_checks{ 0u };
+};
+
+using manager_t = restinio::single_threaded_timing_wheel_timer_manager_t;
+
+auto
+make_manager(
+	restinio::asio_ns::io_context & io_context,
+	std::chrono::steady_clock::duration check_period = 50ms )
+{
+	return manager_t::factory_t{ check_period, 10ms }.create( io_context );
+}
+
+TEST_CASE( "Scheduled context is checked" , "[timing_wheel][schedule]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+
+	auto ctx = std::make_shared< counting_ctx_t >();
+	auto guard = manager->create_timer_guard();
+
+	guard.schedule( ctx );
+
+	io_context.run_for( 30ms );
+	REQUIRE( 0u == ctx->checks() );
+
+	io_context.run_for( 60ms );
+	REQUIRE( 1u == ctx->checks() );
+
+	// The check is one-shot.
+	io_context.run_for( 100ms );
+	REQUIRE( 1u == ctx->checks() );
+
+	manager->stop();
+}
+
+TEST_CASE( "Rescheduling moves the check" , "[timing_wheel][reschedule]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+
+	auto ctx = std::make_shared< counting_ctx_t >();
+	auto guard = manager->create_timer_guard();
+
+	guard.schedule( ctx );
+	io_context.run_for( 30ms );
+	guard.schedule( ctx );
+	io_context.run_for( 30ms );
+	REQUIRE( 0u == ctx->checks() );
+
+	io_context.run_for( 50ms );
+	REQUIRE( 1u == ctx->checks() );
+
+	manager->stop();
+}
+
+TEST_CASE( "Canceled context is not checked" , "[timing_wheel][cancel]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+
+	auto ctx1 = std::make_shared< counting_ctx_t >();
+	auto ctx2 = std::make_shared< counting_ctx_t >();
+	auto guard1 = manager->create_timer_guard();
+	auto guard2 = manager->create_timer_guard();
+
+	guard1.schedule( ctx1 );
+	guard2.schedule( ctx2 );
+	guard1.cancel();
+
+	{
+		// Destruction of a scheduled guard cancels it too.
+		auto ctx3 = std::make_shared< counting_ctx_t >();
+		auto guard3 = manager->create_timer_guard();
+		guard3.schedule( ctx3 );
+	}
+
+	io_context.run_for( 100ms );
+	REQUIRE( 0u == ctx1->checks() );
+	REQUIRE( 1u == ctx2->checks() );
+
+	manager->stop();
+}
+
+TEST_CASE( "Destroyed context is ignored" , "[timing_wheel][expired]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+
+	auto guard = manager->create_timer_guard();
+	{
+		auto ctx = std::make_shared< counting_ctx_t >();
+		guard.schedule( ctx );
+	}
+
+	REQUIRE_NOTHROW( io_context.run_for( 100ms ) );
+
+	manager->stop();
+}
+
+TEST_CASE( "Many contexts" , "[timing_wheel][many]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+
+	std::vector< std::shared_ptr< counting_ctx_t > > contexts;
+	std::vector< manager_t::timer_guard_t > guards;
+	for( std::size_t i = 0u; i != 1000u; ++i )
+	{
+		contexts.push_back( std::make_shared< counting_ctx_t >() );
+		guards.push_back( manager->create_timer_guard() );
+		guards.back().schedule( contexts.back() );
+	}
+
+	for( std::size_t i = 0u; i < guards.size(); i += 2u )
+		guards[ i ].cancel();
+
+	io_context.run_for( 100ms );
+
+	for( std::size_t i = 0u; i != contexts.size(); ++i )
+		REQUIRE( ( i % 2u ) == contexts[ i ]->checks() );
+
+	manager->stop();
+}
+
+TEST_CASE( "Stopped manager doesn't tick" , "[timing_wheel][stop]" )
+{
+	restinio::asio_ns::io_context io_context;
+	auto manager = make_manager( io_context );
+	manager->start();
+	manager->stop();
+
+	auto ctx = std::make_shared< counting_ctx_t >();
+	auto guard = manager->create_timer_guard();
+	guard.schedule( ctx );
+
+	io_context.run_for( 100ms );
+	REQUIRE( 0u == ctx->checks() );
+
+	// Manager can be restarted.
+	// Note: io_context was stopped because it was out of work.
+	io_context.restart();
+	manager->start();
+	io_context.run_for( 100ms );
+	REQUIRE( 1u == ctx->checks() );
+
+	manager->stop();
+}
+
+TEST_CASE( "Timeouts of connections" , "[timing_wheel][server]" )
+{
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::timing_wheel_timer_manager_t,
+				restinio::null_logger_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.timer_manager( 50ms, 10ms )
+				.read_next_http_message_timelimit( 100ms )
+				.request_handler( []( auto ){ return restinio::request_rejected(); } );
+		} };
+
+	other_work_thread_for_server_t<http_server_t> other_thread(http_server);
+	other_thread.run();
+
+	do_with_socket( []( auto & socket, auto & /*io_context*/ ){
+			// Nothing is sent, so the connection should be closed by server.
+			char data[ 16 ];
+			restinio::asio_ns::error_code ec;
+			socket.read_some( restinio::asio_ns::buffer( data ), ec );
+			REQUIRE( restinio::asio_ns::error::eof == ec );
+		} );
+
+	other_thread.stop_and_join();
+}
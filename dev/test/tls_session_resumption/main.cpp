@@ -0,0 +1,344 @@
+/*
+	restinio
+*/
+
+/*!
+	TLS session cache and session ticket keys.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/tls.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+#include <openssl/x509.h>
+
+namespace asio_ns = restinio::asio_ns;
+
+//! Self-signed certificate and key for tests.
+struct test_certificate_t
+{
+	EVP_PKEY * m_key{ nullptr };
+	X509 * m_cert{ nullptr };
+
+	test_certificate_t()
+	{
+		auto * kctx = ::EVP_PKEY_CTX_new_id( EVP_PKEY_EC, nullptr );
+		::EVP_PKEY_keygen_init( kctx );
+		::EVP_PKEY_CTX_set_ec_paramgen_curve_nid( kctx, NID_X9_62_prime256v1 );
+		::EVP_PKEY_keygen( kctx, &m_key );
+		::EVP_PKEY_CTX_free( kctx );
+
+		m_cert = ::X509_new();
+		::X509_set_version( m_cert, 2 );
+		::ASN1_INTEGER_set( ::X509_get_serialNumber( m_cert ), 1 );
+		::X509_gmtime_adj( X509_get_notBefore( m_cert ), 0 );
+		::X509_gmtime_adj( X509_get_notAfter( m_cert ), 3600 );
+		::X509_set_pubkey( m_cert, m_key );
+
+		auto * name = ::X509_get_subject_name( m_cert );
+		::X509_NAME_add_entry_by_txt( name, "CN", MBSTRING_ASC,
+			reinterpret_cast< const unsigned char * >( "localhost" ), -1, -1, 0 );
+		::X509_set_issuer_name( m_cert, name );
+		::X509_sign( m_cert, m_key, ::EVP_sha256() );
+	}
+
+	~test_certificate_t()
+	{
+		::X509_free( m_cert );
+		::EVP_PKEY_free( m_key );
+	}
+
+	asio_ns::ssl::context
+	make_server_context() const
+	{
+		asio_ns::ssl::context ctx{ asio_ns::ssl::context::sslv23 };
+		::SSL_CTX_use_certificate( ctx.native_handle(), m_cert );
+		::SSL_CTX_use_PrivateKey( ctx.native_handle(), m_key );
+
+		return ctx;
+	}
+};
+
+//! Make a client context that can use only TLS 1.2.
+asio_ns::ssl::context
+make_tls12_client_context()
+{
+	asio_ns::ssl::context ctx{ asio_ns::ssl::context::sslv23 };
+	::SSL_CTX_set_max_proto_version( ctx.native_handle(), TLS1_2_VERSION );
+
+	return ctx;
+}
+
+//! Do a handshake between a client and a server in memory.
+/*!
+	Returns the session of the client and sets \a resumed to
+	the server's view on session resumption.
+*/
+SSL_SESSION *
+do_handshake(
+	asio_ns::ssl::context & client_ctx,
+	asio_ns::ssl::context & server_ctx,
+	SSL_SESSION * session_to_resume,
+	bool & resumed )
+{
+	auto * client = ::SSL_new( client_ctx.native_handle() );
+	auto * server = ::SSL_new( server_ctx.native_handle() );
+
+	BIO * client_bio = nullptr;
+	BIO * server_bio = nullptr;
+	::BIO_new_bio_pair( &client_bio, 0, &server_bio, 0 );
+	::SSL_set_bio( client, client_bio, client_bio );
+	::SSL_set_bio( server, server_bio, server_bio );
+
+	::SSL_set_connect_state( client );
+	::SSL_set_accept_state( server );
+	if( session_to_resume )
+		::SSL_set_session( client, session_to_resume );
+
+	bool client_done = false;
+	bool server_done = false;
+	for( int i = 0; i < 100 && !( client_done && server_done ); ++i )
+	{
+		if( !client_done )
+			client_done = 1 == ::SSL_do_handshake( client );
+		if( !server_done )
+			server_done = 1 == ::SSL_do_handshake( server );
+	}
+	REQUIRE( client_done );
+	REQUIRE( server_done );
+
+	// TLS 1.3 tickets are sent after the handshake.
+	char buf[ 1 ];
+	REQUIRE( 0 >= ::SSL_read( client, buf, sizeof( buf ) ) );
+
+	resumed = 1 == ::SSL_session_reused( server );
+	auto * result = ::SSL_get1_session( client );
+
+	::SSL_shutdown( client );
+	::SSL_shutdown( server );
+
+	::SSL_free( client );
+	::SSL_free( server );
+
+	return result;
+}
+
+TEST_CASE( "Session cache" , "[tls][session_cache]" )
+{
+	test_certificate_t cert;
+
+	auto server_ctx = cert.make_server_context();
+	::SSL_CTX_set_options( server_ctx.native_handle(), SSL_OP_NO_TICKET );
+
+	auto cache = std::make_shared< restinio::tls_session_cache_t >();
+	restinio::impl::use_tls_session_cache( server_ctx, cache );
+
+	auto client_ctx = make_tls12_client_context();
+
+	bool resumed = true;
+	auto * session = do_handshake( client_ctx, server_ctx, nullptr, resumed );
+	REQUIRE_FALSE( resumed );
+	REQUIRE( 1u == cache->stats().m_sessions_count );
+
+	auto * second = do_handshake( client_ctx, server_ctx, session, resumed );
+	REQUIRE( resumed );
+	REQUIRE( 1u == cache->stats().m_hits );
+
+	cache->clear();
+	auto * third = do_handshake( client_ctx, server_ctx, session, resumed );
+	REQUIRE_FALSE( resumed );
+	REQUIRE( 1u == cache->stats().m_misses );
+
+	::SSL_SESSION_free( session );
+	::SSL_SESSION_free( second );
+	::SSL_SESSION_free( third );
+}
+
+TEST_CASE( "Session cache limits" , "[tls][session_cache][limits]" )
+{
+	restinio::tls_session_cache_t cache{
+		restinio::tls_session_cache_params_t{}
+			.max_sessions( 4u )
+			.shards_count( 1u ) };
+
+	const auto make_session = []( unsigned char id ) {
+		auto * s = ::SSL_SESSION_new();
+		::SSL_SESSION_set1_id( s, &id, 1u );
+		::SSL_SESSION_set_time( s, static_cast< long >( std::time( nullptr ) ) );
+		::SSL_SESSION_set_timeout( s, 100 );
+		return s;
+	};
+
+	for( unsigned char id = 0u; id < 6u; ++id )
+		cache.insert( make_session( id ) );
+
+	auto stats = cache.stats();
+	REQUIRE( 4u == stats.m_sessions_count );
+	REQUIRE( 2u == stats.m_evictions );
+
+	// The first sessions are evicted.
+	REQUIRE( nullptr == cache.find( std::string( 1u, '\0' ) ) );
+	auto * found = cache.find( std::string( 1u, '\5' ) );
+	REQUIRE( nullptr != found );
+	::SSL_SESSION_free( found );
+
+	// Expired session.
+	auto * old = make_session( 10u );
+	::SSL_SESSION_set_time( old, static_cast< long >( std::time( nullptr ) ) - 200 );
+	cache.insert( old );
+	REQUIRE( nullptr == cache.find( std::string( 1u, '\x0a' ) ) );
+
+	stats = cache.stats();
+	REQUIRE( 1u == stats.m_timeouts );
+	REQUIRE( 3u == stats.m_sessions_count );
+
+	cache.remove( std::string( 1u, '\5' ) );
+	REQUIRE( 2u == cache.stats().m_sessions_count );
+}
+
+TEST_CASE( "Session ticket keys" , "[tls][session_tickets]" )
+{
+	test_certificate_t cert;
+
+	auto server_ctx = cert.make_server_context();
+
+	auto keys = std::make_shared< restinio::tls_session_ticket_keys_t >(
+			std::chrono::hours( 1 ), 2u );
+	restinio::impl::use_tls_session_ticket_keys( server_ctx, keys );
+	REQUIRE( 1u == keys->keys_count() );
+
+	asio_ns::ssl::context client_ctx{ asio_ns::ssl::context::sslv23 };
+
+	bool resumed = true;
+	auto * session = do_handshake( client_ctx, server_ctx, nullptr, resumed );
+	REQUIRE_FALSE( resumed );
+
+	auto * second = do_handshake( client_ctx, server_ctx, session, resumed );
+	REQUIRE( resumed );
+
+	// The ticket is encrypted by the previous key, it is still accepted.
+	keys->rotate();
+	REQUIRE( 2u == keys->keys_count() );
+	auto * third = do_handshake( client_ctx, server_ctx, session, resumed );
+	REQUIRE( resumed );
+
+	// The key of the ticket is dropped.
+	keys->rotate();
+	REQUIRE( 2u == keys->keys_count() );
+	auto * fourth = do_handshake( client_ctx, server_ctx, session, resumed );
+	REQUIRE_FALSE( resumed );
+
+	// The renewed ticket is encrypted by the previous key.
+	auto * fifth = do_handshake( client_ctx, server_ctx, third, resumed );
+	REQUIRE( resumed );
+
+	for( auto * s : { session, second, third, fourth, fifth } )
+		::SSL_SESSION_free( s );
+}
+
+//! State listener that counts TLS handshakes.
+struct handshakes_listener_t
+{
+	restinio::connection_state::tls_handshake_counters_t m_counters;
+
+	void
+	state_changed( const restinio::connection_state::notice_t & notice )
+	{
+		const auto cause = notice.cause();
+		if( auto * accepted = restinio::get_if<
+				restinio::connection_state::accepted_t >( &cause ) )
+		{
+			accepted->try_inspect_tls(
+				[this]( const restinio::connection_state::tls_accessor_t & tls ) {
+					m_counters.handshake_completed( tls );
+				} );
+		}
+	}
+};
+
+struct handshakes_test_traits_t
+	:	public restinio::tls_traits_t<
+			restinio::asio_timer_manager_t,
+			utest_logger_t >
+{
+	using connection_state_listener_t = handshakes_listener_t;
+};
+
+//! Connect to the test server and do a handshake.
+SSL_SESSION *
+connect_to_server(
+	asio_ns::ssl::context & client_ctx,
+	SSL_SESSION * session_to_resume )
+{
+	SSL_SESSION * result = nullptr;
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ) {
+		asio_ns::ssl::stream< asio_ns::ip::tcp::socket & > stream{
+			socket, client_ctx };
+
+		if( session_to_resume )
+			::SSL_set_session( stream.native_handle(), session_to_resume );
+
+		stream.handshake( asio_ns::ssl::stream_base::client );
+		result = ::SSL_get1_session( stream.native_handle() );
+
+		// The server doesn't reply with close_notify, so an error is expected.
+		asio_ns::error_code ec;
+		stream.shutdown( ec );
+	} );
+
+	return result;
+}
+
+TEST_CASE( "Handshake counters" , "[tls][session_cache][state_listener]" )
+{
+	test_certificate_t cert;
+
+	// Sessions are resumed by session id only.
+	auto server_ctx = cert.make_server_context();
+	::SSL_CTX_set_options( server_ctx.native_handle(), SSL_OP_NO_TICKET );
+
+	auto listener = std::make_shared< handshakes_listener_t >();
+	auto cache = std::make_shared< restinio::tls_session_cache_t >();
+
+	using http_server_t = restinio::http_server_t< handshakes_test_traits_t >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.tls_context( std::move( server_ctx ) )
+				.tls_session_cache( cache )
+				.connection_state_listener( listener )
+				.request_handler(
+					[]( auto ){ return restinio::request_rejected(); } );
+		}
+	};
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+	other_thread.run();
+
+	auto client_ctx = make_tls12_client_context();
+
+	auto * session = connect_to_server( client_ctx, nullptr );
+	REQUIRE( nullptr != session );
+	auto * second = connect_to_server( client_ctx, session );
+
+	auto & counters = listener->m_counters;
+	for( int i = 0; i < 100 && counters.full() + counters.resumed() < 2u; ++i )
+		std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+
+	other_thread.stop_and_join();
+
+	REQUIRE( 1u == counters.full() );
+	REQUIRE( 1u == counters.resumed() );
+	REQUIRE( 1u == cache->stats().m_hits );
+
+	::SSL_SESSION_free( session );
+	::SSL_SESSION_free( second );
+}
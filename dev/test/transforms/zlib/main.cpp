@@ -8,6 +8,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <thread>
+
 #include <restinio/all.hpp>
 #include <restinio/transforms/zlib.hpp>
 
@@ -646,3 +648,97 @@ TEST_CASE( "write check input size" , "[zlib][write][large input]" )
 		REQUIRE_THROWS( zc.write( large_input ) );
 	}
 }
+
+TEST_CASE( "stream pool" , "[zlib][pool]" )
+{
+	namespace rtz = restinio::transforms::zlib;
+
+	const std::string input_data = create_random_text( 64 * 1024, 16 );
+
+	// Fill the pool of current thread with suitable streams.
+	REQUIRE( input_data == rtz::gzip_decompress( rtz::gzip_compress( input_data ) ) );
+
+	{
+		const auto before = rtz::stream_pool_stats();
+
+		// Streams must be reused and give the same results.
+		for( int i = 0; i < 10; ++i )
+		{
+			REQUIRE( input_data ==
+				rtz::gzip_decompress( rtz::gzip_compress( input_data ) ) );
+		}
+
+		const auto after = rtz::stream_pool_stats();
+		REQUIRE( before.m_hits + 20u == after.m_hits );
+		REQUIRE( before.m_misses == after.m_misses );
+		REQUIRE( before.m_returned + 20u == after.m_returned );
+		REQUIRE( 0.0 < after.hit_rate() );
+	}
+
+	{
+		const auto before = rtz::stream_pool_stats();
+
+		// Streams with other params are not taken from the pool.
+		REQUIRE( input_data ==
+			rtz::deflate_decompress( rtz::deflate_compress( input_data, 3 ) ) );
+
+		const auto after = rtz::stream_pool_stats();
+		REQUIRE( before.m_misses + 1u == after.m_misses );
+	}
+
+	{
+		// Pooling is turned off by zero capacity.
+		const auto capacity = rtz::stream_pool_capacity();
+		rtz::stream_pool_capacity( 0u );
+
+		REQUIRE( input_data ==
+			rtz::gzip_decompress( rtz::gzip_compress( input_data ) ) );
+
+		const auto before = rtz::stream_pool_stats();
+		REQUIRE( input_data ==
+			rtz::gzip_decompress( rtz::gzip_compress( input_data ) ) );
+		const auto after = rtz::stream_pool_stats();
+
+		REQUIRE( before.m_misses + 2u == after.m_misses );
+		REQUIRE( before.m_dropped + 2u == after.m_dropped );
+		REQUIRE( before.m_returned == after.m_returned );
+
+		rtz::stream_pool_capacity( capacity );
+	}
+
+	{
+		// Stream that was broken by invalid input can be reused.
+		REQUIRE_THROWS( rtz::gzip_decompress( "not a gzip data" ) );
+		REQUIRE( input_data ==
+			rtz::gzip_decompress( rtz::gzip_compress( input_data ) ) );
+	}
+}
+
+TEST_CASE( "zlib_t outlives the stream pool" , "[zlib][pool][lifetime]" )
+{
+	namespace rtz = restinio::transforms::zlib;
+
+	// Holder is constructed before the pool of the thread,
+	// so it is destroyed after the pool on thread exit.
+	struct holder_t
+	{
+		std::unique_ptr< rtz::zlib_t > m_zlib;
+	};
+
+	const auto before = rtz::stream_pool_stats();
+
+	std::thread thread{ [] {
+			thread_local holder_t holder;
+
+			holder.m_zlib = std::make_unique< rtz::zlib_t >(
+					rtz::make_gzip_compress_params() );
+			holder.m_zlib->write( "Hello, world" );
+		} };
+	thread.join();
+
+	const auto after = rtz::stream_pool_stats();
+
+	// The stream isn't returned to the destroyed pool.
+	REQUIRE( before.m_returned == after.m_returned );
+	REQUIRE( before.m_dropped + 1u == after.m_dropped );
+}
@@ -707,3 +707,165 @@ TEST_CASE( "chunked_output" , "[zlib][body_appender][chunked_output]" )
 
 	other_thread.stop_and_join();
 }
+
+//! Get a body of chunked response and a count of non-empty chunks.
+std::pair< std::string, std::size_t >
+decode_chunked_body( const std::string & response )
+{
+	std::pair< std::string, std::size_t > result{ std::string{}, 0u };
+
+	auto pos = response.find( "\r\n\r\n" );
+	REQUIRE( std::string::npos != pos );
+	pos += 4;
+
+	while( true )
+	{
+		const auto size_end = response.find( "\r\n", pos );
+		REQUIRE( std::string::npos != size_end );
+
+		const auto chunk_size = static_cast< std::size_t >(
+			std::stoul( response.substr( pos, size_end - pos ), nullptr, 16 ) );
+
+		if( 0u == chunk_size )
+			break;
+
+		result.first.append( response, size_end + 2, chunk_size );
+		++result.second;
+		pos = size_end + 2 + chunk_size + 2;
+	}
+
+	return result;
+}
+
+TEST_CASE( "streaming output" , "[zlib][body_appender][streaming]" )
+{
+	std::srand( static_cast<unsigned int>(std::time( nullptr )) );
+
+	const auto response_body = create_random_text( 512 * 1024, 16 );
+
+	using router_t = restinio::router::express_router_t<>;
+
+	auto router = std::make_unique< router_t >();
+
+	namespace rtz = restinio::transforms::zlib;
+
+	const auto params =
+		rtz::make_gzip_compress_params()
+			.streaming_block_size( 4 * 1024 );
+
+	router->http_get(
+		R"-(/chunked)-",
+		[ & ]( const restinio::request_handle_t& req, auto ){
+				auto resp = req->create_response< restinio::chunked_output_t >();
+
+				resp
+					.append_header( "Server", "RESTinio Benchmark" )
+					.append_header( "Content-Type", "text/plain; charset=utf-8" );
+
+				auto ba = rtz::body_appender( resp, params );
+
+				ba.append( response_body );
+				ba.complete();
+
+				return resp.done();
+		} );
+
+	router->http_get(
+		R"-(/user_controlled)-",
+		[ & ]( const restinio::request_handle_t& req, auto ){
+				auto resp = req->create_response< restinio::user_controlled_output_t >();
+
+				resp
+					.append_header( "Server", "RESTinio Benchmark" )
+					.append_header( "Content-Type", "text/plain; charset=utf-8" );
+
+				auto ba = rtz::body_appender( resp, params );
+
+				ba.append( response_body );
+				ba.complete();
+
+				return resp.done();
+		} );
+
+	using http_server_t =
+		restinio::http_server_t<
+			restinio::traits_t<
+				restinio::asio_timer_manager_t,
+				utest_logger_t,
+				router_t > >;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler( std::move( router ) );
+		}
+	};
+
+	other_work_thread_for_server_t<http_server_t> other_thread{ http_server };
+	other_thread.run();
+
+	{
+		const std::string request{
+				"GET /chunked HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Connection: close\r\n"
+				"\r\n"
+		};
+		std::string response;
+
+		REQUIRE_NOTHROW( response = do_request( request ) );
+
+		REQUIRE_THAT(
+			response,
+			Catch::Matchers::Contains( "Content-Encoding: gzip\r\n" ) );
+
+		const auto body = decode_chunked_body( response );
+
+		// Compressed data must be sent by several blocks.
+		REQUIRE( 1u < body.second );
+		REQUIRE( response_body == rtz::gzip_decompress( body.first ) );
+	}
+
+	{
+		const std::string request{
+				"GET /user_controlled HTTP/1.0\r\n"
+				"Connection: close\r\n"
+				"\r\n"
+		};
+		std::string response;
+
+		REQUIRE_NOTHROW( response = do_request( request ) );
+
+		REQUIRE_THAT(
+			response,
+			Catch::Matchers::Contains( "Content-Encoding: gzip\r\n" ) );
+
+		const auto body_start = response.find( "\r\n\r\n" ) + 4;
+
+		REQUIRE(
+			response_body ==
+			rtz::gzip_decompress(
+				restinio::string_view_t{
+					response.data() + body_start,
+					response.size() - body_start } ) );
+	}
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "streaming block size" , "[zlib][params][streaming]" )
+{
+	namespace rtz = restinio::transforms::zlib;
+
+	REQUIRE( 0u == rtz::make_gzip_compress_params().streaming_block_size() );
+
+	REQUIRE_THROWS( rtz::make_gzip_compress_params().streaming_block_size( 5u ) );
+
+	REQUIRE( 1024u ==
+		rtz::make_gzip_compress_params()
+			.streaming_block_size( 1024u )
+			.streaming_block_size() );
+}
@@ -474,3 +474,46 @@ TEST_CASE( "Query string with only web-beacon" , "[web-beacon]" )
 	}
 }
 
+
+TEST_CASE( "Query string view" , "[query_string_view]" )
+{
+	const std::string query{
+		"a=1&b=text+with%20spaces;my%20key=42&neg=-7&tag&"
+		"f=3.5&empty=&a=2&long=" + std::string( 100u, 'x' ) + "%21" };
+
+	restinio::query_string_view_t<> qs{ query };
+
+	REQUIRE( qs.has( "a" ) );
+	REQUIRE( qs.has( "my key" ) );
+	REQUIRE( qs.has( "empty" ) );
+	REQUIRE_FALSE( qs.has( "tag" ) );
+	REQUIRE_FALSE( qs.has( "c" ) );
+	REQUIRE_FALSE( qs.has( "my%20key" ) );
+
+	// The first value is used.
+	REQUIRE( 1 == qs.get< int >( "a" ) );
+	REQUIRE( 42u == qs.get< std::uint32_t >( "my key" ) );
+	REQUIRE( -7 == *qs.get_param< std::int64_t >( "neg" ) );
+	REQUIRE( 3.5 == qs.get< double >( "f" ) );
+	REQUIRE( "text with spaces" == qs.get< std::string >( "b" ) );
+	REQUIRE( "text+with%20spaces" == *qs.raw_param( "b" ) );
+	REQUIRE( qs.get< std::string >( "empty" ).empty() );
+	REQUIRE( std::string( 100u, 'x' ) + "!" == qs.get< std::string >( "long" ) );
+
+	REQUIRE_FALSE( qs.get_param< int >( "c" ) );
+	REQUIRE_THROWS( qs.get< int >( "c" ) );
+	REQUIRE_THROWS( qs.get< int >( "b" ) );
+
+	const std::string bad{ "x=%2" };
+	REQUIRE_THROWS( restinio::query_string_view_t<>{ bad }.get< std::string >( "x" ) );
+
+	const std::string js{ "x=A*" };
+	REQUIRE_THROWS(
+		restinio::query_string_view_t<>{ js }.get< std::string >( "x" ) );
+	REQUIRE( "A*" ==
+		restinio::query_string_view_t<
+				restinio::parse_query_traits::javascript_compatible >{ js }
+			.get< std::string >( "x" ) );
+
+	REQUIRE_FALSE( restinio::query_string_view_t<>{ "" }.has( "a" ) );
+}
@@ -0,0 +1,408 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for broadcast_hub_t.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <restinio/all.hpp>
+#include <restinio/websocket/broadcast_hub.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+namespace rws = restinio::websocket::basic;
+
+restinio::write_group_t
+make_write_group( std::string data )
+{
+	restinio::writable_items_container_t bufs;
+	bufs.emplace_back( std::move( data ) );
+
+	return restinio::write_group_t{ std::move( bufs ) };
+}
+
+std::string
+pop_data( rws::impl::ws_outgoing_data_t & outgoing_data )
+{
+	auto wg = outgoing_data.pop_ready_buffers();
+	REQUIRE( wg );
+
+	const auto buf = wg->items().front().buf();
+	return std::string{ static_cast< const char * >( buf.data() ), buf.size() };
+}
+
+TEST_CASE( "Outgoing data with shared frames" , "[ws_outgoing_data]" )
+{
+	rws::impl::ws_outgoing_data_t outgoing_data;
+	const int first_source = 0;
+	const int second_source = 1;
+
+	auto wg = make_write_group( "1" );
+	REQUIRE_FALSE( outgoing_data.replace( wg, &first_source ) );
+	REQUIRE( 0u == outgoing_data.queue_depth() );
+
+	outgoing_data.append( std::move( wg ), &first_source );
+	outgoing_data.append( make_write_group( "2" ) );
+	outgoing_data.append( make_write_group( "3" ), &second_source );
+	outgoing_data.append( make_write_group( "4" ), &first_source );
+	outgoing_data.append( make_write_group( "5" ) );
+	REQUIRE( 5u == outgoing_data.queue_depth() );
+	REQUIRE( 5u == outgoing_data.queued_bytes() );
+
+	// The latest awaiting frame of the source is replaced.
+	wg = make_write_group( "666" );
+	REQUIRE( outgoing_data.replace( wg, &first_source ) );
+	REQUIRE( 5u == outgoing_data.queue_depth() );
+	REQUIRE( 7u == outgoing_data.queued_bytes() );
+
+	REQUIRE( "1" == pop_data( outgoing_data ) );
+	REQUIRE( "2" == pop_data( outgoing_data ) );
+	REQUIRE( "3" == pop_data( outgoing_data ) );
+	REQUIRE( "666" == pop_data( outgoing_data ) );
+	REQUIRE( 1u == outgoing_data.queued_bytes() );
+	REQUIRE( "5" == pop_data( outgoing_data ) );
+	REQUIRE( 0u == outgoing_data.queue_depth() );
+	REQUIRE( 0u == outgoing_data.queued_bytes() );
+	REQUIRE_FALSE( outgoing_data.pop_ready_buffers() );
+}
+
+using traits_t =
+	restinio::traits_t<
+		restinio::asio_timer_manager_t,
+		utest_logger_t >;
+
+using http_server_t = restinio::http_server_t< traits_t >;
+
+//! Websockets accepted by the server.
+struct websockets_t
+{
+	std::mutex m_lock;
+	std::vector< rws::ws_handle_t > m_handles;
+	std::vector< std::string > m_close_statuses;
+
+	void
+	add( rws::ws_handle_t wsh )
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		m_handles.push_back( std::move( wsh ) );
+	}
+
+	rws::ws_handle_t
+	at( std::size_t index )
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_handles.at( index );
+	}
+
+	std::size_t
+	size()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_handles.size();
+	}
+
+	void
+	add_close_status( rws::status_code_t status )
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		m_close_statuses.push_back( rws::status_code_to_bin( status ) );
+	}
+
+	std::vector< std::string >
+	close_statuses()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_close_statuses;
+	}
+
+	void
+	clear()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		m_handles.clear();
+	}
+};
+
+auto
+make_server( websockets_t & websockets )
+{
+	return std::make_unique< http_server_t >(
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[&]( auto req ){
+						websockets.add( rws::upgrade< traits_t >(
+								*req,
+								rws::activation_t::immediate,
+								[&]( rws::ws_handle_t, rws::message_handle_t m ){
+									if( rws::opcode_t::connection_close_frame ==
+										m->opcode() )
+									{
+										websockets.add_close_status(
+											rws::status_code_from_bin( m->payload() ) );
+									}
+								} ) );
+
+						return restinio::request_accepted();
+					} );
+		} );
+}
+
+template< typename Predicate >
+void
+wait_for( Predicate && predicate )
+{
+	for( int i = 0; i != 1000 && !predicate(); ++i )
+		std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+	REQUIRE( predicate() );
+}
+
+void
+upgrade_socket(
+	restinio::asio_ns::ip::tcp::socket & socket,
+	websockets_t & websockets,
+	std::size_t expected_count )
+{
+	restinio::asio_ns::write( socket, restinio::asio_ns::buffer( std::string{
+			"GET /chat HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Upgrade: websocket\r\n"
+			"Connection: Upgrade\r\n"
+			"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+			"Sec-WebSocket-Version: 13\r\n"
+			"\r\n" } ) );
+
+	restinio::asio_ns::streambuf response_buf;
+	const auto header_size = restinio::asio_ns::read_until(
+			socket, response_buf, "\r\n\r\n" );
+	REQUIRE( response_buf.size() == header_size );
+
+	wait_for( [&]{ return expected_count == websockets.size(); } );
+}
+
+//! Read an unmasked frame with a short payload.
+std::string
+read_frame( restinio::asio_ns::ip::tcp::socket & socket, rws::opcode_t opcode )
+{
+	std::array< unsigned char, 2 > header;
+	restinio::asio_ns::read( socket, restinio::asio_ns::buffer( header ) );
+
+	REQUIRE( 0x80u == ( header[ 0 ] & 0xF0u ) );
+	REQUIRE( opcode == static_cast< rws::opcode_t >( header[ 0 ] & 0x0Fu ) );
+
+	const auto size = header[ 1 ] & 0x7Fu;
+	REQUIRE( size < 126u );
+
+	std::string payload( size, '\0' );
+	restinio::asio_ns::read( socket, restinio::asio_ns::buffer( &payload[ 0 ], size ) );
+
+	return payload;
+}
+
+TEST_CASE( "Broadcast" , "[broadcast_hub]" )
+{
+	websockets_t websockets;
+	auto http_server = make_server( websockets );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	rws::broadcast_hub_t hub;
+
+	do_with_socket( [&]( auto & first, auto & /*io_context*/ ){
+		upgrade_socket( first, websockets, 1u );
+
+		do_with_socket( [&]( auto & second, auto & /*io_context*/ ){
+			upgrade_socket( second, websockets, 2u );
+
+			REQUIRE( hub.subscribe( websockets.at( 0u ) ) );
+			REQUIRE( hub.subscribe( websockets.at( 1u ) ) );
+			REQUIRE_FALSE( hub.subscribe( websockets.at( 1u ) ) );
+			REQUIRE( 2u == hub.subscribers_count() );
+
+			hub.broadcast( rws::opcode_t::text_frame, "Hello" );
+			hub.broadcast( rws::message_t{
+					rws::final_frame, rws::opcode_t::binary_frame, "World" } );
+
+			REQUIRE_THROWS( hub.broadcast(
+					rws::opcode_t::connection_close_frame, "" ) );
+			REQUIRE_THROWS( hub.broadcast(
+					rws::opcode_t::continuation_frame, "" ) );
+
+			for( auto * socket : { &first, &second } )
+			{
+				REQUIRE( "Hello" == read_frame( *socket, rws::opcode_t::text_frame ) );
+				REQUIRE( "World" == read_frame( *socket, rws::opcode_t::binary_frame ) );
+			}
+
+			REQUIRE( hub.unsubscribe( websockets.at( 0u ) ) );
+			REQUIRE_FALSE( hub.unsubscribe( websockets.at( 0u ) ) );
+			REQUIRE( 1u == hub.subscribers_count() );
+
+			hub.broadcast( rws::opcode_t::ping_frame, "1" );
+			REQUIRE( "1" == read_frame( second, rws::opcode_t::ping_frame ) );
+
+			// Websockets are still usable for ordinary messages.
+			websockets.at( 0u )->send_message(
+				rws::final_frame, rws::opcode_t::text_frame, "2" );
+			REQUIRE( "2" == read_frame( first, rws::opcode_t::text_frame ) );
+
+			// Subscribers with destroyed ws_t are skipped.
+			const auto id = websockets.at( 1u )->connection_id();
+			websockets.clear();
+			hub.broadcast( rws::opcode_t::text_frame, "Skipped" );
+			REQUIRE( hub.unsubscribe( id ) );
+			REQUIRE( 0u == hub.subscribers_count() );
+		} );
+	} );
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Broadcast to a closing websocket" , "[broadcast_hub]" )
+{
+	websockets_t websockets;
+	auto http_server = make_server( websockets );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	rws::broadcast_hub_t hub;
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		upgrade_socket( socket, websockets, 1u );
+
+		auto ws = websockets.at( 0u );
+		const auto id = ws->connection_id();
+		REQUIRE( hub.subscribe( ws ) );
+
+		// Handlers posted by broadcast() don't touch ws_t,
+		// so it can be killed by its owner at the same time.
+		std::atomic< bool > stop{ false };
+		std::thread producer{ [&] {
+				while( !stop.load() )
+					hub.broadcast( rws::opcode_t::text_frame, "Hello" );
+			} };
+
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+		ws->kill();
+		std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+
+		stop = true;
+		producer.join();
+
+		// The connection is closed.
+		std::vector< char > buf( 64u * 1024u );
+		restinio::asio_ns::error_code ec;
+		while( !ec )
+			socket.read_some( restinio::asio_ns::buffer( buf ), ec );
+
+		REQUIRE( hub.unsubscribe( id ) );
+	} );
+
+	websockets.clear();
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Unsubscribe a closed websocket" , "[broadcast_hub]" )
+{
+	websockets_t websockets;
+	auto http_server = make_server( websockets );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	rws::broadcast_hub_t hub;
+
+	do_with_socket( [&]( auto & first, auto & /*io_context*/ ){
+		upgrade_socket( first, websockets, 1u );
+
+		do_with_socket( [&]( auto & second, auto & /*io_context*/ ){
+			upgrade_socket( second, websockets, 2u );
+
+			auto shut_down = websockets.at( 0u );
+			auto killed = websockets.at( 1u );
+			REQUIRE( hub.subscribe( shut_down ) );
+			REQUIRE( hub.subscribe( killed ) );
+
+			shut_down->shutdown();
+			killed->kill();
+			REQUIRE( 0u == shut_down->connection_id() );
+			REQUIRE( 0u == killed->connection_id() );
+
+			// Websockets are found by the ids they were subscribed with.
+			REQUIRE( hub.unsubscribe( shut_down ) );
+			REQUIRE_FALSE( hub.unsubscribe( shut_down ) );
+			REQUIRE( hub.unsubscribe( killed ) );
+			REQUIRE( 0u == hub.subscribers_count() );
+
+			// A closed websocket can't be subscribed again.
+			REQUIRE_THROWS( hub.subscribe( shut_down ) );
+			REQUIRE( 0u == hub.subscribers_count() );
+		} );
+	} );
+
+	websockets.clear();
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Slow consumer policy" , "[broadcast_hub]" )
+{
+	websockets_t websockets;
+	auto http_server = make_server( websockets );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	// Every subscriber is treated as a slow consumer.
+	rws::broadcast_hub_t dropping_hub{
+		rws::subscriber_settings_t{}.max_queue_depth( 0u ) };
+	rws::broadcast_hub_t hub;
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		upgrade_socket( socket, websockets, 1u );
+
+		REQUIRE( rws::slow_consumer_policy_t::drop ==
+			rws::subscriber_settings_t{}.slow_consumer_policy() );
+		REQUIRE( dropping_hub.subscribe( websockets.at( 0u ) ) );
+		REQUIRE( hub.subscribe( websockets.at( 0u ) ) );
+
+		dropping_hub.broadcast( rws::opcode_t::text_frame, "Dropped" );
+		hub.broadcast( rws::opcode_t::text_frame, "Sent" );
+
+		REQUIRE( "Sent" == read_frame( socket, rws::opcode_t::text_frame ) );
+
+		REQUIRE( dropping_hub.unsubscribe( websockets.at( 0u ) ) );
+		REQUIRE( dropping_hub.subscribe(
+				websockets.at( 0u ),
+				rws::subscriber_settings_t{}
+					.max_queue_depth( 0u )
+					.slow_consumer_policy( rws::slow_consumer_policy_t::disconnect ) ) );
+
+		dropping_hub.broadcast( rws::opcode_t::text_frame, "Disconnected" );
+
+		// Connection is closed without a close frame.
+		std::array< char, 16 > buf;
+		restinio::asio_ns::error_code ec;
+		restinio::asio_ns::read( socket, restinio::asio_ns::buffer( buf ), ec );
+		REQUIRE( ec );
+
+		wait_for( [&]{ return 1u == websockets.close_statuses().size(); } );
+		REQUIRE( rws::status_code_to_bin( rws::status_code_t::policy_violation ) ==
+			websockets.close_statuses().front() );
+	} );
+
+	websockets.clear();
+
+	other_thread.stop_and_join();
+}
@@ -0,0 +1,384 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for limits of the outgoing queue of websocket.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <future>
+
+#include <restinio/all.hpp>
+#include <restinio/websocket/websocket.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+namespace rws = restinio::websocket::basic;
+
+using traits_t =
+	restinio::traits_t<
+		restinio::asio_timer_manager_t,
+		utest_logger_t >;
+
+using http_server_t = restinio::http_server_t< traits_t >;
+
+//! Size of a message sent by the server.
+constexpr std::size_t message_size = 512u * 1024u;
+
+//! Size of a frame with the message (the header has 64-bit length).
+constexpr std::size_t frame_size = message_size + 10u;
+
+//! Count of messages that surely fill socket buffers.
+constexpr std::size_t message_count = 64u;
+
+//! Websocket accepted by the server.
+struct websocket_t
+{
+	std::mutex m_lock;
+	rws::ws_handle_t m_handle;
+	std::vector< std::string > m_close_statuses;
+
+	rws::ws_handle_t
+	handle()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_handle;
+	}
+
+	std::vector< std::string >
+	close_statuses()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		return m_close_statuses;
+	}
+
+	void
+	reset()
+	{
+		std::lock_guard< std::mutex > lock{ m_lock };
+		m_handle.reset();
+	}
+};
+
+auto
+make_server( websocket_t & websocket )
+{
+	return std::make_unique< http_server_t >(
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[&]( auto req ){
+						auto wsh = rws::upgrade< traits_t >(
+								*req,
+								rws::activation_t::immediate,
+								[&]( rws::ws_handle_t, rws::message_handle_t m ){
+									if( rws::opcode_t::connection_close_frame ==
+										m->opcode() )
+									{
+										std::lock_guard< std::mutex > lock{ websocket.m_lock };
+										websocket.m_close_statuses.push_back( m->payload() );
+									}
+								} );
+
+						std::lock_guard< std::mutex > lock{ websocket.m_lock };
+						websocket.m_handle = std::move( wsh );
+
+						return restinio::request_accepted();
+					} );
+		} );
+}
+
+template< typename Predicate >
+void
+wait_for( Predicate && predicate )
+{
+	for( int i = 0; i != 1000 && !predicate(); ++i )
+		std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+
+	REQUIRE( predicate() );
+}
+
+void
+upgrade_socket(
+	restinio::asio_ns::ip::tcp::socket & socket,
+	websocket_t & websocket )
+{
+	restinio::asio_ns::write( socket, restinio::asio_ns::buffer( std::string{
+			"GET /chat HTTP/1.1\r\n"
+			"Host: 127.0.0.1\r\n"
+			"Upgrade: websocket\r\n"
+			"Connection: Upgrade\r\n"
+			"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+			"Sec-WebSocket-Version: 13\r\n"
+			"\r\n" } ) );
+
+	restinio::asio_ns::streambuf response_buf;
+	const auto header_size = restinio::asio_ns::read_until(
+			socket, response_buf, "\r\n\r\n" );
+	REQUIRE( response_buf.size() == header_size );
+
+	wait_for( [&]{ return !!websocket.handle(); } );
+}
+
+void
+send_messages(
+	rws::ws_t & ws,
+	rws::final_frame_flag_t final_flag = rws::final_frame,
+	rws::opcode_t opcode = rws::opcode_t::binary_frame )
+{
+	const auto payload = std::make_shared< std::string >( message_size, 'x' );
+
+	for( std::size_t i = 0; i != message_count; ++i )
+		ws.send_message(
+			final_flag,
+			opcode,
+			restinio::writable_item_t{ payload } );
+}
+
+//! Wait for the result of a write status callback.
+restinio::asio_ns::error_code
+get_write_result( std::promise< restinio::asio_ns::error_code > & result )
+{
+	auto future = result.get_future();
+	REQUIRE( std::future_status::ready ==
+		future.wait_for( std::chrono::seconds( 5 ) ) );
+
+	return future.get();
+}
+
+//! Read data from socket until the given amount is read or an error occurs.
+std::size_t
+read_data( restinio::asio_ns::ip::tcp::socket & socket, std::size_t amount )
+{
+	std::vector< char > buf( 64u * 1024u );
+
+	std::size_t total = 0u;
+	restinio::asio_ns::error_code ec;
+	while( total < amount && !ec )
+	{
+		total += socket.read_some(
+			restinio::asio_ns::buffer(
+				buf.data(), std::min( buf.size(), amount - total ) ),
+			ec );
+	}
+
+	return total;
+}
+
+TEST_CASE( "Limits" , "[outgoing_queue]" )
+{
+	REQUIRE_THROWS( rws::outgoing_queue_limits_t{}.watermarks( 2u, 1u ) );
+
+	const rws::outgoing_queue_limits_t limits;
+	REQUIRE( rws::queue_overflow_policy_t::accept == limits.overflow_policy() );
+	REQUIRE( limits.low_watermark() == limits.high_watermark() );
+	REQUIRE_FALSE( limits.writable_again_handler() );
+}
+
+TEST_CASE( "Watermarks and drop policy" , "[outgoing_queue]" )
+{
+	websocket_t websocket;
+	auto http_server = make_server( websocket );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		upgrade_socket( socket, websocket );
+		auto ws = websocket.handle();
+
+		REQUIRE( ws->is_writable() );
+		REQUIRE( 0u == ws->outgoing_queue_stats().m_queue_depth );
+		REQUIRE( 0u == ws->outgoing_queue_stats().m_queued_bytes );
+
+		std::promise< bool > writable_again;
+		auto limits = rws::outgoing_queue_limits_t{}
+			.watermarks( frame_size, 4u * frame_size )
+			.writable_again_handler( [&]( rws::ws_handle_t wsh ) {
+					writable_again.set_value( wsh->is_writable() );
+				} );
+		ws->set_outgoing_queue_limits( limits );
+
+		send_messages( *ws );
+
+		// The client doesn't read, so data is accumulated in the queue.
+		wait_for( [&]{ return !ws->is_writable(); } );
+		REQUIRE( 4u * frame_size <= ws->outgoing_queue_stats().m_queued_bytes );
+		REQUIRE( 4u <= ws->outgoing_queue_stats().m_queue_depth );
+
+		// New messages are dropped from now on.
+		ws->set_outgoing_queue_limits(
+			std::move( limits ).overflow_policy( rws::queue_overflow_policy_t::drop ) );
+
+		std::promise< restinio::asio_ns::error_code > dropped;
+		ws->send_message(
+			rws::final_frame,
+			rws::opcode_t::text_frame,
+			restinio::writable_item_t{ std::string{ "Dropped" } },
+			[&]( const auto & ec ) { dropped.set_value( ec ); } );
+
+		auto dropped_result = dropped.get_future();
+		REQUIRE( std::future_status::ready ==
+			dropped_result.wait_for( std::chrono::seconds( 5 ) ) );
+		REQUIRE( restinio::make_asio_compaible_error(
+				restinio::asio_convertible_error_t::write_was_not_executed ) ==
+			dropped_result.get() );
+
+		REQUIRE( message_count * frame_size ==
+			read_data( socket, message_count * frame_size ) );
+
+		auto writable_again_result = writable_again.get_future();
+		REQUIRE( std::future_status::ready ==
+			writable_again_result.wait_for( std::chrono::seconds( 5 ) ) );
+		REQUIRE( writable_again_result.get() );
+
+		wait_for( [&]{ return 0u == ws->outgoing_queue_stats().m_queued_bytes; } );
+		REQUIRE( 0u == ws->outgoing_queue_stats().m_queue_depth );
+		REQUIRE( ws->is_writable() );
+
+		// Messages are accepted again.
+		ws->send_message(
+			rws::final_frame, rws::opcode_t::text_frame, "Sent" );
+
+		std::array< char, 6 > frame;
+		restinio::asio_ns::read( socket, restinio::asio_ns::buffer( frame ) );
+		REQUIRE( "\x81\x04Sent" == std::string( frame.data(), frame.size() ) );
+	} );
+
+	websocket.reset();
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Fragmented messages and drop policy" , "[outgoing_queue]" )
+{
+	websocket_t websocket;
+	auto http_server = make_server( websocket );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		upgrade_socket( socket, websocket );
+		auto ws = websocket.handle();
+
+		auto limits = rws::outgoing_queue_limits_t{}
+			.watermarks( frame_size, 4u * frame_size );
+		ws->set_outgoing_queue_limits( limits );
+
+		// A fragmented message is started while the queue is empty
+		// and its continuation frames fill the queue.
+		ws->send_message(
+			rws::not_final_frame, rws::opcode_t::binary_frame, "A1" );
+		send_messages(
+			*ws, rws::not_final_frame, rws::opcode_t::continuation_frame );
+
+		wait_for( [&]{ return !ws->is_writable(); } );
+
+		ws->set_outgoing_queue_limits(
+			std::move( limits ).overflow_policy( rws::queue_overflow_policy_t::drop ) );
+
+		// The started message isn't cut in the middle.
+		std::promise< restinio::asio_ns::error_code > finished;
+		ws->send_message(
+			rws::final_frame,
+			rws::opcode_t::continuation_frame,
+			restinio::writable_item_t{ std::string{ "A2" } },
+			[&]( const auto & ec ) { finished.set_value( ec ); } );
+
+		// A message started above the high watermark is dropped as a whole.
+		std::promise< restinio::asio_ns::error_code > dropped_first;
+		ws->send_message(
+			rws::not_final_frame,
+			rws::opcode_t::text_frame,
+			restinio::writable_item_t{ std::string{ "B1" } },
+			[&]( const auto & ec ) { dropped_first.set_value( ec ); } );
+
+		std::promise< restinio::asio_ns::error_code > dropped_last;
+		ws->send_message(
+			rws::final_frame,
+			rws::opcode_t::continuation_frame,
+			restinio::writable_item_t{ std::string{ "B2" } },
+			[&]( const auto & ec ) { dropped_last.set_value( ec ); } );
+
+		const auto not_executed = restinio::make_asio_compaible_error(
+				restinio::asio_convertible_error_t::write_was_not_executed );
+		REQUIRE( not_executed == get_write_result( dropped_first ) );
+		REQUIRE( not_executed == get_write_result( dropped_last ) );
+
+		// The last frame of the started message waits in the queue.
+		auto finished_result = finished.get_future();
+		REQUIRE( std::future_status::timeout ==
+			finished_result.wait_for( std::chrono::seconds( 0 ) ) );
+
+		std::array< char, 4 > first_frame;
+		restinio::asio_ns::read( socket, restinio::asio_ns::buffer( first_frame ) );
+		REQUIRE( "\x02\x02" "A1" ==
+			std::string( first_frame.data(), first_frame.size() ) );
+
+		REQUIRE( message_count * frame_size ==
+			read_data( socket, message_count * frame_size ) );
+
+		std::array< char, 4 > last_frame;
+		restinio::asio_ns::read( socket, restinio::asio_ns::buffer( last_frame ) );
+		REQUIRE( "\x80\x02" "A2" ==
+			std::string( last_frame.data(), last_frame.size() ) );
+
+		REQUIRE( std::future_status::ready ==
+			finished_result.wait_for( std::chrono::seconds( 5 ) ) );
+		REQUIRE_FALSE( finished_result.get() );
+
+		wait_for( [&]{ return ws->is_writable(); } );
+
+		// Nothing is left from the dropped message.
+		ws->send_message(
+			rws::final_frame, rws::opcode_t::text_frame, "Sent" );
+
+		std::array< char, 6 > frame;
+		restinio::asio_ns::read( socket, restinio::asio_ns::buffer( frame ) );
+		REQUIRE( "\x81\x04Sent" == std::string( frame.data(), frame.size() ) );
+	} );
+
+	websocket.reset();
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Close policy" , "[outgoing_queue]" )
+{
+	websocket_t websocket;
+	auto http_server = make_server( websocket );
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ *http_server };
+	other_thread.run();
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		upgrade_socket( socket, websocket );
+		auto ws = websocket.handle();
+
+		ws->set_outgoing_queue_limits(
+			rws::outgoing_queue_limits_t{}
+				.watermarks( 0u, 4u * frame_size )
+				.overflow_policy( rws::queue_overflow_policy_t::close ) );
+
+		send_messages( *ws );
+
+		// The connection is closed without sending the whole queue.
+		REQUIRE( message_count * frame_size >
+			read_data( socket, message_count * frame_size ) );
+
+		wait_for( [&]{ return 1u == websocket.close_statuses().size(); } );
+		REQUIRE( rws::status_code_to_bin( rws::status_code_t::policy_violation ) ==
+			websocket.close_statuses().front() );
+	} );
+
+	websocket.reset();
+
+	other_thread.stop_and_join();
+}
@@ -97,6 +97,45 @@ TEST_CASE( "Validate mask and unmask operations" , "[websocket][parser][mask]" )
 	REQUIRE( bin_data == unmasked_bin_data_etalon );
 }
 
+TEST_CASE( "All implementations of masking" , "[websocket][parser][mask][vectorized]" )
+{
+	using namespace restinio::websocket::basic::impl::vectorized;
+
+	const mask_t mask{ { 0x37, 0xFA, 0x21, 0x3D } };
+
+	std::string source;
+	for( std::size_t i = 0; i != 300; ++i )
+		source += static_cast< char >( i * 7 );
+
+	const implementation_t impls[] = {
+		implementation_t::word,
+		implementation_t::sse2,
+		implementation_t::avx2
+	};
+
+	for( const auto impl : impls )
+	{
+		// AVX2 is not available on every CPU.
+		if( implementation_t::avx2 == impl &&
+				implementation_t::avx2 != best_implementation() )
+			continue;
+
+		for( std::size_t offset = 0; offset != 4; ++offset )
+			for( std::size_t start = 0; start != 5; ++start )
+			{
+				auto etalon = source;
+				mask_unmask( implementation_t::scalar, mask, offset,
+						&etalon[ start ], etalon.size() - start );
+
+				auto data = source;
+				mask_unmask( impl, mask, offset,
+						&data[ start ], data.size() - start );
+
+				REQUIRE( etalon == data );
+			}
+	}
+}
+
 TEST_CASE( "Reset parser" , "[websocket][parser][reset]" )
 {
 	raw_data_t bin_data{ to_char_each({0x81, 0x05}) };
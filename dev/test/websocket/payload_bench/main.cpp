@@ -0,0 +1,162 @@
+/*
+	restinio
+*/
+
+/*!
+	Benchmark for masking and UTF-8 validation of websocket payload.
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include <restinio/websocket/impl/utf8.hpp>
+#include <restinio/websocket/impl/vectorized_ops.hpp>
+
+using namespace restinio::websocket::basic::impl;
+
+// The byte by byte masking as it was implemented before vectorization.
+void
+byte_by_byte_mask_unmask( const vectorized::mask_t & mask, std::string & payload )
+{
+	const std::size_t MASK_SIZE = 4;
+
+	const auto payload_size = payload.size();
+	for( std::size_t i = 0; i < payload_size; )
+	{
+		for( std::size_t j = 0; j < MASK_SIZE && i < payload_size; ++j, ++i )
+		{
+			payload[ i ] ^= mask[ j ];
+		}
+	}
+}
+
+// The byte by byte UTF-8 check as it was implemented before vectorization.
+bool
+byte_by_byte_utf8_check( const std::string & text )
+{
+	utf8_checker_t checker;
+
+	for( const auto & ch : text )
+	{
+		if( !checker.process_byte( static_cast<std::uint8_t>(ch) ) )
+			return false;
+	}
+
+	return checker.final();
+}
+
+template < typename Lambda >
+void
+run_bench(
+	const char * name,
+	std::size_t iterations,
+	std::size_t bytes,
+	Lambda && lambda )
+{
+	const auto started_at = std::chrono::steady_clock::now();
+
+	for( std::size_t i = 0; i < iterations; ++i )
+		lambda();
+
+	const auto finished_at = std::chrono::steady_clock::now();
+
+	const double seconds = std::chrono::duration< double >(
+			finished_at - started_at ).count();
+
+	std::cout << std::setw( 32 ) << std::left << name << ": "
+		<< std::setw( 10 ) << std::right << std::fixed << std::setprecision( 1 )
+		<< static_cast< double >( bytes * iterations ) / seconds / 1e6
+		<< " MB/s" << std::endl;
+}
+
+const char *
+impl_name( vectorized::implementation_t impl )
+{
+	switch( impl )
+	{
+		case vectorized::implementation_t::scalar: return "scalar";
+		case vectorized::implementation_t::word: return "word";
+		case vectorized::implementation_t::sse2: return "sse2";
+		case vectorized::implementation_t::avx2: return "avx2";
+	}
+
+	return "unknown";
+}
+
+int
+main( int argc, const char *argv[] )
+{
+	const std::size_t iterations =
+			1 < argc ? static_cast< std::size_t >( std::atoi( argv[ 1 ] ) ) : 100u;
+	const std::size_t payload_size = 4u * 1024u * 1024u;
+
+	const auto best = vectorized::best_implementation();
+	std::cout << "Best implementation: " << impl_name( best ) << std::endl;
+
+	std::vector< vectorized::implementation_t > impls{
+		vectorized::implementation_t::scalar,
+		vectorized::implementation_t::word };
+	if( vectorized::implementation_t::sse2 == best ||
+		vectorized::implementation_t::avx2 == best )
+		impls.push_back( vectorized::implementation_t::sse2 );
+	if( vectorized::implementation_t::avx2 == best )
+		impls.push_back( vectorized::implementation_t::avx2 );
+
+	const vectorized::mask_t mask{ { 0x37, 0xFA, 0x21, 0x3D } };
+
+	std::string payload( payload_size, 'x' );
+
+	std::cout << "Masking of " << payload_size << " bytes:" << std::endl;
+	run_bench( "byte by byte", iterations, payload_size,
+		[&]{ byte_by_byte_mask_unmask( mask, payload ); } );
+
+	for( const auto impl : impls )
+		run_bench( impl_name( impl ), iterations, payload_size,
+			[&]{
+				vectorized::mask_unmask( impl, mask, 0u, &payload[ 0 ], payload.size() );
+			} );
+
+	// Mostly ASCII text with some multibyte symbols.
+	std::string text;
+	while( text.size() < payload_size )
+		text += "Some ASCII text with a few multibyte symbols: "
+			"\xc2\xb5\xe1\xbd\xb9\xf0\x90\x80\x80\n";
+
+	std::cout << "UTF-8 check of " << text.size() << " bytes:" << std::endl;
+
+	bool result = true;
+	run_bench( "byte by byte", iterations, text.size(),
+		[&]{ result = result && byte_by_byte_utf8_check( text ); } );
+
+	run_bench( "utf8_checker_t::process_bytes", iterations, text.size(),
+		[&]{ result = result && check_utf8_is_correct( text ); } );
+
+	const std::string ascii_text( payload_size, 'a' );
+	std::cout << "ASCII text of " << ascii_text.size() << " bytes:" << std::endl;
+
+	run_bench( "UTF-8 byte by byte", iterations, ascii_text.size(),
+		[&]{ result = result && byte_by_byte_utf8_check( ascii_text ); } );
+
+	run_bench( "UTF-8 process_bytes", iterations, ascii_text.size(),
+		[&]{ result = result && check_utf8_is_correct( ascii_text ); } );
+
+	std::size_t ascii_size = 0u;
+	for( const auto impl : impls )
+		run_bench( impl_name( impl ), iterations, ascii_text.size(),
+			[&]{
+				ascii_size += vectorized::ascii_prefix_size(
+						impl, ascii_text.data(), ascii_text.size() );
+			} );
+
+	if( !result || ascii_size != ascii_text.size() * iterations * impls.size() )
+	{
+		std::cerr << "Invalid results" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,8 @@
+require 'mxx_ru/cpp'
+
+MxxRu::Cpp::exe_target {
+
+	target( "_bench.test.websocket.payload_bench" )
+
+	cpp_source( "main.cpp" )
+}
@@ -0,0 +1,698 @@
+/*
+	restinio
+*/
+
+/*!
+	Tests for permessage-deflate extension.
+*/
+
+#include <catch2/catch.hpp>
+
+#include <future>
+#include <random>
+
+#include <restinio/all.hpp>
+#include <restinio/websocket/permessage_deflate.hpp>
+
+#include <test/common/utest_logger.hpp>
+#include <test/common/pub.hpp>
+
+namespace rws = restinio::websocket::basic;
+
+std::string
+negotiate(
+	restinio::string_view_t offers,
+	const rws::permessage_deflate_params_t & params =
+		rws::permessage_deflate_params_t{} )
+{
+	const auto config = rws::negotiate_permessage_deflate( offers, params );
+	return config ? config->response_field_value() : std::string{ "declined" };
+}
+
+TEST_CASE( "Negotiation" , "[permessage_deflate][negotiation]" )
+{
+	REQUIRE( "permessage-deflate" == negotiate( "permessage-deflate" ) );
+	REQUIRE( "permessage-deflate" ==
+		negotiate( "permessage-deflate; client_max_window_bits" ) );
+	REQUIRE( "permessage-deflate; client_max_window_bits=10" ==
+		negotiate( "permessage-deflate; client_max_window_bits=10" ) );
+	REQUIRE( "permessage-deflate; server_no_context_takeover; "
+			"client_no_context_takeover; server_max_window_bits=10" ==
+		negotiate( "permessage-deflate; client_no_context_takeover; "
+			"server_no_context_takeover; server_max_window_bits=10" ) );
+
+	// Invalid and unsupported offers.
+	REQUIRE( "declined" == negotiate( "" ) );
+	REQUIRE( "declined" == negotiate( "x-webkit-deflate-frame" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; x=1" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; server_max_window_bits" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; server_max_window_bits=16" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; server_max_window_bits=010" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; server_max_window_bits=8" ) );
+	REQUIRE( "declined" == negotiate( "permessage-deflate; client_max_window_bits=7" ) );
+	REQUIRE( "declined" == negotiate(
+			"permessage-deflate; server_no_context_takeover; server_no_context_takeover" ) );
+	REQUIRE( "declined" == negotiate(
+			"permessage-deflate; server_no_context_takeover=1" ) );
+
+	// The first acceptable offer is used.
+	REQUIRE( "permessage-deflate; server_max_window_bits=12" ==
+		negotiate( "permessage-deflate; server_max_window_bits=8, "
+			"x-webkit-deflate-frame, "
+			"permessage-deflate; server_max_window_bits=\"12\", "
+			"permessage-deflate" ) );
+
+	// Restrictions of the server.
+	const auto params = rws::permessage_deflate_params_t{}
+		.server_no_context_takeover( true )
+		.client_no_context_takeover( true )
+		.server_max_window_bits( 11 )
+		.client_max_window_bits( 9 );
+
+	REQUIRE( "permessage-deflate; server_no_context_takeover; "
+			"client_no_context_takeover; server_max_window_bits=11" ==
+		negotiate( "permessage-deflate", params ) );
+	REQUIRE( "permessage-deflate; server_no_context_takeover; "
+			"client_no_context_takeover; server_max_window_bits=10; "
+			"client_max_window_bits=9" ==
+		negotiate( "permessage-deflate; server_max_window_bits=10; "
+			"client_max_window_bits=12", params ) );
+
+	REQUIRE_THROWS( rws::permessage_deflate_params_t{}.server_max_window_bits( 8 ) );
+	REQUIRE_THROWS( rws::permessage_deflate_params_t{}.client_max_window_bits( 16 ) );
+	REQUIRE_THROWS( rws::permessage_deflate_params_t{}.compression_level( 10 ) );
+}
+
+TEST_CASE( "Negotiation for request" , "[permessage_deflate][negotiation]" )
+{
+	restinio::http_request_header_t header;
+	REQUIRE_FALSE( rws::negotiate_permessage_deflate(
+			header, rws::permessage_deflate_params_t{} ) );
+
+	header.set_field(
+		restinio::http_field::sec_websocket_extensions,
+		"x-webkit-deflate-frame, "
+		"permessage-deflate; client_max_window_bits=15" );
+
+	const auto config = rws::negotiate_permessage_deflate(
+			header, rws::permessage_deflate_params_t{} );
+	REQUIRE( config );
+	REQUIRE( "permessage-deflate; client_max_window_bits=15" ==
+		config->response_field_value() );
+}
+
+rws::impl::ws_compression_t
+make_compression(
+	restinio::string_view_t offer,
+	const rws::permessage_deflate_params_t & params )
+{
+	const auto config = rws::negotiate_permessage_deflate( offer, params );
+	REQUIRE( config );
+
+	return rws::impl::make_permessage_deflate_compression( *config, params );
+}
+
+std::string
+compress(
+	rws::impl::message_compressor_t & compressor,
+	rws::opcode_t opcode,
+	bool final_frame,
+	restinio::string_view_t payload,
+	bool expected_rsv1 = true )
+{
+	auto frame = compressor.compress_frame( opcode, final_frame, payload );
+	REQUIRE( frame );
+	REQUIRE( expected_rsv1 == frame->m_rsv1_flag );
+
+	return std::move( frame->m_payload );
+}
+
+std::string
+decompress(
+	rws::impl::message_decompressor_t & decompressor,
+	bool final_frame,
+	std::string payload )
+{
+	decompressor.decompress_frame( final_frame, payload );
+	return payload;
+}
+
+TEST_CASE( "Decompression of RFC 7692 examples" , "[permessage_deflate][decompress]" )
+{
+	auto c = make_compression(
+		"permessage-deflate", rws::permessage_deflate_params_t{} );
+	auto & d = *c.m_decompressor;
+
+	// RFC 7692, section 7.2.3.1.
+	REQUIRE( "Hello" == decompress(
+			d, true, std::string{ "\xf2\x48\xcd\xc9\xc9\x07\x00", 7u } ) );
+
+	// RFC 7692, section 7.2.3.2: the second message refers to the first one.
+	REQUIRE( "Hello" == decompress( d, true, std::string{ "\xf2\x00\x11\x00\x00", 5u } ) );
+
+	// RFC 7692, section 7.2.3.1: fragmented message.
+	// The decompressed data can be split between frames in any way.
+	auto fragmented = decompress( d, false, "\xf2\x48\xcd" );
+	fragmented += decompress( d, true, std::string{ "\xc9\xc9\x07\x00", 4u } );
+	REQUIRE( "Hello" == fragmented );
+
+	// RFC 7692, section 7.2.3.3: block with no compression.
+	REQUIRE( "Hello" == decompress(
+			d, true, std::string{ "\x00\x05\x00\xfa\xff" "Hello" "\x00", 11u } ) );
+
+	REQUIRE_THROWS( decompress( d, true, "\xff\xff\xff\xff" ) );
+}
+
+TEST_CASE( "Compression" , "[permessage_deflate][compress]" )
+{
+	const std::string text =
+		R"({"symbol":"ABC","bid":100.25,"ask":100.50,"volume":1000})";
+
+	SECTION( "context takeover" )
+	{
+		const auto params = rws::permessage_deflate_params_t{}
+			.compression_threshold( 16u );
+		auto c = make_compression( "permessage-deflate", params );
+
+		const auto first = compress(
+				*c.m_compressor, rws::opcode_t::text_frame, true, text );
+		const auto second = compress(
+				*c.m_compressor, rws::opcode_t::text_frame, true, text );
+
+		REQUIRE( first.size() < text.size() );
+		// The second message refers to the first one.
+		REQUIRE( second.size() < first.size() );
+
+		// Compressed data is decompressed by the peer with the same context.
+		auto d = make_compression( "permessage-deflate", params );
+		REQUIRE( text == decompress( *d.m_decompressor, true, first ) );
+		REQUIRE( text == decompress( *d.m_decompressor, true, second ) );
+
+		// Small messages aren't compressed.
+		REQUIRE_FALSE( c.m_compressor->compress_frame(
+				rws::opcode_t::binary_frame, true, "short" ) );
+	}
+
+	SECTION( "no context takeover" )
+	{
+		const auto params = rws::permessage_deflate_params_t{}
+			.compression_threshold( 0u )
+			.server_no_context_takeover( true );
+		auto c = make_compression( "permessage-deflate", params );
+
+		const auto first = compress(
+				*c.m_compressor, rws::opcode_t::text_frame, true, text );
+		const auto second = compress(
+				*c.m_compressor, rws::opcode_t::text_frame, true, text );
+		REQUIRE( first == second );
+
+		// Empty message.
+		REQUIRE( std::string( 1u, '\0' ) == compress(
+				*c.m_compressor, rws::opcode_t::binary_frame, true, "" ) );
+
+		// Every message can be decompressed separately.
+		auto d = make_compression(
+				"permessage-deflate; server_no_context_takeover", params );
+		REQUIRE( text == decompress( *d.m_decompressor, true, second ) );
+	}
+
+	SECTION( "fragmented message" )
+	{
+		const auto params = rws::permessage_deflate_params_t{}
+			.server_max_window_bits( 9 );
+		auto c = make_compression(
+				"permessage-deflate; server_max_window_bits=9", params );
+		auto d = make_compression(
+				"permessage-deflate; client_max_window_bits=9", params );
+
+		// Fragmented message is compressed even if it's small.
+		const auto first = compress(
+				*c.m_compressor, rws::opcode_t::text_frame, false, "Hel" );
+		const auto second = compress(
+				*c.m_compressor, rws::opcode_t::continuation_frame, true, "lo", false );
+
+		// Every frame is flushed, so it can be decompressed without
+		// waiting for the rest of the message.
+		REQUIRE( "Hel" == decompress( *d.m_decompressor, false, first ) );
+		REQUIRE( "lo" == decompress( *d.m_decompressor, true, second ) );
+	}
+}
+
+TEST_CASE( "Max decompressed message size" , "[permessage_deflate][decompress]" )
+{
+	const auto params = rws::permessage_deflate_params_t{}
+		.compression_threshold( 0u )
+		.max_decompressed_message_size( 100000u );
+
+	auto c = make_compression( "permessage-deflate", params );
+	auto d = make_compression( "permessage-deflate", params );
+
+	const std::string allowed( 100000u, 'a' );
+	REQUIRE( allowed == decompress( *d.m_decompressor, true,
+			compress( *c.m_compressor, rws::opcode_t::binary_frame, true, allowed ) ) );
+
+	const std::string too_big( 100001u, 'a' );
+	const auto compressed =
+		compress( *c.m_compressor, rws::opcode_t::binary_frame, true, too_big );
+	REQUIRE( compressed.size() < 1000u );
+	REQUIRE_THROWS( decompress( *d.m_decompressor, true, compressed ) );
+}
+
+TEST_CASE( "Validation of compressed frames" , "[permessage_deflate][validator]" )
+{
+	using namespace rws::impl;
+
+	const auto make_frame = []( rws::opcode_t opcode, bool final_frame ) {
+		message_details_t frame{
+			final_frame ? rws::final_frame : rws::not_final_frame,
+			opcode,
+			0u,
+			0u };
+		frame.m_rsv1_flag = true;
+		return frame;
+	};
+
+	ws_protocol_validator_t validator{ true };
+	REQUIRE( validation_state_t::non_zero_rsv_flags ==
+		validator.process_new_frame(
+			make_frame( rws::opcode_t::text_frame, true ) ) );
+
+	validator.reset();
+	validator.allow_compressed_messages();
+
+	REQUIRE( validation_state_t::frame_header_is_valid ==
+		validator.process_new_frame(
+			make_frame( rws::opcode_t::text_frame, false ) ) );
+	REQUIRE( validator.is_compressed_message() );
+
+	// Compressed payload isn't checked as UTF-8.
+	char payload[] = "\xff\xfe";
+	REQUIRE( validation_state_t::payload_part_is_valid ==
+		validator.process_and_unmask_next_payload_part( payload, 2u ) );
+	REQUIRE( validation_state_t::incorrect_utf8_data ==
+		validator.process_decompressed_payload_part( payload, 2u ) );
+	REQUIRE( validation_state_t::incorrect_utf8_data == validator.finish_frame() );
+	validator.reset();
+
+	// Only the first frame of a data message can have RSV1.
+	REQUIRE( validation_state_t::frame_header_is_valid ==
+		validator.process_new_frame(
+			make_frame( rws::opcode_t::binary_frame, false ) ) );
+	REQUIRE( validation_state_t::frame_is_valid == validator.finish_frame() );
+
+	REQUIRE( validation_state_t::non_zero_rsv_flags ==
+		validator.process_new_frame(
+			make_frame( rws::opcode_t::ping_frame, true ) ) );
+	validator.finish_frame();
+
+	REQUIRE( validation_state_t::non_zero_rsv_flags ==
+		validator.process_new_frame(
+			make_frame( rws::opcode_t::continuation_frame, true ) ) );
+}
+
+using traits_t =
+	restinio::traits_t<
+		restinio::asio_timer_manager_t,
+		utest_logger_t >;
+
+using http_server_t = restinio::http_server_t< traits_t >;
+
+//! Write a masked frame as a client.
+void
+write_frame(
+	restinio::asio_ns::ip::tcp::socket & socket,
+	rws::opcode_t opcode,
+	bool rsv1,
+	std::string payload )
+{
+	const std::uint32_t masking_key = 0xA1B2C3D4u;
+
+	rws::impl::message_details_t details{
+		rws::final_frame, opcode, payload.size(), masking_key };
+	details.m_rsv1_flag = rsv1;
+
+	rws::impl::mask_unmask_payload( masking_key, payload );
+
+	restinio::asio_ns::write( socket, restinio::asio_ns::buffer(
+			rws::impl::write_message_details( details ) + payload ) );
+}
+
+//! Read an unmasked frame.
+rws::impl::message_details_t
+read_frame( restinio::asio_ns::ip::tcp::socket & socket, std::string & payload )
+{
+	std::array< unsigned char, 2 > header;
+	restinio::asio_ns::read( socket, restinio::asio_ns::buffer( header ) );
+
+	rws::impl::message_details_t details;
+	details.m_final_flag = 0 != ( header[ 0 ] & 0x80u );
+	details.m_rsv1_flag = 0 != ( header[ 0 ] & 0x40u );
+	details.m_opcode = static_cast< rws::opcode_t >( header[ 0 ] & 0x0Fu );
+
+	std::size_t size = header[ 1 ] & 0x7Fu;
+	if( 126u <= size )
+	{
+		// Extended payload length in network byte order.
+		std::array< unsigned char, 8 > length;
+		const std::size_t length_size = 126u == size ? 2u : 8u;
+		restinio::asio_ns::read(
+			socket, restinio::asio_ns::buffer( length.data(), length_size ) );
+
+		size = 0u;
+		for( std::size_t i = 0u; i != length_size; ++i )
+			size = ( size << 8 ) | length[ i ];
+	}
+
+	payload.resize( size );
+	restinio::asio_ns::read( socket, restinio::asio_ns::buffer( &payload[ 0 ], size ) );
+
+	return details;
+}
+
+TEST_CASE( "Compressed echo" , "[permessage_deflate][ws_connection]" )
+{
+	const auto params = rws::permessage_deflate_params_t{}
+		.compression_threshold( 0u );
+
+	std::mutex ws_lock;
+	rws::ws_handle_t ws;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[&]( auto req ){
+						std::lock_guard< std::mutex > lock{ ws_lock };
+						ws = rws::upgrade< traits_t >(
+								*req,
+								rws::activation_t::immediate,
+								params,
+								[]( rws::ws_handle_t wsh, rws::message_handle_t m ){
+									wsh->send_message( *m );
+								} );
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+	other_thread.run();
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		restinio::asio_ns::write( socket, restinio::asio_ns::buffer( std::string{
+				"GET /chat HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Upgrade: websocket\r\n"
+				"Connection: Upgrade\r\n"
+				"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+				"Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits\r\n"
+				"Sec-WebSocket-Version: 13\r\n"
+				"\r\n" } ) );
+
+		restinio::asio_ns::streambuf response_buf;
+		const auto header_size = restinio::asio_ns::read_until(
+				socket, response_buf, "\r\n\r\n" );
+		const std::string response{
+				restinio::asio_ns::buffers_begin( response_buf.data() ),
+				restinio::asio_ns::buffers_begin( response_buf.data() ) + header_size };
+		REQUIRE( response_buf.size() == header_size );
+
+		REQUIRE_THAT( response, Catch::StartsWith( "HTTP/1.1 101 Switching Protocols" ) );
+		REQUIRE_THAT( response, Catch::Contains(
+				"Sec-WebSocket-Accept: s3pPLMBiTxaQ9kYGzzhZRbK+xOo=" ) );
+		REQUIRE_THAT( response, Catch::Contains(
+				"Sec-WebSocket-Extensions: permessage-deflate\r\n" ) );
+
+		// The peer decompresses messages of the server.
+		auto peer = make_compression( "permessage-deflate", params );
+		std::string payload;
+
+		write_frame( socket, rws::opcode_t::text_frame, true,
+			std::string{ "\xf2\x48\xcd\xc9\xc9\x07\x00", 7u } );
+		auto details = read_frame( socket, payload );
+		REQUIRE( details.m_final_flag );
+		REQUIRE( details.m_rsv1_flag );
+		REQUIRE( rws::opcode_t::text_frame == details.m_opcode );
+		REQUIRE( "Hello" == decompress( *peer.m_decompressor, true, payload ) );
+
+		// Uncompressed messages are still accepted.
+		write_frame( socket, rws::opcode_t::binary_frame, false, "World" );
+		details = read_frame( socket, payload );
+		REQUIRE( details.m_rsv1_flag );
+		REQUIRE( rws::opcode_t::binary_frame == details.m_opcode );
+		REQUIRE( "World" == decompress( *peer.m_decompressor, true, payload ) );
+
+		// Control frames aren't compressed.
+		write_frame( socket, rws::opcode_t::ping_frame, false, "ping" );
+		details = read_frame( socket, payload );
+		REQUIRE_FALSE( details.m_rsv1_flag );
+		REQUIRE( "ping" == payload );
+
+		// Invalid compressed data closes the websocket.
+		write_frame( socket, rws::opcode_t::text_frame, true, "\xff\xff\xff\xff" );
+		details = read_frame( socket, payload );
+		REQUIRE( rws::opcode_t::connection_close_frame == details.m_opcode );
+		REQUIRE( rws::status_code_t::invalid_message_data ==
+			rws::status_code_from_bin( payload ) );
+	} );
+
+	{
+		std::lock_guard< std::mutex > lock{ ws_lock };
+		ws.reset();
+	}
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Messages from several threads" , "[permessage_deflate][ws_connection]" )
+{
+	const auto params = rws::permessage_deflate_params_t{}
+		.compression_threshold( 0u );
+
+	std::mutex ws_lock;
+	rws::ws_handle_t ws;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[&]( auto req ){
+						std::lock_guard< std::mutex > lock{ ws_lock };
+						ws = rws::upgrade< traits_t >(
+								*req,
+								rws::activation_t::immediate,
+								params,
+								[]( rws::ws_handle_t, rws::message_handle_t ){} );
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+	other_thread.run();
+
+	constexpr std::size_t threads_count = 4u;
+	constexpr std::size_t messages_count = 200u;
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		restinio::asio_ns::write( socket, restinio::asio_ns::buffer( std::string{
+				"GET /chat HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Upgrade: websocket\r\n"
+				"Connection: Upgrade\r\n"
+				"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+				"Sec-WebSocket-Extensions: permessage-deflate\r\n"
+				"Sec-WebSocket-Version: 13\r\n"
+				"\r\n" } ) );
+
+		restinio::asio_ns::streambuf response_buf;
+		const auto header_size = restinio::asio_ns::read_until(
+				socket, response_buf, "\r\n\r\n" );
+		REQUIRE( response_buf.size() == header_size );
+
+		rws::ws_handle_t wsh;
+		{
+			std::lock_guard< std::mutex > lock{ ws_lock };
+			wsh = ws;
+		}
+		REQUIRE( wsh );
+
+		// Every thread sends its messages at the same time,
+		// each message must be compressed in the order it is written.
+		std::vector< std::thread > senders;
+		for( std::size_t t = 0u; t != threads_count; ++t )
+			senders.emplace_back( [wsh, t] {
+				for( std::size_t i = 0u; i != messages_count; ++i )
+					wsh->send_message(
+						rws::final_frame,
+						rws::opcode_t::text_frame,
+						restinio::writable_item_t{
+							fmt::format( "thread-{} message-{}", t, i ) } );
+			} );
+
+		auto peer = make_compression( "permessage-deflate", params );
+		std::array< std::size_t, threads_count > next_message{};
+
+		std::string payload;
+		for( std::size_t n = 0u; n != threads_count * messages_count; ++n )
+		{
+			const auto details = read_frame( socket, payload );
+			REQUIRE( details.m_rsv1_flag );
+
+			const auto text = decompress( *peer.m_decompressor, true, payload );
+
+			std::size_t t = threads_count;
+			std::size_t i = messages_count;
+			REQUIRE( 2 == std::sscanf( text.c_str(), "thread-%zu message-%zu", &t, &i ) );
+			REQUIRE( t < threads_count );
+			REQUIRE( next_message[ t ] == i );
+			++next_message[ t ];
+		}
+
+		for( auto & s : senders )
+			s.join();
+	} );
+
+	{
+		std::lock_guard< std::mutex > lock{ ws_lock };
+		ws.reset();
+	}
+
+	other_thread.stop_and_join();
+}
+
+TEST_CASE( "Dropped messages and context takeover" ,
+	"[permessage_deflate][ws_connection][outgoing_queue]" )
+{
+	const auto params = rws::permessage_deflate_params_t{}
+		.compression_threshold( 0u );
+
+	std::mutex ws_lock;
+	rws::ws_handle_t ws;
+
+	http_server_t http_server{
+		restinio::own_io_context(),
+		[&]( auto & settings ){
+			settings
+				.port( utest_default_port() )
+				.address( "127.0.0.1" )
+				.request_handler(
+					[&]( auto req ){
+						std::lock_guard< std::mutex > lock{ ws_lock };
+						ws = rws::upgrade< traits_t >(
+								*req,
+								rws::activation_t::immediate,
+								params,
+								[]( rws::ws_handle_t, rws::message_handle_t ){} );
+
+						return restinio::request_accepted();
+					} );
+		} };
+
+	other_work_thread_for_server_t< http_server_t > other_thread{ http_server };
+	other_thread.run();
+
+	// Incompressible messages to fill socket buffers.
+	constexpr std::size_t message_size = 512u * 1024u;
+	constexpr std::size_t message_count = 64u;
+
+	std::string filler( message_size, '\0' );
+	std::mt19937 generator;
+	for( auto & ch : filler )
+		ch = static_cast< char >( generator() );
+
+	const std::string text{ "Hello, hello, hello, hello!" };
+
+	do_with_socket( [&]( auto & socket, auto & /*io_context*/ ){
+		restinio::asio_ns::write( socket, restinio::asio_ns::buffer( std::string{
+				"GET /chat HTTP/1.1\r\n"
+				"Host: 127.0.0.1\r\n"
+				"Upgrade: websocket\r\n"
+				"Connection: Upgrade\r\n"
+				"Sec-WebSocket-Key: dGhlIHNhbXBsZSBub25jZQ==\r\n"
+				"Sec-WebSocket-Extensions: permessage-deflate\r\n"
+				"Sec-WebSocket-Version: 13\r\n"
+				"\r\n" } ) );
+
+		restinio::asio_ns::streambuf response_buf;
+		const auto header_size = restinio::asio_ns::read_until(
+				socket, response_buf, "\r\n\r\n" );
+		REQUIRE( response_buf.size() == header_size );
+
+		rws::ws_handle_t wsh;
+		{
+			std::lock_guard< std::mutex > lock{ ws_lock };
+			wsh = ws;
+		}
+		REQUIRE( wsh );
+
+		auto limits = rws::outgoing_queue_limits_t{}
+			.watermarks( 0u, 4u * message_size );
+		wsh->set_outgoing_queue_limits( limits );
+
+		for( std::size_t i = 0u; i != message_count; ++i )
+			wsh->send_message(
+				rws::final_frame,
+				rws::opcode_t::binary_frame,
+				restinio::writable_item_t{ filler } );
+
+		for( int i = 0; i != 1000 && wsh->is_writable(); ++i )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+		REQUIRE_FALSE( wsh->is_writable() );
+
+		wsh->set_outgoing_queue_limits(
+			std::move( limits ).overflow_policy( rws::queue_overflow_policy_t::drop ) );
+
+		// The dropped message must not get into the compression context,
+		// otherwise the next message refers to data the peer hasn't seen.
+		std::promise< restinio::asio_ns::error_code > dropped;
+		wsh->send_message(
+			rws::final_frame,
+			rws::opcode_t::text_frame,
+			restinio::writable_item_t{ text },
+			[&]( const auto & ec ) { dropped.set_value( ec ); } );
+
+		auto dropped_result = dropped.get_future();
+		REQUIRE( std::future_status::ready ==
+			dropped_result.wait_for( std::chrono::seconds( 5 ) ) );
+		REQUIRE( restinio::make_asio_compaible_error(
+				restinio::asio_convertible_error_t::write_was_not_executed ) ==
+			dropped_result.get() );
+
+		auto peer = make_compression( "permessage-deflate", params );
+
+		std::string payload;
+		for( std::size_t i = 0u; i != message_count; ++i )
+		{
+			const auto details = read_frame( socket, payload );
+			REQUIRE( details.m_rsv1_flag );
+			REQUIRE( filler == decompress( *peer.m_decompressor, true, payload ) );
+		}
+
+		for( int i = 0; i != 1000 && !wsh->is_writable(); ++i )
+			std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+		REQUIRE( wsh->is_writable() );
+
+		wsh->send_message(
+			rws::final_frame,
+			rws::opcode_t::text_frame,
+			restinio::writable_item_t{ text } );
+
+		const auto details = read_frame( socket, payload );
+		REQUIRE( details.m_rsv1_flag );
+		REQUIRE( text == decompress( *peer.m_decompressor, true, payload ) );
+	} );
+
+	{
+		std::lock_guard< std::mutex > lock{ ws_lock };
+		ws.reset();
+	}
+
+	other_thread.stop_and_join();
+}
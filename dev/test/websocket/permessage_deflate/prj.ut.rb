@@ -0,0 +1,7 @@
+require 'mxx_ru/binary_unittest'
+
+Mxx_ru::setup_target(
+	Mxx_ru::Binary_unittest_target.new(
+		"test/websocket/permessage_deflate/prj.ut.rb",
+		"test/websocket/permessage_deflate/prj.rb" )
+)
@@ -119,6 +119,41 @@ TEST_CASE(
 	}
 }
 
+TEST_CASE(
+	"UTF-8 check with long ASCII parts" ,
+	"[validators][utf-8][vectorized]" )
+{
+	const std::string ascii( 100, 'a' );
+	// Some 2, 3 and 4 byte symbols.
+	const std::string multibyte{ to_char_each({
+			0xc2, 0xb5, 0xe1, 0xbd, 0xb9, 0xf0, 0x90, 0x80, 0x80 }) };
+
+	REQUIRE( check_utf8_is_correct( ascii ) );
+	REQUIRE( check_utf8_is_correct( ascii + multibyte + ascii ) );
+	REQUIRE( check_utf8_is_correct( multibyte + ascii + multibyte ) );
+
+	// Incomplete symbol at the end.
+	REQUIRE_FALSE( check_utf8_is_correct( ascii + multibyte.substr( 0, 3 ) ) );
+	// Continuation byte after ASCII.
+	REQUIRE_FALSE( check_utf8_is_correct(
+			ascii + multibyte.substr( 1 ) + ascii ) );
+	// ASCII inside multibyte symbol.
+	REQUIRE_FALSE( check_utf8_is_correct(
+			ascii + multibyte.substr( 0, 4 ) + ascii ) );
+
+	// Symbol split between two parts.
+	{
+		const auto text = ascii + multibyte + ascii;
+		for( std::size_t pos = 0; pos != text.size(); ++pos )
+		{
+			utf8_checker_t checker;
+			REQUIRE( checker.process_bytes( text.data(), pos ) );
+			REQUIRE( checker.process_bytes( text.data() + pos, text.size() - pos ) );
+			REQUIRE( checker.final() );
+		}
+	}
+}
+
 TEST_CASE(
 	"validation_state_str function" ,
 	"[validators][state_to_str]" )
@@ -183,6 +218,26 @@ TEST_CASE(
 		REQUIRE( unmasker.m_mask[2] == 0x21 );
 		REQUIRE( unmasker.m_mask[3] == 0x3D );
 	}
+	{
+		std::string text;
+		for( int i = 0; i != 100; ++i )
+			text += "Hello, ";
+
+		std::string masked_payload = text;
+		mask_unmask_payload( 0x37FA213D, masked_payload );
+
+		// Unmasking by parts of different sizes.
+		unmasker_t unmasker{ 0x37FA213D };
+		std::size_t pos = 0;
+		for( std::size_t part = 1; pos < masked_payload.size(); ++part )
+		{
+			const auto n = std::min( part, masked_payload.size() - pos );
+			unmasker.unmask_bytes( &masked_payload[ pos ], n );
+			pos += n;
+		}
+
+		REQUIRE( masked_payload == text );
+	}
 }
 
 TEST_CASE(
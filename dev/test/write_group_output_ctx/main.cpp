@@ -8,6 +8,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstdio>
+#include <fstream>
 #include <iterator>
 
 #include <restinio/impl/write_group_output_ctx.hpp>
@@ -338,6 +340,94 @@ TEST_CASE( "write_group_output_ctx_t simple sf" , "[write_group_output_ctx_t][se
 	}
 }
 
+TEST_CASE( "sendfile_buffer_t" , "[sendfile_buffer_t]" )
+{
+	sendfile_buffer_t buffer;
+
+	char * const first = buffer.acquire( 1024u );
+	REQUIRE( nullptr != first );
+
+	// A smaller or equal size doesn't reallocate the buffer.
+	REQUIRE( first == buffer.acquire( 512u ) );
+	REQUIRE( first == buffer.acquire( 1024u ) );
+
+	char * const bigger = buffer.acquire( 4096u );
+	REQUIRE( nullptr != bigger );
+	REQUIRE( bigger == buffer.acquire( 2048u ) );
+}
+
+#if defined( ASIO_HAS_LOCAL_SOCKETS ) || defined( BOOST_ASIO_HAS_LOCAL_SOCKETS )
+
+TEST_CASE( "write_group_output_ctx_t buffered sf" ,
+	"[write_group_output_ctx_t][sendfile][buffered]" )
+{
+	const std::string file_name{ "_write_group_output_ctx_test.dat" };
+
+	std::string content;
+	for( std::size_t i = 0; i != 3000u; ++i )
+		content += static_cast< char >( 'a' + i % 26u );
+
+	{
+		std::ofstream f{ file_name, std::ios::binary };
+		f << content;
+	}
+
+	asio_ns::io_context io_context;
+	asio_ns::local::stream_protocol::socket writer{ io_context };
+	asio_ns::local::stream_protocol::socket reader{ io_context };
+	asio_ns::local::connect_pair( writer, reader );
+
+	// Not a tcp-socket, so file data goes through the connection's buffer.
+	write_group_output_ctx_t wg_output{};
+
+	wg_output.start_next_write_group(
+		write_group_t{
+			make_buffers(
+				make_buffers(
+					restinio::sendfile( file_name )
+						.offset_and_size( 0u, 1000u )
+						.chunk_size( 512u ) ),
+				make_buffers(
+					restinio::sendfile( file_name )
+						.offset_and_size( 1000u )
+						.chunk_size( 1024u ) ) ) } );
+
+	for( std::size_t i = 0; i != 2; ++i )
+	{
+		auto wo = wg_output.extract_next_write_operation();
+		REQUIRE( holds_alternative< file_write_operation_t >( wo ) );
+
+		asio_ns::error_code result_ec{ asio_ns::error::would_block };
+		file_size_t result_size{ 0u };
+		get< file_write_operation_t >( wo ).start_sendfile_operation(
+			io_context.get_executor(),
+			writer,
+			[&]( const asio_ns::error_code & ec, file_size_t written ) {
+				get< file_write_operation_t >( wo ).reset();
+				result_ec = ec;
+				result_size = written;
+			} );
+
+		io_context.restart();
+		io_context.run();
+
+		REQUIRE_FALSE( result_ec );
+		REQUIRE( ( 0 == i ? 1000u : 2000u ) == result_size );
+	}
+
+	REQUIRE( holds_alternative< none_write_operation_t >(
+		wg_output.extract_next_write_operation() ) );
+	REQUIRE_NOTHROW( wg_output.finish_write_group() );
+
+	std::string received( content.size(), '\0' );
+	asio_ns::read( reader, asio_ns::buffer( &received[ 0 ], received.size() ) );
+	REQUIRE( content == received );
+
+	std::remove( file_name.c_str() );
+}
+
+#endif
+
 TEST_CASE( "write_group_output_ctx_t mixed" , "[write_group_output_ctx_t][mix][trivial][sendfile]" )
 {
 	{